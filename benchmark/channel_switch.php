@@ -14,7 +14,15 @@ declare(strict_types=1);
 use Swow\Channel;
 use Swow\Coroutine;
 
-$channel = new Channel();
+/*
+ * usage: php channel_switch.php [capacity] [batch size]
+ */
+$capacity = (int) ($argv[1] ?? 0);
+$batchSize = (int) ($argv[2] ?? 64);
+$times = 1000 * 10000;
+
+/* one by one */
+$channel = new Channel($capacity);
 Coroutine::run(static function () use ($channel): void {
     while ($channel->pop()) {
         continue;
@@ -22,7 +30,6 @@ Coroutine::run(static function () use ($channel): void {
     echo 'Over' . PHP_EOL;
 });
 
-$times = 1000 * 10000;
 $use = microtime(true);
 for ($n = $times / 2; $n--;) {
     $channel->push(true);
@@ -33,4 +40,30 @@ $channel->push(false);
 $ns = $use * (1000 * 1000 * 1000) / $times;
 $qps = $times * (1 / $use);
 
-echo sprintf('Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $ns, $qps);
+echo sprintf('[push/pop] Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $ns, $qps);
+
+/* batch */
+$channel = new Channel(max($capacity, $batchSize));
+Coroutine::run(static function () use ($channel, $batchSize): void {
+    while (true) {
+        foreach ($channel->popMany($batchSize) as $data) {
+            if (!$data) {
+                break 2;
+            }
+        }
+    }
+    echo 'Over' . PHP_EOL;
+});
+
+$batch = array_fill(0, $batchSize, true);
+$use = microtime(true);
+for ($n = intdiv($times / 2, $batchSize); $n--;) {
+    $channel->pushMany($batch);
+}
+$use = microtime(true) - $use;
+$channel->push(false);
+
+$ns = $use * (1000 * 1000 * 1000) / $times;
+$qps = $times * (1 / $use);
+
+echo sprintf('[pushMany/popMany] Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $ns, $qps);
@@ -31,4 +31,19 @@ $coroutine->resume(false);
 $ns = $use * (1000 * 1000 * 1000) / $times;
 $qps = $times * (1 / $use);
 
-echo sprintf('Use %fs for %d times, %fns/t, qps=%f', $use, $times, $ns, $qps);
+echo sprintf('[switch]  Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $ns, $qps);
+
+/* create/destroy, stacks are recycled by the stack pool */
+$times = 100 * 10000;
+$stats = Coroutine::getStackPoolStats();
+$use = microtime(true);
+for ($n = $times; $n--;) {
+    Coroutine::run(static function (): void { });
+}
+$use = microtime(true) - $use;
+$hits = Coroutine::getStackPoolStats()['hits'] - $stats['hits'];
+
+$ns = $use * (1000 * 1000 * 1000) / $times;
+$qps = $times * (1 / $use);
+
+echo sprintf('[create]  Use %fs for %d times, %fns/t, qps=%f, stack pool hits=%d' . PHP_EOL, $use, $times, $ns, $qps, $hits);
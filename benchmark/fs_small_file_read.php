@@ -0,0 +1,78 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+/*
+ * Small-file read throughput with concurrent coroutines,
+ * file operations are done by io_uring on Linux if the kernel supports it,
+ * run it with CAT_FS_IO_URING=0 to compare it with the thread pool.
+ * usage: php fs_small_file_read.php [concurrency] [rounds] [files] [size]
+ */
+
+use Swow\Coroutine;
+use Swow\Sync\WaitReference;
+
+$concurrency = (int) ($argv[1] ?? 1000);
+$rounds = (int) ($argv[2] ?? 100);
+$fileCount = (int) ($argv[3] ?? 100);
+$fileSize = (int) ($argv[4] ?? 4096);
+$times = $concurrency * $rounds;
+
+$dir = sys_get_temp_dir() . '/swow_fs_benchmark_' . getmypid();
+mkdir($dir);
+$files = [];
+for ($n = 0; $n < $fileCount; $n++) {
+    $files[] = $file = "{$dir}/{$n}.txt";
+    file_put_contents($file, str_repeat('x', $fileSize));
+}
+
+echo sprintf('engine=%s, concurrency=%d, rounds=%d, files=%d, size=%d' . PHP_EOL,
+    stream_get_fs_engine(),
+    $concurrency, $rounds, $fileCount, $fileSize
+);
+
+/* open + fstat + read + close */
+$use = microtime(true);
+$wr = new WaitReference();
+for ($c = 0; $c < $concurrency; $c++) {
+    Coroutine::run(static function () use ($wr, $files, $fileCount, $fileSize, $rounds, $c): void {
+        for ($n = 0; $n < $rounds; $n++) {
+            $content = file_get_contents($files[($c + $n) % $fileCount]);
+            if (strlen($content) !== $fileSize) {
+                throw new RuntimeException('Unexpected file size');
+            }
+        }
+    });
+}
+WaitReference::wait($wr);
+$use = microtime(true) - $use;
+echo sprintf('[read]    Use %fs for %d times, %fns/t, qps=%f, %fMB/s' . PHP_EOL, $use, $times, $use * (1000 * 1000 * 1000) / $times, $times / $use, $times * $fileSize / $use / (1024 * 1024));
+
+/* stat only */
+$use = microtime(true);
+$wr = new WaitReference();
+for ($c = 0; $c < $concurrency; $c++) {
+    Coroutine::run(static function () use ($wr, $files, $fileCount, $rounds, $c): void {
+        for ($n = 0; $n < $rounds; $n++) {
+            clearstatcache();
+            filesize($files[($c + $n) % $fileCount]);
+        }
+    });
+}
+WaitReference::wait($wr);
+$use = microtime(true) - $use;
+echo sprintf('[stat]    Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $use * (1000 * 1000 * 1000) / $times, $times / $use);
+
+foreach ($files as $file) {
+    unlink($file);
+}
+rmdir($dir);
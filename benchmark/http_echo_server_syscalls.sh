@@ -0,0 +1,32 @@
+#!/bin/bash
+__DIR__=$(cd "$(dirname "$0")" || exit 1; pwd); [ -z "${__DIR__}" ] && exit 1
+
+# Count syscalls of the echo server with and without persistent read interest.
+# usage: http_echo_server_syscalls.sh [requests] [concurrency]
+
+ulimit -n 8192
+
+requests=${1:-100000}
+concurrency=${2:-100}
+
+export SERVER_HOST=127.0.0.1
+export SERVER_PORT=9764
+export SERVER_BACKLOG=8192
+
+for persistent in 0 1; do
+  export SERVER_READ_PERSISTENT=${persistent}
+  output=$(mktemp)
+  strace -f -c -o "${output}" /usr/bin/env php -dextension=swow "${__DIR__}/../examples/http_server/echo.php" &
+  pid=$!
+
+  sleep 1
+  ab -q -c "${concurrency}" -n "${requests}" -k "http://${SERVER_HOST}:${SERVER_PORT}/" | grep -E "^(Requests per second|Failed requests)"
+
+  pkill -INT -P ${pid}
+  wait ${pid}
+  echo "[read persistent: ${persistent}] top syscalls for ${requests} requests:"
+  grep -E "^ *[0-9.]+ " "${output}" | sort -k4 -n -r | head -n 8
+  grep -E "total$" "${output}"
+  rm -f "${output}"
+  echo
+done
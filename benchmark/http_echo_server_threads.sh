@@ -0,0 +1,20 @@
+#!/bin/bash
+__DIR__=$(cd "$(dirname "$0")" || exit 1; pwd); [ -z "${__DIR__}" ] && exit 1
+
+# shellcheck disable=SC2039
+ulimit -n 10240
+
+# same as http_echo_server_multi.sh, but in one process with N threads (requires ZTS build of PHP)
+export SERVER_HOST=127.0.0.1
+export SERVER_PORT=9764
+export SERVER_BACKLOG=8192
+export SERVER_THREADS=${SERVER_THREADS:-8}
+
+/usr/bin/env php -dextension=swow -dmemory_limit=1G "${__DIR__}/../examples/http_server/echo.php" &
+pid=$!
+
+sleep 1
+ab -c 8192 -n 1000000 -k "http://${SERVER_HOST}:${SERVER_PORT}/"
+
+kill ${pid}
+wait ${pid}
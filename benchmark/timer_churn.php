@@ -0,0 +1,60 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+/*
+ * Sleep/timeout churn of the timer subsystem,
+ * run it with different builds of Swow to compare them.
+ * usage: php timer_churn.php [concurrency] [rounds]
+ */
+
+use Swow\Channel;
+use Swow\Coroutine;
+use Swow\Sync\WaitReference;
+
+$concurrency = (int) ($argv[1] ?? 1000);
+$rounds = (int) ($argv[2] ?? 1000);
+$times = $concurrency * $rounds;
+
+/* timers that always fire */
+$use = microtime(true);
+$wr = new WaitReference();
+for ($c = $concurrency; $c--;) {
+    Coroutine::run(static function () use ($wr, $rounds): void {
+        for ($n = $rounds; $n--;) {
+            msleep(1);
+        }
+    });
+}
+WaitReference::wait($wr);
+$use = microtime(true) - $use;
+echo sprintf('[sleep]   Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $use * (1000 * 1000 * 1000) / $times, $times / $use);
+
+/* timeouts that (almost) never fire, e.g. read timeout of sockets */
+$use = microtime(true);
+$wr = new WaitReference();
+for ($c = $concurrency; $c--;) {
+    $channel = new Channel();
+    Coroutine::run(static function () use ($wr, $channel, $rounds): void {
+        for ($n = $rounds; $n--;) {
+            $channel->pop(60 * 1000);
+        }
+    });
+    Coroutine::run(static function () use ($wr, $channel, $rounds): void {
+        for ($n = $rounds; $n--;) {
+            $channel->push(true, 60 * 1000);
+        }
+    });
+}
+WaitReference::wait($wr);
+$use = microtime(true) - $use;
+echo sprintf('[timeout] Use %fs for %d times, %fns/t, qps=%f' . PHP_EOL, $use, $times, $use * (1000 * 1000 * 1000) / $times, $times / $use);
@@ -0,0 +1,49 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+/*
+ * Throughput of WebSocket payload masking from 16B to 16MB,
+ * the kernel can be forced by env, e.g. CAT_WEBSOCKET_MASK_KERNEL=scalar|sse2|avx2|neon
+ * usage: php websocket_mask.php [total bytes per size]
+ */
+
+use Swow\Buffer;
+use Swow\WebSocket\WebSocket;
+
+$total = (int) ($argv[1] ?? 1024 * 1024 * 1024);
+$maskingKey = "\x12\x34\x56\x78";
+
+echo sprintf('kernel=%s' . PHP_EOL, WebSocket::getMaskKernel());
+
+for ($size = 16; $size <= 16 * 1024 * 1024; $size *= 16) {
+    $data = str_repeat('x', $size);
+    $buffer = new Buffer($size);
+    $buffer->append($data);
+    $times = max(1, intdiv($total, $size));
+
+    /* in-place, as receiver does */
+    $use = microtime(true);
+    for ($n = $times; $n--;) {
+        WebSocket::unmask($buffer, maskingKey: $maskingKey);
+    }
+    $use = microtime(true) - $use;
+    echo sprintf('[unmask %8d] Use %fs for %d times, %fns/t, %fMB/s' . PHP_EOL, $size, $use, $times, $use * (1000 * 1000 * 1000) / $times, $size * $times / $use / (1024 * 1024));
+
+    /* copying, as sender does */
+    $use = microtime(true);
+    for ($n = $times; $n--;) {
+        WebSocket::mask($data, maskingKey: $maskingKey);
+    }
+    $use = microtime(true) - $use;
+    echo sprintf('[mask   %8d] Use %fs for %d times, %fns/t, %fMB/s' . PHP_EOL, $size, $use, $times, $use * (1000 * 1000 * 1000) / $times, $size * $times / $use / (1024 * 1024));
+}
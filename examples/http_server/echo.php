@@ -17,13 +17,29 @@ use Swow\Http\Parser;
 use Swow\Http\ParserException;
 use Swow\Socket;
 use Swow\SocketException;
+use Swow\Thread;
 
 $host = getenv('SERVER_HOST') ?: '127.0.0.1';
 $port = (int) (getenv('SERVER_PORT') ?: 9764);
 $backlog = (int) (getenv('SERVER_BACKLOG') ?: 8192);
 $multi = (bool) (getenv('SERVER_MULTI') ?: false);
+$readPersistent = (bool) (getenv('SERVER_READ_PERSISTENT') ?: false);
+$threads = (int) (getenv('SERVER_THREADS') ?: 1);
 $bindFlag = Socket::BIND_FLAG_NONE;
 
+/* run the same server in other threads (requires ZTS), they share the port by SO_REUSEPORT */
+$workers = [];
+if ($threads > 1) {
+    $multi = true;
+    if (Thread::getCurrentId() === 0) {
+        for ($n = 1; $n < $threads; $n++) {
+            $workers[] = new Thread(__FILE__);
+        }
+    }
+}
+
+Socket::setGlobalReadPersistent($readPersistent);
+
 $server = new Socket(Socket::TYPE_TCP);
 if ($multi) {
     $bindFlag |= Socket::BIND_FLAG_REUSEPORT;
@@ -379,6 +379,7 @@ EOF
     swow_coroutine.c \
     swow_channel.c \
     swow_sync.c \
+    swow_pool.c \
     swow_event.c \
     swow_time.c \
     swow_buffer.c \
@@ -394,6 +395,7 @@ EOF
     swow_http.c \
     swow_websocket.c \
     swow_proc_open.c \
+    swow_thread.c \
     , SWOW_INCLUDES, SWOW_CFLAGS)
   dnl if we do in-tree build, zend_language_scanner_defs.h may be not exist, add dependencies
   if test x"${PHP_PECL_EXTENSION}" = x"swow"; then
@@ -474,6 +476,7 @@ EOF
       cat_coroutine.c \
       cat_channel.c \
       cat_sync.c \
+      cat_pool.c \
       cat_event.c \
       cat_poll.c \
       cat_time.c \
@@ -489,6 +492,26 @@ EOF
       cat_http.c \
       cat_websocket.c, SWOW_CAT_INCLUDES, SWOW_CAT_CFLAGS)
 
+    dnl check if we can use io_uring for fs (kernel support is checked at runtime)
+    AS_CASE([$host_os],
+      [linux*], [
+        AC_MSG_CHECKING([for io_uring])
+        AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+            #include <linux/io_uring.h>
+            #include <sys/syscall.h>
+        ]], [[
+            int op = IORING_OP_STATX + IORING_REGISTER_PROBE + IORING_FEAT_RW_CUR_POS;
+            long nr = __NR_io_uring_setup + __NR_io_uring_enter + __NR_io_uring_register;
+            (void) op; (void) nr;
+        ]])],[
+            AC_DEFINE([CAT_HAVE_IO_URING], 1, [Have io_uring])
+            AC_MSG_RESULT([yes])
+        ],[
+            AC_MSG_RESULT([no])
+        ])
+      ]
+    )
+
     dnl prepare cat used context
 
     if test "${PHP_SWOW_THREAD_CONTEXT}" = "yes"; then
@@ -963,8 +963,16 @@ void uv__io_stop(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
       loop->nfds--;
     }
   }
-  else if (QUEUE_EMPTY(&w->watcher_queue))
+  else if (QUEUE_EMPTY(&w->watcher_queue)) {
+#if !defined(__sun)
+    /* Short-circuit if the event mask is unchanged, e.g. stopping POLLOUT
+     * that was never started (uv__drain() after each synchronous write).
+     */
+    if (w->events == w->pevents)
+      return;
+#endif
     QUEUE_INSERT_TAIL(&loop->watcher_queue, &w->watcher_queue);
+  }
 }
 
 
@@ -26,6 +26,7 @@ extern "C" {
 #include "cat_coroutine.h"
 #include "cat_channel.h"
 #include "cat_sync.h"
+#include "cat_pool.h"
 #include "cat_event.h"
 #include "cat_poll.h"
 #include "cat_time.h"
@@ -50,6 +50,41 @@ CAT_API cat_bool_t cat_async_cleanup(cat_async_t *async, cat_async_cleanup_callb
 /* async handle will be closed immediately, clean up callback will be called at the same time  */
 CAT_API cat_bool_t cat_async_close(cat_async_t *async, cat_async_cleanup_callback cleanup);
 
+/* async queue: thread-safe message queue for cross-runtime (cross-thread) messaging,
+ * every receiver waits on an async handle of its own event loop,
+ * so coroutines of any runtime can wait on it without blocking their event loops.
+ * queue and messages are allocated by the system allocator,
+ * they can be freed in any thread */
+
+typedef struct cat_async_message_s {
+    cat_queue_node_t node;
+    size_t length;
+    char data[1];
+} cat_async_message_t;
+
+typedef struct cat_async_queue_s {
+    uv_mutex_t mutex;
+    cat_queue_t messages;
+    cat_queue_t waiters;
+    size_t count;
+    size_t refcount;
+    cat_bool_t closed;
+} cat_async_queue_t;
+
+/* refcount is 1 after creation */
+CAT_API cat_async_queue_t *cat_async_queue_create(void);
+CAT_API cat_async_queue_t *cat_async_queue_addref(cat_async_queue_t *queue);
+/* free it if refcount reaches zero, unconsumed messages are dropped */
+CAT_API void cat_async_queue_release(cat_async_queue_t *queue);
+CAT_API cat_bool_t cat_async_queue_push(cat_async_queue_t *queue, const char *data, size_t length);
+/* returned message must be freed by cat_async_message_free() */
+CAT_API cat_async_message_t *cat_async_queue_pop(cat_async_queue_t *queue, cat_timeout_t timeout);
+CAT_API void cat_async_message_free(cat_async_message_t *message);
+/* waiters are woken up, pop() fails with ECLOSED once the queue is drained */
+CAT_API void cat_async_queue_close(cat_async_queue_t *queue);
+CAT_API cat_bool_t cat_async_queue_is_closed(cat_async_queue_t *queue);
+CAT_API size_t cat_async_queue_count(cat_async_queue_t *queue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,8 @@ CAT_API cat_bool_t cat_buffer_create(cat_buffer_t *buffer, size_t size);
 CAT_API cat_bool_t cat_buffer_realloc(cat_buffer_t *buffer, size_t new_size);
 CAT_API cat_bool_t cat_buffer_extend(cat_buffer_t *buffer, size_t recommend_size);
 CAT_API cat_bool_t cat_buffer_prepare(cat_buffer_t *buffer, size_t append_length);
+/* data has been written into the space after length directly (e.g. received from socket) */
+CAT_API void cat_buffer_commit(cat_buffer_t *buffer, size_t append_length);
 CAT_API cat_bool_t cat_buffer_malloc_trim(cat_buffer_t *buffer);
 CAT_API cat_bool_t cat_buffer_write(cat_buffer_t *buffer, size_t offset, const void *ptr, size_t length);
 CAT_API cat_bool_t cat_buffer_append(cat_buffer_t *buffer, const void *ptr, size_t length);
@@ -44,12 +44,6 @@ typedef uint8_t cat_channel_data_size_t;
 
 typedef void (*cat_channel_data_dtor_t)(const cat_data_t *data);
 
-/* Note: this should be public, it's used by channel_get_storage() */
-typedef struct cat_channel_bucket_s {
-    cat_queue_node_t node;
-    char data[1];
-} cat_channel_bucket_t;
-
 typedef struct cat_channel_s {
     cat_channel_flags_t flags;
     cat_channel_data_size_t data_size;
@@ -70,7 +64,11 @@ typedef struct cat_channel_s {
             } able;
         } unbuffered;
         struct {
-            cat_queue_t storage;
+            /* power-of-two ring of data_size slots,
+             * it is allocated at the first push and grows up to the capacity */
+            char *storage;
+            cat_channel_size_t mask;
+            cat_channel_size_t head;
         } buffered;
     } u;
 } cat_channel_t;
@@ -82,6 +80,14 @@ CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_si
 CAT_API cat_bool_t cat_channel_push(cat_channel_t *channel, const cat_data_t *data, cat_timeout_t timeout);
 CAT_API cat_bool_t cat_channel_pop(cat_channel_t *channel, cat_data_t *data, cat_timeout_t timeout);
 
+/* batch operations, data points to an array of count elements,
+ * waiters on the other side are woken up once per batch instead of once per element.
+ * push_many() waits until all elements have been pushed,
+ * pop_many() waits until at least one element is available and takes as many as it can,
+ * they return the number of elements transferred, which is less than count on failure */
+CAT_API cat_channel_size_t cat_channel_push_many(cat_channel_t *channel, const cat_data_t *data, cat_channel_size_t count, cat_timeout_t timeout);
+CAT_API cat_channel_size_t cat_channel_pop_many(cat_channel_t *channel, cat_data_t *data, cat_channel_size_t count, cat_timeout_t timeout);
+
 /* close channel without clean storage */
 CAT_API cat_bool_t cat_channel_close(cat_channel_t *channel);
 /* close channel if channel is not closed and clean storage */
@@ -131,7 +137,8 @@ CAT_API cat_channel_data_dtor_t cat_channel_set_dtor(cat_channel_t *channel, cat
 
 /* ext */
 
-CAT_API cat_queue_t *cat_channel_get_storage(cat_channel_t *channel); CAT_INTERNAL
+/* get the buffered element at index (0 is the oldest one), it returns NULL if out of range */
+CAT_API cat_data_t *cat_channel_get_buffered_data(cat_channel_t *channel, cat_channel_size_t index); CAT_INTERNAL
 
 #ifdef __cplusplus
 }
@@ -164,6 +164,49 @@ typedef void (*cat_coroutine_deadlock_callback_t)(void);
 
 typedef cat_msec_t (*cat_coroutine_msec_time_function_t)(void);
 
+/* stack pool: stacks of dead coroutines are cached by size class and reused,
+ * idle stacks over the high-water mark are released lazily by madvise()
+ * (they keep their mappings and guard pages, only the pages are dropped) */
+
+#ifndef CAT_COROUTINE_STACK_POOL_CLASS_COUNT
+#define CAT_COROUTINE_STACK_POOL_CLASS_COUNT 4
+#endif
+#define CAT_COROUTINE_STACK_POOL_DEFAULT_MAX_COUNT       128
+#define CAT_COROUTINE_STACK_POOL_DEFAULT_HIGH_WATER_MARK (16 * 1024 * 1024)
+
+typedef struct cat_coroutine_stack_pool_class_s {
+    /* virtual memory size of stacks in this class (0 means unused) */
+    size_t size;
+    size_t count;
+    /* stacks[0, trimmed) have been released by madvise() */
+    size_t trimmed;
+    size_t capacity;
+    void **stacks;
+} cat_coroutine_stack_pool_class_t;
+
+typedef struct cat_coroutine_stack_pool_s {
+    /* options */
+    size_t max_count;
+    size_t high_water_mark;
+    /* info */
+    size_t count;
+    size_t resident_bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t trims;
+    cat_coroutine_stack_pool_class_t classes[CAT_COROUTINE_STACK_POOL_CLASS_COUNT];
+} cat_coroutine_stack_pool_t;
+
+typedef struct cat_coroutine_stack_pool_stats_s {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t trims;
+    size_t count;
+    size_t bytes;
+    /* upper bound, pages of cached stacks which have not been trimmed */
+    size_t resident_bytes;
+} cat_coroutine_stack_pool_stats_t;
+
 CAT_GLOBALS_STRUCT_BEGIN(cat_coroutine) {
     /* options */
     cat_coroutine_stack_size_t default_stack_size;
@@ -187,6 +230,8 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_coroutine) {
     cat_coroutine_count_t peak_count;
     /* global switches (for watchdog) */
     cat_coroutine_switches_t switches;
+    /* stacks */
+    cat_coroutine_stack_pool_t stack_pool;
 } CAT_GLOBALS_STRUCT_END(cat_coroutine);
 
 extern CAT_API CAT_GLOBALS_DECLARE(cat_coroutine);
@@ -215,6 +260,9 @@ CAT_API cat_log_type_t cat_coroutine_set_deadlock_log_type(cat_log_type_t type);
 CAT_API cat_coroutine_deadlock_callback_t cat_coroutine_set_deadlock_callback(cat_coroutine_deadlock_callback_t callback);
 /* function will be used for coroutine_get_start_time()/coroutine_get_end_time() (non-thread-safe) */
 CAT_API cat_coroutine_msec_time_function_t cat_coroutine_set_msec_time_function(cat_coroutine_msec_time_function_t callback);
+/* return the original value, cached stacks over the new limits are released immediately */
+CAT_API size_t cat_coroutine_set_stack_pool_max_count(size_t count);
+CAT_API size_t cat_coroutine_set_stack_pool_high_water_mark(size_t size);
 
 /* globals */
 CAT_API cat_coroutine_stack_size_t cat_coroutine_get_default_stack_size(void);
@@ -228,6 +276,9 @@ CAT_API cat_coroutine_count_t cat_coroutine_get_count(void);
 CAT_API cat_coroutine_count_t cat_coroutine_get_real_count(void);
 CAT_API cat_coroutine_count_t cat_coroutine_get_peak_count(void);
 CAT_API cat_coroutine_switches_t cat_coroutine_get_global_switches(void);
+CAT_API size_t cat_coroutine_get_stack_pool_max_count(void);
+CAT_API size_t cat_coroutine_get_stack_pool_high_water_mark(void);
+CAT_API cat_coroutine_stack_pool_stats_t *cat_coroutine_get_stack_pool_stats(cat_coroutine_stack_pool_stats_t *stats);
 
 /* ctor and dtor */
 CAT_API cat_coroutine_t *cat_coroutine_create(cat_coroutine_t *coroutine, cat_coroutine_function_t function);
@@ -248,6 +299,8 @@ CAT_API cat_coroutine_t *cat_coroutine_get_from(const cat_coroutine_t *coroutine
 CAT_API cat_coroutine_t *cat_coroutine_get_previous(const cat_coroutine_t *coroutine);
 CAT_API cat_coroutine_t *cat_coroutine_get_next(const cat_coroutine_t *coroutine);
 CAT_API cat_coroutine_stack_size_t cat_coroutine_get_stack_size(const cat_coroutine_t *coroutine);
+/* stacks are reserved lazily, only touched pages are resident */
+CAT_API size_t cat_coroutine_get_stack_resident_size(const cat_coroutine_t *coroutine);
 
 /* status */
 CAT_API cat_bool_t cat_coroutine_is_available(const cat_coroutine_t *coroutine);
@@ -23,16 +23,56 @@ extern "C" {
 #endif
 
 #include "cat.h"
-#include "cat_socket.h"
+#include "cat_queue.h"
+
+#include "uv/tree.h"
 
 /* Notice: this module is a part of Socket */
 
-/*
-typedef struct cat_dns_cache_s {
+#define CAT_DNS_CACHE_DEFAULT_CAPACITY     1024
+#define CAT_DNS_CACHE_DEFAULT_TTL          (30 * 1000)
+#define CAT_DNS_CACHE_DEFAULT_NEGATIVE_TTL (5 * 1000)
+
+RB_HEAD(cat_dns_cache_tree_s, cat_dns_cache_entry_s);
 
+/* results of getaddrinfo() are cached by (hostname, service, hints),
+ * the system resolver provides no TTL, so fixed TTLs are used,
+ * failures of "no such name" kind are cached with the negative TTL,
+ * concurrent lookups of the same key share one getaddrinfo() request */
+typedef struct cat_dns_cache_s {
+    struct cat_dns_cache_tree_s tree;
+    /* most recently used entries are at the front */
+    cat_queue_t lru;
+    size_t size;
+    size_t capacity;
+    cat_msec_t ttl;
+    cat_msec_t negative_ttl;
+    /* counters */
+    uint64_t hits;
+    uint64_t negative_hits;
+    uint64_t misses;
+    uint64_t coalesced;
+    uint64_t evictions;
 } cat_dns_cache_t;
-*/
 
+typedef struct cat_dns_cache_stats_s {
+    size_t size;
+    size_t capacity;
+    uint64_t hits;
+    uint64_t negative_hits;
+    uint64_t misses;
+    uint64_t coalesced;
+    uint64_t evictions;
+} cat_dns_cache_stats_t;
+
+/* Socket globals hold the cache, so it must be included after the types above */
+#include "cat_socket.h"
+
+/* runtime (called by Socket runtime) */
+CAT_API cat_bool_t cat_dns_runtime_init(void);
+CAT_API cat_bool_t cat_dns_runtime_shutdown(void);
+
+/* Notice: responses must be released by cat_dns_freeaddrinfo() */
 CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *service, const struct addrinfo *hints);
 CAT_API struct addrinfo *cat_dns_getaddrinfo_ex(const char *hostname, const char *service, const struct addrinfo *hints, cat_timeout_t timeout);
 CAT_API void cat_dns_freeaddrinfo(struct addrinfo *response);
@@ -40,6 +80,17 @@ CAT_API void cat_dns_freeaddrinfo(struct addrinfo *response);
 CAT_API cat_bool_t cat_dns_get_ip(char *buffer, size_t buffer_size, const char *name, int af);
 CAT_API cat_bool_t cat_dns_get_ip_ex(char *buffer, size_t buffer_size, const char *name, int af, cat_timeout_t timeout);
 
+/* capacity 0 disables the cache */
+CAT_API size_t cat_dns_cache_get_capacity(void);
+CAT_API void cat_dns_cache_set_capacity(size_t capacity);
+/* TTL 0 means that the kind of results will not be cached */
+CAT_API cat_msec_t cat_dns_cache_get_ttl(void);
+CAT_API void cat_dns_cache_set_ttl(cat_msec_t ttl);
+CAT_API cat_msec_t cat_dns_cache_get_negative_ttl(void);
+CAT_API void cat_dns_cache_set_negative_ttl(cat_msec_t ttl);
+CAT_API cat_dns_cache_stats_t *cat_dns_cache_get_stats(cat_dns_cache_stats_t *stats);
+CAT_API void cat_dns_cache_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
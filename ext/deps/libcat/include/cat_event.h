@@ -44,12 +44,25 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_event) {
     cat_queue_t runtime_shutdown_tasks;
     cat_queue_t io_defer_tasks;
     uv_check_t io_defer_check;
+    cat_slab_t slab;
 } CAT_GLOBALS_STRUCT_END(cat_event);
 
 extern CAT_API CAT_GLOBALS_DECLARE(cat_event);
 
 #define CAT_EVENT_G(x) CAT_GLOBALS_GET(cat_event, x)
 
+/* small objects of hot paths which live no longer than the event loop
+ * (e.g. timers, requests, tasks) are allocated from the slab of it */
+static cat_always_inline void *cat_event_slab_malloc(size_t size)
+{
+    return cat_slab_malloc(&CAT_EVENT_G(slab), size);
+}
+
+static cat_always_inline void cat_event_slab_free(void *ptr, size_t size)
+{
+    cat_slab_free(&CAT_EVENT_G(slab), ptr, size);
+}
+
 CAT_API cat_bool_t cat_event_module_init(void);
 CAT_API cat_bool_t cat_event_module_shutdown(void);
 CAT_API cat_bool_t cat_event_runtime_init(void);
@@ -88,6 +101,8 @@ CAT_API cat_event_io_defer_task_t *cat_event_io_defer_task_create(
  * if task callback has been called, it will return true, otherwise false. */
 CAT_API cat_bool_t cat_event_io_defer_task_close(cat_event_io_defer_task_t *task);
 
+CAT_API cat_slab_stats_t *cat_event_get_slab_stats(cat_slab_stats_t *stats);
+
 CAT_API void cat_event_fork(void);
 
 CAT_API void cat_event_print_all_handles(cat_os_fd_t output);
@@ -33,6 +33,28 @@ typedef uv_file cat_file_t;
 #define CAT_FS_FILE_FMT_SPEC "d"
 #define CAT_FS_INVALID_FILE -1
 
+#if defined(CAT_OS_LINUX) && defined(CAT_HAVE_IO_URING)
+# define CAT_FS_IO_URING 1
+#endif
+
+/* file operations are done by io_uring if the kernel supports it (it can be disabled by CAT_FS_IO_URING=0),
+ * otherwise (or if the ring is busy) they are done by the thread pool */
+typedef enum cat_fs_engine_e {
+    CAT_FS_ENGINE_THREAD_POOL,
+    CAT_FS_ENGINE_IO_URING,
+} cat_fs_engine_t;
+
+CAT_API cat_bool_t cat_fs_module_init(void);
+CAT_API cat_bool_t cat_fs_module_shutdown(void);
+CAT_API cat_bool_t cat_fs_runtime_init(void);
+CAT_API cat_bool_t cat_fs_runtime_shutdown(void);
+
+CAT_API void cat_fs_fork(void);
+
+/* the kernel is probed on the first file operation (or the first call of them) */
+CAT_API cat_fs_engine_t cat_fs_get_engine(void);
+CAT_API const char *cat_fs_get_engine_name(void);
+
 #define CAT_FS_OPEN_FLAG_MAP(XX) \
     XX(APPEND) \
     XX(CREAT) \
@@ -207,7 +229,10 @@ CAT_API int cat_fs_sendfile(cat_file_t out_fd, cat_file_t in_fd, int64_t in_offs
 * @note: you must use the return str before next event loop
 */
 CAT_API const char *cat_fs_mkdtemp(const char *tpl);
-CAT_API cat_file_t cat_fs_mkstemp(const char *tpl);
+/*
+* fs_mkstemp - like mkstemp(3), the trailing XXXXXX of tpl are replaced with the name of the created file
+*/
+CAT_API cat_file_t cat_fs_mkstemp(char *tpl);
 CAT_API int cat_fs_statfs(const char *path, cat_statfs_t *buf);
 
 #define CAT_FS_FLOCK_FLAG_MAP(XX) \
@@ -38,6 +38,8 @@ typedef enum cat_log_union_types_e {
     CAT_LOG_TYPES_UNFILTERABLE    = CAT_LOG_TYPE_ERROR | CAT_LOG_TYPE_CORE_ERROR,
 } cat_log_union_types_t;
 
+typedef struct cat_log_async_s cat_log_async_t;
+
 typedef struct cat_log_globals_s {
     cat_log_types_t types;
     FILE *error_output;
@@ -54,6 +56,7 @@ typedef struct cat_log_globals_s {
 #ifdef CAT_SOURCE_POSITION
     cat_bool_t show_source_postion;
 #endif
+    cat_log_async_t *async;
 } cat_log_globals_t;
 
 #define CAT_LOG_STRING_OR_X_PARAM(string, x) \
@@ -235,6 +238,49 @@ extern CAT_API cat_log_t cat_log_function CAT_LOG_ATTRIBUTES;
 
 CAT_API cat_bool_t cat_log_fwrite(FILE *file, const char *str, size_t length);
 
+/* async log: records are still formatted by the caller, but they are put into a ring buffer
+ * and written in batches by a background thread, so the caller never waits for the output.
+ * records of ERROR/CORE_ERROR and records which are larger than half of the ring buffer
+ * are written synchronously after all pending records have been written. */
+
+#define CAT_LOG_ASYNC_DEFAULT_BUFFER_SIZE (1024 * 1024)
+
+typedef enum cat_log_async_backpressure_e {
+    /* drop new records if there is no space */
+    CAT_LOG_ASYNC_BACKPRESSURE_DROP,
+    /* wait for the background thread to make space */
+    CAT_LOG_ASYNC_BACKPRESSURE_BLOCK,
+    /* only keep one of every sample_rate records if the ring buffer is over 3/4 full, drop if full */
+    CAT_LOG_ASYNC_BACKPRESSURE_SAMPLE,
+} cat_log_async_backpressure_t;
+
+typedef struct cat_log_async_stats_s {
+    uint64_t records;
+    uint64_t bytes;
+    /* writes done by the background thread */
+    uint64_t batches;
+    uint64_t dropped;
+    uint64_t sampled_out;
+    /* times the caller waited for space (BLOCK) */
+    uint64_t blocked;
+    /* records which were written synchronously */
+    uint64_t direct;
+    uint64_t write_errors;
+    size_t buffer_size;
+    size_t pending_bytes;
+} cat_log_async_stats_t;
+
+/* buffer_size will be aligned to power of 2 */
+CAT_API cat_bool_t cat_log_async_enable(size_t buffer_size, cat_log_async_backpressure_t backpressure, unsigned int sample_rate);
+/* pending records will be written before it returns */
+CAT_API void cat_log_async_disable(void);
+CAT_API cat_bool_t cat_log_async_is_enabled(void);
+/* wait until all pending records have been written */
+CAT_API void cat_log_async_flush(void);
+/* pending records belong to the parent process, the background thread is restarted in the child */
+CAT_API void cat_log_async_fork(void);
+CAT_API cat_bool_t cat_log_async_get_stats(cat_log_async_stats_t *stats);
+
 CAT_API void cat_log_va_list_standard(CAT_LOG_VA_LIST_PARAMETERS);
 CAT_API void cat_log_standard(CAT_LOG_PARAMETERS);
 
@@ -21,3 +21,18 @@
 #define CAT_MIN(value1, value2)  (((value1) > (value2)) ? (value2) : (value1))
 #define CAT_BETWEEN(value, min, max) \
         (unlikely((value) > (max)) ? (max) : (unlikely((value) < (min)) ? (min) : (value)))
+
+/* count trailing zeros, value must not be 0 */
+static cat_always_inline unsigned int cat_ctz64(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_ctzll(value);
+#else
+    unsigned int n = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
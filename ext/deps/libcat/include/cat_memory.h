@@ -221,6 +221,100 @@ CAT_API void *cat_realloc_function(void *ptr, size_t size);
 CAT_API void cat_free_function(void *ptr);
 CAT_API void cat_freep_function(void *ptr); /* free(ptr->ptr) */
 
+/* slab allocator: small objects are carved from pages of their size class
+ * and recycled through per-class free lists, so they cost no allocator calls
+ * once the slab is warm. It is not thread-safe (each event loop owns one),
+ * objects must be released with the same size they were allocated with,
+ * and pages are only returned to the allocator when the slab is destroyed */
+
+#define CAT_SLAB_ALIGNMENT   16
+#define CAT_SLAB_MAX_SIZE    512
+#define CAT_SLAB_CLASS_COUNT (CAT_SLAB_MAX_SIZE / CAT_SLAB_ALIGNMENT)
+#ifndef CAT_SLAB_PAGE_SIZE
+#define CAT_SLAB_PAGE_SIZE   (16 * 1024)
+#endif
+
+typedef struct cat_slab_object_s cat_slab_object_t;
+typedef struct cat_slab_page_s cat_slab_page_t;
+
+struct cat_slab_object_s {
+    cat_slab_object_t *next;
+};
+
+typedef struct cat_slab_class_s {
+    cat_slab_object_t *free_list;
+    size_t count;
+    size_t free_count;
+    size_t page_count;
+} cat_slab_class_t;
+
+typedef struct cat_slab_s {
+    cat_slab_class_t classes[CAT_SLAB_CLASS_COUNT];
+    cat_slab_page_t *pages;
+    size_t page_count;
+    /* objects that are too large for slabs are passed to cat_malloc() */
+    size_t large_count;
+} cat_slab_t;
+
+typedef struct cat_slab_class_stats_s {
+    size_t size;
+    size_t count;
+    size_t free_count;
+    size_t page_count;
+} cat_slab_class_stats_t;
+
+typedef struct cat_slab_stats_s {
+    size_t page_count;
+    size_t page_bytes;
+    size_t used_bytes;
+    size_t large_count;
+    cat_slab_class_stats_t classes[CAT_SLAB_CLASS_COUNT];
+} cat_slab_stats_t;
+
+CAT_API void cat_slab_init(cat_slab_t *slab);
+CAT_API void cat_slab_destroy(cat_slab_t *slab);
+CAT_API cat_slab_stats_t *cat_slab_get_stats(const cat_slab_t *slab, cat_slab_stats_t *stats);
+/* slow path of cat_slab_malloc(), do not call it directly */
+CAT_API void *cat_slab_malloc_slow(cat_slab_t *slab, size_t size);
+
+static cat_always_inline void *cat_slab_malloc(cat_slab_t *slab, size_t size)
+{
+#ifndef CAT_HAVE_ASAN /* let ASan see every object */
+    /* size 0 wraps around and goes to the large path */
+    if (likely(size - 1 < CAT_SLAB_MAX_SIZE)) {
+        cat_slab_class_t *slab_class = &slab->classes[(size - 1) / CAT_SLAB_ALIGNMENT];
+        cat_slab_object_t *object = slab_class->free_list;
+        if (unlikely(object == NULL)) {
+            return cat_slab_malloc_slow(slab, size);
+        }
+        slab_class->free_list = object->next;
+        slab_class->free_count--;
+        slab_class->count++;
+        return object;
+    }
+#endif
+    slab->large_count++;
+    return cat_malloc(size);
+}
+
+static cat_always_inline void cat_slab_free(cat_slab_t *slab, void *ptr, size_t size)
+{
+#ifndef CAT_HAVE_ASAN
+    if (likely(size - 1 < CAT_SLAB_MAX_SIZE)) {
+        cat_slab_class_t *slab_class = &slab->classes[(size - 1) / CAT_SLAB_ALIGNMENT];
+        cat_slab_object_t *object = (cat_slab_object_t *) ptr;
+        /* LIFO for cache warmth */
+        object->next = slab_class->free_list;
+        slab_class->free_list = object;
+        slab_class->free_count++;
+        slab_class->count--;
+        return;
+    }
+#endif
+    slab->large_count--;
+    cat_free(ptr);
+}
+
 extern CAT_API size_t cat_pagesize;
 
 CAT_API size_t cat_getpagesize_slow(void);
@@ -59,6 +59,39 @@ typedef SHORT cat_pollfd_events_t;
     XX(HUP) \
     XX(NVAL) \
 
+#ifdef CAT_OS_LINUX
+# define CAT_POLL_REGISTRY 1
+#endif
+
+/* fds which are not managed by the event loop (e.g. fds of 3rd-party libraries) are
+ * registered to a per-runtime epoll instance on Linux (it can be disabled by CAT_POLL_REGISTRY=0),
+ * registrations are kept across waits, so waiting on the same fd again only changes its interest mask,
+ * otherwise (or if the fd can not be registered) a poll handle is created and closed for every wait,
+ * regular files are remembered and reported at once without trying to register them again */
+typedef struct cat_poll_registry_stats_s {
+    /* EPOLL_CTL_ADD/MOD/DEL calls */
+    uint64_t adds;
+    uint64_t mods;
+    uint64_t dels;
+    /* waits which were done by one-shot poll handles */
+    uint64_t fallbacks;
+    /* fds which are registered now */
+    size_t count;
+} cat_poll_registry_stats_t;
+
+CAT_API cat_bool_t cat_poll_module_init(void);
+CAT_API cat_bool_t cat_poll_module_shutdown(void);
+CAT_API cat_bool_t cat_poll_runtime_init(void);
+CAT_API cat_bool_t cat_poll_runtime_shutdown(void);
+
+CAT_API void cat_poll_fork(void);
+
+/* it must be called before the fd which may have been polled is closed,
+ * otherwise the registration leaks until the fd number is reused */
+CAT_API void cat_poll_unregister(cat_os_socket_t fd);
+
+CAT_API void cat_poll_get_registry_stats(cat_poll_registry_stats_t *stats);
+
 /** OK: events triggered, NONE: timedout, ERROR: error ocurred.
  * @note: it does not always return ERROR when it was cancelled,
  * because poll() operation may be partially done. */
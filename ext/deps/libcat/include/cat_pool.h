@@ -0,0 +1,132 @@
+/*
+  +--------------------------------------------------------------------------+
+  | libcat                                                                   |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef CAT_POOL_H
+#define CAT_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cat.h"
+#include "cat_coroutine.h"
+#include "cat_queue.h"
+
+typedef struct cat_pool_s cat_pool_t;
+
+/* create() may switch coroutines (e.g. connect), it returns NULL and updates the last error on failure,
+ * destroy() may be called by the idle evictor in the event loop, it must not switch coroutines,
+ * check() tells whether an idle item is still usable before it is handed out (e.g. cat_socket_check_liveness()) */
+typedef cat_data_t *(*cat_pool_create_function_t)(cat_pool_t *pool);
+typedef void (*cat_pool_destroy_function_t)(cat_pool_t *pool, cat_data_t *item);
+typedef cat_bool_t (*cat_pool_check_function_t)(cat_pool_t *pool, cat_data_t *item);
+
+typedef enum cat_pool_flag_e {
+    CAT_POOL_FLAG_NONE   = 0,
+    CAT_POOL_FLAG_CLOSED = 1 << 0,
+} cat_pool_flag_t;
+
+typedef uint8_t cat_pool_flags_t;
+
+typedef struct cat_pool_options_s {
+    /* the evictor never shrinks the pool below it */
+    uint32_t min_size;
+    /* getters wait when this number of items are alive */
+    uint32_t max_size;
+    /* idle items are evicted after this (in msec), 0 or negative means never */
+    cat_timeout_t idle_timeout;
+} cat_pool_options_t;
+
+/* times are in nanoseconds */
+typedef struct cat_pool_stats_s {
+    uint64_t get_count;
+    uint64_t put_count;
+    uint64_t wait_count;
+    uint64_t timeout_count;
+    uint64_t total_wait_time;
+    uint64_t max_wait_time;
+    uint64_t create_count;
+    uint64_t create_failure_count;
+    uint64_t total_create_time;
+    uint64_t max_create_time;
+    uint64_t destroy_count;
+    uint64_t check_failure_count;
+    uint64_t eviction_count;
+} cat_pool_stats_t;
+
+typedef struct cat_pool_idle_item_s {
+    cat_data_t *data;
+    cat_msec_t last_used;
+} cat_pool_idle_item_t;
+
+struct cat_pool_s {
+    cat_pool_flags_t flags;
+    /* alive items, including the ones in use and the ones being created */
+    uint32_t size;
+    /* ring of max_size slots, the most recently used one is reused first
+     * and the least recently used one is evicted first */
+    cat_pool_idle_item_t *idle;
+    uint32_t idle_head;
+    uint32_t idle_count;
+    cat_queue_t waiters;
+    uv_timer_t *evictor;
+    cat_pool_create_function_t create;
+    cat_pool_destroy_function_t destroy;
+    cat_pool_check_function_t check;
+    cat_pool_options_t options;
+    cat_pool_stats_t stats;
+    cat_data_t *data;
+};
+
+CAT_API void cat_pool_options_init(cat_pool_options_t *options);
+
+CAT_API cat_pool_t *cat_pool_create(
+    cat_pool_t *pool, const cat_pool_options_t *options,
+    cat_pool_create_function_t create, cat_pool_destroy_function_t destroy, cat_pool_check_function_t check,
+    cat_data_t *data
+);
+/* destroy idle items and wake up waiters, items in use are destroyed when they are put back,
+ * memory of pool can be released after all of its getters have returned */
+CAT_API cat_bool_t cat_pool_close(cat_pool_t *pool);
+
+/* get() neither allocates nor switches if there is an idle item,
+ * otherwise it creates a new one if it is not full, or waits for one in FIFO order */
+CAT_API cat_data_t *cat_pool_get(cat_pool_t *pool, cat_timeout_t timeout);
+/* broken items are destroyed instead of being reused */
+CAT_API cat_bool_t cat_pool_put(cat_pool_t *pool, cat_data_t *item, cat_bool_t broken);
+/* create items until there are min_size ones, it returns the number of created ones */
+CAT_API uint32_t cat_pool_fill(cat_pool_t *pool);
+/* destroy idle items which have been idle for longer than idle_timeout,
+ * it is called by the evictor periodically, it returns the number of evicted ones */
+CAT_API uint32_t cat_pool_evict(cat_pool_t *pool);
+
+/* status */
+
+CAT_API uint32_t cat_pool_get_size(const cat_pool_t *pool);
+CAT_API uint32_t cat_pool_get_idle_count(const cat_pool_t *pool);
+CAT_API cat_bool_t cat_pool_has_waiters(const cat_pool_t *pool);
+CAT_API cat_bool_t cat_pool_is_available(const cat_pool_t *pool);
+CAT_API const cat_pool_stats_t *cat_pool_get_stats(const cat_pool_t *pool);
+CAT_API cat_data_t *cat_pool_get_data(const cat_pool_t *pool);
+
+/* get the idle item at index (0 is the least recently used one), it returns NULL if out of range */
+CAT_API cat_data_t *cat_pool_get_idle_item(const cat_pool_t *pool, uint32_t index); CAT_INTERNAL
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAT_POOL_H */
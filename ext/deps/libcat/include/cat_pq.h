@@ -35,6 +35,8 @@ CAT_API cat_bool_t cat_pq_runtime_init(void);
 CAT_API cat_bool_t cat_pq_runtime_close(void);
 
 CAT_API PGconn *cat_pq_connectdb(const char *conninfo);
+/* same as PQfinish(), but it also drops the poll registration of the connection */
+CAT_API void cat_pq_finish(PGconn *conn);
 CAT_API PGresult *cat_pq_prepare(PGconn *conn, const char *stmt_name, const char *query, int n_params, const Oid *param_types);
 CAT_API PGresult *cat_pq_exec_prepared(PGconn *conn, const char *stmt_name, int n_params, 
     const char *const *param_values, const int *param_lengths, const int *param_formats, int result_format);
@@ -42,6 +44,16 @@ CAT_API PGresult *cat_pq_exec(PGconn *conn, const char *query);
 CAT_API PGresult *cat_pq_exec_params(PGconn *conn, const char *command, int n_params,
     const Oid *param_types, const char *const *param_values, const int *param_lengths, const int *param_formats, int result_format);
 
+/* wait until PQgetResult() would not block */
+CAT_API cat_bool_t cat_pq_wait_result(PGconn *conn);
+
+#ifdef LIBPQ_HAS_PIPELINING
+#define CAT_PQ_HAVE_PIPELINE 1
+/* in pipeline mode, queries are queued by PQsend*() without waiting,
+ * then we mark a sync point and read results in order with cat_pq_wait_result() + PQgetResult() */
+CAT_API cat_bool_t cat_pq_pipeline_sync(PGconn *conn);
+#endif
+
 #endif /* CAT_HAVE_PQ */
 
 #ifdef __cplusplus
@@ -27,6 +27,7 @@ extern "C" {
 #include "cat_coroutine.h"
 #include "cat_dns.h"
 #include "cat_ssl.h"
+#include "cat_buffer.h"
 
 #ifdef CAT_OS_UNIX_LIKE
 #include <sys/socket.h>
@@ -194,6 +195,37 @@ static cat_always_inline cat_socket_write_vector_t cat_socket_write_vector_init(
 
 CAT_API size_t cat_socket_write_vector_length(const cat_socket_write_vector_t *vector, unsigned int vector_count);
 
+/* socket datagram (for batched recvfrom/sendto) */
+
+typedef struct cat_socket_datagram_s {
+    /* recv: buffer of size bytes; send: length bytes of data */
+    char *buffer;
+    size_t size;
+    size_t length;
+    /* recv: peer address; send: destination (length 0 means the connected peer) */
+    cat_sockaddr_info_t address;
+    /* GSO (send) or GRO (recv) segment size, 0 means that datagram is not segmented */
+    size_t segment_size;
+} cat_socket_datagram_t;
+
+/* socket frame (for length-prefixed framing) */
+
+#define CAT_SOCKET_FRAME_HEADER_MAX_SIZE 64
+
+/* frame: [length_offset bytes][length field][body of length bytes],
+ * leading bytes before the length field are skipped on receiving and zero-filled on sending */
+typedef struct cat_socket_frame_format_s {
+    /* size of the length field, it must be 1, 2, 4 or 8 */
+    uint8_t length_size;
+    cat_bool_t little_endian;
+    size_t length_offset;
+    /* max body length of received frames, 0 means not limited */
+    size_t max_length;
+} cat_socket_frame_format_t;
+
+CAT_API cat_bool_t cat_socket_frame_format_init(cat_socket_frame_format_t *format, size_t length_size, cat_bool_t little_endian, size_t length_offset, size_t max_length);
+CAT_API size_t cat_socket_frame_format_get_header_size(const cat_socket_frame_format_t *format);
+
 /* socket */
 
 #ifdef CAT_OS_UNIX_LIKE
@@ -268,6 +300,9 @@ typedef enum cat_socket_type_e {
     XX(TCP_DELAY,     1 << 0)  /* (disable tcp_nodelay) */ \
     XX(TCP_KEEPALIVE, 1 << 1)  /* (enable keep-alive) */ \
     XX(UDP_BROADCAST, 1 << 2)  /* (enable broadcast) TODO: support it or remove */ \
+    XX(UDP_GRO,       1 << 3)  /* (enable generic receive offload) */ \
+    /* 9 ~ 16 (stream-extra) */ \
+    XX(READ_PERSISTENT, 1 << 8)  /* (keep read interest armed between reads) */ \
 
 typedef enum cat_socket_option_flag_e {
 #define CAT_SOCKET_OPTION_FLAG_GEN(name, value) CAT_ENUM_GEN(CAT_SOCKET_OPTION_FLAG_, name, value)
@@ -310,6 +345,8 @@ typedef uint32_t cat_socket_flags_t;
     /* socket may be a pipe file, which is created by pipe2()
      * and can only work with read()/write() */ \
     XX(NOT_SOCK,          1 << 3) \
+    /* read interest is kept armed across reads (persistent read mode) */ \
+    XX(READING,           1 << 4) \
     /* 20 ~ 23 (stream (tcp|pipe|tty)) */ \
     XX(SERVER,            1 << 20) \
     XX(SERVER_CONNECTION, 1 << 21) \
@@ -408,6 +445,22 @@ typedef struct uv_udg_s {
 typedef struct cat_socket_s cat_socket_t;
 typedef struct cat_socket_internal_s cat_socket_internal_t;
 
+#ifndef CAT_SOCKET_READ_AHEAD_BUFFER_SIZE
+#define CAT_SOCKET_READ_AHEAD_BUFFER_SIZE 8192
+#endif
+
+/* ring buffer for data which arrives while nobody is reading (persistent read mode),
+ * or data which was received but not consumed (recv_until) */
+typedef struct cat_socket_read_ahead_s {
+    size_t head;
+    size_t length;
+    /* pending EOF or error, it is reported after all buffered data is consumed */
+    ssize_t error;
+    /* it is CAT_SOCKET_READ_AHEAD_BUFFER_SIZE at least, may be grown by put back data */
+    size_t size;
+    char buffer[1];
+} cat_socket_read_ahead_t;
+
 typedef struct cat_socket_options_s {
     cat_socket_timeout_options_t timeout;
     unsigned int tcp_keepalive_delay;
@@ -440,6 +493,8 @@ struct cat_socket_internal_s
             cat_socket_write_context_t write;
         } io;
     } context;
+    /* lazy alloc in persistent read mode */
+    cat_socket_read_ahead_t *read_ahead;
     /* cache */
     struct {
         cat_socket_fd_t fd;
@@ -512,13 +567,14 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_socket) {
     struct {
         cat_socket_timeout_options_t timeout;
         unsigned int tcp_keepalive_delay;
+        cat_bool_t read_persistent;
     } options;
     /* In theory, all internal socket objects should be maintained in the tree,
      * but currently only the internal sockets that need to be used are stored
      * e.g., server sockets for poll module. */
     struct cat_socket_internal_tree_s internal_tree;
     /* dns */
-    // TODO: dns_cache (we should implement lru_cache)
+    cat_dns_cache_t dns_cache;
 } CAT_GLOBALS_STRUCT_END(cat_socket);
 
 extern CAT_API CAT_GLOBALS_DECLARE(cat_socket);
@@ -530,6 +586,7 @@ extern CAT_API CAT_GLOBALS_DECLARE(cat_socket);
 CAT_API cat_bool_t cat_socket_module_init(void);
 CAT_API cat_bool_t cat_socket_module_shutdown(void);
 CAT_API cat_bool_t cat_socket_runtime_init(void);
+CAT_API cat_bool_t cat_socket_runtime_shutdown(void);
 
 /* common methods */
 /* tip: functions of fast version will never change the last error */
@@ -591,6 +648,9 @@ CAT_API cat_bool_t cat_socket_bind_to_ex(cat_socket_t *socket, const char *name,
 CAT_API cat_bool_t cat_socket_listen(cat_socket_t *socket, int backlog);
 CAT_API cat_bool_t cat_socket_accept(cat_socket_t *server, cat_socket_t *client);
 CAT_API cat_bool_t cat_socket_accept_ex(cat_socket_t *server, cat_socket_t *client, cat_timeout_t timeout);
+/* accept a connection which is already pending in the backlog without waiting,
+ * it fails with CAT_EAGAIN if there is no one, so the backlog can be drained in one go */
+CAT_API cat_bool_t cat_socket_try_accept(cat_socket_t *server, cat_socket_t *client);
 
 CAT_API cat_bool_t cat_socket_connect(cat_socket_t *socket, const cat_sockaddr_t *address, cat_socklen_t address_length);
 CAT_API cat_bool_t cat_socket_connect_ex(cat_socket_t *socket, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout);
@@ -631,6 +691,9 @@ typedef struct cat_socket_crypto_options_s {
     cat_bool_t no_ticket;
     cat_bool_t no_compression;
     cat_bool_t no_client_ca_list;
+    cat_bool_t no_session_cache;
+    /* offload record encryption to the kernel after handshake if possible */
+    cat_bool_t ktls;
     void *context; /* context for crypto things */
 } cat_socket_crypto_options_t;
 
@@ -650,6 +713,20 @@ CAT_API const cat_sockaddr_info_t *cat_socket_getpeername_fast(cat_socket_t *soc
 /* recv: same as recv system call, it always returns as soon as possible */
 CAT_API ssize_t cat_socket_recv(cat_socket_t *socket, char *buffer, size_t size);
 CAT_API ssize_t cat_socket_recv_ex(cat_socket_t *socket, char *buffer, size_t size, cat_timeout_t timeout);
+/* receive a frame which ends with the delimiter, returns the frame length (including the delimiter),
+ * data after the delimiter is kept in the socket and served by the next read.
+ * if it fails (e.g. timedout, or delimiter was not found in size bytes (EMSGSIZE)), nothing is consumed. */
+CAT_API ssize_t cat_socket_recv_until(cat_socket_t *socket, char *buffer, size_t size, const char *delimiter, size_t delimiter_length);
+CAT_API ssize_t cat_socket_recv_until_ex(cat_socket_t *socket, char *buffer, size_t size, const char *delimiter, size_t delimiter_length, cat_timeout_t timeout);
+/* receive a length-prefixed frame, the body (without header) is appended to the buffer (it will be extended if needed),
+ * returns the body length, data after the frame is kept in the socket and served by the next read.
+ * if it fails (e.g. timedout, or body length is greater than max_length (EMSGSIZE)), nothing is consumed. */
+CAT_API ssize_t cat_socket_recv_frame(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer);
+CAT_API ssize_t cat_socket_recv_frame_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, cat_timeout_t timeout);
+/* same as recv_frame, but it takes all complete frames which have been received after the first one (at most count),
+ * bodies are appended to the buffer one by one, and body lengths are stored in lengths, returns the number of frames */
+CAT_API ssize_t cat_socket_recv_frames(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, size_t *lengths, size_t count);
+CAT_API ssize_t cat_socket_recv_frames_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, size_t *lengths, size_t count, cat_timeout_t timeout);
 /* send: it always sends all data as much as possible, unless interrupted by errors */
 CAT_API cat_bool_t cat_socket_send(cat_socket_t *socket, const char *buffer, size_t length);
 CAT_API cat_bool_t cat_socket_send_ex(cat_socket_t *socket, const char *buffer, size_t length, cat_timeout_t timeout);
@@ -660,6 +737,9 @@ CAT_API ssize_t cat_socket_read_ex(cat_socket_t *socket, char *buffer, size_t le
 /* write: it always writes all data as much as possible, unless interrupted by errors */
 CAT_API cat_bool_t cat_socket_write(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count);
 CAT_API cat_bool_t cat_socket_write_ex(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, cat_timeout_t timeout);
+/* write a length-prefixed frame, the header is sent together with the body vectors (no concatenation) */
+CAT_API cat_bool_t cat_socket_write_frame(cat_socket_t *socket, const cat_socket_frame_format_t *format, const cat_socket_write_vector_t *vector, unsigned int vector_count);
+CAT_API cat_bool_t cat_socket_write_frame_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, const cat_socket_write_vector_t *vector, unsigned int vector_count, cat_timeout_t timeout);
 
 /* Notice: [name rule] only native APIs use conjunctions, e.g. recvfrom/sendto/getsockname/getpeername...  */
 CAT_API ssize_t cat_socket_recvfrom(cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length);
@@ -687,6 +767,16 @@ CAT_API ssize_t cat_socket_try_write(cat_socket_t *socket, const cat_socket_writ
 CAT_API ssize_t cat_socket_try_writeto(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length);
 CAT_API ssize_t cat_socket_try_write_to(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const char *name, size_t name_length, int port);
 
+/* batched recvfrom/sendto: they use recvmmsg/sendmmsg if possible,
+ * recvfrom_many waits for the first datagram and then takes what is already queued,
+ * both return the number of datagrams transferred (it may be less than count on error, last error is set) */
+CAT_API ssize_t cat_socket_recvfrom_many(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count);
+CAT_API ssize_t cat_socket_recvfrom_many_ex(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout);
+CAT_API ssize_t cat_socket_sendto_many(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count);
+CAT_API ssize_t cat_socket_sendto_many_ex(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout);
+/* resolve name to address in the same way as *_to() APIs do (DNS query may be triggered) */
+CAT_API cat_bool_t cat_socket_getaddrbyname(cat_socket_t *socket, cat_sockaddr_info_t *address_info, const char *name, size_t name_length, int port);
+
 CAT_API ssize_t cat_socket_peek(const cat_socket_t *socket, char *buffer, size_t size);
 CAT_API ssize_t cat_socket_peek_ex(const cat_socket_t *socket, char *buffer, size_t size, cat_timeout_t timeout);
 CAT_API ssize_t cat_socket_peekfrom(const cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length);
@@ -694,6 +784,25 @@ CAT_API ssize_t cat_socket_peekfrom_ex(const cat_socket_t *socket, char *buffer,
 CAT_API ssize_t cat_socket_peek_from(const cat_socket_t *socket, char *buffer, size_t size, char *name, size_t *name_length, int *port);
 CAT_API ssize_t cat_socket_peek_from_ex(const cat_socket_t *socket, char *buffer, size_t size, char *name, size_t *name_length, int *port, cat_timeout_t timeout);
 
+/* post_write: write data without waiting (e.g. for broadcasting),
+ * data which can not be written immediately is queued and written by event loop,
+ * the caller must keep the data alive until release callback is called (only if it was queued),
+ * it skips the socket if size of its write queue would exceed max_queue_size */
+
+typedef enum cat_socket_post_write_result_e {
+    CAT_SOCKET_POST_WRITE_FAILED  = -1,
+    CAT_SOCKET_POST_WRITE_DONE    =  0, /* all data has been written */
+    CAT_SOCKET_POST_WRITE_QUEUED  =  1, /* (the rest of) data has been queued */
+    CAT_SOCKET_POST_WRITE_SKIPPED =  2, /* nothing was written because the queue is full */
+} cat_socket_post_write_result_t;
+
+typedef void (*cat_socket_post_write_release_callback_t)(cat_data_t *data);
+
+#define CAT_SOCKET_POST_WRITE_DEFAULT_MAX_QUEUE_SIZE (1024 * 1024)
+
+CAT_API cat_socket_post_write_result_t cat_socket_post_write(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, size_t max_queue_size, cat_socket_post_write_release_callback_t release, cat_data_t *data);
+CAT_API size_t cat_socket_get_write_queue_size(const cat_socket_t *socket);
+
 CAT_API cat_bool_t cat_socket_send_handle(cat_socket_t *socket, cat_socket_t *handle);
 CAT_API cat_bool_t cat_socket_send_handle_ex(cat_socket_t *socket, cat_socket_t *handle, cat_timeout_t timeout);
 
@@ -711,6 +820,7 @@ CAT_API cat_bool_t cat_socket_is_established(const cat_socket_t *socket);
 #ifdef CAT_SSL
 CAT_API cat_bool_t cat_socket_has_crypto(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_is_encrypted(const cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_is_ktls_enabled(const cat_socket_t *socket);
 #endif
 CAT_API cat_bool_t cat_socket_is_server(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_is_server_connection(const cat_socket_t *socket);
@@ -753,6 +863,17 @@ CAT_API cat_bool_t cat_socket_set_tcp_keepalive(cat_socket_t *socket, cat_bool_t
 CAT_API cat_bool_t cat_socket_get_udp_broadcast(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_set_udp_broadcast(cat_socket_t *socket, cat_bool_t enable);
 
+/* Notice: with GRO, one datagram received by recvfrom_many may contain multiple segments (see segment_size) */
+CAT_API cat_bool_t cat_socket_get_udp_gro(const cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_set_udp_gro(cat_socket_t *socket, cat_bool_t enable);
+
+/* Notice: persistent read mode keeps read interest of stream sockets armed between reads,
+ * data which arrives in the meantime is buffered and served by the next read without syscall */
+CAT_API cat_bool_t cat_socket_get_read_persistent(const cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_set_read_persistent(cat_socket_t *socket, cat_bool_t enable);
+CAT_API cat_bool_t cat_socket_get_global_read_persistent(void);
+CAT_API void cat_socket_set_global_read_persistent(cat_bool_t enable);
+
 /* helper */
 
 CAT_API int cat_socket_get_local_free_port(void);
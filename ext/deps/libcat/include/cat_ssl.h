@@ -113,6 +113,10 @@ extern "C" {
 #define CAT_SSL_MAX_PLAIN_LENGTH  SSL3_RT_MAX_PLAIN_LENGTH
 #define CAT_SSL_BUFFER_SIZE       SSL3_RT_MAX_PACKET_SIZE
 
+#define CAT_SSL_SESSION_CACHE_DEFAULT_SIZE    4096
+#define CAT_SSL_SESSION_CACHE_DEFAULT_TIMEOUT 300  /* seconds, same as OpenSSL */
+#define CAT_SSL_TICKET_KEY_DEFAULT_LIFETIME   3600 /* seconds */
+
 #ifndef OPENSSL_NO_TLSEXT
 #define CAT_SSL_HAVE_TLS_SNI 1
 #define CAT_SSL_HAVE_TLS_ALPN 1
@@ -127,6 +131,11 @@ extern "C" {
 # endif
 #endif
 
+/* kTLS send needs OpenSSL 3.0+ built with kTLS support (which is only available on Linux and FreeBSD) */
+#if defined(SSL_OP_ENABLE_KTLS) && defined(BIO_CTRL_GET_KTLS_SEND) && !defined(OPENSSL_NO_KTLS)
+# define CAT_SSL_HAVE_KTLS 1
+#endif
+
 typedef enum cat_ssl_flag_e {
     CAT_SSL_FLAG_NONE                  = 0,
     CAT_SSL_FLAG_ALLOC                 = 1 << 0,
@@ -135,6 +144,8 @@ typedef enum cat_ssl_flag_e {
     CAT_SSL_FLAG_HANDSHAKE_OK          = 1 << 3,
     CAT_SSL_FLAG_RENEGOTIATION         = 1 << 4,
     CAT_SSL_FLAG_HANDSHAKE_BUFFER_SET  = 1 << 5,
+    CAT_SSL_FLAG_KTLS_PREPARED         = 1 << 6,
+    CAT_SSL_FLAG_KTLS_SEND             = 1 << 7,
     CAT_SSL_FLAG_UNRECOVERABLE_ERROR   = 1 << 31,
 } cat_ssl_flag_t;
 
@@ -200,6 +211,8 @@ typedef struct cat_ssl_s {
     cat_buffer_t write_buffer;
     /* options */
     cat_bool_t allow_self_signed;
+    /* client session store key (host:port) */
+    cat_string_t session_key;
     /* internals */
     cat_ssl_context_t *context; // for free data before SSL_free()
 } cat_ssl_t;
@@ -213,7 +226,34 @@ typedef enum cat_ssl_ret_e {
     CAT_SSL_RET_WANT_IO = CAT_SSL_RET_WANT_READ | CAT_SSL_RET_WANT_WRITE,
 } cat_ssl_ret_t;
 
+typedef struct cat_ssl_session_cache_stats_s {
+    uint64_t server_hits;
+    uint64_t server_misses;
+    uint64_t client_hits;
+    uint64_t client_misses;
+    size_t server_count;
+    size_t client_count;
+    uint64_t ticket_key_rotations;
+} cat_ssl_session_cache_stats_t;
+
 CAT_API cat_bool_t cat_ssl_module_init(void);
+CAT_API cat_bool_t cat_ssl_module_shutdown(void);
+CAT_API cat_bool_t cat_ssl_runtime_init(void);
+CAT_API cat_bool_t cat_ssl_runtime_shutdown(void);
+
+/* session cache (shared by all contexts of the current thread,
+ * server sessions are keyed by session id, client sessions by host:port
+ * together with the client certificate and verify options) */
+
+CAT_API void cat_ssl_set_session_cache_size(size_t size); /* 0 means disabled */
+CAT_API size_t cat_ssl_get_session_cache_size(void);
+CAT_API void cat_ssl_set_session_cache_timeout(long timeout);
+CAT_API long cat_ssl_get_session_cache_timeout(void);
+CAT_API void cat_ssl_set_ticket_key_lifetime(long lifetime);
+CAT_API long cat_ssl_get_ticket_key_lifetime(void);
+CAT_API cat_bool_t cat_ssl_rotate_ticket_keys(void);
+CAT_API void cat_ssl_clear_session_cache(void);
+CAT_API void cat_ssl_get_session_cache_stats(cat_ssl_session_cache_stats_t *stats);
 
 /* context */
 
@@ -235,6 +275,7 @@ CAT_API void cat_ssl_context_enable_verify_peer(cat_ssl_context_t *context);
 CAT_API void cat_ssl_context_disable_verify_peer(cat_ssl_context_t *context);
 CAT_API void cat_ssl_context_set_no_ticket(cat_ssl_context_t *context);
 CAT_API void cat_ssl_context_set_no_compression(cat_ssl_context_t *context);
+CAT_API cat_bool_t cat_ssl_context_enable_session_cache(cat_ssl_context_t *context, cat_bool_t is_client, const char *session_id_context, size_t session_id_context_length);
 #ifdef CAT_SSL_HAVE_SECURITY_LEVEL
 CAT_API void cat_ssl_context_set_security_level(cat_ssl_context_t *context, int level);
 #endif
@@ -251,11 +292,25 @@ CAT_API void cat_ssl_set_accept_state(cat_ssl_t *ssl);
 CAT_API void cat_ssl_set_connect_state(cat_ssl_t *ssl);
 
 CAT_API cat_bool_t cat_ssl_set_sni_server_name(cat_ssl_t *ssl, const char *name);
+/* reuse the cached session of the key and save new sessions to it */
+CAT_API cat_bool_t cat_ssl_set_session_key(cat_ssl_t *ssl, const char *key, size_t key_length);
 
 CAT_API cat_bool_t cat_ssl_is_established(const cat_ssl_t *ssl);
 
 CAT_API cat_ssl_ret_t cat_ssl_handshake(cat_ssl_t *ssl);
 
+/* kTLS: handshake records are written through the writer (which must not return until all data has been written),
+ * then OpenSSL is able to install the send keys into the kernel by the socket fd,
+ * records are written to the fd directly after that, WANT_WRITE is returned if it is not writable.
+ * complete() falls back to the BIO pair if the kernel refused the keys */
+#ifdef CAT_SSL_HAVE_KTLS
+typedef cat_bool_t (*cat_ssl_ktls_writer_t)(void *data, const char *buffer, size_t length);
+
+CAT_API cat_bool_t cat_ssl_ktls_prepare(cat_ssl_t *ssl, int fd, cat_ssl_ktls_writer_t writer, void *data);
+CAT_API cat_bool_t cat_ssl_ktls_complete(cat_ssl_t *ssl);
+#endif
+CAT_API cat_bool_t cat_ssl_is_ktls_send_enabled(const cat_ssl_t *ssl);
+
 CAT_API cat_bool_t cat_ssl_verify_peer(cat_ssl_t *ssl, cat_bool_t allow_self_signed);
 CAT_API cat_bool_t cat_ssl_check_host(cat_ssl_t *ssl, const char *name, size_t name_length);
 
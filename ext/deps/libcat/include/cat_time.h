@@ -23,6 +23,48 @@ extern "C" {
 #endif
 
 #include "cat.h"
+#include "cat_queue.h"
+
+/* timer wheel: all time waiters share one uv timer per event loop,
+ * near timeouts are in the root wheel (1ms per slot),
+ * far ones are kept in coarser levels and cascaded down on demand,
+ * so timeouts that are canceled before expiring cost O(1) */
+
+#define CAT_TIMER_WHEEL_ROOT_BITS  8
+#define CAT_TIMER_WHEEL_ROOT_SIZE  (1 << CAT_TIMER_WHEEL_ROOT_BITS)
+#define CAT_TIMER_WHEEL_ROOT_MASK  (CAT_TIMER_WHEEL_ROOT_SIZE - 1)
+#define CAT_TIMER_WHEEL_LEVEL_BITS 6
+#define CAT_TIMER_WHEEL_LEVEL_SIZE (1 << CAT_TIMER_WHEEL_LEVEL_BITS)
+#define CAT_TIMER_WHEEL_LEVEL_MASK (CAT_TIMER_WHEEL_LEVEL_SIZE - 1)
+#define CAT_TIMER_WHEEL_LEVELS     4
+#define CAT_TIMER_WHEEL_SLOT_COUNT (CAT_TIMER_WHEEL_ROOT_SIZE + CAT_TIMER_WHEEL_LEVEL_SIZE * CAT_TIMER_WHEEL_LEVELS)
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_time) {
+    /* wheel */
+    uv_timer_t timer;
+    cat_msec_t current;
+    cat_msec_t scheduled;
+    size_t count;
+    uint64_t bitmap[CAT_TIMER_WHEEL_SLOT_COUNT / 64];
+    cat_queue_t slots[CAT_TIMER_WHEEL_SLOT_COUNT];
+} CAT_GLOBALS_STRUCT_END(cat_time);
+
+extern CAT_API CAT_GLOBALS_DECLARE(cat_time);
+
+#define CAT_TIME_G(x) CAT_GLOBALS_GET(cat_time, x)
+
+/* module/runtime (runtime must be initialized after event runtime) */
+CAT_API cat_bool_t cat_time_module_init(void);
+CAT_API cat_bool_t cat_time_module_shutdown(void);
+CAT_API cat_bool_t cat_time_runtime_init(void);
+CAT_API cat_bool_t cat_time_runtime_shutdown(void);
+
+/* memory of timers is reported by cat_event_get_slab_stats() */
+typedef struct cat_timer_stats_s {
+    size_t count;
+} cat_timer_stats_t;
+
+CAT_API cat_timer_stats_t *cat_time_get_timer_stats(cat_timer_stats_t *stats);
 
 /* powered by hr_time() */
 CAT_API cat_nsec_t cat_time_nsec(void);
@@ -157,6 +157,10 @@ CAT_API void cat_websocket_mask_ex(const char *from, char *to, uint64_t length,
 CAT_API void cat_websocket_unmask(char *data, uint64_t length, const char *masking_key);
 CAT_API void cat_websocket_unmask_ex(char *data, uint64_t length, const char *masking_key, uint64_t index);
 
+/* name of the kernel used for masking (e.g. "avx2", "sse2", "neon" or "scalar"),
+ * it is chosen at the first call by CPU features or $CAT_WEBSOCKET_MASK_KERNEL */
+CAT_API const char *cat_websocket_mask_get_kernel_name(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -173,6 +173,14 @@ CAT_API cat_bool_t cat_runtime_init(void)
     if (cat_env_is_true("CAT_SHOW_LAST_ERROR", cat_false)) {
         CAT_G(show_last_error) = cat_true;
     }
+    /* async log */
+    CAT_LOG_G(async) = NULL;
+    if (cat_env_is_true("CAT_LOG_ASYNC", cat_false)) {
+        (void) cat_log_async_enable(
+            (size_t) cat_env_get_i("CAT_LOG_ASYNC_BUFFER_SIZE", 0),
+            CAT_LOG_ASYNC_BACKPRESSURE_DROP, 0
+        );
+    }
 
     CAT_G(runtime) = cat_true;
 
@@ -183,6 +191,7 @@ CAT_API cat_bool_t cat_runtime_shutdown(void)
 {
     cat_clear_last_error();
 
+    cat_log_async_disable();
     if (CAT_LOG_G(module_name_filter) != NULL) {
         cat_free(CAT_LOG_G(module_name_filter));
     }
@@ -158,3 +158,194 @@ CAT_API cat_bool_t cat_async_close(cat_async_t *async, cat_async_cleanup_callbac
 
     return cat_true;
 }
+
+/* async queue */
+
+typedef struct cat_async_queue_waiter_s {
+    cat_queue_node_t node;
+    /* it would be set to NULL by the notifier */
+    cat_async_t *async;
+} cat_async_queue_waiter_t;
+
+/* must be called with lock held */
+static void cat_async_queue_wake_up_one(cat_async_queue_t *queue)
+{
+    cat_async_queue_waiter_t *waiter;
+
+    waiter = cat_queue_front_data(&queue->waiters, cat_async_queue_waiter_t, node);
+    if (waiter != NULL) {
+        cat_queue_remove(&waiter->node);
+        (void) cat_async_notify(waiter->async);
+        waiter->async = NULL;
+    }
+}
+
+CAT_API cat_async_queue_t *cat_async_queue_create(void)
+{
+    cat_async_queue_t *queue;
+    int error;
+
+    queue = (cat_async_queue_t *) cat_sys_malloc(sizeof(*queue));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(queue == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for async queue failed");
+        return NULL;
+    }
+#endif
+    error = uv_mutex_init(&queue->mutex);
+    if (unlikely(error != 0)) {
+        cat_sys_free(queue);
+        cat_update_last_error_with_reason(error, "Async queue mutex init failed");
+        return NULL;
+    }
+    cat_queue_init(&queue->messages);
+    cat_queue_init(&queue->waiters);
+    queue->count = 0;
+    queue->refcount = 1;
+    queue->closed = cat_false;
+
+    return queue;
+}
+
+CAT_API cat_async_queue_t *cat_async_queue_addref(cat_async_queue_t *queue)
+{
+    uv_mutex_lock(&queue->mutex);
+    queue->refcount++;
+    uv_mutex_unlock(&queue->mutex);
+
+    return queue;
+}
+
+CAT_API void cat_async_queue_release(cat_async_queue_t *queue)
+{
+    cat_async_message_t *message;
+    size_t refcount;
+
+    uv_mutex_lock(&queue->mutex);
+    refcount = --queue->refcount;
+    uv_mutex_unlock(&queue->mutex);
+    if (refcount != 0) {
+        return;
+    }
+    CAT_ASSERT(cat_queue_empty(&queue->waiters) && "Async queue waiters should be empty");
+    while ((message = cat_queue_front_data(&queue->messages, cat_async_message_t, node))) {
+        cat_queue_remove(&message->node);
+        cat_async_message_free(message);
+    }
+    uv_mutex_destroy(&queue->mutex);
+    cat_sys_free(queue);
+}
+
+CAT_API cat_bool_t cat_async_queue_push(cat_async_queue_t *queue, const char *data, size_t length)
+{
+    cat_async_message_t *message;
+
+    message = (cat_async_message_t *) cat_sys_malloc(offsetof(cat_async_message_t, data) + length + 1);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(message == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for async message failed");
+        return cat_false;
+    }
+#endif
+    message->length = length;
+    memcpy(message->data, data, length);
+    message->data[length] = '\0';
+
+    uv_mutex_lock(&queue->mutex);
+    if (unlikely(queue->closed)) {
+        uv_mutex_unlock(&queue->mutex);
+        cat_sys_free(message);
+        cat_update_last_error(CAT_ECLOSED, "Async queue has been closed");
+        return cat_false;
+    }
+    cat_queue_push_back(&queue->messages, &message->node);
+    queue->count++;
+    cat_async_queue_wake_up_one(queue);
+    uv_mutex_unlock(&queue->mutex);
+
+    return cat_true;
+}
+
+CAT_API cat_async_message_t *cat_async_queue_pop(cat_async_queue_t *queue, cat_timeout_t timeout)
+{
+    cat_async_queue_waiter_t waiter;
+    cat_async_message_t *message;
+    cat_bool_t ret;
+
+    uv_mutex_lock(&queue->mutex);
+    while (1) {
+        message = cat_queue_front_data(&queue->messages, cat_async_message_t, node);
+        if (message != NULL) {
+            cat_queue_remove(&message->node);
+            queue->count--;
+            break;
+        }
+        if (unlikely(queue->closed)) {
+            cat_update_last_error(CAT_ECLOSED, "Async queue has been closed");
+            break;
+        }
+        waiter.async = cat_async_create(NULL);
+        if (unlikely(waiter.async == NULL)) {
+            cat_update_last_error_with_previous("Async queue create waiter failed");
+            break;
+        }
+        cat_queue_push_back(&queue->waiters, &waiter.node);
+        uv_mutex_unlock(&queue->mutex);
+        CAT_TIME_WAIT_START() {
+            ret = cat_async_wait_and_close(waiter.async, NULL, timeout);
+        } CAT_TIME_WAIT_END(timeout);
+        uv_mutex_lock(&queue->mutex);
+        if (unlikely(!ret)) {
+            if (waiter.async != NULL) {
+                /* nobody would notify it, but it can only be closed in notify callback */
+                cat_queue_remove(&waiter.node);
+                (void) cat_async_notify(waiter.async);
+            } else if (!cat_queue_empty(&queue->messages)) {
+                /* we have been chosen, pass it to the next one */
+                cat_async_queue_wake_up_one(queue);
+            }
+            cat_update_last_error_with_previous("Async queue pop failed");
+            break;
+        }
+    }
+    uv_mutex_unlock(&queue->mutex);
+
+    return message;
+}
+
+CAT_API void cat_async_message_free(cat_async_message_t *message)
+{
+    cat_sys_free(message);
+}
+
+CAT_API void cat_async_queue_close(cat_async_queue_t *queue)
+{
+    uv_mutex_lock(&queue->mutex);
+    queue->closed = cat_true;
+    while (!cat_queue_empty(&queue->waiters)) {
+        cat_async_queue_wake_up_one(queue);
+    }
+    uv_mutex_unlock(&queue->mutex);
+}
+
+CAT_API cat_bool_t cat_async_queue_is_closed(cat_async_queue_t *queue)
+{
+    cat_bool_t closed;
+
+    uv_mutex_lock(&queue->mutex);
+    closed = queue->closed;
+    uv_mutex_unlock(&queue->mutex);
+
+    return closed;
+}
+
+CAT_API size_t cat_async_queue_count(cat_async_queue_t *queue)
+{
+    size_t count;
+
+    uv_mutex_lock(&queue->mutex);
+    count = queue->count;
+    uv_mutex_unlock(&queue->mutex);
+
+    return count;
+}
@@ -206,6 +206,12 @@ CAT_API cat_bool_t cat_buffer_prepare(cat_buffer_t *buffer, size_t append_length
     return cat_true;
 }
 
+CAT_API void cat_buffer_commit(cat_buffer_t *buffer, size_t append_length)
+{
+    CAT_ASSERT(buffer->length + append_length <= buffer->size);
+    cat_buffer__update(buffer, buffer->length + append_length);
+}
+
 CAT_API cat_bool_t cat_buffer_malloc_trim(cat_buffer_t *buffer)
 {
     if (unlikely(buffer->length == buffer->size)) {
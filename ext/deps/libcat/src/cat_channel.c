@@ -256,55 +256,108 @@ static cat_bool_t cat_channel_unbuffered_pop(cat_channel_t *channel, cat_data_t
     return cat_true;
 }
 
-static cat_always_inline cat_channel_bucket_t *cat_channel_buffered_bucket_create(const cat_data_t *data, size_t data_size)
-{
-    cat_channel_bucket_t *bucket;
-
-    bucket = (cat_channel_bucket_t *) cat_malloc(offsetof(cat_channel_bucket_t, data) + data_size);
-
-#if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(bucket == NULL)) {
-        cat_update_last_error_of_syscall("Malloc for channel bucket failed");
-        return NULL;
-    }
+#ifndef CAT_CHANNEL_BUFFERED_MIN_SIZE
+#define CAT_CHANNEL_BUFFERED_MIN_SIZE 8
 #endif
 
-    memcpy(bucket->data, data, data_size);
+/* @notice x % (2 ^ k) is equivalent to x & (2 ^ k - 1),
+ * and since the ring size always divides 2 ^ 32, head + index can overflow safely */
+static cat_always_inline size_t cat_channel_buffered_get_size(const cat_channel_t *channel)
+{
+    return channel->u.buffered.storage != NULL ? ((size_t) channel->u.buffered.mask) + 1 : 0;
+}
 
-    return bucket;
+static cat_always_inline char *cat_channel_buffered_get_slot(const cat_channel_t *channel, cat_channel_size_t index)
+{
+    return channel->u.buffered.storage +
+        ((size_t) ((channel->u.buffered.head + index) & channel->u.buffered.mask)) * channel->data_size;
 }
 
-static cat_always_inline cat_bool_t cat_channel_buffered_push_data(cat_channel_t *channel, const cat_data_t *data)
+static cat_never_inline cat_bool_t cat_channel_buffered_grow(cat_channel_t *channel, cat_channel_size_t length)
 {
-    cat_channel_bucket_t *bucket;
+    size_t size = cat_channel_buffered_get_size(channel);
+    size_t max_size = CAT_CHANNEL_BUFFERED_MIN_SIZE;
+    size_t new_size = size != 0 ? size : CAT_CHANNEL_BUFFERED_MIN_SIZE;
+    size_t data_size = channel->data_size;
+    char *storage;
 
-    bucket = cat_channel_buffered_bucket_create(data, channel->data_size);
+    while (max_size < channel->capacity && max_size <= SIZE_MAX / 2) {
+        max_size <<= 1;
+    }
+    while (new_size < length) {
+        new_size <<= 1;
+    }
+    new_size = CAT_MIN(new_size, max_size);
+    CAT_ASSERT(new_size > size);
 
+    storage = (char *) cat_realloc(channel->u.buffered.storage, new_size * data_size);
 #if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(bucket == NULL)) {
+    if (unlikely(storage == NULL)) {
+        cat_update_last_error_of_syscall("Realloc for channel storage failed");
         return cat_false;
     }
 #endif
+    /* the size at least doubled, so the wrapped part can be simply moved to the end of the old ring */
+    if ((size_t) channel->u.buffered.head + channel->length > size) {
+        size_t wrapped = (size_t) channel->u.buffered.head + channel->length - size;
+        memcpy(storage + size * data_size, storage, wrapped * data_size);
+    }
+    channel->u.buffered.storage = storage;
+    channel->u.buffered.mask = (cat_channel_size_t) (new_size - 1);
 
-    cat_queue_push_back(&channel->u.buffered.storage, &bucket->node);
-    channel->length++;
+    return cat_true;
+}
+
+static cat_always_inline cat_bool_t cat_channel_buffered_push_data_many(cat_channel_t *channel, const char *data, cat_channel_size_t count)
+{
+    size_t data_size = channel->data_size;
+    size_t size, tail, n;
+
+    CAT_ASSERT(count <= channel->capacity - channel->length);
+    if (unlikely(cat_channel_buffered_get_size(channel) < (size_t) channel->length + count)) {
+        if (unlikely(!cat_channel_buffered_grow(channel, channel->length + count))) {
+            return cat_false;
+        }
+    }
+    size = cat_channel_buffered_get_size(channel);
+    tail = (size_t) ((channel->u.buffered.head + channel->length) & channel->u.buffered.mask);
+    n = CAT_MIN((size_t) count, size - tail);
+    memcpy(channel->u.buffered.storage + tail * data_size, data, n * data_size);
+    memcpy(channel->u.buffered.storage, data + n * data_size, (count - n) * data_size);
+    channel->length += count;
 
     return cat_true;
 }
 
-static cat_always_inline void cat_channel_buffered_pop_data(cat_channel_t *channel, cat_data_t *data)
+static cat_always_inline cat_bool_t cat_channel_buffered_push_data(cat_channel_t *channel, const cat_data_t *data)
+{
+    return cat_channel_buffered_push_data_many(channel, (const char *) data, 1);
+}
+
+static cat_always_inline void cat_channel_buffered_pop_data_many(cat_channel_t *channel, char *data, cat_channel_size_t count)
 {
-    cat_channel_bucket_t *bucket;
+    size_t data_size = channel->data_size;
+    size_t size, n;
 
-    bucket = cat_queue_front_data(&channel->u.buffered.storage, cat_channel_bucket_t, node);
-    cat_queue_remove(&bucket->node);
+    CAT_ASSERT(count <= channel->length);
     if (data != NULL) {
-        memcpy(data, bucket->data, channel->data_size);
+        size = cat_channel_buffered_get_size(channel);
+        n = CAT_MIN((size_t) count, size - channel->u.buffered.head);
+        memcpy(data, channel->u.buffered.storage + channel->u.buffered.head * data_size, n * data_size);
+        memcpy(data + n * data_size, channel->u.buffered.storage, (count - n) * data_size);
     } else if (channel->dtor != NULL) {
-        channel->dtor(bucket->data);
+        cat_channel_size_t i;
+        for (i = 0; i < count; i++) {
+            channel->dtor(cat_channel_buffered_get_slot(channel, i));
+        }
     }
-    cat_free(bucket);
-    channel->length--;
+    channel->u.buffered.head = (channel->u.buffered.head + count) & channel->u.buffered.mask;
+    channel->length -= count;
+}
+
+static cat_always_inline void cat_channel_buffered_pop_data(cat_channel_t *channel, cat_data_t *data)
+{
+    cat_channel_buffered_pop_data_many(channel, (char *) data, 1);
 }
 
 static cat_always_inline void cat_channel_notify_possible_consumer(cat_channel_t *channel)
@@ -388,6 +441,127 @@ static cat_bool_t cat_channel_buffered_pop(cat_channel_t *channel, cat_data_t *d
     return cat_true;
 }
 
+static cat_always_inline void cat_channel_notify_possible_consumers(cat_channel_t *channel)
+{
+    cat_coroutine_t *consumer;
+
+    /* every woken consumer takes at least one element before it returns here */
+    while (!cat_channel__is_empty(channel) &&
+           (consumer = cat_queue_front_data(&channel->consumers, cat_coroutine_t, waiter.node)) != NULL) {
+        cat_channel_resume_waiter(consumer, "Consumer");
+    }
+}
+
+static cat_always_inline void cat_channel_notify_possible_producers(cat_channel_t *channel)
+{
+    cat_coroutine_t *producer;
+
+    /* every woken producer puts at least one element before it returns here */
+    while (!cat_channel__is_full(channel) &&
+           (producer = cat_queue_front_data(&channel->producers, cat_coroutine_t, waiter.node)) != NULL) {
+        cat_channel_resume_waiter(producer, "Producer");
+    }
+}
+
+static cat_channel_size_t cat_channel_buffered_push_many(cat_channel_t *channel, const char *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    cat_channel_size_t pushed = 0, n;
+
+    while (1) {
+        /* if it is full, just wait */
+        if (cat_channel__is_full(channel)) {
+            cat_bool_t ret;
+            CAT_TIME_WAIT_START() {
+                ret = cat_channel_wait_on(channel, &channel->producers, timeout);
+            } CAT_TIME_WAIT_END(timeout);
+            if (unlikely(!ret)) {
+                /* sleep failed or timedout */
+                cat_update_last_error_with_previous("Channel wait consumer failed");
+                break;
+            }
+            CAT_CHANNEL_CHECK_STATE(channel, break);
+            if (unlikely(cat_channel__is_full(channel))) {
+                /* still full, must be canceled */
+                cat_update_last_error(CAT_ECANCELED, "Channel push has been canceled");
+                break;
+            }
+        }
+        n = CAT_MIN(count - pushed, channel->capacity - channel->length);
+        if (unlikely(!cat_channel_buffered_push_data_many(channel, data + ((size_t) pushed) * channel->data_size, n))) {
+            break;
+        }
+        pushed += n;
+        /* wake up consumers for all of them at once */
+        cat_channel_notify_possible_consumers(channel);
+        if (pushed == count) {
+            break;
+        }
+        CAT_CHANNEL_CHECK_STATE(channel, break);
+    }
+
+    return pushed;
+}
+
+static cat_channel_size_t cat_channel_buffered_pop_many(cat_channel_t *channel, char *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    cat_channel_size_t n;
+
+    /* if it is empty, just wait */
+    if (cat_channel__is_empty(channel)) {
+        if (unlikely(!cat_channel_wait_on(channel, &channel->consumers, timeout))) {
+            /* sleep failed or timedout */
+            cat_update_last_error_with_previous("Channel wait producer failed");
+            return 0;
+        }
+        if (unlikely(cat_channel__is_empty(channel))) {
+            /* still empty, must be canceled */
+            cat_update_last_error(CAT_ECANCELED, "Channel pop has been canceled");
+            return 0;
+        }
+    }
+    n = CAT_MIN(count, channel->length);
+    cat_channel_buffered_pop_data_many(channel, data, n);
+    /* wake up producers for all of them at once */
+    cat_channel_notify_possible_producers(channel);
+
+    return n;
+}
+
+static cat_channel_size_t cat_channel_unbuffered_push_many(cat_channel_t *channel, const char *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    cat_channel_size_t pushed = 0;
+    cat_bool_t ret;
+
+    /* there is no storage, elements can only be handed over one by one */
+    while (pushed < count) {
+        CAT_CHANNEL_CHECK_STATE(channel, break);
+        CAT_TIME_WAIT_START() {
+            ret = cat_channel_unbuffered_push(channel, data + ((size_t) pushed) * channel->data_size, timeout);
+        } CAT_TIME_WAIT_END(timeout);
+        if (unlikely(!ret)) {
+            break;
+        }
+        pushed++;
+    }
+
+    return pushed;
+}
+
+static cat_channel_size_t cat_channel_unbuffered_pop_many(cat_channel_t *channel, char *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    cat_channel_size_t popped = 0;
+
+    if (unlikely(!cat_channel_unbuffered_pop(channel, data, timeout))) {
+        return 0;
+    }
+    /* take the ones from the producers which are waiting already */
+    for (popped = 1; popped < count && cat_channel__has_producers(channel); popped++) {
+        (void) cat_channel_unbuffered_pop(channel, data != NULL ? data + ((size_t) popped) * channel->data_size : NULL, 0);
+    }
+
+    return popped;
+}
+
 /* common */
 
 CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_size_t capacity, cat_channel_data_size_t data_size, cat_channel_data_dtor_t dtor)
@@ -402,7 +576,9 @@ CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_si
     if (cat_channel__is_unbuffered(channel)) {
         memset(&channel->u.unbuffered, 0, sizeof(channel->u.unbuffered));
     } else {
-        cat_queue_init(&channel->u.buffered.storage);
+        channel->u.buffered.storage = NULL;
+        channel->u.buffered.mask = 0;
+        channel->u.buffered.head = 0;
     }
 
     return channel;
@@ -431,6 +607,35 @@ CAT_API cat_bool_t cat_channel_pop(cat_channel_t *channel, cat_data_t *data, cat
     }
 }
 
+CAT_API cat_channel_size_t cat_channel_push_many(cat_channel_t *channel, const cat_data_t *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    CAT_CHANNEL_CHECK_STATE(channel, return 0);
+    CAT_ASSERT(data != NULL || count == 0);
+
+    if (unlikely(count == 0)) {
+        return 0;
+    }
+    if (cat_channel__is_unbuffered(channel)) {
+        return cat_channel_unbuffered_push_many(channel, (const char *) data, count, timeout);
+    } else {
+        return cat_channel_buffered_push_many(channel, (const char *) data, count, timeout);
+    }
+}
+
+CAT_API cat_channel_size_t cat_channel_pop_many(cat_channel_t *channel, cat_data_t *data, cat_channel_size_t count, cat_timeout_t timeout)
+{
+    CAT_CHANNEL_CHECK_STATE_FOR_READING(channel, return 0);
+
+    if (unlikely(count == 0)) {
+        return 0;
+    }
+    if (cat_channel__is_unbuffered(channel)) {
+        return cat_channel_unbuffered_pop_many(channel, (char *) data, count, timeout);
+    } else {
+        return cat_channel_buffered_pop_many(channel, (char *) data, count, timeout);
+    }
+}
+
 CAT_API cat_bool_t cat_channel_close(cat_channel_t *channel)
 {
     CAT_CHANNEL_CHECK_STATE(channel, return cat_false);
@@ -459,18 +664,14 @@ CAT_API void cat_channel_cleanup(cat_channel_t *channel)
         (void) cat_channel_close(channel);
     }
 
-    /* clean up the data bucket (no more consumers) */
+    /* clean up the data storage (no more consumers) */
     if (!cat_channel__is_unbuffered(channel)) {
-        cat_queue_t *storage = &channel->u.buffered.storage;
-        cat_channel_data_dtor_t dtor = channel->dtor;
-        cat_channel_bucket_t *bucket;
-        while ((bucket = cat_queue_front_data(storage, cat_channel_bucket_t, node))) {
-            cat_queue_remove(&bucket->node);
-            if (dtor != NULL) {
-                dtor(bucket->data);
-            }
-            cat_free(bucket);
-            channel->length--;
+        cat_channel_buffered_pop_data_many(channel, NULL, channel->length);
+        if (channel->u.buffered.storage != NULL) {
+            cat_free(channel->u.buffered.storage);
+            channel->u.buffered.storage = NULL;
+            channel->u.buffered.mask = 0;
+            channel->u.buffered.head = 0;
         }
     }
 
@@ -657,10 +858,10 @@ CAT_API cat_channel_data_dtor_t cat_channel_set_dtor(cat_channel_t *channel, cat
 
 /* ext */
 
-CAT_API cat_queue_t *cat_channel_get_storage(cat_channel_t *channel)
+CAT_API cat_data_t *cat_channel_get_buffered_data(cat_channel_t *channel, cat_channel_size_t index)
 {
-    if (unlikely(cat_channel__is_unbuffered(channel))) {
+    if (unlikely(cat_channel__is_unbuffered(channel) || index >= channel->length)) {
         return NULL;
     }
-    return &channel->u.buffered.storage;
+    return cat_channel_buffered_get_slot(channel, index);
 }
@@ -54,6 +54,11 @@
 #  undef MAP_STACK
 #  define MAP_STACK 0
 # endif
+/* stacks are reserved without committing swap space,
+ * only the pages which have been touched take memory */
+# ifndef MAP_NORESERVE
+#  define MAP_NORESERVE 0
+# endif
 # ifndef MAP_FAILED
 #  define MAP_FAILED ((void * ) -1)
 # endif
@@ -72,6 +77,12 @@
 # define CAT_COROUTINE_STACK_PADDING_PAGE_COUNT  0
 #endif
 
+/* stacks allocated by mmap() are recycled by the stack pool,
+ * they are trimmed by madvise() without losing the mappings */
+#ifdef CAT_COROUTINE_USE_MMAP
+# define CAT_COROUTINE_USE_STACK_POOL 1
+#endif
+
 #ifdef CAT_HAVE_VALGRIND
 # include <valgrind/valgrind.h>
 #endif
@@ -156,6 +167,202 @@ static cat_coroutine_stack_size_t cat_coroutine_align_stack_size(size_t size)
 
 CAT_API CAT_GLOBALS_DECLARE(cat_coroutine);
 
+/* stack pool */
+
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+/* MADV_FREE is lazier (pages are only reclaimed under memory pressure),
+ * we fall back to MADV_DONTNEED if the kernel does not support it */
+# ifdef MADV_FREE
+static int cat_coroutine_stack_pool_advice = MADV_FREE;
+# else
+static int cat_coroutine_stack_pool_advice = MADV_DONTNEED;
+# endif
+
+static cat_coroutine_stack_pool_class_t *cat_coroutine_stack_pool_get_class(size_t size, cat_bool_t create)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *unused = NULL;
+    size_t i;
+
+    for (i = 0; i < CAT_COROUTINE_STACK_POOL_CLASS_COUNT; i++) {
+        cat_coroutine_stack_pool_class_t *stack_class = &pool->classes[i];
+        if (stack_class->size == size) {
+            return stack_class;
+        }
+        if (unused == NULL && stack_class->count == 0) {
+            unused = stack_class;
+        }
+    }
+    if (create && unused != NULL) {
+        unused->size = size;
+        unused->trimmed = 0;
+        return unused;
+    }
+
+    return NULL;
+}
+
+static void cat_coroutine_stack_pool_release_pages(void *virtual_memory, size_t virtual_memory_size)
+{
+    /* guard page is never touched, skip it */
+    size_t padding_size = cat_getpagesize() * CAT_COROUTINE_STACK_PADDING_PAGE_COUNT;
+    void *stack = ((char *) virtual_memory) + padding_size;
+    size_t stack_size = virtual_memory_size - padding_size;
+    int error;
+
+    error = madvise(stack, stack_size, cat_coroutine_stack_pool_advice);
+# ifdef MADV_FREE
+    if (unlikely(error != 0 && errno == EINVAL && cat_coroutine_stack_pool_advice == MADV_FREE)) {
+        cat_coroutine_stack_pool_advice = MADV_DONTNEED;
+        error = madvise(stack, stack_size, cat_coroutine_stack_pool_advice);
+    }
+# endif
+    if (unlikely(error != 0)) {
+        CAT_SYSCALL_FAILURE(NOTICE, COROUTINE, "Release pages of stack failed");
+    }
+}
+
+static void cat_coroutine_stack_pool_trim(void)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    size_t i;
+
+    /* cold stacks are at the bottom of the LIFO lists */
+    for (i = 0; i < CAT_COROUTINE_STACK_POOL_CLASS_COUNT && pool->resident_bytes > pool->high_water_mark; i++) {
+        cat_coroutine_stack_pool_class_t *stack_class = &pool->classes[i];
+        while (stack_class->trimmed < stack_class->count && pool->resident_bytes > pool->high_water_mark) {
+            cat_coroutine_stack_pool_release_pages(stack_class->stacks[stack_class->trimmed++], stack_class->size);
+            pool->resident_bytes -= stack_class->size;
+            pool->trims++;
+        }
+    }
+}
+
+static void *cat_coroutine_stack_pool_take(cat_coroutine_stack_pool_class_t *stack_class)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    void *virtual_memory = stack_class->stacks[--stack_class->count];
+
+    if (stack_class->count < stack_class->trimmed) {
+        stack_class->trimmed = stack_class->count;
+    } else {
+        pool->resident_bytes -= stack_class->size;
+    }
+    pool->count--;
+
+    return virtual_memory;
+}
+
+static void *cat_coroutine_stack_pool_pop(size_t virtual_memory_size)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *stack_class;
+
+    stack_class = cat_coroutine_stack_pool_get_class(virtual_memory_size, cat_false);
+    if (stack_class == NULL || stack_class->count == 0) {
+        pool->misses++;
+        return NULL;
+    }
+    pool->hits++;
+
+    return cat_coroutine_stack_pool_take(stack_class);
+}
+
+static cat_bool_t cat_coroutine_stack_pool_push(void *virtual_memory, size_t virtual_memory_size)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *stack_class;
+
+    if (pool->count >= pool->max_count) {
+        return cat_false;
+    }
+    stack_class = cat_coroutine_stack_pool_get_class(virtual_memory_size, cat_true);
+    if (stack_class == NULL) {
+        return cat_false;
+    }
+    if (unlikely(stack_class->count == stack_class->capacity)) {
+        size_t capacity = stack_class->capacity == 0 ? 8 : stack_class->capacity * 2;
+        void **stacks = (void **) cat_realloc(stack_class->stacks, sizeof(*stacks) * capacity);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(stacks == NULL)) {
+            return cat_false;
+        }
+#endif
+        stack_class->stacks = stacks;
+        stack_class->capacity = capacity;
+    }
+    stack_class->stacks[stack_class->count++] = virtual_memory;
+    pool->count++;
+    pool->resident_bytes += virtual_memory_size;
+    if (pool->resident_bytes > pool->high_water_mark) {
+        cat_coroutine_stack_pool_trim();
+    }
+
+    return cat_true;
+}
+
+static void cat_coroutine_stack_pool_shrink(size_t count)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    size_t i;
+
+    for (i = 0; i < CAT_COROUTINE_STACK_POOL_CLASS_COUNT && pool->count > count; i++) {
+        cat_coroutine_stack_pool_class_t *stack_class = &pool->classes[i];
+        while (stack_class->count > 0 && pool->count > count) {
+            munmap(cat_coroutine_stack_pool_take(stack_class), stack_class->size);
+        }
+    }
+}
+#endif
+
+CAT_API size_t cat_coroutine_set_stack_pool_max_count(size_t count)
+{
+    size_t original_count = CAT_COROUTINE_G(stack_pool).max_count;
+    CAT_COROUTINE_G(stack_pool).max_count = count;
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    cat_coroutine_stack_pool_shrink(count);
+#endif
+    return original_count;
+}
+
+CAT_API size_t cat_coroutine_set_stack_pool_high_water_mark(size_t size)
+{
+    size_t original_size = CAT_COROUTINE_G(stack_pool).high_water_mark;
+    CAT_COROUTINE_G(stack_pool).high_water_mark = size;
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    cat_coroutine_stack_pool_trim();
+#endif
+    return original_size;
+}
+
+CAT_API size_t cat_coroutine_get_stack_pool_max_count(void)
+{
+    return CAT_COROUTINE_G(stack_pool).max_count;
+}
+
+CAT_API size_t cat_coroutine_get_stack_pool_high_water_mark(void)
+{
+    return CAT_COROUTINE_G(stack_pool).high_water_mark;
+}
+
+CAT_API cat_coroutine_stack_pool_stats_t *cat_coroutine_get_stack_pool_stats(cat_coroutine_stack_pool_stats_t *stats)
+{
+    const cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    size_t i;
+
+    stats->hits = pool->hits;
+    stats->misses = pool->misses;
+    stats->trims = pool->trims;
+    stats->count = pool->count;
+    stats->bytes = 0;
+    for (i = 0; i < CAT_COROUTINE_STACK_POOL_CLASS_COUNT; i++) {
+        stats->bytes += pool->classes[i].size * pool->classes[i].count;
+    }
+    stats->resident_bytes = pool->resident_bytes;
+
+    return stats;
+}
+
 CAT_API cat_bool_t cat_coroutine_module_init(void)
 {
     CAT_GLOBALS_REGISTER(cat_coroutine);
@@ -189,6 +396,11 @@ CAT_API cat_bool_t cat_coroutine_runtime_init(void)
     CAT_COROUTINE_G(peak_count) = 0;
     CAT_COROUTINE_G(switches) = 0;
 
+    /* init stack pool */
+    memset(&CAT_COROUTINE_G(stack_pool), 0, sizeof(CAT_COROUTINE_G(stack_pool)));
+    CAT_COROUTINE_G(stack_pool).max_count = CAT_COROUTINE_STACK_POOL_DEFAULT_MAX_COUNT;
+    CAT_COROUTINE_G(stack_pool).high_water_mark = CAT_COROUTINE_STACK_POOL_DEFAULT_HIGH_WATER_MARK;
+
     /* init main coroutine properties */
     do {
         cat_coroutine_t *main_coroutine = &CAT_COROUTINE_G(_main);
@@ -250,6 +462,19 @@ CAT_API cat_bool_t cat_coroutine_runtime_shutdown(void)
     CAT_ASSERT(cat_coroutine_get_scheduler() == NULL && "Coroutine scheduler should have been stopped");
     CAT_ASSERT(CAT_COROUTINE_G(count) == 1 && "Coroutine count should be 1");
 
+    /* release all cached stacks, stacks of coroutines which are freed later will be unmapped directly */
+    do {
+        cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+        size_t i;
+        cat_coroutine_set_stack_pool_max_count(0);
+        for (i = 0; i < CAT_COROUTINE_STACK_POOL_CLASS_COUNT; i++) {
+            if (pool->classes[i].stacks != NULL) {
+                cat_free(pool->classes[i].stacks);
+            }
+        }
+        memset(pool->classes, 0, sizeof(pool->classes));
+    } while (0);
+
     return cat_true;
 }
 
@@ -498,6 +723,9 @@ CAT_API cat_coroutine_t *cat_coroutine_create_ex(cat_coroutine_t *coroutine, cat
     size_t virtual_memory_size;
     size_t padding_size = cat_getpagesize() * CAT_COROUTINE_STACK_PADDING_PAGE_COUNT;
     void *stack, *stack_start;
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    cat_bool_t recycled;
+#endif
     /* Coroutine Virtual Memory
     * - PADDING: memory-protection is on
     *   (1 page for mmap/VirtualAlloc, 2 pages for sys_malloc)
@@ -510,11 +738,17 @@ CAT_API cat_coroutine_t *cat_coroutine_create_ex(cat_coroutine_t *coroutine, cat
     virtual_memory_size = padding_size + stack_size;
     /* alloc memory */
 #if defined(CAT_COROUTINE_USE_MMAP)
-    virtual_memory = mmap(NULL, virtual_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    virtual_memory = cat_coroutine_stack_pool_pop(virtual_memory_size);
+    recycled = virtual_memory != NULL;
+    if (!recycled) {
+        virtual_memory = mmap(NULL, virtual_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK | MAP_NORESERVE, -1, 0);
+    }
 #elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
     virtual_memory = VirtualAlloc(0, virtual_memory_size, MEM_COMMIT, PAGE_READWRITE);
+    CAT_COROUTINE_G(stack_pool).misses++;
 #else // if defined(CAT_COROUTINE_USE_SYS_MALLOC)
     virtual_memory = cat_sys_malloc_recoverable(virtual_memory_size);
+    CAT_COROUTINE_G(stack_pool).misses++;
 #endif
     if (unlikely(virtual_memory == CAT_COROUTINE_MEMORY_INVALID)) {
         cat_update_last_error_of_syscall("Allocate virtual memory for coroutine stack failed with size %zu", virtual_memory_size);
@@ -528,8 +762,12 @@ CAT_API cat_coroutine_t *cat_coroutine_create_ex(cat_coroutine_t *coroutine, cat
 
 #ifdef CAT_COROUTINE_MEMORY_PROTECT_SUPPORT
     /* protect a page of memory after the stack top
-     * to notify stack overflow */
+     * to notify stack overflow (recycled stacks are still protected) */
+# ifdef CAT_COROUTINE_USE_STACK_POOL
+    if (cat_coroutine_use_memory_protect && !recycled) {
+# else
     if (cat_coroutine_use_memory_protect) {
+# endif
         void *page = virtual_memory;
         cat_bool_t ret;
 # ifdef CAT_COROUTINE_USE_SYS_MALLOC
@@ -635,7 +873,9 @@ CAT_API void cat_coroutine_free(cat_coroutine_t *coroutine)
     }
 #endif
 #if defined(CAT_COROUTINE_USE_MMAP)
-    munmap(coroutine->virtual_memory, coroutine->virtual_memory_size);
+    if (!cat_coroutine_stack_pool_push(coroutine->virtual_memory, coroutine->virtual_memory_size)) {
+        munmap(coroutine->virtual_memory, coroutine->virtual_memory_size);
+    }
 #elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
     VirtualFree(coroutine->virtual_memory, 0, MEM_RELEASE);
 #elif defined(CAT_COROUTINE_USE_SYS_MALLOC)
@@ -900,6 +1140,46 @@ CAT_API cat_coroutine_stack_size_t cat_coroutine_get_stack_size(const cat_corout
     return coroutine->stack_size;
 }
 
+CAT_API size_t cat_coroutine_get_stack_resident_size(const cat_coroutine_t *coroutine)
+{
+#if defined(CAT_COROUTINE_USE_MMAP) && !defined(__OpenBSD__)
+# ifdef __linux__
+    unsigned char vector[256];
+# else
+    char vector[256];
+# endif
+    size_t page_size = cat_getpagesize();
+    char *stack, *stack_end;
+    size_t resident_size = 0;
+
+    if (coroutine->virtual_memory == NULL) {
+        return 0;
+    }
+    stack_end = ((char *) coroutine->virtual_memory) + coroutine->virtual_memory_size;
+    stack = stack_end - coroutine->stack_size;
+    while (stack < stack_end) {
+        size_t length = CAT_MIN((size_t) (stack_end - stack), page_size * sizeof(vector));
+        size_t n, count = (length + page_size - 1) / page_size;
+        if (unlikely(mincore(stack, length, vector) != 0)) {
+            return coroutine->stack_size;
+        }
+        for (n = 0; n < count; n++) {
+            if (vector[n] & 1) {
+                resident_size += page_size;
+            }
+        }
+        stack += length;
+    }
+
+    return resident_size;
+#elif defined(CAT_COROUTINE_USE_USER_STACK)
+    /* we can not know it, assume that all pages are resident */
+    return coroutine->virtual_memory != NULL ? coroutine->stack_size : 0;
+#else
+    return coroutine->stack_size;
+#endif
+}
+
 /* status */
 
 CAT_API cat_bool_t cat_coroutine_is_available(const cat_coroutine_t *coroutine)
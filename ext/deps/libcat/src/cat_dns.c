@@ -21,29 +21,266 @@
 #include "cat_event.h"
 #include "cat_time.h"
 
-typedef struct cat_getaddrinfo_context_s {
-    union {
-        cat_coroutine_t *coroutine;
-        uv_req_t req;
-        uv_getaddrinfo_t getaddrinfo;
-    } request;
-    int status;
+typedef struct cat_dns_cache_entry_s {
+    RB_ENTRY(cat_dns_cache_entry_s) tree_entry;
+    cat_queue_node_t lru_node;
+    /* key */
+    int family;
+    int socktype;
+    int protocol;
+    int flags;
+    const char *hostname;
+    const char *service;
+    /* result */
     struct addrinfo *response;
-} cat_getaddrinfo_context_t;
+    int status;
+    cat_msec_t expire;
+    /* lookup */
+    uv_getaddrinfo_t request;
+    cat_queue_t waiters;
+    uint32_t refcount;
+    cat_bool_t resolving;
+    cat_bool_t cached;
+} cat_dns_cache_entry_t;
+
+typedef struct cat_dns_cache_waiter_s {
+    cat_queue_node_t node;
+    cat_coroutine_t *coroutine;
+} cat_dns_cache_waiter_t;
+
+static int cat_dns_cache_string_compare(const char *string1, const char *string2)
+{
+    if (string1 == NULL || string2 == NULL) {
+        return (string1 != NULL) - (string2 != NULL);
+    }
+    return strcmp(string1, string2);
+}
+
+static int cat_dns_cache_entry_compare(const cat_dns_cache_entry_t *entry1, const cat_dns_cache_entry_t *entry2)
+{
+    int diff;
 
-static void cat_dns_getaddrinfo_callback(uv_getaddrinfo_t* request, int status, struct addrinfo *response)
+    if (entry1->family != entry2->family) {
+        return entry1->family < entry2->family ? -1 : 1;
+    }
+    if (entry1->socktype != entry2->socktype) {
+        return entry1->socktype < entry2->socktype ? -1 : 1;
+    }
+    if (entry1->protocol != entry2->protocol) {
+        return entry1->protocol < entry2->protocol ? -1 : 1;
+    }
+    if (entry1->flags != entry2->flags) {
+        return entry1->flags < entry2->flags ? -1 : 1;
+    }
+    diff = cat_dns_cache_string_compare(entry1->hostname, entry2->hostname);
+    if (diff != 0) {
+        return diff;
+    }
+    return cat_dns_cache_string_compare(entry1->service, entry2->service);
+}
+
+RB_GENERATE_STATIC(cat_dns_cache_tree_s,
+                   cat_dns_cache_entry_s, tree_entry,
+                   cat_dns_cache_entry_compare);
+
+/* copy the whole list into one block so that it can be released by cat_free() */
+static struct addrinfo *cat_dns_addrinfo_dup(const struct addrinfo *response)
 {
-    cat_getaddrinfo_context_t *context = cat_container_of(request, cat_getaddrinfo_context_t, request.getaddrinfo);
+    const struct addrinfo *ai;
+    struct addrinfo *copy, *copy_ai;
+    char *data;
+    size_t count = 0, size = 0;
 
-    if (likely(context->request.coroutine != NULL)) {
-        context->status = status;
-        context->response = response;
-        cat_coroutine_schedule(context->request.coroutine, DNS, "DNS resolver");
-    } else if (response != NULL) {
+    for (ai = response; ai != NULL; ai = ai->ai_next) {
+        count++;
+        size += CAT_MEMORY_ALIGNED_SIZE(ai->ai_addrlen);
+        if (ai->ai_canonname != NULL) {
+            size += strlen(ai->ai_canonname) + 1;
+        }
+    }
+    copy = (struct addrinfo *) cat_malloc(sizeof(*copy) * count + size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(copy == NULL)) {
+        return NULL;
+    }
+#endif
+    data = (char *) (copy + count);
+    for (ai = response, copy_ai = copy; ai != NULL; ai = ai->ai_next, copy_ai++) {
+        *copy_ai = *ai;
+        copy_ai->ai_addr = (struct sockaddr *) data;
+        memcpy(data, ai->ai_addr, ai->ai_addrlen);
+        data += CAT_MEMORY_ALIGNED_SIZE(ai->ai_addrlen);
+        if (ai->ai_canonname != NULL) {
+            size_t length = strlen(ai->ai_canonname) + 1;
+            copy_ai->ai_canonname = data;
+            memcpy(data, ai->ai_canonname, length);
+            data += length;
+        }
+        copy_ai->ai_next = ai->ai_next != NULL ? copy_ai + 1 : NULL;
+    }
+
+    return copy;
+}
+
+static cat_always_inline cat_dns_cache_t *cat_dns_cache_get(void)
+{
+    return &CAT_SOCKET_G(dns_cache);
+}
+
+static void cat_dns_cache_entry_release(cat_dns_cache_entry_t *entry)
+{
+    if (--entry->refcount != 0) {
+        return;
+    }
+    if (entry->response != NULL) {
+        cat_free(entry->response);
+    }
+    cat_free(entry);
+}
+
+static void cat_dns_cache_remove(cat_dns_cache_t *cache, cat_dns_cache_entry_t *entry)
+{
+    CAT_ASSERT(entry->cached);
+    RB_REMOVE(cat_dns_cache_tree_s, &cache->tree, entry);
+    cat_queue_remove(&entry->lru_node);
+    cache->size--;
+    entry->cached = cat_false;
+    cat_dns_cache_entry_release(entry);
+}
+
+static void cat_dns_cache_shrink(cat_dns_cache_t *cache, size_t size)
+{
+    while (cache->size > size) {
+        cat_dns_cache_entry_t *entry = cat_queue_back_data(&cache->lru, cat_dns_cache_entry_t, lru_node);
+        cat_dns_cache_remove(cache, entry);
+        cache->evictions++;
+    }
+}
+
+static cat_bool_t cat_dns_cache_is_negative_status(int status)
+{
+    return status == CAT_EAI_NONAME || status == CAT_EAI_NODATA;
+}
+
+static void cat_dns_getaddrinfo_callback(uv_getaddrinfo_t *request, int status, struct addrinfo *response)
+{
+    cat_dns_cache_entry_t *entry = cat_container_of(request, cat_dns_cache_entry_t, request);
+
+    if (response != NULL) {
+        if (likely(status == 0)) {
+            entry->response = cat_dns_addrinfo_dup(response);
+            if (unlikely(entry->response == NULL)) {
+                status = CAT_ENOMEM;
+            }
+        }
         uv_freeaddrinfo(response);
     }
+    entry->status = status;
+    entry->resolving = cat_false;
+
+    if (entry->cached) {
+        cat_dns_cache_t *cache = cat_dns_cache_get();
+        cat_msec_t ttl = 0;
+        if (status == 0) {
+            ttl = cache->ttl;
+        } else if (cat_dns_cache_is_negative_status(status)) {
+            ttl = cache->negative_ttl;
+        }
+        if (ttl > 0) {
+            entry->expire = cat_time_msec_cached() + ttl;
+        } else {
+            cat_dns_cache_remove(cache, entry);
+        }
+    }
+
+    while (!cat_queue_empty(&entry->waiters)) {
+        cat_dns_cache_waiter_t *waiter = cat_queue_front_data(&entry->waiters, cat_dns_cache_waiter_t, node);
+        cat_coroutine_t *coroutine = waiter->coroutine;
+        cat_queue_remove(&waiter->node);
+        waiter->coroutine = NULL;
+        cat_coroutine_schedule(coroutine, DNS, "DNS resolver");
+    }
+
+    /* release the reference of the request */
+    cat_dns_cache_entry_release(entry);
+}
+
+static struct addrinfo *cat_dns_cache_entry_get_response(const cat_dns_cache_entry_t *entry)
+{
+    struct addrinfo *response;
+
+    if (unlikely(entry->status != 0)) {
+        cat_update_last_error_with_reason(entry->status, "DNS getaddrinfo failed");
+        return NULL;
+    }
+    response = cat_dns_addrinfo_dup(entry->response);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(response == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for DNS getaddrinfo response failed");
+        return NULL;
+    }
+#endif
+
+    return response;
+}
+
+static struct addrinfo *cat_dns_cache_entry_wait(cat_dns_cache_entry_t *entry, cat_timeout_t timeout)
+{
+    cat_dns_cache_waiter_t waiter;
+    struct addrinfo *response;
+    cat_bool_t ret;
+
+    waiter.coroutine = CAT_COROUTINE_G(current);
+    cat_queue_push_back(&entry->waiters, &waiter.node);
+    entry->refcount++;
+    ret = cat_time_wait(timeout);
+    if (waiter.coroutine != NULL) {
+        cat_queue_remove(&waiter.node);
+    }
+    if (unlikely(entry->resolving)) {
+        if (!ret) {
+            cat_update_last_error_with_previous("DNS getaddrinfo wait failed");
+        } else {
+            cat_update_last_error(CAT_ECANCELED, "DNS getaddrinfo has been canceled");
+        }
+        /* nobody is interested in the result anymore */
+        if (!entry->cached && cat_queue_empty(&entry->waiters)) {
+            (void) uv_cancel((uv_req_t *) &entry->request);
+        }
+        response = NULL;
+    } else {
+        response = cat_dns_cache_entry_get_response(entry);
+    }
+    cat_dns_cache_entry_release(entry);
 
-    cat_free(context);
+    return response;
+}
+
+CAT_API cat_bool_t cat_dns_runtime_init(void)
+{
+    cat_dns_cache_t *cache = cat_dns_cache_get();
+
+    RB_INIT(&cache->tree);
+    cat_queue_init(&cache->lru);
+    cache->size = 0;
+    cache->capacity = CAT_DNS_CACHE_DEFAULT_CAPACITY;
+    cache->ttl = CAT_DNS_CACHE_DEFAULT_TTL;
+    cache->negative_ttl = CAT_DNS_CACHE_DEFAULT_NEGATIVE_TTL;
+    cache->hits = 0;
+    cache->negative_hits = 0;
+    cache->misses = 0;
+    cache->coalesced = 0;
+    cache->evictions = 0;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_dns_runtime_shutdown(void)
+{
+    /* entries which are still being resolved will be released by the callback */
+    cat_dns_cache_clear();
+
+    return cat_true;
 }
 
 CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *service, const struct addrinfo *hints)
@@ -53,47 +290,91 @@ CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *s
 
 CAT_API struct addrinfo *cat_dns_getaddrinfo_ex(const char *hostname, const char *service, const struct addrinfo *hints, cat_timeout_t timeout)
 {
-    cat_getaddrinfo_context_t *context = (cat_getaddrinfo_context_t *) cat_malloc(sizeof(*context));
-    cat_bool_t ret;
+    cat_dns_cache_t *cache = cat_dns_cache_get();
+    cat_dns_cache_entry_t key, *entry;
+    size_t hostname_size, service_size;
+    char *data;
     int error;
 
+    key.family = hints != NULL ? hints->ai_family : AF_UNSPEC;
+    key.socktype = hints != NULL ? hints->ai_socktype : 0;
+    key.protocol = hints != NULL ? hints->ai_protocol : 0;
+    key.flags = hints != NULL ? hints->ai_flags : 0;
+    key.hostname = hostname;
+    key.service = service;
+
+    if (hostname != NULL && cache->capacity > 0) {
+        entry = RB_FIND(cat_dns_cache_tree_s, &cache->tree, &key);
+        if (entry != NULL) {
+            if (entry->resolving) {
+                cache->coalesced++;
+                return cat_dns_cache_entry_wait(entry, timeout);
+            }
+            if (entry->expire > cat_time_msec_cached()) {
+                if (entry->status == 0) {
+                    cache->hits++;
+                } else {
+                    cache->negative_hits++;
+                }
+                cat_queue_remove(&entry->lru_node);
+                cat_queue_push_front(&cache->lru, &entry->lru_node);
+                return cat_dns_cache_entry_get_response(entry);
+            }
+            cat_dns_cache_remove(cache, entry);
+        }
+        cache->misses++;
+    }
+
+    hostname_size = hostname != NULL ? strlen(hostname) + 1 : 0;
+    service_size = service != NULL ? strlen(service) + 1 : 0;
+    entry = (cat_dns_cache_entry_t *) cat_malloc(sizeof(*entry) + hostname_size + service_size);
 #if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(context == NULL)) {
+    if (unlikely(entry == NULL)) {
         cat_update_last_error_of_syscall("Malloc for DNS getaddrinfo context failed");
         return NULL;
     }
 #endif
-    error = uv_getaddrinfo(&CAT_EVENT_G(loop), &context->request.getaddrinfo, cat_dns_getaddrinfo_callback, hostname, service, hints);
+    *entry = key;
+    data = (char *) (entry + 1);
+    if (hostname != NULL) {
+        entry->hostname = (const char *) memcpy(data, hostname, hostname_size);
+        data += hostname_size;
+    }
+    if (service != NULL) {
+        entry->service = (const char *) memcpy(data, service, service_size);
+    }
+    entry->response = NULL;
+    entry->status = CAT_ECANCELED;
+    entry->expire = 0;
+    cat_queue_init(&entry->waiters);
+    entry->refcount = 0;
+    entry->resolving = cat_true;
+    entry->cached = cat_false;
+
+    error = uv_getaddrinfo(&CAT_EVENT_G(loop), &entry->request, cat_dns_getaddrinfo_callback, hostname, service, hints);
     if (error != 0) {
         cat_update_last_error_with_reason(error, "DNS getaddrinfo init failed");
-        cat_free(context);
+        cat_free(entry);
         return NULL;
     }
-    context->status = CAT_ECANCELED;
-    context->request.coroutine = CAT_COROUTINE_G(current);
-    ret = cat_time_wait(timeout);
-    context->request.coroutine = NULL;
-    if (unlikely(!ret)) {
-        cat_update_last_error_with_previous("DNS getaddrinfo wait failed");
-        (void) uv_cancel(&context->request.req);
-        return NULL;
-    }
-    if (unlikely(context->status != 0)) {
-        if (context->status == CAT_ECANCELED) {
-            cat_update_last_error(CAT_ECANCELED, "DNS getaddrinfo has been canceled");
-            (void) uv_cancel(&context->request.req);
-        } else {
-            cat_update_last_error_with_reason(context->status, "DNS getaddrinfo failed");
-        }
-        return NULL;
+    /* reference of the request */
+    entry->refcount++;
+    if (hostname != NULL && cache->capacity > 0) {
+        cat_dns_cache_shrink(cache, cache->capacity - 1);
+        RB_INSERT(cat_dns_cache_tree_s, &cache->tree, entry);
+        cat_queue_push_front(&cache->lru, &entry->lru_node);
+        cache->size++;
+        entry->cached = cat_true;
+        /* reference of the cache */
+        entry->refcount++;
     }
 
-    return context->response;
+    return cat_dns_cache_entry_wait(entry, timeout);
 }
 
 CAT_API void cat_dns_freeaddrinfo(struct addrinfo *response)
 {
-    uv_freeaddrinfo(response);
+    cat_free(response);
 }
 
 CAT_API cat_bool_t cat_dns_get_ip(char *buffer, size_t buffer_size, const char *name, int af)
@@ -132,3 +413,61 @@ CAT_API cat_bool_t cat_dns_get_ip_ex(char *buffer, size_t buffer_size, const cha
 
     return cat_true;
 }
+
+CAT_API size_t cat_dns_cache_get_capacity(void)
+{
+    return cat_dns_cache_get()->capacity;
+}
+
+CAT_API void cat_dns_cache_set_capacity(size_t capacity)
+{
+    cat_dns_cache_t *cache = cat_dns_cache_get();
+
+    cat_dns_cache_shrink(cache, capacity);
+    cache->capacity = capacity;
+}
+
+CAT_API cat_msec_t cat_dns_cache_get_ttl(void)
+{
+    return cat_dns_cache_get()->ttl;
+}
+
+CAT_API void cat_dns_cache_set_ttl(cat_msec_t ttl)
+{
+    cat_dns_cache_get()->ttl = ttl;
+}
+
+CAT_API cat_msec_t cat_dns_cache_get_negative_ttl(void)
+{
+    return cat_dns_cache_get()->negative_ttl;
+}
+
+CAT_API void cat_dns_cache_set_negative_ttl(cat_msec_t ttl)
+{
+    cat_dns_cache_get()->negative_ttl = ttl;
+}
+
+CAT_API cat_dns_cache_stats_t *cat_dns_cache_get_stats(cat_dns_cache_stats_t *stats)
+{
+    const cat_dns_cache_t *cache = cat_dns_cache_get();
+
+    stats->size = cache->size;
+    stats->capacity = cache->capacity;
+    stats->hits = cache->hits;
+    stats->negative_hits = cache->negative_hits;
+    stats->misses = cache->misses;
+    stats->coalesced = cache->coalesced;
+    stats->evictions = cache->evictions;
+
+    return stats;
+}
+
+CAT_API void cat_dns_cache_clear(void)
+{
+    cat_dns_cache_t *cache = cat_dns_cache_get();
+
+    while (cache->size > 0) {
+        cat_dns_cache_entry_t *entry = cat_queue_back_data(&cache->lru, cat_dns_cache_entry_t, lru_node);
+        cat_dns_cache_remove(cache, entry);
+    }
+}
@@ -74,6 +74,7 @@ CAT_API cat_bool_t cat_event_runtime_init(void)
         return cat_false;
     }
 
+    cat_slab_init(&CAT_EVENT_G(slab));
     cat_queue_init(&CAT_EVENT_G(runtime_shutdown_tasks));
     cat_queue_init(&CAT_EVENT_G(io_defer_tasks));
     do {
@@ -96,7 +97,7 @@ CAT_API cat_bool_t cat_event_runtime_shutdown(void)
         while ((shutdown_task = cat_queue_front_data(shutdown_tasks, cat_event_shutdown_task_t, node))) {
             cat_queue_remove(&shutdown_task->node);
             shutdown_task->callback(shutdown_task->data);
-            cat_free(shutdown_task);
+            cat_event_slab_free(shutdown_task, sizeof(*shutdown_task));
         }
     } while (0);
 
@@ -122,10 +123,13 @@ CAT_API cat_bool_t cat_event_runtime_close(void)
         if (error == CAT_EBUSY) {
             uv_print_all_handles(&CAT_EVENT_G(loop), CAT_LOG_G(error_output));
         }
-        return cat_false;
     }
 
-    return cat_true;
+    /* all handles have been closed (or leaked with the dead loop, their callbacks will never be called),
+     * nobody can hold objects from the slab anymore */
+    cat_slab_destroy(&CAT_EVENT_G(slab));
+
+    return error == 0;
 }
 
 CAT_API void cat_event_schedule(void)
@@ -153,9 +157,14 @@ CAT_API cat_coroutine_t *cat_event_scheduler_close(void)
     return cat_coroutine_scheduler_close();
 }
 
+CAT_API cat_slab_stats_t *cat_event_get_slab_stats(cat_slab_stats_t *stats)
+{
+    return cat_slab_get_stats(&CAT_EVENT_G(slab), stats);
+}
+
 CAT_API cat_event_shutdown_task_t *cat_event_register_runtime_shutdown_task(cat_event_shutdown_callback_t callback, cat_data_t *data)
 {
-    cat_event_shutdown_task_t *task = (cat_event_shutdown_task_t *) cat_malloc(sizeof(*task));
+    cat_event_shutdown_task_t *task = (cat_event_shutdown_task_t *) cat_event_slab_malloc(sizeof(*task));
 
 #if CAT_ALLOC_HANDLE_ERRORS
     if (unlikely(task == NULL)) {
@@ -173,7 +182,7 @@ CAT_API cat_event_shutdown_task_t *cat_event_register_runtime_shutdown_task(cat_
 CAT_API void cat_event_unregister_runtime_shutdown_task(cat_event_shutdown_task_t *task)
 {
     cat_queue_remove(&task->node);
-    cat_free(task);
+    cat_event_slab_free(task, sizeof(*task));
 }
 
 static void cat_event_loop_defer_task_callback(uv_timer_t *timer)
@@ -187,7 +196,7 @@ static void cat_event_loop_defer_task_callback(uv_timer_t *timer)
 static void cat_event_loop_defer_task_free_callback(uv_handle_t *handle)
 {
     cat_event_loop_defer_task_t *task = cat_container_of(handle, cat_event_loop_defer_task_t, u.handle);
-    cat_free(task);
+    cat_event_slab_free(task, sizeof(*task));
 }
 
 CAT_API cat_event_loop_defer_task_t *cat_event_loop_defer_task_create(
@@ -195,7 +204,12 @@ CAT_API cat_event_loop_defer_task_t *cat_event_loop_defer_task_create(
     cat_data_t *data
 ) {
     cat_event_loop_defer_task_t *task;
-    task = (cat_event_loop_defer_task_t *) cat_malloc_unrecoverable(sizeof(*task));
+    task = (cat_event_loop_defer_task_t *) cat_event_slab_malloc(sizeof(*task));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(task == NULL)) {
+        cat_out_of_memory();
+    }
+#endif
     task->callback = callback;
     task->u.data = data;
     (void) uv_timer_init(&CAT_EVENT_G(loop), &task->u.timer);
@@ -229,7 +243,12 @@ CAT_API cat_event_io_defer_task_t *cat_event_io_defer_task_create(
     cat_event_io_defer_callback_t callback,
     cat_data_t *data
 ) {
-    cat_event_io_defer_task_t *task = (cat_event_io_defer_task_t *) cat_malloc_unrecoverable(sizeof(*task));
+    cat_event_io_defer_task_t *task = (cat_event_io_defer_task_t *) cat_event_slab_malloc(sizeof(*task));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(task == NULL)) {
+        cat_out_of_memory();
+    }
+#endif
     task->callback = callback;
     task->data = data;
     cat_queue_push_back(&CAT_EVENT_G(io_defer_tasks), &task->node);
@@ -243,7 +262,7 @@ CAT_API cat_bool_t cat_event_io_defer_task_close(cat_event_io_defer_task_t *task
     if (!called) {
         cat_queue_remove(&task->node);
     }
-    cat_free(task);
+    cat_event_slab_free(task, sizeof(*task));
     return called;
 }
 
@@ -92,7 +92,7 @@ static cat_bool_t cat_fs_do_result(cat_fs_context_t *context, int error, const c
         cat_update_last_error_with_reason(error, "File-System %s init failed", operation);
         errno = cat_orig_errno(cat_get_last_error_code());
         // CAT_LOG_DEBUG(FS, "Failed uv_fs_%s context=%p, uv_errno=%d", operation, context, error);
-        cat_free(context);
+        cat_event_slab_free(context, sizeof(*context));
         return cat_false;
     }
     context->coroutine = CAT_COROUTINE_G(current);
@@ -125,7 +125,7 @@ static cat_bool_t cat_fs_do_result(cat_fs_context_t *context, int error, const c
 }
 
 #define CAT_FS_DO_RESULT_EX(on_fail, on_done, operation, ...) do { \
-    cat_fs_context_t *context = (cat_fs_context_t *) cat_malloc(sizeof(*context)); \
+    cat_fs_context_t *context = (cat_fs_context_t *) cat_event_slab_malloc(sizeof(*context)); \
     if (unlikely(context == NULL)) { \
         cat_update_last_error_of_syscall("Malloc for file-system context failed"); \
         errno = ENOMEM; \
@@ -153,9 +153,705 @@ static void cat_fs_callback(uv_fs_t *fs)
     }
 
     uv_fs_req_cleanup(&context->fs);
-    cat_free(context);
+    cat_event_slab_free(context, sizeof(*context));
 }
 
+/* io_uring engine */
+
+#ifdef CAT_FS_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+
+#ifndef AT_EMPTY_PATH
+# define AT_EMPTY_PATH 0x1000
+#endif
+
+#define CAT_FS_IO_URING_SQ_ENTRIES 256
+/* completions of requests in flight must always fit in the CQ,
+ * requests over it are done by the thread pool */
+#define CAT_FS_IO_URING_CQ_ENTRIES 4096
+
+typedef enum cat_fs_io_uring_state_e {
+    CAT_FS_IO_URING_STATE_UNKNOWN = 0,
+    CAT_FS_IO_URING_STATE_READY,
+    CAT_FS_IO_URING_STATE_UNAVAILABLE,
+} cat_fs_io_uring_state_t;
+
+typedef struct cat_fs_io_uring_s {
+    int fd;
+    /* submission queue */
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int sq_mask;
+    unsigned int sq_entries;
+    unsigned int *sq_array;
+    struct io_uring_sqe *sqes;
+    /* completion queue */
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int cq_mask;
+    unsigned int cq_entries;
+    struct io_uring_cqe *cqes;
+    /* mappings */
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    /* sqes which have not been submitted yet */
+    unsigned int sq_pending;
+    /* errno of the persistent submit failure */
+    int error;
+    /* requests which have not been completed yet */
+    unsigned int inflight;
+    /* coroutines waiting for completions, they keep the event loop alive */
+    unsigned int waiter_count;
+    /* supported ops (IORING_OP_READ/WRITE without offset also need IORING_FEAT_RW_CUR_POS) */
+    uint64_t ops;
+    /* it submits sqes before the event loop blocks, so they are batched per round */
+    uv_prepare_t flusher;
+    /* ring fd is readable when there are completions */
+    uv_poll_t poller;
+    uint8_t handle_count;
+} cat_fs_io_uring_t;
+
+/* same as struct statx, but it never conflicts with the one from libc */
+typedef struct cat_fs_statx_timestamp_s {
+    int64_t tv_sec;
+    uint32_t tv_nsec;
+    int32_t unused0;
+} cat_fs_statx_timestamp_t;
+
+typedef struct cat_fs_statx_s {
+    uint32_t stx_mask;
+    uint32_t stx_blksize;
+    uint64_t stx_attributes;
+    uint32_t stx_nlink;
+    uint32_t stx_uid;
+    uint32_t stx_gid;
+    uint16_t stx_mode;
+    uint16_t unused0;
+    uint64_t stx_ino;
+    uint64_t stx_size;
+    uint64_t stx_blocks;
+    uint64_t stx_attributes_mask;
+    cat_fs_statx_timestamp_t stx_atime;
+    cat_fs_statx_timestamp_t stx_btime;
+    cat_fs_statx_timestamp_t stx_ctime;
+    cat_fs_statx_timestamp_t stx_mtime;
+    uint32_t stx_rdev_major;
+    uint32_t stx_rdev_minor;
+    uint32_t stx_dev_major;
+    uint32_t stx_dev_minor;
+    uint64_t unused1[14];
+} cat_fs_statx_t;
+
+typedef struct cat_fs_io_uring_context_s {
+    cat_coroutine_t *coroutine;
+    uint32_t size;
+    int32_t result;
+} cat_fs_io_uring_context_t;
+
+typedef struct cat_fs_io_uring_stat_context_s {
+    cat_fs_io_uring_context_t context;
+    cat_fs_statx_t statx;
+} cat_fs_io_uring_stat_context_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_fs) {
+    cat_fs_io_uring_state_t io_uring_state;
+    cat_fs_io_uring_t *io_uring;
+} CAT_GLOBALS_STRUCT_END(cat_fs);
+
+CAT_GLOBALS_DECLARE(cat_fs);
+
+#define CAT_FS_G(x) CAT_GLOBALS_GET(cat_fs, x)
+
+static int cat_fs_io_uring_setup(unsigned int entries, struct io_uring_params *params)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int cat_fs_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+    return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int cat_fs_io_uring_register(int fd, unsigned int opcode, void *arg, unsigned int nr_args)
+{
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void cat_fs_io_uring_free(cat_fs_io_uring_t *ring)
+{
+    if (ring->sqes != NULL) {
+        (void) munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring) {
+        (void) munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL) {
+        (void) munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->fd != -1) {
+        (void) close(ring->fd);
+    }
+    cat_free(ring);
+}
+
+static void cat_fs_io_uring_close_callback(uv_handle_t *handle)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) handle->data;
+
+    if (--ring->handle_count == 0) {
+        cat_fs_io_uring_free(ring);
+    }
+}
+
+static void cat_fs_io_uring_close(cat_fs_io_uring_t *ring)
+{
+    CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") close with %u requests in flight", ring->fd, ring->inflight);
+    uv_close((uv_handle_t *) &ring->flusher, cat_fs_io_uring_close_callback);
+    uv_close((uv_handle_t *) &ring->poller, cat_fs_io_uring_close_callback);
+}
+
+static int cat_fs_io_uring_submit(cat_fs_io_uring_t *ring)
+{
+    while (ring->sq_pending > 0) {
+        int n = cat_fs_io_uring_enter(ring->fd, ring->sq_pending, 0, 0);
+        if (unlikely(n < 0)) {
+            if (errno == EINTR) {
+                continue;
+            }
+            /* EAGAIN/EBUSY: the kernel is short of resources or completions,
+             * pending sqes are kept and submitted in the next round,
+             * otherwise the ring is broken, pending sqes will never be submitted */
+            if (errno != EAGAIN && errno != EBUSY) {
+                ring->error = errno;
+            }
+            CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") submit failed, errno=%d", ring->fd, errno);
+            return -1;
+        }
+        ring->sq_pending -= (unsigned int) n;
+    }
+    return 0;
+}
+
+static void cat_fs_io_uring_complete(cat_fs_io_uring_context_t *context, int32_t result)
+{
+    if (context->coroutine != NULL) {
+        cat_coroutine_t *coroutine = context->coroutine;
+        context->coroutine = NULL;
+        context->result = result;
+        cat_coroutine_schedule(coroutine, FS, "File-System");
+        /* waiter frees the context */
+        return;
+    }
+    /* waiter has gone */
+    cat_event_slab_free(context, context->size);
+}
+
+static void cat_fs_io_uring_update_ref(cat_fs_io_uring_t *ring)
+{
+    if (ring->waiter_count > 0) {
+        uv_ref((uv_handle_t *) &ring->poller);
+    } else {
+        uv_unref((uv_handle_t *) &ring->poller);
+    }
+}
+
+static void cat_fs_io_uring_poll_callback(uv_poll_t *poller, int status, int events)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) poller->data;
+    (void) status;
+    (void) events;
+
+    while (1) {
+        unsigned int head = *ring->cq_head;
+        if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+        cat_fs_io_uring_context_t *context = (cat_fs_io_uring_context_t *) (uintptr_t) cqe->user_data;
+        int32_t result = cqe->res;
+        /* release the cqe before resuming, the coroutine may submit new requests */
+        __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+        ring->inflight--;
+        cat_fs_io_uring_complete(context, result);
+    }
+}
+
+/* pending sqes are taken back from the sq and their waiters are resumed with the error,
+ * it must be called in the scheduler */
+static void cat_fs_io_uring_fail_pending(cat_fs_io_uring_t *ring, int error)
+{
+    unsigned int tail = *ring->sq_tail;
+    unsigned int head = tail - ring->sq_pending;
+
+    CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") fails %u pending requests, errno=%d", ring->fd, ring->sq_pending, error);
+    __atomic_store_n(ring->sq_tail, head, __ATOMIC_RELEASE);
+    ring->sq_pending = 0;
+    for (; head != tail; head++) {
+        struct io_uring_sqe *sqe = &ring->sqes[ring->sq_array[head & ring->sq_mask]];
+        ring->inflight--;
+        cat_fs_io_uring_complete((cat_fs_io_uring_context_t *) (uintptr_t) sqe->user_data, -error);
+    }
+}
+
+static void cat_fs_io_uring_flush_callback(uv_prepare_t *flusher)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) flusher->data;
+
+    if (ring->sq_pending > 0 && cat_fs_io_uring_submit(ring) != 0 && ring->error != 0) {
+        /* new requests go to the thread pool, requests in flight are still reaped by the poller */
+        CAT_FS_G(io_uring_state) = CAT_FS_IO_URING_STATE_UNAVAILABLE;
+        cat_fs_io_uring_fail_pending(ring, ring->error);
+    }
+}
+
+static cat_fs_io_uring_t *cat_fs_io_uring_create(void)
+{
+    static const uint8_t required_ops[] = {
+        IORING_OP_READ, IORING_OP_WRITE, IORING_OP_OPENAT,
+        IORING_OP_CLOSE, IORING_OP_STATX, IORING_OP_FSYNC,
+    };
+    struct io_uring_params params;
+    struct io_uring_probe *probe;
+    cat_fs_io_uring_t *ring;
+    size_t probe_size;
+    int fd, error;
+
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = CAT_FS_IO_URING_CQ_ENTRIES;
+    fd = cat_fs_io_uring_setup(CAT_FS_IO_URING_SQ_ENTRIES, &params);
+    if (fd < 0) {
+        /* ENOSYS: not supported, EPERM: disabled (e.g. by sysctl or seccomp), ENOMEM: RLIMIT_MEMLOCK on old kernels */
+        CAT_LOG_DEBUG(FS, "io_uring setup failed, errno=%d", errno);
+        return NULL;
+    }
+    ring = (cat_fs_io_uring_t *) cat_malloc(sizeof(*ring));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(ring == NULL)) {
+        (void) close(fd);
+        return NULL;
+    }
+#endif
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = fd;
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        goto _unavailable;
+    }
+    /* map rings */
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->sq_ring_size = ring->cq_ring_size = CAT_MAX(ring->sq_ring_size, ring->cq_ring_size);
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        ring->sq_ring = NULL;
+        goto _unavailable;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            ring->cq_ring = NULL;
+            goto _unavailable;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *) mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        goto _unavailable;
+    }
+    ring->sq_head = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.head);
+    ring->sq_tail = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = *(unsigned int *) ((char *) ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_array = (unsigned int *) ((char *) ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (unsigned int *) ((char *) ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned int *) ((char *) ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = *(unsigned int *) ((char *) ring->cq_ring + params.cq_off.ring_mask);
+    ring->cq_entries = params.cq_entries;
+    ring->cqes = (struct io_uring_cqe *) ((char *) ring->cq_ring + params.cq_off.cqes);
+    /* probe ops */
+    probe_size = sizeof(*probe) + (IORING_OP_LAST * sizeof(struct io_uring_probe_op));
+    probe = (struct io_uring_probe *) cat_malloc(probe_size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(probe == NULL)) {
+        goto _unavailable;
+    }
+#endif
+    memset(probe, 0, probe_size);
+    error = cat_fs_io_uring_register(fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST);
+    if (error == 0) {
+        size_t n;
+        for (n = 0; n < probe->ops_len; n++) {
+            if ((probe->ops[n].flags & IO_URING_OP_SUPPORTED) && probe->ops[n].op < 64) {
+                ring->ops |= UINT64_C(1) << probe->ops[n].op;
+            }
+        }
+    }
+    cat_free(probe);
+    if (error != 0) {
+        goto _unavailable;
+    }
+    for (size_t n = 0; n < CAT_ARRAY_SIZE(required_ops); n++) {
+        if (!(ring->ops & (UINT64_C(1) << required_ops[n]))) {
+            goto _unavailable;
+        }
+    }
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        /* read()/write() without offset are done by the thread pool */
+        ring->ops &= ~((UINT64_C(1) << IORING_OP_READ) | (UINT64_C(1) << IORING_OP_WRITE));
+    }
+    /* event loop handles */
+    (void) uv_prepare_init(&CAT_EVENT_G(loop), &ring->flusher);
+    ring->flusher.data = ring;
+    (void) uv_prepare_start(&ring->flusher, cat_fs_io_uring_flush_callback);
+    uv_unref((uv_handle_t *) &ring->flusher);
+    ring->handle_count++;
+    error = uv_poll_init(&CAT_EVENT_G(loop), &ring->poller, fd);
+    if (unlikely(error != 0)) {
+        uv_close((uv_handle_t *) &ring->flusher, cat_fs_io_uring_close_callback);
+        CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") poll init failed, error=%d", fd, error);
+        return NULL;
+    }
+    ring->poller.data = ring;
+    ring->handle_count++;
+    (void) uv_poll_start(&ring->poller, UV_READABLE, cat_fs_io_uring_poll_callback);
+    uv_unref((uv_handle_t *) &ring->poller);
+    CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") created with sq_entries=%u, cq_entries=%u, features=0x%x",
+        fd, ring->sq_entries, ring->cq_entries, params.features);
+
+    return ring;
+
+    _unavailable:
+    CAT_LOG_DEBUG(FS, "io_uring(" CAT_OS_FD_FMT ") is unavailable, features=0x%x", fd, params.features);
+    cat_fs_io_uring_free(ring);
+    return NULL;
+}
+
+static cat_fs_io_uring_t *cat_fs_io_uring_get(void)
+{
+    cat_fs_io_uring_t *ring = CAT_FS_G(io_uring);
+
+    if (likely(CAT_FS_G(io_uring_state) != CAT_FS_IO_URING_STATE_UNKNOWN)) {
+        return CAT_FS_G(io_uring_state) == CAT_FS_IO_URING_STATE_READY ? ring : NULL;
+    }
+    if (cat_env_is_true("CAT_FS_IO_URING", cat_true)) {
+        ring = cat_fs_io_uring_create();
+    }
+    CAT_FS_G(io_uring) = ring;
+    CAT_FS_G(io_uring_state) = ring != NULL ? CAT_FS_IO_URING_STATE_READY : CAT_FS_IO_URING_STATE_UNAVAILABLE;
+
+    return ring;
+}
+
+/* it returns NULL if the op should be done by the thread pool */
+static struct io_uring_sqe *cat_fs_io_uring_get_sqe(uint8_t opcode, size_t context_size, cat_fs_io_uring_context_t **context_ptr)
+{
+    cat_fs_io_uring_t *ring = cat_fs_io_uring_get();
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+    unsigned int tail, index;
+
+    if (ring == NULL || !(ring->ops & (UINT64_C(1) << opcode)) || unlikely(ring->error != 0)) {
+        return NULL;
+    }
+    if (unlikely(ring->inflight >= ring->cq_entries)) {
+        return NULL;
+    }
+    tail = *ring->sq_tail;
+    if (unlikely(tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries)) {
+        /* sq is full, submit them right now */
+        if (cat_fs_io_uring_submit(ring) != 0 ||
+            tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+            return NULL;
+        }
+    }
+    context = (cat_fs_io_uring_context_t *) cat_event_slab_malloc(context_size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(context == NULL)) {
+        return NULL;
+    }
+#endif
+    context->coroutine = NULL;
+    context->size = (uint32_t) context_size;
+    context->result = 0;
+    index = tail & ring->sq_mask;
+    sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->user_data = (uint64_t) (uintptr_t) context;
+    ring->sq_array[index] = index;
+    *context_ptr = context;
+
+    return sqe;
+}
+
+static cat_bool_t cat_fs_io_uring_wait(cat_fs_io_uring_context_t *context, const char *operation)
+{
+    cat_fs_io_uring_t *ring = CAT_FS_G(io_uring);
+    cat_bool_t ret;
+
+    /* publish the sqe, it is submitted before the event loop blocks */
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+    ring->sq_pending++;
+    ring->inflight++;
+    if (ring->waiter_count++ == 0) {
+        cat_fs_io_uring_update_ref(ring);
+    }
+    context->coroutine = CAT_COROUTINE_G(current);
+    ret = cat_time_wait(CAT_TIMEOUT_FOREVER);
+    if (--ring->waiter_count == 0) {
+        cat_fs_io_uring_update_ref(ring);
+    }
+    if (unlikely(context->coroutine != NULL)) {
+        /* the request is still in flight, make sure that the kernel has consumed its arguments (e.g. path),
+         * then detach it, the context will be freed when it is completed */
+        context->coroutine = NULL;
+        (void) cat_fs_io_uring_submit(ring);
+        if (unlikely(!ret)) {
+            cat_update_last_error_with_previous("File-System %s wait failed", operation);
+        } else {
+            cat_update_last_error(CAT_ECANCELED, "File-System %s has been canceled", operation);
+        }
+        errno = cat_orig_errno(cat_get_last_error_code());
+        return cat_false;
+    }
+    if (unlikely(context->result < 0)) {
+        cat_update_last_error_with_reason((cat_errno_t) context->result, "File-System %s failed", operation);
+        errno = cat_orig_errno((cat_errno_t) context->result);
+        cat_event_slab_free(context, context->size);
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+/* it returns CAT_EAGAIN if the op should be done by the thread pool, otherwise result of the op */
+static ssize_t cat_fs_io_uring_rw(uint8_t opcode, cat_file_t fd, const void *buffer, size_t size, uint64_t offset, const char *operation)
+{
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+    ssize_t n;
+
+    sqe = cat_fs_io_uring_get_sqe(opcode, sizeof(*context), &context);
+    if (sqe == NULL) {
+        return CAT_EAGAIN;
+    }
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) buffer;
+    sqe->len = (uint32_t) CAT_MIN(size, INT32_MAX);
+    sqe->off = offset;
+    if (!cat_fs_io_uring_wait(context, operation)) {
+        return -1;
+    }
+    n = context->result;
+    cat_event_slab_free(context, context->size);
+
+    return n;
+}
+
+static int cat_fs_io_uring_fsync(cat_file_t fd, uint32_t flags, const char *operation)
+{
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+
+    sqe = cat_fs_io_uring_get_sqe(IORING_OP_FSYNC, sizeof(*context), &context);
+    if (sqe == NULL) {
+        return CAT_EAGAIN;
+    }
+    sqe->fd = fd;
+    sqe->fsync_flags = flags;
+    if (!cat_fs_io_uring_wait(context, operation)) {
+        return -1;
+    }
+    cat_event_slab_free(context, context->size);
+
+    return 0;
+}
+
+static cat_file_t cat_fs_io_uring_open(const char *path, cat_fs_open_flags_t flags, int mode)
+{
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+    cat_file_t fd;
+
+    sqe = cat_fs_io_uring_get_sqe(IORING_OP_OPENAT, sizeof(*context), &context);
+    if (sqe == NULL) {
+        return CAT_EAGAIN;
+    }
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) (uintptr_t) path;
+    sqe->len = (uint32_t) mode;
+    /* same as libuv */
+    sqe->open_flags = (uint32_t) (flags | O_CLOEXEC);
+    if (!cat_fs_io_uring_wait(context, "open")) {
+        return -1;
+    }
+    fd = context->result;
+    cat_event_slab_free(context, context->size);
+
+    return fd;
+}
+
+static int cat_fs_io_uring_close_file(cat_file_t fd)
+{
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+
+    sqe = cat_fs_io_uring_get_sqe(IORING_OP_CLOSE, sizeof(*context), &context);
+    if (sqe == NULL) {
+        return CAT_EAGAIN;
+    }
+    sqe->fd = fd;
+    if (!cat_fs_io_uring_wait(context, "close")) {
+        return -1;
+    }
+    cat_event_slab_free(context, context->size);
+
+    return 0;
+}
+
+static int cat_fs_io_uring_stat(cat_file_t fd, const char *path, uint32_t flags, cat_stat_t *statbuf, const char *operation)
+{
+    cat_fs_io_uring_stat_context_t *stat_context;
+    cat_fs_io_uring_context_t *context;
+    struct io_uring_sqe *sqe;
+    cat_fs_statx_t *statx;
+
+    sqe = cat_fs_io_uring_get_sqe(IORING_OP_STATX, sizeof(*stat_context), &context);
+    if (sqe == NULL) {
+        return CAT_EAGAIN;
+    }
+    stat_context = cat_container_of(context, cat_fs_io_uring_stat_context_t, context);
+    statx = &stat_context->statx;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) path;
+    sqe->len = 0xfff; /* STATX_BASIC_STATS | STATX_BTIME */
+    sqe->off = (uint64_t) (uintptr_t) statx;
+    sqe->statx_flags = flags;
+    if (!cat_fs_io_uring_wait(context, operation)) {
+        return -1;
+    }
+    /* same as uv__fs_statx() */
+    statbuf->st_dev = makedev(statx->stx_dev_major, statx->stx_dev_minor);
+    statbuf->st_mode = statx->stx_mode;
+    statbuf->st_nlink = statx->stx_nlink;
+    statbuf->st_uid = statx->stx_uid;
+    statbuf->st_gid = statx->stx_gid;
+    statbuf->st_rdev = makedev(statx->stx_rdev_major, statx->stx_rdev_minor);
+    statbuf->st_ino = statx->stx_ino;
+    statbuf->st_size = statx->stx_size;
+    statbuf->st_blksize = statx->stx_blksize;
+    statbuf->st_blocks = statx->stx_blocks;
+    statbuf->st_atim.tv_sec = statx->stx_atime.tv_sec;
+    statbuf->st_atim.tv_nsec = statx->stx_atime.tv_nsec;
+    statbuf->st_mtim.tv_sec = statx->stx_mtime.tv_sec;
+    statbuf->st_mtim.tv_nsec = statx->stx_mtime.tv_nsec;
+    statbuf->st_ctim.tv_sec = statx->stx_ctime.tv_sec;
+    statbuf->st_ctim.tv_nsec = statx->stx_ctime.tv_nsec;
+    statbuf->st_birthtim.tv_sec = statx->stx_btime.tv_sec;
+    statbuf->st_birthtim.tv_nsec = statx->stx_btime.tv_nsec;
+    statbuf->st_flags = 0;
+    statbuf->st_gen = 0;
+    cat_event_slab_free(context, context->size);
+
+    return 0;
+}
+
+/* try io_uring first, fall back to the thread pool if it returns CAT_EAGAIN */
+#define CAT_FS_IO_URING_TRY(type, expression) do { \
+    type _ret = (type) (expression); \
+    if (_ret != (type) CAT_EAGAIN) { \
+        return _ret; \
+    } \
+} while (0)
+
+#else
+#define CAT_FS_IO_URING_TRY(type, expression)
+#endif /* CAT_FS_IO_URING */
+
+CAT_API cat_bool_t cat_fs_module_init(void)
+{
+#ifdef CAT_FS_IO_URING
+    CAT_GLOBALS_REGISTER(cat_fs);
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_fs_module_shutdown(void)
+{
+#ifdef CAT_FS_IO_URING
+    CAT_GLOBALS_UNREGISTER(cat_fs);
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_fs_runtime_init(void)
+{
+#ifdef CAT_FS_IO_URING
+    /* ring is created lazily */
+    CAT_FS_G(io_uring_state) = CAT_FS_IO_URING_STATE_UNKNOWN;
+    CAT_FS_G(io_uring) = NULL;
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_fs_runtime_shutdown(void)
+{
+#ifdef CAT_FS_IO_URING
+    if (CAT_FS_G(io_uring) != NULL) {
+        cat_fs_io_uring_close(CAT_FS_G(io_uring));
+        CAT_FS_G(io_uring) = NULL;
+    }
+    CAT_FS_G(io_uring_state) = CAT_FS_IO_URING_STATE_UNKNOWN;
+#endif
+    return cat_true;
+}
+
+CAT_API void cat_fs_fork(void)
+{
+#ifdef CAT_FS_IO_URING
+    /* ring is shared with the parent process, child process creates its own one */
+    if (CAT_FS_G(io_uring) != NULL) {
+        cat_fs_io_uring_close(CAT_FS_G(io_uring));
+        CAT_FS_G(io_uring) = NULL;
+    }
+    CAT_FS_G(io_uring_state) = CAT_FS_IO_URING_STATE_UNKNOWN;
+#endif
+}
+
+CAT_API cat_fs_engine_t cat_fs_get_engine(void)
+{
+#ifdef CAT_FS_IO_URING
+    if (cat_fs_io_uring_get() != NULL) {
+        return CAT_FS_ENGINE_IO_URING;
+    }
+#endif
+    return CAT_FS_ENGINE_THREAD_POOL;
+}
+
+CAT_API const char *cat_fs_get_engine_name(void)
+{
+    switch (cat_fs_get_engine()) {
+        case CAT_FS_ENGINE_IO_URING:
+            return "io_uring";
+        case CAT_FS_ENGINE_THREAD_POOL:
+        default:
+            return "thread_pool";
+    }
+}
+
+
 #ifdef CAT_OS_WIN
 # define wrappath(_path, path) \
 char path##buf[(32767/*hard limit*/ + 4/* \\?\ */ + 1/* \0 */)*sizeof(wchar_t)] = {'\\', '\\', '?', '\\'}; \
@@ -415,6 +1111,7 @@ static cat_always_inline cat_file_t cat_fs_open_impl(const char *_path, cat_fs_o
 {
     wrappath(_path, path);
 
+    CAT_FS_IO_URING_TRY(cat_file_t, cat_fs_io_uring_open(path, flags, mode));
     CAT_FS_DO_RESULT(cat_file_t, open, path, flags, mode);
 }
 
@@ -450,6 +1147,7 @@ CAT_API cat_file_t cat_fs_open(const char *path, cat_fs_open_flags_t flags, ...)
 
 static cat_always_inline int cat_fs_close_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_close_file(fd));
     CAT_FS_DO_RESULT(int, close, fd);
 }
 
@@ -490,6 +1188,7 @@ static void cat_fs_read_cb(cat_data_t *ptr)
 
 static cat_always_inline ssize_t cat_fs_read_impl(cat_file_t fd, void *buf, size_t size)
 {
+    CAT_FS_IO_URING_TRY(ssize_t, cat_fs_io_uring_rw(IORING_OP_READ, fd, buf, size, (uint64_t) -1, "read"));
     cat_fs_read_data_t *data = (cat_fs_read_data_t *) cat_malloc(sizeof(*data));
 #if CAT_ALLOC_HANDLE_ERRORS
     if (data == NULL) {
@@ -546,6 +1245,7 @@ static void cat_fs_write_cb(cat_data_t *ptr)
 
 static cat_always_inline ssize_t cat_fs_write_impl(cat_file_t fd, const void *buf, size_t length)
 {
+    CAT_FS_IO_URING_TRY(ssize_t, cat_fs_io_uring_rw(IORING_OP_WRITE, fd, buf, length, (uint64_t) -1, "write"));
     cat_fs_write_data_t *data = (cat_fs_write_data_t *) cat_malloc(sizeof(*data));
 #if CAT_ALLOC_HANDLE_ERRORS
     if (data == NULL) {
@@ -589,6 +1289,7 @@ static cat_always_inline ssize_t cat_fs_pread_impl(cat_file_t fd, void *buffer,
 {
     uv_buf_t buf = uv_buf_init((char *) buffer, (unsigned int) size);
 
+    CAT_FS_IO_URING_TRY(ssize_t, cat_fs_io_uring_rw(IORING_OP_READ, fd, buffer, size, (uint64_t) offset, "pread"));
     CAT_FS_DO_RESULT(ssize_t, read, fd, &buf, 1, offset);
 }
 
@@ -615,6 +1316,7 @@ static cat_always_inline ssize_t cat_fs_pwrite_impl(cat_file_t fd, const void *b
 {
     uv_buf_t buf = uv_buf_init((char *) buffer, (unsigned int) length);
 
+    CAT_FS_IO_URING_TRY(ssize_t, cat_fs_io_uring_rw(IORING_OP_WRITE, fd, buffer, length, (uint64_t) offset, "pwrite"));
     CAT_FS_DO_RESULT(ssize_t, write, fd, &buf, 1, offset);
 }
 
@@ -687,6 +1389,7 @@ CAT_API off_t cat_fs_lseek(cat_file_t fd, off_t offset, int whence)
 
 static cat_always_inline int cat_fs_fsync_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_fsync(fd, 0, "fsync"));
     CAT_FS_DO_RESULT(int, fsync, fd);
 }
 
@@ -701,6 +1404,7 @@ CAT_API int cat_fs_fsync(cat_file_t fd)
 
 static cat_always_inline int cat_fs_fdatasync_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_fsync(fd, IORING_FSYNC_DATASYNC, "fdatasync"));
     CAT_FS_DO_RESULT(int, fdatasync, fd);
 }
 
@@ -911,6 +1615,7 @@ CAT_API int cat_fs_access(const char *path, int mode)
 static cat_always_inline int cat_fs_stat_impl(const char *_path, cat_stat_t *statbuf)
 {
     wrappath(_path, path);
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_stat(AT_FDCWD, path, 0, statbuf, "stat"));
     CAT_FS_DO_STAT(stat, path);
 }
 
@@ -927,6 +1632,7 @@ CAT_API int cat_fs_stat(const char *path, cat_stat_t *statbuf)
 static cat_always_inline int cat_fs_lstat_impl(const char *_path, cat_stat_t *statbuf)
 {
     wrappath(_path, path);
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_stat(AT_FDCWD, path, AT_SYMLINK_NOFOLLOW, statbuf, "lstat"));
     CAT_FS_DO_STAT(lstat, path);
 }
 
@@ -942,6 +1648,7 @@ CAT_API int cat_fs_lstat(const char *path, cat_stat_t *statbuf)
 
 static cat_always_inline int cat_fs_fstat_impl(cat_file_t fd, cat_stat_t *statbuf)
 {
+    CAT_FS_IO_URING_TRY(int, cat_fs_io_uring_stat(fd, "", AT_EMPTY_PATH, statbuf, "fstat"));
     CAT_FS_DO_STAT(fstat, fd);
 }
 
@@ -1277,15 +1984,23 @@ CAT_API const char *cat_fs_mkdtemp(const char *tpl)
     return path;
 }
 
-static cat_always_inline int cat_fs_mkstemp_impl(const char *_tpl)
+static cat_always_inline int cat_fs_mkstemp_impl(char *_tpl)
 {
     wrappath(_tpl, tpl);
     CAT_FS_DO_RESULT_EX({return -1;}, {
+        if (context->fs.result >= 0) {
+            /* libuv works on a copy of the template */
+            size_t tpl_length = strlen(_tpl);
+            size_t path_length = strlen(context->fs.path);
+            if (tpl_length >= 6 && path_length >= 6) {
+                memcpy(_tpl + tpl_length - 6, context->fs.path + path_length - 6, 6);
+            }
+        }
         return (int) context->fs.result;
     }, mkstemp, tpl);
 }
 
-CAT_API int cat_fs_mkstemp(const char *tpl)
+CAT_API int cat_fs_mkstemp(char *tpl)
 {
     int fd;
     CAT_LOG_DEBUG(FS, "mkstemp(\"%s\") = " CAT_LOG_UNFINISHED_STR, tpl);
@@ -1671,7 +2386,7 @@ static void cat_fs_async_closedir(void *ptr)
         return;
     }
     dir->dir = ptr;
-    cat_fs_context_t *context = (cat_fs_context_t *) cat_malloc(sizeof(*context));
+    cat_fs_context_t *context = (cat_fs_context_t *) cat_event_slab_malloc(sizeof(*context));
 #if CAT_ALLOC_HANDLE_ERRORS
     if (context == NULL) {
         goto _malloc_context_error;
@@ -1683,7 +2398,7 @@ static void cat_fs_async_closedir(void *ptr)
     }
     return;
     _closedir_error:
-    cat_free(context);
+    cat_event_slab_free(context, sizeof(*context));
 #if CAT_ALLOC_HANDLE_ERRORS
     _malloc_context_error:
 #endif
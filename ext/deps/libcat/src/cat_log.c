@@ -24,6 +24,11 @@
 
 #include "cat_buffer.h"
 #include "cat_coroutine.h" /* for coroutine id (TODO: need to decouple it?) */
+#include "cat_atomic.h"
+
+#ifndef CAT_OS_WIN
+#include <sys/uio.h> /* writev */
+#endif
 
 CAT_API cat_log_t cat_log_function;
 
@@ -230,7 +235,7 @@ static cat_bool_t cat_log_fwrite_syscall_impl(FILE *file, const char *str, size_
     return cat_true;
 }
 
-CAT_API cat_bool_t cat_log_fwrite(FILE *file, const char *str, size_t length)
+static cat_bool_t cat_log_fwrite_sync(FILE *file, const char *str, size_t length)
 {
     if (likely(!cat_log_fwrite_use_libc_impl)) {
         return cat_log_fwrite_syscall_impl(file, str, length);
@@ -239,6 +244,449 @@ CAT_API cat_bool_t cat_log_fwrite(FILE *file, const char *str, size_t length)
     }
 }
 
+/* async log */
+
+#define CAT_LOG_ASYNC_MIN_BUFFER_SIZE    (4 * 1024)
+#define CAT_LOG_ASYNC_MAX_BUFFER_SIZE    (1024 * 1024 * 1024)
+#define CAT_LOG_ASYNC_RECORD_ALIGNMENT   8
+#define CAT_LOG_ASYNC_RECORD_WRAP        UINT32_MAX
+#define CAT_LOG_ASYNC_BATCH_MAX_COUNT    64
+
+/* each record is a header followed by the log message, the ring buffer is only
+ * written by the owner thread (producer) and only read by the background thread (consumer),
+ * head and tail are offsets which never wrap, so the used size is always (tail - head) */
+typedef struct cat_log_async_record_s {
+    /* length of message, or CAT_LOG_ASYNC_RECORD_WRAP means the rest of buffer is skipped */
+    uint32_t length;
+    int32_t fd;
+} cat_log_async_record_t;
+
+struct cat_log_async_s {
+    char *buffer;
+    size_t size;
+    cat_log_async_backpressure_t backpressure;
+    unsigned int sample_rate;
+    unsigned int sample_count;
+    /* only updated by consumer */
+    cat_atomic_uint64_t head;
+    /* only updated by producer */
+    cat_atomic_uint64_t tail;
+    cat_atomic_bool_t sleeping;
+    cat_atomic_bool_t stop;
+    uv_mutex_t mutex;
+    /* wake up the background thread */
+    uv_cond_t cond;
+    /* broadcast after each batch was written */
+    uv_cond_t drained;
+    uv_thread_t thread;
+    /* stats of producer */
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t dropped;
+    uint64_t sampled_out;
+    uint64_t blocked;
+    uint64_t direct;
+    /* stats of consumer */
+    cat_atomic_uint64_t batches;
+    cat_atomic_uint64_t write_errors;
+};
+
+static cat_always_inline size_t cat_log_async_record_size(size_t length)
+{
+    return CAT_MEMORY_ALIGNED_SIZE_EX(sizeof(cat_log_async_record_t) + length, CAT_LOG_ASYNC_RECORD_ALIGNMENT);
+}
+
+static size_t cat_log_async_align_buffer_size(size_t size)
+{
+    size_t aligned_size = CAT_LOG_ASYNC_MIN_BUFFER_SIZE;
+
+    if (size == 0) {
+        size = CAT_LOG_ASYNC_DEFAULT_BUFFER_SIZE;
+    } else if (size > CAT_LOG_ASYNC_MAX_BUFFER_SIZE) {
+        size = CAT_LOG_ASYNC_MAX_BUFFER_SIZE;
+    }
+    while (aligned_size < size) {
+        aligned_size <<= 1;
+    }
+
+    return aligned_size;
+}
+
+#ifndef CAT_OS_WIN
+static cat_bool_t cat_log_async_writev(int fd, struct iovec *iov, int count)
+{
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (unlikely(n < 0)) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN && cat_log_select_writable(fd)) {
+                continue;
+            }
+            return cat_false;
+        }
+        while (count > 0 && (size_t) n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = ((char *) iov->iov_base) + n;
+            iov->iov_len -= n;
+        }
+    }
+
+    return cat_true;
+}
+#endif
+
+/* write out at most CAT_LOG_ASYNC_BATCH_MAX_COUNT continuous records to the same fd,
+ * return false if there is nothing to do */
+static cat_bool_t cat_log_async_drain(cat_log_async_t *async)
+{
+    uint64_t head = cat_atomic_uint64_load(&async->head);
+    uint64_t tail = cat_atomic_uint64_load(&async->tail);
+    size_t mask = async->size - 1;
+#ifndef CAT_OS_WIN
+    struct iovec iov[CAT_LOG_ASYNC_BATCH_MAX_COUNT];
+#else
+    cat_log_async_record_t *records[CAT_LOG_ASYNC_BATCH_MAX_COUNT];
+#endif
+    int count = 0, fd = -1;
+    cat_bool_t ret = cat_true;
+
+    if (head == tail) {
+        return cat_false;
+    }
+
+    while (head < tail && count < CAT_LOG_ASYNC_BATCH_MAX_COUNT) {
+        size_t offset = (size_t) (head & mask);
+        cat_log_async_record_t *record = (cat_log_async_record_t *) (async->buffer + offset);
+        if (record->length == CAT_LOG_ASYNC_RECORD_WRAP) {
+            head += async->size - offset;
+            continue;
+        }
+        if (count > 0 && record->fd != fd) {
+            break;
+        }
+        fd = record->fd;
+#ifndef CAT_OS_WIN
+        iov[count].iov_base = record + 1;
+        iov[count].iov_len = record->length;
+#else
+        records[count] = record;
+#endif
+        count++;
+        head += cat_log_async_record_size(record->length);
+    }
+
+    if (count > 0) {
+#ifndef CAT_OS_WIN
+        ret = cat_log_async_writev(fd, iov, count);
+#else
+        int i;
+        for (i = 0; i < count && ret; i++) {
+            const char *p = (const char *) (records[i] + 1);
+            const char *pe = p + records[i]->length;
+            while (p < pe) {
+                int n = _write(fd, p, (unsigned int) (pe - p));
+                if (n <= 0) {
+                    ret = cat_false;
+                    break;
+                }
+                p += n;
+            }
+        }
+#endif
+        (void) cat_atomic_uint64_fetch_add(&async->batches, 1);
+        if (unlikely(!ret)) {
+            (void) cat_atomic_uint64_fetch_add(&async->write_errors, 1);
+        }
+    }
+
+    uv_mutex_lock(&async->mutex);
+    cat_atomic_uint64_store(&async->head, head);
+    uv_cond_broadcast(&async->drained);
+    uv_mutex_unlock(&async->mutex);
+
+    return cat_true;
+}
+
+static void cat_log_async_loop(void *arg)
+{
+    cat_log_async_t *async = (cat_log_async_t *) arg;
+
+    while (1) {
+        if (cat_log_async_drain(async)) {
+            continue;
+        }
+        if (cat_atomic_bool_load(&async->stop)) {
+            break;
+        }
+        uv_mutex_lock(&async->mutex);
+        cat_atomic_bool_store(&async->sleeping, cat_true);
+        if (cat_atomic_uint64_load(&async->head) == cat_atomic_uint64_load(&async->tail) &&
+            !cat_atomic_bool_load(&async->stop)) {
+            uv_cond_wait(&async->cond, &async->mutex);
+        }
+        cat_atomic_bool_store(&async->sleeping, cat_false);
+        uv_mutex_unlock(&async->mutex);
+    }
+}
+
+static void cat_log_async_wakeup(cat_log_async_t *async)
+{
+    if (cat_atomic_bool_load(&async->sleeping)) {
+        uv_mutex_lock(&async->mutex);
+        uv_cond_signal(&async->cond);
+        uv_mutex_unlock(&async->mutex);
+    }
+}
+
+/* wait until the consumer has read up to the given offset */
+static void cat_log_async_wait(cat_log_async_t *async, uint64_t offset)
+{
+    uv_mutex_lock(&async->mutex);
+    while (cat_atomic_uint64_load(&async->head) < offset) {
+        uv_cond_signal(&async->cond);
+        uv_cond_wait(&async->drained, &async->mutex);
+    }
+    uv_mutex_unlock(&async->mutex);
+}
+
+/* return false if the record should be written synchronously */
+static cat_bool_t cat_log_async_write(cat_log_async_t *async, FILE *file, const char *str, size_t length)
+{
+    size_t record_size = cat_log_async_record_size(length);
+    uint64_t tail = cat_atomic_uint64_load(&async->tail);
+    size_t offset = (size_t) (tail & (async->size - 1));
+    size_t contiguous_size = async->size - offset;
+    size_t required_size;
+    cat_log_async_record_t *record;
+    int fd = fileno(file);
+
+    if (unlikely(fd < 0 || record_size > async->size / 2)) {
+        cat_log_async_flush();
+        async->direct++;
+        return cat_false;
+    }
+    /* the rest of buffer is skipped if record can not be put in it continuously */
+    required_size = record_size <= contiguous_size ? record_size : contiguous_size + record_size;
+
+    if (async->backpressure == CAT_LOG_ASYNC_BACKPRESSURE_SAMPLE &&
+        (tail - cat_atomic_uint64_load(&async->head)) + required_size > async->size / 4 * 3 &&
+        (++async->sample_count % async->sample_rate) != 0) {
+        async->sampled_out++;
+        return cat_true;
+    }
+    while (unlikely((tail - cat_atomic_uint64_load(&async->head)) + required_size > async->size)) {
+        if (async->backpressure != CAT_LOG_ASYNC_BACKPRESSURE_BLOCK) {
+            async->dropped++;
+            return cat_true;
+        }
+        async->blocked++;
+        cat_log_async_wait(async, tail + required_size - async->size);
+    }
+
+    if (record_size > contiguous_size) {
+        record = (cat_log_async_record_t *) (async->buffer + offset);
+        record->length = CAT_LOG_ASYNC_RECORD_WRAP;
+        record->fd = -1;
+        tail += contiguous_size;
+        offset = 0;
+    }
+    record = (cat_log_async_record_t *) (async->buffer + offset);
+    record->length = (uint32_t) length;
+    record->fd = fd;
+    memcpy(record + 1, str, length);
+    cat_atomic_uint64_store(&async->tail, tail + record_size);
+    async->records++;
+    async->bytes += length;
+
+    cat_log_async_wakeup(async);
+
+    return cat_true;
+}
+
+static cat_bool_t cat_log_async_start(cat_log_async_t *async)
+{
+    int error;
+
+    cat_atomic_bool_init(&async->sleeping, cat_false);
+    cat_atomic_bool_init(&async->stop, cat_false);
+    error = uv_mutex_init(&async->mutex);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Async log init mutex failed");
+        goto _mutex_init_failed;
+    }
+    error = uv_cond_init(&async->cond);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Async log init cond failed");
+        goto _cond_init_failed;
+    }
+    error = uv_cond_init(&async->drained);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Async log init cond failed");
+        goto _drained_init_failed;
+    }
+    error = uv_thread_create(&async->thread, cat_log_async_loop, async);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Async log create thread failed");
+        goto _thread_create_failed;
+    }
+
+    return cat_true;
+
+    _thread_create_failed:
+    uv_cond_destroy(&async->drained);
+    _drained_init_failed:
+    uv_cond_destroy(&async->cond);
+    _cond_init_failed:
+    uv_mutex_destroy(&async->mutex);
+    _mutex_init_failed:
+    return cat_false;
+}
+
+static void cat_log_async_stop(cat_log_async_t *async)
+{
+    uv_mutex_lock(&async->mutex);
+    cat_atomic_bool_store(&async->stop, cat_true);
+    uv_cond_signal(&async->cond);
+    uv_mutex_unlock(&async->mutex);
+    (void) uv_thread_join(&async->thread);
+    uv_cond_destroy(&async->drained);
+    uv_cond_destroy(&async->cond);
+    uv_mutex_destroy(&async->mutex);
+}
+
+CAT_API cat_bool_t cat_log_async_enable(size_t buffer_size, cat_log_async_backpressure_t backpressure, unsigned int sample_rate)
+{
+    cat_log_async_t *async;
+
+    if (CAT_LOG_G(async) != NULL) {
+        cat_log_async_disable();
+    }
+
+    async = (cat_log_async_t *) cat_malloc(sizeof(*async));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(async == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for async log failed");
+        return cat_false;
+    }
+#endif
+    async->size = cat_log_async_align_buffer_size(buffer_size);
+    async->buffer = (char *) cat_malloc(async->size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(async->buffer == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for async log buffer failed");
+        cat_free(async);
+        return cat_false;
+    }
+#endif
+    async->backpressure = backpressure;
+    async->sample_rate = sample_rate > 0 ? sample_rate : 1;
+    async->sample_count = 0;
+    cat_atomic_uint64_init(&async->head, 0);
+    cat_atomic_uint64_init(&async->tail, 0);
+    async->records = 0;
+    async->bytes = 0;
+    async->dropped = 0;
+    async->sampled_out = 0;
+    async->blocked = 0;
+    async->direct = 0;
+    cat_atomic_uint64_init(&async->batches, 0);
+    cat_atomic_uint64_init(&async->write_errors, 0);
+
+    if (unlikely(!cat_log_async_start(async))) {
+        cat_free(async->buffer);
+        cat_free(async);
+        return cat_false;
+    }
+
+    CAT_LOG_G(async) = async;
+
+    return cat_true;
+}
+
+CAT_API void cat_log_async_disable(void)
+{
+    cat_log_async_t *async = CAT_LOG_G(async);
+
+    if (async == NULL) {
+        return;
+    }
+    CAT_LOG_G(async) = NULL;
+    /* background thread exits after all pending records have been written */
+    cat_log_async_stop(async);
+    cat_free(async->buffer);
+    cat_free(async);
+}
+
+CAT_API cat_bool_t cat_log_async_is_enabled(void)
+{
+    return CAT_LOG_G(async) != NULL;
+}
+
+CAT_API void cat_log_async_flush(void)
+{
+    cat_log_async_t *async = CAT_LOG_G(async);
+
+    if (async == NULL) {
+        return;
+    }
+    cat_log_async_wait(async, cat_atomic_uint64_load(&async->tail));
+}
+
+CAT_API void cat_log_async_fork(void)
+{
+    cat_log_async_t *async = CAT_LOG_G(async);
+
+    if (async == NULL) {
+        return;
+    }
+    /* the background thread does not exist in child process,
+     * and the lock may have been held by it when fork() was called */
+    cat_atomic_uint64_store(&async->head, cat_atomic_uint64_load(&async->tail));
+    if (unlikely(!cat_log_async_start(async))) {
+        CAT_LOG_G(async) = NULL;
+        cat_free(async->buffer);
+        cat_free(async);
+    }
+}
+
+CAT_API cat_bool_t cat_log_async_get_stats(cat_log_async_stats_t *stats)
+{
+    cat_log_async_t *async = CAT_LOG_G(async);
+
+    if (async == NULL) {
+        return cat_false;
+    }
+    stats->records = async->records;
+    stats->bytes = async->bytes;
+    stats->batches = cat_atomic_uint64_load(&async->batches);
+    stats->dropped = async->dropped;
+    stats->sampled_out = async->sampled_out;
+    stats->blocked = async->blocked;
+    stats->direct = async->direct;
+    stats->write_errors = cat_atomic_uint64_load(&async->write_errors);
+    stats->buffer_size = async->size;
+    stats->pending_bytes = (size_t) (cat_atomic_uint64_load(&async->tail) - cat_atomic_uint64_load(&async->head));
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_log_fwrite(FILE *file, const char *str, size_t length)
+{
+    cat_log_async_t *async = CAT_LOG_G(async);
+
+    if (async != NULL && cat_log_async_write(async, file, str, length)) {
+        return cat_true;
+    }
+
+    return cat_log_fwrite_sync(file, str, length);
+}
+
 CAT_API void cat_log_va_list_standard(CAT_LOG_VA_LIST_PARAMETERS)
 {
     cat_buffer_t buffer;
@@ -334,7 +782,14 @@ CAT_API void cat_log_va_list_standard(CAT_LOG_VA_LIST_PARAMETERS)
 
     cat_buffer_zero_terminate(&buffer);
 
-    if (!cat_log_fwrite(output, buffer.value, buffer.length)) {
+    if (unlikely(type & (CAT_LOG_TYPE_ERROR | CAT_LOG_TYPE_CORE_ERROR))) {
+        /* process is going to abort, do not leave it in async log buffer */
+        cat_log_async_flush();
+        ret = cat_log_fwrite_sync(output, buffer.value, buffer.length);
+    } else {
+        ret = cat_log_fwrite(output, buffer.value, buffer.length);
+    }
+    if (!ret) {
         goto _error;
     }
 
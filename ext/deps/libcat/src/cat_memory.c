@@ -136,6 +136,86 @@ CAT_API void cat_freep_function(void *ptr)
     cat_free_function(ptr);
 }
 
+/* slab allocator */
+
+struct cat_slab_page_s {
+    cat_slab_page_t *next;
+    /* objects follow, keep them aligned */
+    char padding[CAT_SLAB_ALIGNMENT - sizeof(cat_slab_page_t *)];
+};
+
+CAT_API void cat_slab_init(cat_slab_t *slab)
+{
+    memset(slab, 0, sizeof(*slab));
+}
+
+CAT_API void cat_slab_destroy(cat_slab_t *slab)
+{
+    cat_slab_page_t *page;
+
+    while ((page = slab->pages) != NULL) {
+        slab->pages = page->next;
+        cat_free(page);
+    }
+    cat_slab_init(slab);
+}
+
+CAT_API cat_slab_stats_t *cat_slab_get_stats(const cat_slab_t *slab, cat_slab_stats_t *stats)
+{
+    size_t i;
+
+    stats->page_count = slab->page_count;
+    stats->page_bytes = slab->page_count * CAT_SLAB_PAGE_SIZE;
+    stats->used_bytes = 0;
+    stats->large_count = slab->large_count;
+    for (i = 0; i < CAT_SLAB_CLASS_COUNT; i++) {
+        const cat_slab_class_t *slab_class = &slab->classes[i];
+        cat_slab_class_stats_t *class_stats = &stats->classes[i];
+        class_stats->size = (i + 1) * CAT_SLAB_ALIGNMENT;
+        class_stats->count = slab_class->count;
+        class_stats->free_count = slab_class->free_count;
+        class_stats->page_count = slab_class->page_count;
+        stats->used_bytes += class_stats->size * class_stats->count;
+    }
+
+    return stats;
+}
+
+CAT_API void *cat_slab_malloc_slow(cat_slab_t *slab, size_t size)
+{
+    size_t index = (size - 1) / CAT_SLAB_ALIGNMENT;
+    size_t object_size = (index + 1) * CAT_SLAB_ALIGNMENT;
+    size_t object_count = (CAT_SLAB_PAGE_SIZE - sizeof(cat_slab_page_t)) / object_size;
+    cat_slab_class_t *slab_class = &slab->classes[index];
+    cat_slab_page_t *page;
+    char *objects;
+    size_t i;
+
+    CAT_ASSERT(slab_class->free_list == NULL);
+    page = (cat_slab_page_t *) cat_malloc(CAT_SLAB_PAGE_SIZE);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(page == NULL)) {
+        return NULL;
+    }
+#endif
+    page->next = slab->pages;
+    slab->pages = page;
+    slab->page_count++;
+    slab_class->page_count++;
+
+    /* the first object is returned, link the rest in address order */
+    objects = (char *) (page + 1);
+    for (i = object_count - 1; i > 0; i--) {
+        cat_slab_object_t *object = (cat_slab_object_t *) (objects + i * object_size);
+        object->next = slab_class->free_list;
+        slab_class->free_list = object;
+    }
+    slab_class->free_count += object_count - 1;
+    slab_class->count++;
+
+    return objects;
+}
+
 CAT_API size_t cat_pagesize = 0;
 
 CAT_API size_t cat_getpagesize_slow(void)
@@ -19,6 +19,7 @@
 #include "cat_poll.h"
 
 #include "cat_coroutine.h"
+#include "cat_env.h"
 #include "cat_event.h"
 #include "cat_time.h"
 
@@ -243,6 +244,10 @@ static void cat_poll_one_callback(uv_poll_t* handle, int status, uv_events_t eve
 
 CAT_API cat_poll_one_emulate_t cat_poll_one_emulate;
 
+#ifdef CAT_POLL_REGISTRY
+static cat_bool_t cat_poll_registry_poll_one(cat_os_socket_t fd, cat_pollfd_events_t events, cat_pollfd_events_t *revents, cat_timeout_t timeout, cat_ret_t *ret);
+#endif
+
 static cat_ret_t cat_poll_one_impl(cat_os_socket_t fd, cat_pollfd_events_t events, cat_pollfd_events_t *revents, cat_timeout_t timeout)
 {
     CAT_POLL_ONE_EMULATE(fd, events, revents);
@@ -252,6 +257,12 @@ static cat_ret_t cat_poll_one_impl(cat_os_socket_t fd, cat_pollfd_events_t event
     cat_ret_t ret;
     int error;
 
+#ifdef CAT_POLL_REGISTRY
+    if (cat_poll_registry_poll_one(fd, events, revents, timeout, &ret)) {
+        return ret;
+    }
+#endif
+
     *revents = POLLNONE;
 
     poll = (cat_poll_one_t *) cat_malloc(sizeof(*poll));
@@ -396,6 +407,9 @@ typedef struct {
         uv_events_t events; // uv events, e.g UV_EVENT_READABLE, UV_EVENT_WRITABLE...
     } ret;
     cat_bool_t initialized;
+#ifdef CAT_POLL_REGISTRY
+    cat_bool_t registered;
+#endif
 #ifdef CAT_OS_UNIX_LIKE
     cat_os_fd_t fd_dup;
 #endif
@@ -456,6 +470,510 @@ static void cat_poll_callback(uv_poll_t* handle, int status, uv_events_t events)
     }
 }
 
+/* registry */
+
+#ifdef CAT_POLL_REGISTRY
+
+#include <sys/epoll.h>
+#include <sys/stat.h>
+
+#define CAT_POLL_REGISTRY_EVENTS_PER_ROUND 64
+
+typedef enum cat_poll_registry_state_e {
+    CAT_POLL_REGISTRY_STATE_UNKNOWN = 0,
+    CAT_POLL_REGISTRY_STATE_READY,
+    CAT_POLL_REGISTRY_STATE_UNAVAILABLE,
+} cat_poll_registry_state_t;
+
+typedef struct cat_poll_registry_entry_s {
+    /* it is changed every time the fd is added, so events of
+     * the closed file which has the same fd number can be ignored,
+     * 0 means the fd is not registered */
+    uint32_t generation;
+    /* epoll events which have been triggered */
+    uint32_t revents;
+    /* epoll events which were armed last time */
+    uint32_t events;
+    /* EPOLL_CTL_ADD failed with EPERM (regular file or directory), do not try it again on every wait,
+     * it is reset when the fd is unregistered, gets a new generation or is not such a file anymore */
+    cat_bool_t unpollable;
+    /* waiter, NULL if nobody is waiting on the fd */
+    cat_poll_context_t *context;
+} cat_poll_registry_entry_t;
+
+typedef struct cat_poll_registry_s {
+    int epfd;
+    uint32_t generation;
+    /* coroutines waiting on the registered fds, they keep the event loop alive */
+    unsigned int waiter_count;
+    /* entries are indexed by fd */
+    size_t size;
+    cat_poll_registry_entry_t *entries;
+    /* epoll fd is readable when there are events */
+    uv_poll_t poller;
+} cat_poll_registry_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_poll) {
+    cat_poll_registry_state_t registry_state;
+    cat_poll_registry_t *registry;
+    cat_poll_registry_stats_t registry_stats;
+} CAT_GLOBALS_STRUCT_END(cat_poll);
+
+CAT_GLOBALS_DECLARE(cat_poll);
+
+#define CAT_POLL_G(x) CAT_GLOBALS_GET(cat_poll, x)
+
+static cat_always_inline uint64_t cat_poll_registry_make_data(cat_os_socket_t fd, uint32_t generation)
+{
+    return (((uint64_t) generation) << 32) | (uint32_t) fd;
+}
+
+static cat_always_inline uint32_t cat_poll_registry_translate_sys_events(cat_pollfd_events_t sys_events)
+{
+    uint32_t events = 0;
+
+    /* same as what uv_poll does */
+    if (sys_events & POLLIN) {
+        events |= (EPOLLIN | EPOLLRDHUP);
+    }
+    if (sys_events & POLLOUT) {
+        events |= (EPOLLOUT | EPOLLRDHUP);
+    }
+    if (sys_events & POLLPRI) {
+        events |= EPOLLPRI;
+    }
+
+    return events;
+}
+
+static cat_always_inline cat_pollfd_events_t cat_poll_registry_translate_epoll_events(uint32_t events)
+{
+    cat_pollfd_events_t revents = 0;
+
+    /* uv_poll reports EBADF on POLLERR, which is translated to POLLERR */
+    if (events & EPOLLERR) {
+        return POLLERR;
+    }
+    if (events & EPOLLIN) {
+        revents |= POLLIN;
+    }
+    if (events & EPOLLOUT) {
+        revents |= POLLOUT;
+    }
+    if (events & (EPOLLRDHUP | EPOLLHUP)) {
+        revents |= POLLHUP;
+    }
+    if (events & EPOLLPRI) {
+        revents |= POLLPRI;
+    }
+
+    return revents;
+}
+
+static void cat_poll_registry_close_callback(uv_handle_t *handle)
+{
+    cat_poll_registry_t *registry = (cat_poll_registry_t *) handle->data;
+
+    (void) close(registry->epfd);
+    if (registry->entries != NULL) {
+        cat_free(registry->entries);
+    }
+    cat_free(registry);
+}
+
+static void cat_poll_registry_close(cat_poll_registry_t *registry)
+{
+    CAT_LOG_DEBUG(POLL, "registry(" CAT_OS_FD_FMT ") close with %zu fds registered", registry->epfd, CAT_POLL_G(registry_stats).count);
+    CAT_POLL_G(registry_stats).count = 0;
+    uv_close((uv_handle_t *) &registry->poller, cat_poll_registry_close_callback);
+}
+
+static void cat_poll_registry_update_ref(cat_poll_registry_t *registry)
+{
+    if (registry->waiter_count > 0) {
+        uv_ref((uv_handle_t *) &registry->poller);
+    } else {
+        uv_unref((uv_handle_t *) &registry->poller);
+    }
+}
+
+static void cat_poll_registry_poll_callback(uv_poll_t *poller, int status, int events)
+{
+    cat_poll_registry_t *registry = (cat_poll_registry_t *) poller->data;
+    struct epoll_event epoll_events[CAT_POLL_REGISTRY_EVENTS_PER_ROUND];
+    int n, i;
+    (void) status;
+    (void) events;
+
+    do {
+        n = epoll_wait(registry->epfd, epoll_events, CAT_ARRAY_SIZE(epoll_events), 0);
+        if (unlikely(n < 0)) {
+            if (errno == EINTR) {
+                n = CAT_ARRAY_SIZE(epoll_events);
+                continue;
+            }
+            CAT_LOG_DEBUG(POLL, "registry(" CAT_OS_FD_FMT ") wait failed, errno=%d", registry->epfd, errno);
+            break;
+        }
+        for (i = 0; i < n; i++) {
+            struct epoll_event *epoll_event = &epoll_events[i];
+            cat_os_socket_t fd = (cat_os_socket_t) (uint32_t) epoll_event->data.u64;
+            uint32_t generation = (uint32_t) (epoll_event->data.u64 >> 32);
+            cat_poll_registry_entry_t *entry;
+            if (unlikely((size_t) fd >= registry->size)) {
+                continue;
+            }
+            entry = &registry->entries[fd];
+            /* fd has been closed and reused, or nobody is waiting on it */
+            if (entry->generation != generation || entry->context == NULL) {
+                continue;
+            }
+            entry->revents |= epoll_event->events;
+            /* schedule coroutine in io defer callback to get all revents at once */
+            if (entry->context->done_task == NULL) {
+                entry->context->done_task = cat_event_io_defer_task_create(cat_poll_done_callback, entry->context);
+            }
+        }
+    } while (n == CAT_ARRAY_SIZE(epoll_events));
+}
+
+static cat_poll_registry_t *cat_poll_registry_create(void)
+{
+    cat_poll_registry_t *registry;
+    int epfd, error;
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        CAT_LOG_DEBUG(POLL, "registry create failed, errno=%d", errno);
+        return NULL;
+    }
+    registry = (cat_poll_registry_t *) cat_malloc(sizeof(*registry));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(registry == NULL)) {
+        (void) close(epfd);
+        return NULL;
+    }
+#endif
+    memset(registry, 0, sizeof(*registry));
+    registry->epfd = epfd;
+    error = uv_poll_init(&CAT_EVENT_G(loop), &registry->poller, epfd);
+    if (unlikely(error != 0)) {
+        CAT_LOG_DEBUG(POLL, "registry(" CAT_OS_FD_FMT ") poll init failed, error=%d", epfd, error);
+        (void) close(epfd);
+        cat_free(registry);
+        return NULL;
+    }
+    registry->poller.data = registry;
+    (void) uv_poll_start(&registry->poller, UV_READABLE, cat_poll_registry_poll_callback);
+    uv_unref((uv_handle_t *) &registry->poller);
+    CAT_LOG_DEBUG(POLL, "registry(" CAT_OS_FD_FMT ") created", epfd);
+
+    return registry;
+}
+
+static cat_poll_registry_t *cat_poll_registry_get(void)
+{
+    cat_poll_registry_t *registry = CAT_POLL_G(registry);
+
+    if (likely(CAT_POLL_G(registry_state) != CAT_POLL_REGISTRY_STATE_UNKNOWN)) {
+        return registry;
+    }
+    if (cat_env_is_true("CAT_POLL_REGISTRY", cat_true)) {
+        registry = cat_poll_registry_create();
+    }
+    CAT_POLL_G(registry) = registry;
+    CAT_POLL_G(registry_state) = registry != NULL ? CAT_POLL_REGISTRY_STATE_READY : CAT_POLL_REGISTRY_STATE_UNAVAILABLE;
+
+    return registry;
+}
+
+static cat_poll_registry_entry_t *cat_poll_registry_get_entry(cat_poll_registry_t *registry, cat_os_socket_t fd)
+{
+    if (unlikely((size_t) fd >= registry->size)) {
+        cat_poll_registry_entry_t *entries;
+        size_t size = CAT_MAX(registry->size * 2, 64);
+        while (size <= (size_t) fd) {
+            size *= 2;
+        }
+        entries = (cat_poll_registry_entry_t *) cat_realloc(registry->entries, sizeof(*entries) * size);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(entries == NULL)) {
+            return NULL;
+        }
+#endif
+        memset(entries + registry->size, 0, sizeof(*entries) * (size - registry->size));
+        registry->entries = entries;
+        registry->size = size;
+    }
+
+    return &registry->entries[fd];
+}
+
+/* (re)arm the fd with its current interest mask, returns 0 or errno */
+static int cat_poll_registry_arm(cat_poll_registry_t *registry, cat_poll_registry_entry_t *entry, cat_os_socket_t fd, uint32_t events)
+{
+    cat_poll_registry_stats_t *stats = &CAT_POLL_G(registry_stats);
+    struct epoll_event epoll_event;
+    uint32_t generation;
+
+    /* oneshot: events of the fds which nobody is waiting on will never be reported again */
+    epoll_event.events = events | EPOLLONESHOT;
+    if (entry->generation != 0) {
+        epoll_event.data.u64 = cat_poll_registry_make_data(fd, entry->generation);
+        if (epoll_ctl(registry->epfd, EPOLL_CTL_MOD, fd, &epoll_event) == 0) {
+            stats->mods++;
+            entry->events = events;
+            return 0;
+        }
+        /* the registered file has gone (ENOENT: the fd number has been reused) */
+        entry->generation = 0;
+        stats->count--;
+        if (errno != ENOENT) {
+            return errno;
+        }
+    }
+    generation = ++registry->generation;
+    if (unlikely(generation == 0)) {
+        generation = ++registry->generation;
+    }
+    epoll_event.data.u64 = cat_poll_registry_make_data(fd, generation);
+    if (epoll_ctl(registry->epfd, EPOLL_CTL_ADD, fd, &epoll_event) == 0) {
+        stats->adds++;
+    } else {
+        /* EPERM: regular files are not supported, EBADF: fd is invalid,
+         * EEXIST: the fd was registered but its entry has been reset */
+        if (errno != EEXIST || epoll_ctl(registry->epfd, EPOLL_CTL_MOD, fd, &epoll_event) != 0) {
+            if (errno == EPERM) {
+                entry->unpollable = cat_true;
+            }
+            return errno;
+        }
+        stats->mods++;
+    }
+    entry->generation = generation;
+    entry->events = events;
+    entry->unpollable = cat_false;
+    stats->count++;
+
+    return 0;
+}
+
+static cat_poll_registry_entry_t *cat_poll_registry_attach(cat_poll_registry_t *registry, cat_os_socket_t fd, cat_pollfd_events_t events, cat_poll_context_t *context)
+{
+    cat_poll_registry_entry_t *entry;
+    int error;
+
+    if (unlikely(fd < 0)) {
+        return NULL;
+    }
+    entry = cat_poll_registry_get_entry(registry, fd);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(entry == NULL)) {
+        return NULL;
+    }
+#endif
+    /* the same fd is being polled by another coroutine */
+    if (unlikely(entry->context != NULL)) {
+        return NULL;
+    }
+    error = cat_poll_registry_arm(registry, entry, fd, cat_poll_registry_translate_sys_events(events));
+    if (unlikely(error != 0)) {
+        CAT_LOG_DEBUG_V2(POLL, "registry(" CAT_OS_FD_FMT ") arm fd " CAT_OS_SOCKET_FMT " failed, errno=%d", registry->epfd, fd, error);
+        return NULL;
+    }
+    entry->revents = 0;
+    entry->context = context;
+    registry->waiter_count++;
+    cat_poll_registry_update_ref(registry);
+
+    return entry;
+}
+
+/* an fstat() is cheaper than failing in both EPOLL_CTL_ADD of the registry and the fallback poll handle,
+ * and it tells us whether the fd number has been reused by another kind of file without unregistering */
+static cat_bool_t cat_poll_registry_is_unpollable(cat_poll_registry_t *registry, cat_os_socket_t fd)
+{
+    cat_poll_registry_entry_t *entry;
+    struct stat st;
+
+    if (fd < 0 || (size_t) fd >= registry->size) {
+        return cat_false;
+    }
+    entry = &registry->entries[fd];
+    if (likely(!entry->unpollable)) {
+        return cat_false;
+    }
+    if (fstat(fd, &st) == 0 && (S_ISREG(st.st_mode) || S_ISDIR(st.st_mode))) {
+        return cat_true;
+    }
+    entry->unpollable = cat_false;
+
+    return cat_false;
+}
+
+/* returns the triggered poll events */
+static cat_pollfd_events_t cat_poll_registry_detach(cat_poll_registry_t *registry, cat_os_socket_t fd)
+{
+    /* entries may be reallocated during waiting, so we always find it by fd */
+    cat_poll_registry_entry_t *entry = &registry->entries[fd];
+    uint32_t revents = entry->revents;
+
+    entry->revents = 0;
+    entry->context = NULL;
+    registry->waiter_count--;
+    cat_poll_registry_update_ref(registry);
+
+    return cat_poll_registry_translate_epoll_events(revents);
+}
+
+static cat_bool_t cat_poll_registry_poll_one(cat_os_socket_t fd, cat_pollfd_events_t events, cat_pollfd_events_t *revents, cat_timeout_t timeout, cat_ret_t *ret_ptr)
+{
+    cat_poll_registry_t *registry;
+    cat_poll_context_t context;
+    cat_ret_t ret;
+
+    if (uv__fd_exists(&CAT_EVENT_G(loop), fd)) {
+        return cat_false;
+    }
+    registry = cat_poll_registry_get();
+    if (registry == NULL) {
+        return cat_false;
+    }
+    if (cat_poll_registry_is_unpollable(registry, fd)) {
+        /* same as what the poll handle reports for regular files */
+        CAT_POLL_G(registry_stats).fallbacks++;
+        cat_update_last_error_with_reason(CAT_EPERM, "Poll init failed");
+        *revents = cat_poll_translate_error_to_sys_events(events, CAT_ENOTSOCK);
+        *ret_ptr = CAT_RET_ERROR;
+        return cat_true;
+    }
+    context.coroutine = CAT_COROUTINE_G(current);
+    context.done_task = NULL;
+    if (cat_poll_registry_attach(registry, fd, events, &context) == NULL) {
+        CAT_POLL_G(registry_stats).fallbacks++;
+        return cat_false;
+    }
+
+    ret = cat_time_delay(timeout);
+
+    if (context.done_task != NULL) {
+        cat_event_io_defer_task_close(context.done_task);
+    }
+    *revents = cat_poll_registry_detach(registry, fd);
+
+    switch (ret) {
+        /* delay canceled */
+        case CAT_RET_NONE: {
+            if (unlikely(*revents == POLLNONE)) {
+                cat_update_last_error(CAT_ECANCELED, "Poll has been canceled");
+                ret = CAT_RET_ERROR;
+            } else {
+                ret = CAT_RET_OK;
+            }
+            break;
+        }
+        /* timedout */
+        case CAT_RET_OK:
+            *revents = POLLNONE;
+            ret = CAT_RET_NONE;
+            break;
+        /* error */
+        case CAT_RET_ERROR:
+            *revents = POLLNONE;
+            cat_update_last_error_with_previous("Poll wait failed");
+            break;
+        default:
+            CAT_NEVER_HERE("Impossible");
+    }
+    *ret_ptr = ret;
+
+    return cat_true;
+}
+#endif /* CAT_POLL_REGISTRY */
+
+CAT_API cat_bool_t cat_poll_module_init(void)
+{
+#ifdef CAT_POLL_REGISTRY
+    CAT_GLOBALS_REGISTER(cat_poll);
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_poll_module_shutdown(void)
+{
+#ifdef CAT_POLL_REGISTRY
+    CAT_GLOBALS_UNREGISTER(cat_poll);
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_poll_runtime_init(void)
+{
+#ifdef CAT_POLL_REGISTRY
+    /* registry is created lazily */
+    CAT_POLL_G(registry_state) = CAT_POLL_REGISTRY_STATE_UNKNOWN;
+    CAT_POLL_G(registry) = NULL;
+    memset(&CAT_POLL_G(registry_stats), 0, sizeof(CAT_POLL_G(registry_stats)));
+#endif
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_poll_runtime_shutdown(void)
+{
+#ifdef CAT_POLL_REGISTRY
+    if (CAT_POLL_G(registry) != NULL) {
+        cat_poll_registry_close(CAT_POLL_G(registry));
+        CAT_POLL_G(registry) = NULL;
+    }
+    CAT_POLL_G(registry_state) = CAT_POLL_REGISTRY_STATE_UNKNOWN;
+#endif
+    return cat_true;
+}
+
+CAT_API void cat_poll_fork(void)
+{
+#ifdef CAT_POLL_REGISTRY
+    /* epoll instance is shared with the parent process, child process creates its own one */
+    if (CAT_POLL_G(registry) != NULL) {
+        cat_poll_registry_close(CAT_POLL_G(registry));
+        CAT_POLL_G(registry) = NULL;
+    }
+    CAT_POLL_G(registry_state) = CAT_POLL_REGISTRY_STATE_UNKNOWN;
+#endif
+}
+
+CAT_API void cat_poll_unregister(cat_os_socket_t fd)
+{
+#ifdef CAT_POLL_REGISTRY
+    cat_poll_registry_t *registry = CAT_POLL_G(registry);
+    cat_poll_registry_entry_t *entry;
+
+    if (registry == NULL || fd < 0 || (size_t) fd >= registry->size) {
+        return;
+    }
+    entry = &registry->entries[fd];
+    entry->unpollable = cat_false;
+    if (entry->generation == 0) {
+        return;
+    }
+    (void) epoll_ctl(registry->epfd, EPOLL_CTL_DEL, fd, NULL);
+    entry->generation = 0;
+    CAT_POLL_G(registry_stats).dels++;
+    CAT_POLL_G(registry_stats).count--;
+#else
+    (void) fd;
+#endif
+}
+
+CAT_API void cat_poll_get_registry_stats(cat_poll_registry_stats_t *stats)
+{
+#ifdef CAT_POLL_REGISTRY
+    *stats = CAT_POLL_G(registry_stats);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
 #define CAT_POLL_EMULATE(fds, nfds) do { \
     if (cat_poll_emulate != NULL) { \
         int n; \
@@ -472,6 +990,9 @@ static int cat_poll_impl(cat_pollfd_t *fds, cat_nfds_t nfds, cat_timeout_t timeo
 {
     CAT_POLL_EMULATE(fds, nfds);
     CAT_POLL_CHECK_TIMEOUT(timeout);
+#ifdef CAT_POLL_REGISTRY
+    cat_poll_registry_t *registry = cat_poll_registry_get();
+#endif
     cat_poll_context_t *context;
     cat_poll_t *polls;
     cat_nfds_t i = 0, e = 0;
@@ -506,6 +1027,27 @@ static int cat_poll_impl(cat_pollfd_t *fds, cat_nfds_t nfds, cat_timeout_t timeo
             cat_os_socket_t fd_no = fd->fd;
 #ifdef CAT_OS_UNIX_LIKE
             poll->fd_dup = CAT_OS_INVALID_FD;
+#endif
+#ifdef CAT_POLL_REGISTRY
+            poll->registered = cat_false;
+            if (registry != NULL && !uv__fd_exists(&CAT_EVENT_G(loop), fd->fd)) {
+                if (cat_poll_registry_is_unpollable(registry, fd->fd)) {
+                    /* same as what the poll handle reports for regular files */
+                    CAT_POLL_G(registry_stats).fallbacks++;
+                    poll->ret.status = CAT_ENOTSOCK;
+                    e++;
+                    break;
+                }
+                /* registry entries do not hold references of context */
+                if (cat_poll_registry_attach(registry, fd->fd, fd->events, context) != NULL) {
+                    poll->registered = cat_true;
+                    poll->ret.status = CAT_ECANCELED;
+                    break;
+                }
+                CAT_POLL_G(registry_stats).fallbacks++;
+            }
+#endif
+#ifdef CAT_OS_UNIX_LIKE
             if (unlikely(uv__fd_exists(&CAT_EVENT_G(loop), fd->fd))) {
                 /* uv_poll_init_socket() and uv_poll_start() will return error if fd exists */
                 poll->fd_dup = dup(fd->fd);
@@ -558,6 +1100,18 @@ static int cat_poll_impl(cat_pollfd_t *fds, cat_nfds_t nfds, cat_timeout_t timeo
     for (; i-- > 0;) {
         cat_pollfd_t *fd = &fds[i];
         cat_poll_t *poll = &polls[i];
+#ifdef CAT_POLL_REGISTRY
+        if (poll->registered) {
+            cat_pollfd_events_t revents = cat_poll_registry_detach(registry, fd->fd);
+            if (likely(ret != CAT_RET_ERROR)) {
+                fd->revents = revents;
+                if (revents != POLLNONE) {
+                    n++;
+                }
+            }
+            continue;
+        }
+#endif
         if (poll->initialized) {
             uv_close(&poll->u.handle, cat_poll_close_callback);
         }
@@ -0,0 +1,408 @@
+/*
+  +--------------------------------------------------------------------------+
+  | libcat                                                                   |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#include "cat_pool.h"
+#include "cat_event.h"
+#include "cat_time.h"
+
+typedef struct cat_pool_waiter_s {
+    cat_queue_node_t node;
+    cat_coroutine_t *coroutine;
+    /* item which is handed over by put() */
+    cat_data_t *item;
+    /* a slot is released by others, waiter can create a new item */
+    cat_bool_t reserved;
+} cat_pool_waiter_t;
+
+static cat_always_inline cat_bool_t cat_pool__is_available(const cat_pool_t *pool)
+{
+    return !(pool->flags & CAT_POOL_FLAG_CLOSED);
+}
+
+static cat_never_inline void cat_pool__update_last_error(void)
+{
+    cat_update_last_error(CAT_ECLOSED, "Pool has been closed");
+}
+
+static cat_always_inline cat_pool_idle_item_t *cat_pool_idle_slot(const cat_pool_t *pool, uint32_t index)
+{
+    index += pool->idle_head;
+    if (index >= pool->options.max_size) {
+        index -= pool->options.max_size;
+    }
+    return &pool->idle[index];
+}
+
+static cat_always_inline void cat_pool_idle_push(cat_pool_t *pool, cat_data_t *item)
+{
+    cat_pool_idle_item_t *slot = cat_pool_idle_slot(pool, pool->idle_count);
+    slot->data = item;
+    slot->last_used = cat_time_msec_cached();
+    pool->idle_count++;
+}
+
+/* the most recently used one */
+static cat_always_inline cat_data_t *cat_pool_idle_pop(cat_pool_t *pool)
+{
+    pool->idle_count--;
+    return cat_pool_idle_slot(pool, pool->idle_count)->data;
+}
+
+/* the least recently used one */
+static cat_always_inline cat_data_t *cat_pool_idle_shift(cat_pool_t *pool)
+{
+    cat_data_t *item = pool->idle[pool->idle_head].data;
+    if (++pool->idle_head == pool->options.max_size) {
+        pool->idle_head = 0;
+    }
+    pool->idle_count--;
+    return item;
+}
+
+static void cat_pool_destroy_item(cat_pool_t *pool, cat_data_t *item)
+{
+    CAT_ASSERT(pool->size > 0);
+    pool->size--;
+    pool->stats.destroy_count++;
+    pool->destroy(pool, item);
+}
+
+/* a slot has been released, let the first waiter create a new item */
+static void cat_pool_notify_reservation(cat_pool_t *pool)
+{
+    cat_pool_waiter_t *waiter;
+
+    if (!cat_pool__is_available(pool) || pool->size >= pool->options.max_size) {
+        return;
+    }
+    waiter = cat_queue_front_data(&pool->waiters, cat_pool_waiter_t, node);
+    if (waiter == NULL) {
+        return;
+    }
+    pool->size++;
+    waiter->reserved = cat_true;
+    cat_coroutine_schedule(waiter->coroutine, POOL, "Pool");
+}
+
+/* size has been increased by the caller */
+static cat_data_t *cat_pool_create_item(cat_pool_t *pool)
+{
+    cat_nsec_t start, elapsed;
+    cat_data_t *item;
+
+    start = cat_time_nsec();
+    item = pool->create(pool);
+    elapsed = cat_time_nsec() - start;
+    if (unlikely(item == NULL)) {
+        pool->size--;
+        pool->stats.create_failure_count++;
+        cat_update_last_error_with_previous("Pool create item failed");
+        cat_pool_notify_reservation(pool);
+        return NULL;
+    }
+    pool->stats.create_count++;
+    pool->stats.total_create_time += elapsed;
+    if (elapsed > pool->stats.max_create_time) {
+        pool->stats.max_create_time = elapsed;
+    }
+    if (unlikely(!cat_pool__is_available(pool))) {
+        /* closed during creation */
+        cat_pool_destroy_item(pool, item);
+        cat_pool__update_last_error();
+        return NULL;
+    }
+
+    return item;
+}
+
+static void cat_pool_evictor_callback(uv_timer_t *evictor)
+{
+    (void) cat_pool_evict((cat_pool_t *) evictor->data);
+}
+
+static void cat_pool_evictor_close_callback(uv_handle_t *handle)
+{
+    cat_event_slab_free(handle, sizeof(uv_timer_t));
+}
+
+CAT_API void cat_pool_options_init(cat_pool_options_t *options)
+{
+    options->min_size = 0;
+    options->max_size = 64;
+    options->idle_timeout = -1;
+}
+
+CAT_API cat_pool_t *cat_pool_create(
+    cat_pool_t *pool, const cat_pool_options_t *options,
+    cat_pool_create_function_t create, cat_pool_destroy_function_t destroy, cat_pool_check_function_t check,
+    cat_data_t *data
+) {
+    cat_pool_options_t default_options;
+
+    if (options == NULL) {
+        cat_pool_options_init(&default_options);
+        options = &default_options;
+    }
+    if (unlikely(options->max_size == 0)) {
+        cat_update_last_error(CAT_EINVAL, "Pool max size must be greater than 0");
+        return NULL;
+    }
+    if (unlikely(options->min_size > options->max_size)) {
+        cat_update_last_error(CAT_EINVAL, "Pool min size can not be greater than max size");
+        return NULL;
+    }
+    pool->idle = (cat_pool_idle_item_t *) cat_malloc(sizeof(*pool->idle) * options->max_size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(pool->idle == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for pool failed");
+        return NULL;
+    }
+#endif
+    pool->flags = CAT_POOL_FLAG_NONE;
+    pool->size = 0;
+    pool->idle_head = 0;
+    pool->idle_count = 0;
+    cat_queue_init(&pool->waiters);
+    pool->evictor = NULL;
+    pool->create = create;
+    pool->destroy = destroy;
+    pool->check = check;
+    pool->options = *options;
+    memset(&pool->stats, 0, sizeof(pool->stats));
+    pool->data = data;
+
+    if (options->idle_timeout > 0) {
+        uint64_t interval = CAT_MAX(options->idle_timeout / 2, 1);
+        pool->evictor = (uv_timer_t *) cat_event_slab_malloc(sizeof(*pool->evictor));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(pool->evictor == NULL)) {
+            cat_free(pool->idle);
+            cat_update_last_error_of_syscall("Malloc for pool evictor failed");
+            return NULL;
+        }
+#endif
+        (void) uv_timer_init(&CAT_EVENT_G(loop), pool->evictor);
+        pool->evictor->data = pool;
+        (void) uv_timer_start(pool->evictor, cat_pool_evictor_callback, interval, interval);
+        /* idle pool should not keep the event loop alive */
+        uv_unref((uv_handle_t *) pool->evictor);
+    }
+
+    return pool;
+}
+
+CAT_API cat_bool_t cat_pool_close(cat_pool_t *pool)
+{
+    cat_pool_waiter_t *waiter;
+
+    if (unlikely(!cat_pool__is_available(pool))) {
+        cat_pool__update_last_error();
+        return cat_false;
+    }
+    pool->flags |= CAT_POOL_FLAG_CLOSED;
+    if (pool->evictor != NULL) {
+        uv_close((uv_handle_t *) pool->evictor, cat_pool_evictor_close_callback);
+        pool->evictor = NULL;
+    }
+    while (pool->idle_count > 0) {
+        cat_pool_destroy_item(pool, cat_pool_idle_pop(pool));
+    }
+    cat_free(pool->idle);
+    pool->idle = NULL;
+    /* waiters will remove themselves from the queue */
+    while ((waiter = cat_queue_front_data(&pool->waiters, cat_pool_waiter_t, node)) != NULL) {
+        cat_coroutine_schedule(waiter->coroutine, POOL, "Pool");
+    }
+
+    return cat_true;
+}
+
+CAT_API cat_data_t *cat_pool_get(cat_pool_t *pool, cat_timeout_t timeout)
+{
+    cat_pool_waiter_t waiter;
+    cat_nsec_t start, elapsed;
+    cat_data_t *item;
+    cat_bool_t ret;
+
+    if (unlikely(!cat_pool__is_available(pool))) {
+        cat_pool__update_last_error();
+        return NULL;
+    }
+    pool->stats.get_count++;
+
+    while (pool->idle_count > 0) {
+        item = cat_pool_idle_pop(pool);
+        if (pool->check == NULL || likely(pool->check(pool, item))) {
+            return item;
+        }
+        pool->stats.check_failure_count++;
+        cat_pool_destroy_item(pool, item);
+    }
+    if (pool->size < pool->options.max_size) {
+        pool->size++;
+        return cat_pool_create_item(pool);
+    }
+
+    /* wait for an item or a slot */
+    waiter.coroutine = CAT_COROUTINE_G(current);
+    waiter.item = NULL;
+    waiter.reserved = cat_false;
+    pool->stats.wait_count++;
+    start = cat_time_nsec();
+    cat_queue_push_back(&pool->waiters, &waiter.node);
+    ret = cat_time_wait(timeout);
+    cat_queue_remove(&waiter.node);
+    elapsed = cat_time_nsec() - start;
+    pool->stats.total_wait_time += elapsed;
+    if (elapsed > pool->stats.max_wait_time) {
+        pool->stats.max_wait_time = elapsed;
+    }
+
+    if (waiter.item != NULL) {
+        return waiter.item;
+    }
+    if (waiter.reserved) {
+        return cat_pool_create_item(pool);
+    }
+    if (unlikely(!ret)) {
+        if (cat_get_last_error_code() == CAT_ETIMEDOUT) {
+            pool->stats.timeout_count++;
+        }
+        cat_update_last_error_with_previous("Pool wait for item failed");
+        return NULL;
+    }
+    if (unlikely(!cat_pool__is_available(pool))) {
+        cat_pool__update_last_error();
+        return NULL;
+    }
+    cat_update_last_error(CAT_ECANCELED, "Pool get has been canceled");
+    return NULL;
+}
+
+CAT_API cat_bool_t cat_pool_put(cat_pool_t *pool, cat_data_t *item, cat_bool_t broken)
+{
+    cat_pool_waiter_t *waiter;
+
+    /* size would wrap around if an item which does not belong to it is put */
+    if (unlikely(pool->size <= pool->idle_count)) {
+        cat_update_last_error(CAT_EMISUSE, "Pool has no item in use, item may not belong to it");
+        return cat_false;
+    }
+    pool->stats.put_count++;
+    if (unlikely(broken || !cat_pool__is_available(pool))) {
+        cat_pool_destroy_item(pool, item);
+        cat_pool_notify_reservation(pool);
+        return cat_true;
+    }
+    waiter = cat_queue_front_data(&pool->waiters, cat_pool_waiter_t, node);
+    if (waiter != NULL) {
+        /* hand it over directly, the waiter will remove itself from the queue */
+        waiter->item = item;
+        cat_coroutine_schedule(waiter->coroutine, POOL, "Pool");
+        return cat_true;
+    }
+    if (unlikely(pool->idle_count >= pool->options.max_size)) {
+        pool->stats.put_count--;
+        cat_update_last_error(CAT_EMISUSE, "Pool is full of idle items, item may not belong to it");
+        return cat_false;
+    }
+    cat_pool_idle_push(pool, item);
+
+    return cat_true;
+}
+
+CAT_API uint32_t cat_pool_fill(cat_pool_t *pool)
+{
+    uint32_t count = 0;
+    cat_data_t *item;
+
+    while (cat_pool__is_available(pool) && pool->size < pool->options.min_size) {
+        pool->size++;
+        item = cat_pool_create_item(pool);
+        if (unlikely(item == NULL)) {
+            break;
+        }
+        count++;
+        if (unlikely(!cat_pool_put(pool, item, cat_false))) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+CAT_API uint32_t cat_pool_evict(cat_pool_t *pool)
+{
+    cat_msec_t now = cat_time_msec_cached();
+    uint32_t count = 0;
+
+    if (unlikely(!cat_pool__is_available(pool) || pool->options.idle_timeout <= 0)) {
+        return 0;
+    }
+    while (
+        pool->idle_count > 0 &&
+        pool->size > pool->options.min_size &&
+        now - pool->idle[pool->idle_head].last_used >= (cat_msec_t) pool->options.idle_timeout
+    ) {
+        cat_pool_destroy_item(pool, cat_pool_idle_shift(pool));
+        count++;
+    }
+    pool->stats.eviction_count += count;
+
+    return count;
+}
+
+/* status */
+
+CAT_API uint32_t cat_pool_get_size(const cat_pool_t *pool)
+{
+    return pool->size;
+}
+
+CAT_API uint32_t cat_pool_get_idle_count(const cat_pool_t *pool)
+{
+    return pool->idle_count;
+}
+
+CAT_API cat_bool_t cat_pool_has_waiters(const cat_pool_t *pool)
+{
+    return !cat_queue_empty(&pool->waiters);
+}
+
+CAT_API cat_bool_t cat_pool_is_available(const cat_pool_t *pool)
+{
+    return cat_pool__is_available(pool);
+}
+
+CAT_API const cat_pool_stats_t *cat_pool_get_stats(const cat_pool_t *pool)
+{
+    return &pool->stats;
+}
+
+CAT_API cat_data_t *cat_pool_get_data(const cat_pool_t *pool)
+{
+    return pool->data;
+}
+
+CAT_API cat_data_t *cat_pool_get_idle_item(const cat_pool_t *pool, uint32_t index)
+{
+    if (index >= pool->idle_count) {
+        return NULL;
+    }
+    return cat_pool_idle_slot(pool, index)->data;
+}
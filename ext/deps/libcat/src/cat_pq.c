@@ -114,6 +114,17 @@ CAT_API PGconn *cat_pq_connectdb(const char *conninfo)
     return conn;
 }
 
+CAT_API void cat_pq_finish(PGconn *conn)
+{
+    int fd = PQsocket(conn);
+
+    if (fd >= 0) {
+        /* fd is closed by PQfinish() */
+        cat_poll_unregister(fd);
+    }
+    PQfinish(conn);
+}
+
 CAT_API PGresult *cat_pq_prepare(PGconn *conn, const char *stmt_name, const char *query, int n_params, const Oid *param_types)
 {
     CAT_LOG_DEBUG(PQ, "PQsendPrepare(conn=%p, stmt_name='%s')", conn, stmt_name);
@@ -176,4 +187,44 @@ CAT_API PGresult *cat_pq_exec_params(PGconn *conn, const char *command, int n_pa
     return cat_pq_get_result(conn);
 }
 
+CAT_API cat_bool_t cat_pq_wait_result(PGconn *conn)
+{
+    while (1) {
+        cat_pollfd_events_t events = POLLIN;
+        cat_ret_t poll_ret;
+        /* there may be still queued data (e.g. in pipeline mode),
+         * server may not respond until it receives all of them */
+        int flush_ret = PQflush(conn);
+        if (unlikely(flush_ret == -1)) {
+            return cat_false;
+        }
+        if (!PQisBusy(conn)) {
+            return cat_true;
+        }
+        if (flush_ret == 1) {
+            events |= POLLOUT;
+        }
+        poll_ret = cat_poll_one(PQsocket(conn), events, NULL, -1);
+        if (unlikely(poll_ret == CAT_RET_ERROR)) {
+            return cat_false;
+        }
+        CAT_LOG_DEBUG(PQ, "PQconsumeInput(conn=%p)", conn);
+        if (unlikely(PQconsumeInput(conn) == 0)) {
+            return cat_false;
+        }
+    }
+}
+
+#ifdef CAT_PQ_HAVE_PIPELINE
+CAT_API cat_bool_t cat_pq_pipeline_sync(PGconn *conn)
+{
+    CAT_LOG_DEBUG(PQ, "PQpipelineSync(conn=%p)", conn);
+    if (PQpipelineSync(conn) == 0) {
+        return cat_false;
+    }
+
+    return cat_pq_flush(conn) != -1;
+}
+#endif
+
 #endif /* CAT_PQ */
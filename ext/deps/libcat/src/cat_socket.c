@@ -52,6 +52,24 @@
 #include <winsock2.h>
 #endif /* CAT_OS_WIN */
 
+#if defined(CAT_OS_UNIX_LIKE) && HAVE_MMSG
+#define CAT_SOCKET_HAVE_MMSG 1
+/* max number of datagrams per recvmmsg/sendmmsg call */
+#define CAT_SOCKET_MMSG_BATCH_SIZE 64
+#endif
+
+#ifdef CAT_OS_LINUX
+/* for UDP_SEGMENT and UDP_GRO */
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#define CAT_SOCKET_HAVE_UDP_OFFLOAD 1
+#endif
+
 #ifdef __linux__
 #define cat_sockaddr_is_linux_abstract_name(path, length) (length > 0 && path[0] == '\0')
 #else
@@ -490,9 +508,18 @@ CAT_API cat_bool_t cat_socket_runtime_init(void)
 
     RB_INIT(&CAT_SOCKET_G(internal_tree));
 
+    if (unlikely(!cat_dns_runtime_init())) {
+        return cat_false;
+    }
+
     return cat_true;
 }
 
+CAT_API cat_bool_t cat_socket_runtime_shutdown(void)
+{
+    return cat_dns_runtime_shutdown();
+}
+
 static cat_never_inline const char *cat_socket_get_error_from_flags(cat_errno_t *error, cat_socket_flags_t flags)
 {
     if (flags & CAT_SOCKET_FLAG_UNRECOVERABLE_ERROR) {
@@ -567,6 +594,15 @@ static cat_always_inline cat_bool_t cat_socket_internal_is_established(cat_socke
     return cat_true;
 }
 
+#ifdef CAT_SSL
+/* records are encrypted by the kernel if kTLS send is enabled,
+ * so we can write plain data to the socket directly */
+static cat_always_inline cat_bool_t cat_socket_internal_write_is_encrypted(const cat_socket_internal_t *socket_i)
+{
+    return socket_i->ssl != NULL && !(socket_i->ssl->flags & CAT_SSL_FLAG_KTLS_SEND);
+}
+#endif
+
 #define CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY_SILENT(_socket_i, _failure) do { \
     if (unlikely(!cat_socket_internal_is_established(_socket_i))) { \
         cat_errno_t error = CAT_ENOTCONN; \
@@ -775,6 +811,19 @@ static cat_always_inline cat_bool_t cat_socket_internal_can_be_transfer_by_ipc(c
             0;
 }
 
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+static int cat_socket_internal_set_udp_gro(cat_socket_internal_t *socket_i, cat_bool_t enable)
+{
+    int value = enable;
+
+    if (unlikely(setsockopt(cat_socket_internal_get_fd_fast(socket_i), IPPROTO_UDP, UDP_GRO, &value, sizeof(value)) != 0)) {
+        return cat_translate_sys_error(cat_sys_errno);
+    }
+
+    return 0;
+}
+#endif
+
 static cat_always_inline void cat_socket_internal_on_open(cat_socket_internal_t *socket_i, cat_sa_family_t af)
 {
     if (unlikely(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_OPENED)) {
@@ -794,6 +843,11 @@ static cat_always_inline void cat_socket_internal_on_open(cat_socket_internal_t
         if (socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_UDP_BROADCAST) {
             (void) uv_udp_set_broadcast(&socket_i->u.udp, 1);
         }
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+        if (socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_UDP_GRO) {
+            (void) cat_socket_internal_set_udp_gro(socket_i, cat_true);
+        }
+#endif
     }
     if (af != AF_UNSPEC && (socket_i->type & CAT_SOCKET_TYPE_FLAG_INET)) {
         CAT_ASSERT(af == AF_INET || af == AF_INET6);
@@ -943,6 +997,7 @@ static cat_always_inline cat_socket_t *cat_socket_create_impl(cat_socket_t *sock
     socket_i->io_flags = CAT_SOCKET_IO_FLAG_NONE;
     memset(&socket_i->context.io.read, 0, sizeof(socket_i->context.io.read));
     cat_queue_init(&socket_i->context.io.write.coroutines);
+    socket_i->read_ahead = NULL;
     /* part of cache */
     socket_i->cache.fd = CAT_SOCKET_INVALID_FD;
     socket_i->cache.write_request = NULL;
@@ -953,6 +1008,9 @@ static cat_always_inline cat_socket_t *cat_socket_create_impl(cat_socket_t *sock
     socket_i->cache.send_buffer_size = -1;
     /* options */
     socket_i->option_flags = CAT_SOCKET_OPTION_FLAG_NONE;
+    if ((type & CAT_SOCKET_TYPE_FLAG_STREAM) && CAT_SOCKET_G(options.read_persistent)) {
+        socket_i->option_flags |= CAT_SOCKET_OPTION_FLAG_READ_PERSISTENT;
+    }
     socket_i->options.timeout = cat_socket_default_timeout_options;
     socket_i->options.tcp_keepalive_delay = 0;
 #ifdef CAT_SSL
@@ -1653,6 +1711,31 @@ CAT_API cat_bool_t cat_socket_listen(cat_socket_t *socket, int backlog)
     return ret;
 }
 
+static cat_always_inline cat_bool_t cat_socket_internal_accept_check_type(cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i)
+{
+    cat_socket_type_t server_type = cat_socket_type_simplify(server_i->type);
+    cat_socket_type_t connection_type = connection_i->type;
+
+    if (unlikely((server_type & connection_type) != server_type)) {
+        cat_update_last_error(CAT_EINVAL, "Socket accept connection type mismatch, expect %s but got %s",
+            cat_socket_type_get_name(server_type), cat_socket_type_get_name(connection_type));
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+static cat_always_inline void cat_socket_internal_on_accept(
+    cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i,
+    cat_socket_inheritance_info_t *handle_info
+) {
+    /* init client properties */
+    connection_i->flags |= (CAT_SOCKET_INTERNAL_FLAG_ESTABLISHED | CAT_SOCKET_INTERNAL_FLAG_SERVER_CONNECTION);
+    /* TODO: socket_extends() ? */
+    memcpy(&connection_i->options, handle_info == NULL ? &server_i->options : &handle_info->options, sizeof(connection_i->options));
+    cat_socket_internal_on_open(connection_i, cat_socket_type_to_af(handle_info == NULL ? server_i->type : handle_info->type));
+}
+
 static cat_bool_t cat_socket_internal_accept(
     cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i,
     cat_socket_inheritance_info_t *handle_info, cat_timeout_t timeout
@@ -1660,11 +1743,7 @@ static cat_bool_t cat_socket_internal_accept(
     int error;
 
     if (handle_info == NULL) {
-        cat_socket_type_t server_type = cat_socket_type_simplify(server_i->type);
-        cat_socket_type_t connection_type = connection_i->type;
-        if (unlikely((server_type & connection_type) != server_type)) {
-            cat_update_last_error(CAT_EINVAL, "Socket accept connection type mismatch, expect %s but got %s",
-                cat_socket_type_get_name(server_type), cat_socket_type_get_name(connection_type));
+        if (unlikely(!cat_socket_internal_accept_check_type(server_i, connection_i))) {
             return cat_false;
         }
     }
@@ -1673,11 +1752,7 @@ static cat_bool_t cat_socket_internal_accept(
         cat_bool_t ret;
         error = uv_accept(&server_i->u.stream, &connection_i->u.stream);
         if (error == 0) {
-            /* init client properties */
-            connection_i->flags |= (CAT_SOCKET_INTERNAL_FLAG_ESTABLISHED | CAT_SOCKET_INTERNAL_FLAG_SERVER_CONNECTION);
-            /* TODO: socket_extends() ? */
-            memcpy(&connection_i->options, handle_info == NULL ? &server_i->options : &handle_info->options, sizeof(connection_i->options));
-            cat_socket_internal_on_open(connection_i, cat_socket_type_to_af(handle_info == NULL ? server_i->type : handle_info->type));
+            cat_socket_internal_on_accept(server_i, connection_i, handle_info);
             return cat_true;
         }
         if (unlikely(error != CAT_EAGAIN)) {
@@ -1762,6 +1837,77 @@ CAT_API cat_bool_t cat_socket_accept_ex(cat_socket_t *server, cat_socket_t *conn
     return ret;
 }
 
+static cat_bool_t cat_socket_internal_try_accept(cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i)
+{
+    int error;
+
+    if (unlikely(!cat_socket_internal_accept_check_type(server_i, connection_i))) {
+        return cat_false;
+    }
+
+    error = uv_accept(&server_i->u.stream, &connection_i->u.stream);
+#ifndef CAT_OS_WIN
+    if (error == CAT_EAGAIN) {
+        /* libuv holds at most one pending connection, and it will not accept
+         * the next one until the next poll, so we drain the backlog by ourselves */
+        int fd = uv__accept(cat_socket_internal_get_fd_fast(server_i));
+        if (fd < 0) {
+            error = fd;
+        } else {
+            error = uv__stream_open(&connection_i->u.stream, fd, UV_HANDLE_READABLE | UV_HANDLE_WRITABLE);
+            if (unlikely(error != 0)) {
+                uv__close(fd);
+            } else {
+                connection_i->u.stream.flags |= UV_HANDLE_BOUND;
+            }
+        }
+    }
+#endif
+    if (unlikely(error != 0)) {
+        if (error == CAT_EAGAIN) {
+            cat_update_last_error(CAT_EAGAIN, "Socket has no pending connection");
+        } else {
+            cat_update_last_error_with_reason(error, "Socket accept failed");
+        }
+        return cat_false;
+    }
+    cat_socket_internal_on_accept(server_i, connection_i, NULL);
+
+    return cat_true;
+}
+
+static cat_always_inline cat_bool_t cat_socket_try_accept_impl(cat_socket_t *server, cat_socket_t *connection)
+{
+    CAT_SOCKET_INTERNAL_GETTER_WITH_IO(server, server_i, CAT_SOCKET_IO_FLAG_ACCEPT, return cat_false);
+    CAT_SOCKET_INTERNAL_SERVER_ONLY(server_i, return cat_false);
+    if (unlikely(server_i->type & CAT_SOCKET_TYPE_FLAG_IPC)) {
+        cat_update_last_error(CAT_ENOTSUP, "Socket try accept can not act on an IPC socket");
+        return cat_false;
+    }
+
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(connection, connection_i, {
+        cat_update_last_error(CAT_EINVAL, "Socket accept can not act on an unavailable socket");
+        return cat_false;
+    });
+    if (unlikely(cat_socket_is_open(connection))) {
+        cat_update_last_error(CAT_EMISUSE, "Socket accept can only act on a lazy socket");
+        return cat_false;
+    }
+
+    return cat_socket_internal_try_accept(server_i, connection_i);
+}
+
+CAT_API cat_bool_t cat_socket_try_accept(cat_socket_t *server, cat_socket_t *connection)
+{
+    cat_bool_t ret = cat_socket_try_accept_impl(server, connection);
+
+    CAT_LOG_DEBUG(SOCKET, "try_accept(" CAT_SOCKET_ID_FMT ") = " CAT_SOCKET_ID_FMT  CAT_LOG_STRERRNO_FMT,
+        server->id, ret ? connection->id : CAT_SOCKET_INVALID_ID, CAT_LOG_STRERRNO_C(ret, cat_get_last_error_code()));
+    CAT_LOG_DEBUG_SOCKET_ESTABLISHED(connection, accepted, ret);
+
+    return ret;
+}
+
 static cat_always_inline void cat_socket_internal_on_connect_done(cat_socket_internal_t *socket_i, cat_sa_family_t af)
 {
     /* connect done successfully, we can do something here before transfer data */
@@ -1787,7 +1933,7 @@ static void cat_socket_internal_connect_callback(uv_connect_t* request, int stat
         cat_coroutine_schedule(coroutine, SOCKET, "Connect");
     }
 
-    cat_free(request);
+    cat_event_slab_free(request, sizeof(*request));
 }
 
 static void cat_socket_internal_try_connect_callback(uv_connect_t* request, int status)
@@ -1800,7 +1946,7 @@ static void cat_socket_internal_try_connect_callback(uv_connect_t* request, int
     }
 #endif
 
-    cat_free(request);
+    cat_event_slab_free(request, sizeof(*request));
 }
 
 static cat_bool_t cat_socket_internal_connect(
@@ -1817,7 +1963,7 @@ static cat_bool_t cat_socket_internal_connect(
     /* only TCP and PIPE need request */
     if (((type & CAT_SOCKET_TYPE_TCP) == CAT_SOCKET_TYPE_TCP) || (type & CAT_SOCKET_TYPE_FLAG_LOCAL)) {
         /* malloc for request (we must free it in the callback if it has been started) */
-        request = (uv_connect_t *) cat_malloc(sizeof(*request));
+        request = (uv_connect_t *) cat_event_slab_malloc(sizeof(*request));
 #if CAT_ALLOC_HANDLE_ERRORS
         if (unlikely(request == NULL)) {
             cat_update_last_error_of_syscall("Malloc for Socket connect request failed");
@@ -1834,7 +1980,7 @@ static cat_bool_t cat_socket_internal_connect(
         );
         if (unlikely(error != 0)) {
             cat_update_last_error_with_reason(error, "Tcp connect init failed");
-            cat_free(request);
+            cat_event_slab_free(request, sizeof(*request));
             return cat_false;
         }
     } else if ((type & CAT_SOCKET_TYPE_UDP) == CAT_SOCKET_TYPE_UDP) {
@@ -2117,9 +2263,46 @@ CAT_API void cat_socket_crypto_options_init(cat_socket_crypto_options_t *options
     options->no_ticket = cat_false;
     options->no_compression = cat_false;
     options->no_client_ca_list = cat_false;
+    options->no_session_cache = cat_false;
+    options->ktls = cat_false;
     options->context = NULL;
 }
 
+#ifdef CAT_SSL_HAVE_KTLS
+typedef struct cat_socket_ssl_ktls_writer_context_s {
+    cat_socket_t *socket;
+    cat_timeout_t timeout;
+} cat_socket_ssl_ktls_writer_context_t;
+
+static cat_bool_t cat_socket_ssl_ktls_write(void *data, const char *buffer, size_t length)
+{
+    cat_socket_ssl_ktls_writer_context_t *context = (cat_socket_ssl_ktls_writer_context_t *) data;
+    cat_bool_t ret;
+
+    CAT_TIME_WAIT_START() {
+        ret = cat_socket_send_ex(context->socket, buffer, length, context->timeout);
+    } CAT_TIME_WAIT_END(context->timeout);
+
+    return ret;
+}
+
+static cat_ret_t cat_socket_internal_ssl_ktls_wait_writable(cat_socket_internal_t *socket_i, cat_timeout_t timeout)
+{
+    /* fd is watched by libuv, poll on a dup of it */
+    cat_os_socket_t fd = dup(cat_socket_internal_get_fd_fast(socket_i));
+    cat_ret_t ret;
+
+    if (unlikely(fd == CAT_OS_INVALID_SOCKET)) {
+        cat_update_last_error_of_syscall("Socket SSL dup fd failed");
+        return CAT_RET_ERROR;
+    }
+    ret = cat_poll_one(fd, POLLOUT, NULL, timeout);
+    uv__close(fd);
+
+    return ret;
+}
+#endif
+
 /* TODO: Support non-blocking SSL handshake? (just for PHP, stupid design) */
 
 static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_socket_crypto_options_t *options, cat_timeout_t timeout)
@@ -2136,6 +2319,9 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     cat_ssl_context_t *context = NULL;
     cat_buffer_t *buffer;
     cat_socket_crypto_options_t ioptions;
+#ifdef CAT_SSL_HAVE_KTLS
+    cat_socket_ssl_ktls_writer_context_t ktls_writer_context;
+#endif
     cat_bool_t use_tmp_context;
     cat_bool_t ret = cat_false;
 
@@ -2218,6 +2404,31 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     if (ioptions.no_compression) {
         cat_ssl_context_set_no_compression(context);
     }
+    if (!ioptions.no_session_cache) {
+        char *session_id_context = NULL;
+        size_t session_id_context_length = 0;
+        cat_bool_t ret;
+        if (!ioptions.is_client) {
+            /* the certificate path and the client verification options, so that sessions are not
+             * resumed by servers with other certificates or with a stricter verification */
+            session_id_context = cat_slprintf("%s|%s|%s|%d", &session_id_context_length,
+                ioptions.certificate != NULL ? ioptions.certificate : "",
+                ioptions.ca_file != NULL ? ioptions.ca_file : "",
+                ioptions.ca_path != NULL ? ioptions.ca_path : "",
+                ioptions.verify_peer);
+            if (unlikely(session_id_context == NULL)) {
+                cat_update_last_error_of_syscall("Malloc for SSL session id context failed");
+                goto _setup_error;
+            }
+        }
+        ret = cat_ssl_context_enable_session_cache(context, ioptions.is_client, session_id_context, session_id_context_length);
+        if (session_id_context != NULL) {
+            cat_free(session_id_context);
+        }
+        if (!ret) {
+            goto _setup_error;
+        }
+    }
 #ifdef CAT_SSL_HAVE_SECURITY_LEVEL
     cat_ssl_context_set_security_level(context, ioptions.security_level);
 #endif
@@ -2249,7 +2460,43 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     if (ioptions.is_client && ioptions.peer_name != NULL) {
         cat_ssl_set_sni_server_name(ssl, ioptions.peer_name);
     }
+    if (ioptions.is_client && !ioptions.no_session_cache && ioptions.load_certficate == NULL) {
+        /* sessions are reused by host:port with the same client certificate and verify options,
+         * a session which was established without verification must not skip it later */
+        char host[CAT_SOCKADDR_MAX_PATH];
+        size_t host_length = sizeof(host);
+        int port = cat_socket_get_peer_port(socket);
+        if (ioptions.peer_name != NULL) {
+            host_length = strlen(ioptions.peer_name);
+        } else if (!cat_socket_get_peer_address(socket, host, &host_length)) {
+            host_length = 0;
+        }
+        if (host_length != 0 && port > 0) {
+            char *key;
+            size_t key_length;
+            key = cat_slprintf("%.*s:%d|%s|%s|%s|%d|%d|%d|%d|%d", &key_length,
+                (int) host_length, ioptions.peer_name != NULL ? ioptions.peer_name : host, port,
+                ioptions.certificate != NULL ? ioptions.certificate : "",
+                ioptions.ca_file != NULL ? ioptions.ca_file : "",
+                ioptions.ca_path != NULL ? ioptions.ca_path : "",
+                ioptions.verify_peer, ioptions.verify_peer_name, ioptions.allow_self_signed,
+                ioptions.verify_depth, (int) ioptions.protocols);
+            /* it is just an optimization, go on with full handshake if it failed */
+            if (likely(key != NULL)) {
+                (void) cat_ssl_set_session_key(ssl, key, key_length);
+                cat_free(key);
+            }
+        }
+    }
     ssl->allow_self_signed = ioptions.allow_self_signed;
+#ifdef CAT_SSL_HAVE_KTLS
+    ktls_writer_context.socket = socket;
+    ktls_writer_context.timeout = timeout;
+    if (ioptions.ktls && !cat_ssl_ktls_prepare(ssl, cat_socket_internal_get_fd_fast(socket_i), cat_socket_ssl_ktls_write, &ktls_writer_context)) {
+        /* keep going in user space */
+        CAT_LOG_DEBUG(SOCKET, "Socket SSL kTLS prepare failed, reason: %s", cat_get_last_error_message());
+    }
+#endif
 
     buffer = &ssl->read_buffer;
 
@@ -2257,10 +2504,34 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
         ssize_t n;
         cat_ssl_ret_t ssl_ret;
 
+#ifdef CAT_SSL_HAVE_KTLS
+        /* handshake records may be written by the kTLS writer */
+        ktls_writer_context.timeout = timeout;
+        ssl_ret = cat_ssl_handshake(ssl);
+        timeout = ktls_writer_context.timeout;
+#else
         ssl_ret = cat_ssl_handshake(ssl);
+#endif
         if (unlikely(ssl_ret == CAT_SSL_RET_ERROR)) {
             break;
         }
+#ifdef CAT_SSL_HAVE_KTLS
+        if (ssl_ret == CAT_SSL_RET_WANT_WRITE) {
+            /* records encrypted by the kernel are written by the socket BIO directly,
+             * it is rare since the writer always waits for the write completion */
+            cat_ret_t poll_ret;
+            CAT_TIME_WAIT_START() {
+                poll_ret = cat_socket_internal_ssl_ktls_wait_writable(socket_i, timeout);
+            } CAT_TIME_WAIT_END(timeout);
+            if (unlikely(poll_ret != CAT_RET_OK)) {
+                if (poll_ret == CAT_RET_NONE) {
+                    cat_update_last_error(CAT_ETIMEDOUT, "Socket SSL handshake timedout when poll writable");
+                }
+                break;
+            }
+            continue;
+        }
+#endif
         /* ssl_read_encrypted_bytes() may return n > 0
          * after ssl_handshake() return OK */
         n = cat_ssl_read_encrypted_bytes(ssl, buffer->value, buffer->size);
@@ -2324,6 +2595,11 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
             goto _unrecoverable_error;
         }
     }
+#ifdef CAT_SSL_HAVE_KTLS
+    if (ssl->flags & CAT_SSL_FLAG_KTLS_PREPARED) {
+        (void) cat_ssl_ktls_complete(ssl);
+    }
+#endif
 
     socket_i->ssl = ssl;
 
@@ -2360,7 +2636,9 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     "allow_self_signed: %s, " \
     "no_ticket: %s, " \
     "no_compression: %s, " \
-    "no_client_ca_list: %s" \
+    "no_client_ca_list: %s, " \
+    "no_session_cache: %s, " \
+    "ktls: %s" \
     " }"
 
 #define CAT_SOCKET_CRYPTO_OPTIONS_C(options, protocols_str) \
@@ -2380,7 +2658,9 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     cat_bool_str(options.allow_self_signed), \
     cat_bool_str(options.no_ticket), \
     cat_bool_str(options.no_compression), \
-    cat_bool_str(options.no_client_ca_list)
+    cat_bool_str(options.no_client_ca_list), \
+    cat_bool_str(options.no_session_cache), \
+    cat_bool_str(options.ktls)
 
 CAT_API cat_bool_t cat_socket_enable_crypto(cat_socket_t *socket, const cat_socket_crypto_options_t *options)
 {
@@ -2604,12 +2884,165 @@ typedef struct cat_socket_read_context_s {
     ssize_t error;
 } cat_socket_read_context_t;
 
+/* persistent read mode */
+
+static cat_always_inline cat_bool_t cat_socket_internal_support_inline_read(const cat_socket_internal_t *socket_i);
+
+static cat_always_inline cat_bool_t cat_socket_internal_is_read_persistent(const cat_socket_internal_t *socket_i)
+{
+    return (socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_READ_PERSISTENT) &&
+           (socket_i->type & CAT_SOCKET_TYPE_FLAG_STREAM) &&
+           cat_socket_internal_support_inline_read(socket_i);
+}
+
+static cat_always_inline cat_bool_t cat_socket_internal_has_read_ahead(const cat_socket_internal_t *socket_i)
+{
+    const cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+    return read_ahead != NULL && (read_ahead->length > 0 || read_ahead->error != 0);
+}
+
+static size_t cat_socket_read_ahead_copy(const cat_socket_read_ahead_t *read_ahead, char *buffer, size_t size)
+{
+    size_t n = CAT_MIN(size, read_ahead->length);
+    size_t tail_length = read_ahead->size - read_ahead->head;
+
+    if (n <= tail_length) {
+        memcpy(buffer, read_ahead->buffer + read_ahead->head, n);
+    } else {
+        memcpy(buffer, read_ahead->buffer + read_ahead->head, tail_length);
+        memcpy(buffer + tail_length, read_ahead->buffer, n - tail_length);
+    }
+
+    return n;
+}
+
+static size_t cat_socket_read_ahead_consume(cat_socket_read_ahead_t *read_ahead, char *buffer, size_t size)
+{
+    size_t n = cat_socket_read_ahead_copy(read_ahead, buffer, size);
+
+    read_ahead->length -= n;
+    if (read_ahead->length == 0) {
+        read_ahead->head = 0;
+    } else {
+        read_ahead->head = (read_ahead->head + n) % read_ahead->size;
+    }
+
+    return n;
+}
+
+static void cat_socket_read_ahead_alloc(cat_socket_internal_t *socket_i, uv_buf_t *buf)
+{
+    cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+    size_t tail;
+
+    if (unlikely(read_ahead == NULL)) {
+        read_ahead = (cat_socket_read_ahead_t *) cat_malloc(offsetof(cat_socket_read_ahead_t, buffer) + CAT_SOCKET_READ_AHEAD_BUFFER_SIZE);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(read_ahead == NULL)) {
+            buf->base = NULL;
+            buf->len = 0;
+            return;
+        }
+#endif
+        read_ahead->head = 0;
+        read_ahead->length = 0;
+        read_ahead->error = 0;
+        read_ahead->size = CAT_SOCKET_READ_AHEAD_BUFFER_SIZE;
+        socket_i->read_ahead = read_ahead;
+        /* make buffered data visible to poll emulation */
+        RB_INSERT(cat_socket_internal_tree_s, &CAT_SOCKET_G(internal_tree), socket_i);
+    }
+    tail = (read_ahead->head + read_ahead->length) % read_ahead->size;
+    buf->base = read_ahead->buffer + tail;
+    if (read_ahead->length == read_ahead->size) {
+        buf->len = 0;
+    } else if (tail >= read_ahead->head) {
+        buf->len = (cat_socket_vector_length_t) (read_ahead->size - tail);
+    } else {
+        buf->len = (cat_socket_vector_length_t) (read_ahead->head - tail);
+    }
+}
+
+static void cat_socket_read_ahead_callback(cat_socket_internal_t *socket_i, ssize_t nread)
+{
+    cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+
+    if (nread > 0) {
+        read_ahead->length += nread;
+        return;
+    }
+    /* buffer is full (or alloc failed), stop reading until someone consumes it */
+    if (nread == CAT_ENOBUFS) {
+        uv_read_stop(&socket_i->u.stream);
+    } else if (read_ahead != NULL) {
+        /* EOF or io error, libuv has already stopped reading */
+        read_ahead->error = nread;
+    }
+    socket_i->flags &= ~CAT_SOCKET_INTERNAL_FLAG_READING;
+}
+
+/* put data back to the front of the read-ahead buffer, so it is served by the next read */
+static cat_bool_t cat_socket_read_ahead_put_back(cat_socket_internal_t *socket_i, const char *data, size_t length)
+{
+    cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+    size_t head, tail_length;
+
+    if (length == 0) {
+        return cat_true;
+    }
+    if (read_ahead == NULL || read_ahead->size - read_ahead->length < length) {
+        size_t buffered_length = read_ahead != NULL ? read_ahead->length : 0;
+        size_t size = CAT_MAX(CAT_SOCKET_READ_AHEAD_BUFFER_SIZE, buffered_length + length);
+        cat_socket_read_ahead_t *new_read_ahead;
+        /* it is only called between reads, so no buffer of it is held by the event loop */
+        new_read_ahead = (cat_socket_read_ahead_t *) cat_malloc(offsetof(cat_socket_read_ahead_t, buffer) + size);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(new_read_ahead == NULL)) {
+            cat_update_last_error_of_syscall("Malloc for socket read-ahead buffer failed");
+            return cat_false;
+        }
+#endif
+        new_read_ahead->head = 0;
+        new_read_ahead->length = buffered_length + length;
+        new_read_ahead->size = size;
+        memcpy(new_read_ahead->buffer, data, length);
+        if (read_ahead != NULL) {
+            (void) cat_socket_read_ahead_copy(read_ahead, new_read_ahead->buffer + length, buffered_length);
+            new_read_ahead->error = read_ahead->error;
+            cat_free(read_ahead);
+        } else {
+            new_read_ahead->error = 0;
+            /* make buffered data visible to poll emulation */
+            RB_INSERT(cat_socket_internal_tree_s, &CAT_SOCKET_G(internal_tree), socket_i);
+        }
+        socket_i->read_ahead = new_read_ahead;
+        return cat_true;
+    }
+    head = (read_ahead->head + read_ahead->size - length) % read_ahead->size;
+    tail_length = read_ahead->size - head;
+    if (length <= tail_length) {
+        memcpy(read_ahead->buffer + head, data, length);
+    } else {
+        memcpy(read_ahead->buffer + head, data, tail_length);
+        memcpy(read_ahead->buffer, data + tail_length, length - tail_length);
+    }
+    read_ahead->head = head;
+    read_ahead->length += length;
+
+    return cat_true;
+}
+
 static void cat_socket_read_alloc_callback(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf)
 {
     (void) suggested_size;
     cat_socket_internal_t *socket_i = cat_container_of(handle, cat_socket_internal_t, u.handle);
     cat_socket_read_context_t *context = (cat_socket_read_context_t *) socket_i->context.io.read.data.ptr;
 
+    if (context == NULL) {
+        /* nobody is reading now (persistent read mode) */
+        cat_socket_read_ahead_alloc(socket_i, buf);
+        return;
+    }
     buf->base = context->buffer + context->nread;
     buf->len =  (cat_socket_vector_length_t) (context->size - context->nread);
 }
@@ -2620,13 +3053,21 @@ static void cat_socket_read_callback(uv_stream_t *stream, ssize_t nread, const u
     cat_socket_internal_t *socket_i = cat_container_of(stream, cat_socket_internal_t, u.stream);
     cat_socket_read_context_t *context = (cat_socket_read_context_t *) socket_i->context.io.read.data.ptr;
 
-    CAT_ASSERT(context != NULL);
-
     /* 0 == EAGAIN */
     if (nread == 0) {
         return;
     }
 
+    if (context == NULL) {
+        CAT_ASSERT(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_READING);
+        cat_socket_read_ahead_callback(socket_i, nread);
+        return;
+    }
+    if (nread < 0 && nread != CAT_ENOBUFS) {
+        /* libuv stops reading on EOF or error */
+        socket_i->flags &= ~CAT_SOCKET_INTERNAL_FLAG_READING;
+    }
+
     if (nread > 0) {
         context->nread += nread;
     }
@@ -2746,6 +3187,7 @@ static ssize_t cat_socket_internal_read_raw(
 #ifdef CAT_OS_UNIX_LIKE
     cat_bool_t is_udg = (socket_i->type & CAT_SOCKET_TYPE_UDG) == CAT_SOCKET_TYPE_UDG;
 #endif
+    cat_bool_t is_persistent = cat_false;
     size_t nread = 0;
     ssize_t error;
 
@@ -2758,6 +3200,27 @@ static ssize_t cat_socket_internal_read_raw(
         if (unlikely(address_length != NULL)) {
             *address_length = 0;
         }
+        is_persistent = cat_socket_internal_is_read_persistent(socket_i);
+        /* serve data which arrived while nobody was reading first */
+        if (unlikely(cat_socket_internal_has_read_ahead(socket_i))) {
+            cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+            nread = cat_socket_read_ahead_consume(read_ahead, buffer, size);
+            if (nread == size || (once && nread > 0)) {
+                return (ssize_t) nread;
+            }
+            if (read_ahead->length == 0 && read_ahead->error != 0) {
+                if (read_ahead->error == CAT_EOF) {
+                    if (once) {
+                        /* connection closed normally */
+                        return (ssize_t) nread;
+                    }
+                    error = CAT_ECONNRESET;
+                } else {
+                    error = read_ahead->error;
+                }
+                goto _error;
+            }
+        }
     } else {
         once = cat_true;
     }
@@ -2765,8 +3228,11 @@ static ssize_t cat_socket_internal_read_raw(
 #ifdef CAT_OS_UNIX_LIKE /* Do not inline read on WIN, proactor way is faster */
     /* Notice: when IO is low/slow, this is de-optimization,
      * because recv usually returns EAGAIN error,
-     * and there is an additional system call overhead */
-    if (likely(cat_socket_internal_support_inline_read(socket_i))) {
+     * and there is an additional system call overhead.
+     * In persistent read mode, event loop will deliver the data
+     * once read interest has been armed, so skip it */
+    if (likely(cat_socket_internal_support_inline_read(socket_i)) &&
+        !(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_READING)) {
         cat_socket_fd_t fd = cat_socket_internal_get_fd_fast(socket_i);
         if (unlikely(fd == CAT_SOCKET_INVALID_FD)) {
             CAT_ASSERT(is_dgram && "only dgram fd creation is lazy");
@@ -2845,7 +3311,14 @@ static ssize_t cat_socket_internal_read_raw(
          * because read_alloc_callback may triggered immediately on Windows,
          * and it requires some data from context. */
         if (!is_udp) {
-            error = uv_read_start(&socket_i->u.stream, cat_socket_read_alloc_callback, cat_socket_read_callback);
+            if (socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_READING) {
+                error = 0;
+            } else {
+                error = uv_read_start(&socket_i->u.stream, cat_socket_read_alloc_callback, cat_socket_read_callback);
+                if (error == 0 && is_persistent) {
+                    socket_i->flags |= CAT_SOCKET_INTERNAL_FLAG_READING;
+                }
+            }
         } else {
             error = uv_udp_recv_start(&socket_i->u.udp, cat_socket_read_alloc_callback, cat_socket_udp_recv_callback);
         }
@@ -2856,9 +3329,14 @@ static ssize_t cat_socket_internal_read_raw(
         if (unlikely(error != 0)) {
             goto _error;
         }
-        /* read stop after wait done */
+        /* read stop after wait done (unless read interest is persistent) */
         if (!is_udp) {
-            uv_read_stop(&socket_i->u.stream);
+            if (!(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_READING) ||
+                unlikely(!cat_socket_internal_is_read_persistent(socket_i) ||
+                         (socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_CLOSED))) {
+                uv_read_stop(&socket_i->u.stream);
+                socket_i->flags &= ~CAT_SOCKET_INTERNAL_FLAG_READING;
+            }
         } else {
             uv_udp_recv_stop(&socket_i->u.udp);
         }
@@ -2911,6 +3389,16 @@ static ssize_t cat_socket_internal_try_recv_raw(
     if (unlikely(fd == CAT_SOCKET_INVALID_FD)) {
         return CAT_EBADF;
     }
+    if (unlikely(cat_socket_internal_has_read_ahead(socket_i))) {
+        cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+        if (address_length != NULL) {
+            *address_length = 0;
+        }
+        if (read_ahead->length > 0) {
+            return (ssize_t) cat_socket_read_ahead_consume(read_ahead, buffer, size);
+        }
+        return read_ahead->error == CAT_EOF ? 0 : read_ahead->error;
+    }
 
     while (1) {
         nread = recvfrom(
@@ -3064,41 +3552,341 @@ static cat_always_inline ssize_t cat_socket_internal_read(
     return cat_socket_internal_read_raw(socket_i, buffer, size, address, address_length, timeout, once);
 }
 
-static cat_always_inline ssize_t cat_socket_internal_try_recv(
-    cat_socket_internal_t *socket_i,
-    char *buffer, size_t size,
-    cat_sockaddr_t *address, cat_socklen_t *address_length
+/* take buffered data up to and including the delimiter (which may start in the first *length bytes of buffer),
+ * data is scanned in place, so the rest is neither copied nor put back */
+static cat_bool_t cat_socket_read_ahead_consume_until(
+    cat_socket_read_ahead_t *read_ahead,
+    char *buffer, size_t *length, size_t size,
+    const char *delimiter, size_t delimiter_length
 )
 {
-#ifdef CAT_SSL
-    if (socket_i->ssl != NULL) {
-        return cat_socket_internal_try_recv_decrypted(socket_i, buffer, size, address, address_length);
+    size_t overlap = delimiter_length - 1;
+
+    while (read_ahead->length > 0 && *length < size) {
+        const char *data = read_ahead->buffer + read_ahead->head;
+        size_t data_length = CAT_MIN(read_ahead->length, read_ahead->size - read_ahead->head);
+        const char *found;
+        size_t taken;
+
+        data_length = CAT_MIN(data_length, size - *length);
+        /* delimiter may span the data which has been taken and the buffered data */
+        if (overlap > 0 && *length > 0) {
+            size_t start = *length > overlap ? *length - overlap : 0;
+            size_t tail_length = CAT_MIN(overlap, data_length);
+            memcpy(buffer + *length, data, tail_length);
+            found = cat_memmem(buffer + start, *length + tail_length - start, delimiter, delimiter_length);
+            if (found != NULL) {
+                taken = (size_t) (found - buffer) + delimiter_length - *length;
+                *length += cat_socket_read_ahead_consume(read_ahead, buffer + *length, taken);
+                return cat_true;
+            }
+        }
+        found = cat_memmem(data, data_length, delimiter, delimiter_length);
+        if (found != NULL) {
+            taken = (size_t) (found - data) + delimiter_length;
+            *length += cat_socket_read_ahead_consume(read_ahead, buffer + *length, taken);
+            return cat_true;
+        }
+        /* all of them belong to the current frame */
+        *length += cat_socket_read_ahead_consume(read_ahead, buffer + *length, data_length);
     }
-#endif
-    return cat_socket_internal_try_recv_raw(socket_i, buffer, size, address, address_length);
-}
-
-CAT_STATIC_ASSERT(sizeof(cat_socket_write_vector_t) == sizeof(uv_buf_t));
-CAT_STATIC_ASSERT(offsetof(cat_socket_write_vector_t, base) == offsetof(uv_buf_t, base));
-CAT_STATIC_ASSERT(offsetof(cat_socket_write_vector_t, length) == offsetof(uv_buf_t, len));
 
-CAT_API size_t cat_socket_write_vector_length(const cat_socket_write_vector_t *vector, unsigned int vector_count)
-{
-    return cat_io_vector_length((const cat_io_vector_t *) vector, vector_count);
+    return cat_false;
 }
 
-#ifdef CAT_ENABLE_DEBUG_LOG
-static CAT_BUFFER_STR_FREE char *cat_socket_write_vector_str(const cat_socket_write_vector_t *vector, unsigned int vector_count)
+static ssize_t cat_socket_internal_recv_until(
+    cat_socket_internal_t *socket_i,
+    char *buffer, size_t size,
+    const char *delimiter, size_t delimiter_length,
+    cat_timeout_t timeout
+)
 {
-    cat_buffer_t buffer;
-    unsigned int i;
-    cat_buffer_create(&buffer, 256);
-    cat_buffer_append_char(&buffer, '[');
-    for (i = 0; i < vector_count; i++) {
-        size_t show_length = CAT_MIN(vector[i].length, CAT_LOG_G(str_size));
-        size_t need_size = cat_str_quote_size(show_length, CAT_STR_QUOTE_STYLE_FLAG_NONE);
-        if (i > 0) {
-            cat_buffer_append_str(&buffer, ", ");
+    const char *found;
+    size_t length = 0, scanned = 0, frame_length;
+    ssize_t n;
+
+    while (1) {
+        cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+        if (read_ahead != NULL && read_ahead->length > 0) {
+            if (cat_socket_read_ahead_consume_until(read_ahead, buffer, &length, size, delimiter, delimiter_length)) {
+                return (ssize_t) length;
+            }
+            if (unlikely(length == size)) {
+                cat_update_last_error(CAT_EMSGSIZE, "Delimiter was not found in %zu bytes", size);
+                goto _error;
+            }
+            scanned = length >= delimiter_length ? length - (delimiter_length - 1) : 0;
+            continue;
+        }
+        /* only new bytes are received here */
+        CAT_TIME_WAIT_START() {
+            n = cat_socket_internal_read_raw(socket_i, buffer + length, size - length, NULL, NULL, timeout, cat_true);
+        } CAT_TIME_WAIT_END(timeout);
+        if (unlikely(n <= 0)) {
+            if (n == 0) {
+                cat_update_last_error(CAT_ECONNRESET, "Connection closed before delimiter was found");
+            }
+            goto _error;
+        }
+        length += n;
+        /* only the new data (and the tail which may be a part of delimiter) is scanned */
+        found = cat_memmem(buffer + scanned, length - scanned, delimiter, delimiter_length);
+        if (found != NULL) {
+            break;
+        }
+        if (unlikely(length == size)) {
+            cat_update_last_error(CAT_EMSGSIZE, "Delimiter was not found in %zu bytes", size);
+            goto _error;
+        }
+        if (length >= delimiter_length) {
+            scanned = length - (delimiter_length - 1);
+        }
+    }
+
+    frame_length = (size_t) (found - buffer) + delimiter_length;
+    /* the data after the delimiter belongs to the next frame, it is copied back once,
+     * the following calls scan it in place */
+    if (unlikely(!cat_socket_read_ahead_put_back(socket_i, buffer + frame_length, length - frame_length))) {
+        cat_update_last_error_with_previous("Socket recv until failed");
+        return -1;
+    }
+
+    return (ssize_t) frame_length;
+
+    _error:
+    /* nothing is consumed if frame is not completed, so it can be retried */
+    if (length > 0 && unlikely(!cat_socket_read_ahead_put_back(socket_i, buffer, length))) {
+        cat_update_last_error_with_previous("Socket recv until failed");
+    }
+    return -1;
+}
+
+CAT_API cat_bool_t cat_socket_frame_format_init(cat_socket_frame_format_t *format, size_t length_size, cat_bool_t little_endian, size_t length_offset, size_t max_length)
+{
+    if (unlikely(length_size != 1 && length_size != 2 && length_size != 4 && length_size != 8)) {
+        cat_update_last_error(CAT_EINVAL, "Frame length size must be 1, 2, 4 or 8, got %zu", length_size);
+        return cat_false;
+    }
+    if (unlikely(length_offset > CAT_SOCKET_FRAME_HEADER_MAX_SIZE - length_size)) {
+        cat_update_last_error(CAT_EINVAL, "Frame header size must be less than or equal to %d", CAT_SOCKET_FRAME_HEADER_MAX_SIZE);
+        return cat_false;
+    }
+    format->length_size = (uint8_t) length_size;
+    format->little_endian = little_endian;
+    format->length_offset = length_offset;
+    format->max_length = max_length;
+
+    return cat_true;
+}
+
+CAT_API size_t cat_socket_frame_format_get_header_size(const cat_socket_frame_format_t *format)
+{
+    return format->length_offset + format->length_size;
+}
+
+static uint64_t cat_socket_frame_header_unpack(const cat_socket_frame_format_t *format, const char *header)
+{
+    const unsigned char *field = (const unsigned char *) header + format->length_offset;
+    uint64_t length = 0;
+    uint8_t i;
+
+    if (format->little_endian) {
+        for (i = format->length_size; i > 0; i--) {
+            length = (length << 8) | field[i - 1];
+        }
+    } else {
+        for (i = 0; i < format->length_size; i++) {
+            length = (length << 8) | field[i];
+        }
+    }
+
+    return length;
+}
+
+static void cat_socket_frame_header_pack(const cat_socket_frame_format_t *format, char *header, uint64_t length)
+{
+    unsigned char *field = (unsigned char *) header + format->length_offset;
+    uint8_t i;
+
+    memset(header, 0, format->length_offset);
+    if (format->little_endian) {
+        for (i = 0; i < format->length_size; i++) {
+            field[i] = (unsigned char) length;
+            length >>= 8;
+        }
+    } else {
+        for (i = format->length_size; i > 0; i--) {
+            field[i - 1] = (unsigned char) length;
+            length >>= 8;
+        }
+    }
+}
+
+static ssize_t cat_socket_internal_recv_frames(
+    cat_socket_internal_t *socket_i,
+    const cat_socket_frame_format_t *format,
+    cat_buffer_t *buffer, size_t *lengths, size_t count,
+    cat_timeout_t timeout
+)
+{
+    size_t header_size = cat_socket_frame_format_get_header_size(format);
+    /* bodies are moved to [out, start), data which has not been consumed is in [start, end) */
+    size_t out = buffer->length, start = out, end = out;
+    size_t expected_size = header_size, n = 0;
+    cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+    uint64_t length;
+    ssize_t nread;
+
+    /* take complete frames from the buffered data in place, so the rest is neither copied nor put back */
+    if (read_ahead != NULL && read_ahead->length > 0) {
+        char header[CAT_SOCKET_FRAME_HEADER_MAX_SIZE];
+        while (read_ahead->length >= header_size) {
+            (void) cat_socket_read_ahead_copy(read_ahead, header, header_size);
+            length = cat_socket_frame_header_unpack(format, header);
+            if (unlikely((format->max_length != 0 && length > format->max_length) ||
+                         length > (uint64_t) (SIZE_MAX - out - header_size))) {
+                if (n > 0) {
+                    /* report it on the next call */
+                    break;
+                }
+                cat_update_last_error(CAT_EMSGSIZE, "Frame body length %" PRIu64 " exceeds the max length %zu", length, format->max_length);
+                return -1;
+            }
+            if (read_ahead->length - header_size < length) {
+                break;
+            }
+            if (buffer->size - out < length) {
+                if (unlikely(!cat_buffer_extend(buffer, out + (size_t) length))) {
+                    cat_update_last_error(CAT_ENOMEM, "Failed to extend buffer to %zu bytes for frame", out + (size_t) length);
+                    if (n > 0) {
+                        break;
+                    }
+                    return -1;
+                }
+            }
+            (void) cat_socket_read_ahead_consume(read_ahead, header, header_size);
+            out += cat_socket_read_ahead_consume(read_ahead, buffer->value + out, (size_t) length);
+            lengths[n++] = (size_t) length;
+            if (n == count) {
+                break;
+            }
+        }
+        if (n > 0) {
+            cat_buffer_commit(buffer, out - buffer->length);
+            return (ssize_t) n;
+        }
+        /* the frame is not completed, wait for the rest of it with the buffered part */
+        if (buffer->size - end < read_ahead->length) {
+            if (unlikely(!cat_buffer_extend(buffer, end + read_ahead->length))) {
+                cat_update_last_error(CAT_ENOMEM, "Failed to extend buffer to %zu bytes for frame", end + read_ahead->length);
+                return -1;
+            }
+        }
+        end += cat_socket_read_ahead_consume(read_ahead, buffer->value + end, read_ahead->length);
+    }
+
+    while (1) {
+        /* take all complete frames from the received data */
+        while (end - start >= header_size) {
+            length = cat_socket_frame_header_unpack(format, buffer->value + start);
+            if (unlikely((format->max_length != 0 && length > format->max_length) ||
+                         length > (uint64_t) (SIZE_MAX - start - header_size))) {
+                if (n > 0) {
+                    /* report it on the next call */
+                    goto _done;
+                }
+                cat_update_last_error(CAT_EMSGSIZE, "Frame body length %" PRIu64 " exceeds the max length %zu", length, format->max_length);
+                goto _error;
+            }
+            expected_size = header_size + (size_t) length;
+            if (end - start < expected_size) {
+                break;
+            }
+            memmove(buffer->value + out, buffer->value + start + header_size, (size_t) length);
+            out += (size_t) length;
+            start += expected_size;
+            expected_size = header_size;
+            lengths[n++] = (size_t) length;
+            if (n == count) {
+                goto _done;
+            }
+        }
+        /* only wait for the first one */
+        if (n > 0) {
+            goto _done;
+        }
+        if (buffer->size - start < expected_size) {
+            if (unlikely(!cat_buffer_extend(buffer, start + expected_size))) {
+                cat_update_last_error(CAT_ENOMEM, "Failed to extend buffer to %zu bytes for frame", start + expected_size);
+                goto _error;
+            }
+        }
+        /* read as much as possible, it may contain the following frames */
+        CAT_TIME_WAIT_START() {
+            nread = cat_socket_internal_read_raw(socket_i, buffer->value + end, buffer->size - end, NULL, NULL, timeout, cat_true);
+        } CAT_TIME_WAIT_END(timeout);
+        if (unlikely(nread <= 0)) {
+            if (nread == 0) {
+                cat_update_last_error(CAT_ECONNRESET, "Connection closed before frame was completed");
+            }
+            goto _error;
+        }
+        end += nread;
+    }
+
+    _done:
+    /* the rest belongs to the next frame */
+    if (unlikely(!cat_socket_read_ahead_put_back(socket_i, buffer->value + start, end - start))) {
+        cat_update_last_error_with_previous("Socket recv frames failed");
+        return -1;
+    }
+    cat_buffer_commit(buffer, out - buffer->length);
+
+    return (ssize_t) n;
+
+    _error:
+    /* nothing is consumed if frame is not completed, so it can be retried */
+    if (end > start && unlikely(!cat_socket_read_ahead_put_back(socket_i, buffer->value + start, end - start))) {
+        cat_update_last_error_with_previous("Socket recv frames failed");
+    }
+    return -1;
+}
+
+static cat_always_inline ssize_t cat_socket_internal_try_recv(
+    cat_socket_internal_t *socket_i,
+    char *buffer, size_t size,
+    cat_sockaddr_t *address, cat_socklen_t *address_length
+)
+{
+#ifdef CAT_SSL
+    if (socket_i->ssl != NULL) {
+        return cat_socket_internal_try_recv_decrypted(socket_i, buffer, size, address, address_length);
+    }
+#endif
+    return cat_socket_internal_try_recv_raw(socket_i, buffer, size, address, address_length);
+}
+
+CAT_STATIC_ASSERT(sizeof(cat_socket_write_vector_t) == sizeof(uv_buf_t));
+CAT_STATIC_ASSERT(offsetof(cat_socket_write_vector_t, base) == offsetof(uv_buf_t, base));
+CAT_STATIC_ASSERT(offsetof(cat_socket_write_vector_t, length) == offsetof(uv_buf_t, len));
+
+CAT_API size_t cat_socket_write_vector_length(const cat_socket_write_vector_t *vector, unsigned int vector_count)
+{
+    return cat_io_vector_length((const cat_io_vector_t *) vector, vector_count);
+}
+
+#ifdef CAT_ENABLE_DEBUG_LOG
+static CAT_BUFFER_STR_FREE char *cat_socket_write_vector_str(const cat_socket_write_vector_t *vector, unsigned int vector_count)
+{
+    cat_buffer_t buffer;
+    unsigned int i;
+    cat_buffer_create(&buffer, 256);
+    cat_buffer_append_char(&buffer, '[');
+    for (i = 0; i < vector_count; i++) {
+        size_t show_length = CAT_MIN(vector[i].length, CAT_LOG_G(str_size));
+        size_t need_size = cat_str_quote_size(show_length, CAT_STR_QUOTE_STYLE_FLAG_NONE);
+        if (i > 0) {
+            cat_buffer_append_str(&buffer, ", ");
         }
         cat_buffer_append_char(&buffer, '{');
         if (cat_buffer_prepare(&buffer, need_size)) {
@@ -3440,6 +4228,7 @@ static void cat_socket_internal_try_write_encrypted_callback(uv_write_t *request
     if (status == 0) {
         socket_i->ssl->write_buffer.length = 0;
     }
+    cat_event_slab_free(request, sizeof(*request));
 }
 
 static ssize_t cat_socket_internal_try_write_encrypted(
@@ -3528,7 +4317,7 @@ static ssize_t cat_socket_internal_try_write_encrypted(
             /* We tell caller all data has been sent, but actually they are in buffered,
                 * it's ok, just like syscall write() did. */
             CAT_LOG_DEBUG(SSL, "SSL %p write buffer now has %zu bytes queued data", ssl, ssl->write_buffer.length);
-            uv_write_t *request = (uv_write_t *) cat_malloc(sizeof(*request));
+            uv_write_t *request = (uv_write_t *) cat_event_slab_malloc(sizeof(*request));
 #if CAT_ALLOC_HANDLE_ERRORS
             if (unlikely(request == NULL)) {
                 nwrite = cat_translate_sys_error(cat_sys_errno);
@@ -3541,6 +4330,7 @@ static ssize_t cat_socket_internal_try_write_encrypted(
                 buf.len = (cat_io_vector_length_t) ssl->write_buffer.length;
                 int error = uv_write(request, &socket_i->u.stream, &buf, 1, cat_socket_internal_try_write_encrypted_callback);
                 if (unlikely(error != 0)) {
+                    cat_event_slab_free(request, sizeof(*request));
                     nwrite = error;
                 }
             }
@@ -3563,7 +4353,7 @@ static cat_always_inline cat_bool_t cat_socket_internal_write(
 #ifdef CAT_SSL
     /** @thinking: shall we check and wait for previous hanging write coroutines here?
      * before previous write() are done (writable/POLLOUT), may SSL can not encrypt more data? */
-    if (socket_i->ssl != NULL) {
+    if (cat_socket_internal_write_is_encrypted(socket_i)) {
         return cat_socket_internal_write_encrypted(socket_i, vector, vector_count, address, address_length, timeout);
     }
 #endif
@@ -3577,13 +4367,349 @@ static cat_always_inline ssize_t cat_socket_internal_try_write(
 )
 {
 #ifdef CAT_SSL
-    if (socket_i->ssl != NULL) {
+    if (cat_socket_internal_write_is_encrypted(socket_i)) {
         return cat_socket_internal_try_write_encrypted(socket_i, vector, vector_count, address, address_length);
     }
 #endif
     return cat_socket_internal_try_write_raw(socket_i, vector, vector_count, address, address_length);
 }
 
+/* batched datagram IO */
+
+#ifdef CAT_SOCKET_HAVE_MMSG
+typedef union {
+    char buffer[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+} cat_socket_mmsg_control_t;
+
+static void cat_socket_udp_wait_alloc_callback(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf)
+{
+    (void) handle;
+    (void) suggested_size;
+    /* libuv reports ENOBUFS without reading, datagrams stay in the socket for recvmmsg */
+    buf->base = NULL;
+    buf->len = 0;
+}
+
+static void cat_socket_udp_wait_recv_callback(uv_udp_t *udp, ssize_t nread, const uv_buf_t *buf, const struct sockaddr *address, unsigned flags)
+{
+    (void) buf;
+    (void) address;
+    (void) flags;
+    cat_socket_internal_t *socket_i = cat_container_of(udp, cat_socket_internal_t, u.udp);
+    int *error = (int *) socket_i->context.io.read.data.ptr;
+
+    CAT_ASSERT(error != NULL);
+    /* stop it immediately, otherwise we would be called again and again until data is consumed */
+    uv_udp_recv_stop(udp);
+    *error = nread == CAT_ENOBUFS ? 0 : (int) nread;
+    cat_coroutine_schedule(socket_i->context.io.read.coroutine, SOCKET, "UDP wait readable");
+}
+
+static int cat_socket_internal_udp_wait_readable(cat_socket_internal_t *socket_i, cat_timeout_t timeout)
+{
+    int error;
+    cat_bool_t ret;
+
+    error = uv_udp_recv_start(&socket_i->u.udp, cat_socket_udp_wait_alloc_callback, cat_socket_udp_wait_recv_callback);
+    if (unlikely(error != 0)) {
+        return error;
+    }
+    error = CAT_ECANCELED;
+    socket_i->context.io.read.data.ptr = &error;
+    socket_i->context.io.read.coroutine = CAT_COROUTINE_G(current);
+    socket_i->io_flags |= CAT_SOCKET_IO_FLAG_READ;
+    ret = cat_time_wait(timeout);
+    socket_i->io_flags ^= CAT_SOCKET_IO_FLAG_READ;
+    socket_i->context.io.read.coroutine = NULL;
+    socket_i->context.io.read.data.ptr = NULL;
+    uv_udp_recv_stop(&socket_i->u.udp);
+    if (unlikely(!ret)) {
+        return CAT_EPREV;
+    }
+    return error;
+}
+
+static ssize_t cat_socket_internal_try_recvmmsg(cat_socket_internal_t *socket_i, cat_socket_fd_t fd, cat_socket_datagram_t *datagrams, size_t count)
+{
+    struct uv__mmsghdr messages[CAT_SOCKET_MMSG_BATCH_SIZE];
+    struct iovec iov[CAT_SOCKET_MMSG_BATCH_SIZE];
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+    cat_socket_mmsg_control_t controls[CAT_SOCKET_MMSG_BATCH_SIZE];
+    cat_bool_t gro = !!(socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_UDP_GRO);
+#endif
+    size_t n = 0;
+
+    while (n < count) {
+        unsigned int batch = (unsigned int) CAT_MIN(count - n, CAT_SOCKET_MMSG_BATCH_SIZE), i;
+        int ret;
+        for (i = 0; i < batch; i++) {
+            cat_socket_datagram_t *datagram = &datagrams[n + i];
+            struct msghdr *message = &messages[i].msg_hdr;
+            iov[i].iov_base = datagram->buffer;
+            iov[i].iov_len = datagram->size;
+            message->msg_name = &datagram->address.address;
+            message->msg_namelen = sizeof(datagram->address.address);
+            message->msg_iov = &iov[i];
+            message->msg_iovlen = 1;
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+            if (gro) {
+                message->msg_control = controls[i].buffer;
+                message->msg_controllen = sizeof(controls[i].buffer);
+            } else
+#endif
+            {
+                message->msg_control = NULL;
+                message->msg_controllen = 0;
+            }
+            message->msg_flags = 0;
+        }
+        do {
+            ret = uv__recvmmsg(fd, messages, batch);
+        } while (ret < 0 && cat_sys_errno == EINTR);
+        if (ret < 0) {
+            if (n > 0) {
+                /* report it on the next call */
+                break;
+            }
+            if (cat_sys_errno == EAGAIN || cat_sys_errno == EWOULDBLOCK) {
+                return CAT_EAGAIN;
+            }
+            return cat_translate_sys_error(cat_sys_errno);
+        }
+        for (i = 0; i < (unsigned int) ret; i++) {
+            cat_socket_datagram_t *datagram = &datagrams[n + i];
+            datagram->length = messages[i].msg_len;
+            datagram->address.length = messages[i].msg_hdr.msg_namelen;
+            datagram->segment_size = 0;
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+            if (gro) {
+                struct msghdr *message = &messages[i].msg_hdr;
+                struct cmsghdr *cmsg;
+                for (cmsg = CMSG_FIRSTHDR(message); cmsg != NULL; cmsg = CMSG_NXTHDR(message, cmsg)) {
+                    if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+                        int segment_size;
+                        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+                        datagram->segment_size = (size_t) segment_size;
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+        n += ret;
+        if ((unsigned int) ret < batch) {
+            /* drained */
+            break;
+        }
+    }
+
+    return (ssize_t) n;
+}
+
+static ssize_t cat_socket_internal_try_sendmmsg(cat_socket_internal_t *socket_i, cat_socket_fd_t fd, const cat_socket_datagram_t *datagrams, size_t count)
+{
+    struct uv__mmsghdr messages[CAT_SOCKET_MMSG_BATCH_SIZE];
+    struct iovec iov[CAT_SOCKET_MMSG_BATCH_SIZE];
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+    cat_socket_mmsg_control_t controls[CAT_SOCKET_MMSG_BATCH_SIZE];
+#endif
+    size_t n = 0;
+    (void) socket_i;
+
+    while (n < count) {
+        unsigned int batch = (unsigned int) CAT_MIN(count - n, CAT_SOCKET_MMSG_BATCH_SIZE), i;
+        int ret;
+        for (i = 0; i < batch; i++) {
+            const cat_socket_datagram_t *datagram = &datagrams[n + i];
+            struct msghdr *message = &messages[i].msg_hdr;
+            iov[i].iov_base = datagram->buffer;
+            iov[i].iov_len = datagram->length;
+            if (datagram->address.length != 0) {
+                message->msg_name = (void *) &datagram->address.address;
+                message->msg_namelen = datagram->address.length;
+            } else {
+                message->msg_name = NULL;
+                message->msg_namelen = 0;
+            }
+            message->msg_iov = &iov[i];
+            message->msg_iovlen = 1;
+            message->msg_control = NULL;
+            message->msg_controllen = 0;
+#ifdef CAT_SOCKET_HAVE_UDP_OFFLOAD
+            if (datagram->segment_size != 0) {
+                struct cmsghdr *cmsg;
+                uint16_t segment_size = (uint16_t) datagram->segment_size;
+                message->msg_control = controls[i].buffer;
+                message->msg_controllen = CMSG_SPACE(sizeof(segment_size));
+                cmsg = CMSG_FIRSTHDR(message);
+                cmsg->cmsg_level = IPPROTO_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size));
+                memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+            }
+#endif
+            message->msg_flags = 0;
+        }
+        do {
+            ret = uv__sendmmsg(fd, messages, batch);
+        } while (ret < 0 && CAT_SOCKET_RETRY_ON_WRITE_ERROR(cat_sys_errno));
+        if (ret < 0) {
+            if (n > 0) {
+                break;
+            }
+            if (CAT_SOCKET_IS_TRANSIENT_WRITE_ERROR(cat_sys_errno)) {
+                return CAT_EAGAIN;
+            }
+            return cat_translate_sys_error(cat_sys_errno);
+        }
+        n += ret;
+        if ((unsigned int) ret < batch) {
+            break;
+        }
+    }
+
+    return (ssize_t) n;
+}
+#endif /* CAT_SOCKET_HAVE_MMSG */
+
+static ssize_t cat_socket_internal_recvfrom_many(
+    cat_socket_internal_t *socket_i,
+    cat_socket_datagram_t *datagrams, size_t count,
+    cat_timeout_t timeout
+)
+{
+    size_t n = 0;
+    ssize_t error;
+
+    if (unlikely(count == 0)) {
+        return 0;
+    }
+#ifdef CAT_SOCKET_HAVE_MMSG
+    if ((socket_i->type & CAT_SOCKET_TYPE_UDP) == CAT_SOCKET_TYPE_UDP) {
+        while (1) {
+            cat_socket_fd_t fd = cat_socket_internal_get_fd_fast(socket_i);
+            if (likely(fd != CAT_SOCKET_INVALID_FD)) {
+                error = cat_socket_internal_try_recvmmsg(socket_i, fd, datagrams, count);
+                if (error > 0) {
+                    return error;
+                }
+                if (unlikely(error == CAT_ENOSYS)) {
+                    break;
+                }
+                if (unlikely(error != CAT_EAGAIN)) {
+                    cat_update_last_error_with_reason((cat_errno_t) error, "Socket recvfrom many failed");
+                    return -1;
+                }
+            }
+            /* recv_start() binds the socket if it has not been bound yet */
+            error = cat_socket_internal_udp_wait_readable(socket_i, timeout);
+            if (unlikely(error != 0)) {
+                if (error == CAT_EPREV) {
+                    cat_update_last_error_with_previous("Socket read wait failed");
+                } else if (error == CAT_ECANCELED) {
+                    cat_update_last_error(CAT_ECANCELED, "Socket read has been canceled");
+                } else {
+                    cat_update_last_error_with_reason((cat_errno_t) error, "Socket recvfrom many failed");
+                }
+                return -1;
+            }
+        }
+    }
+#endif
+    /* wait for the first one, then take what is already there */
+    do {
+        cat_socket_datagram_t *datagram = &datagrams[n];
+        datagram->address.length = sizeof(datagram->address.address);
+        datagram->segment_size = 0;
+        if (n == 0) {
+            error = cat_socket_internal_read_raw(
+                socket_i, datagram->buffer, datagram->size,
+                &datagram->address.address.common, &datagram->address.length,
+                timeout, cat_true
+            );
+        } else {
+            error = cat_socket_internal_try_recv_raw(
+                socket_i, datagram->buffer, datagram->size,
+                &datagram->address.address.common, &datagram->address.length
+            );
+        }
+        if (error < 0) {
+            if (n == 0) {
+                return -1;
+            }
+            datagram->address.length = 0;
+            break;
+        }
+        datagram->length = (size_t) error;
+    } while (++n < count);
+
+    return (ssize_t) n;
+}
+
+static ssize_t cat_socket_internal_sendto_many(
+    cat_socket_internal_t *socket_i,
+    const cat_socket_datagram_t *datagrams, size_t count,
+    cat_timeout_t timeout
+)
+{
+    size_t n = 0;
+#ifdef CAT_SOCKET_HAVE_MMSG
+    cat_bool_t segmentation_offload = cat_true;
+#endif
+
+    while (n < count) {
+        const cat_socket_datagram_t *datagram;
+        const cat_sockaddr_t *address;
+        size_t offset, segment_size;
+#ifdef CAT_SOCKET_HAVE_MMSG
+        cat_socket_fd_t fd = cat_socket_internal_get_fd_fast(socket_i);
+        /* keep the order with the queued sends */
+        if ((socket_i->type & CAT_SOCKET_TYPE_UDP) == CAT_SOCKET_TYPE_UDP &&
+            fd != CAT_SOCKET_INVALID_FD &&
+            !(socket_i->io_flags & CAT_SOCKET_IO_FLAG_WRITE) &&
+            socket_i->u.udp.send_queue_count == 0 &&
+            (segmentation_offload || datagrams[n].segment_size == 0)) {
+            ssize_t error = cat_socket_internal_try_sendmmsg(socket_i, fd, datagrams + n, count - n);
+            if (error > 0) {
+                n += error;
+                continue;
+            }
+            /* UDP_SEGMENT is not supported by the kernel, the route or the device,
+             * segmented datagrams are split by ourselves from now on */
+            if (datagrams[n].segment_size != 0 &&
+                (error == CAT_EINVAL || error == CAT_EIO || error == CAT_ENOPROTOOPT)) {
+                segmentation_offload = cat_false;
+            } else if (unlikely(error != CAT_EAGAIN && error != CAT_ENOSYS)) {
+                cat_update_last_error_with_reason((cat_errno_t) error, "Socket sendto many failed");
+                break;
+            }
+        }
+#endif
+        /* send it in the common way and wait for it,
+         * segmented datagram is split by ourselves */
+        datagram = &datagrams[n];
+        address = datagram->address.length != 0 ? &datagram->address.address.common : NULL;
+        segment_size = datagram->segment_size != 0 ? datagram->segment_size : datagram->length;
+        offset = 0;
+        do {
+            size_t length = CAT_MIN(datagram->length - offset, segment_size);
+            cat_socket_write_vector_t vector = cat_socket_write_vector_init(datagram->buffer + offset, (cat_socket_vector_length_t) length);
+            if (unlikely(!cat_socket_internal_write_raw(socket_i, &vector, 1, address, datagram->address.length, NULL, timeout))) {
+                goto _out;
+            }
+            offset += length;
+        } while (offset < datagram->length);
+        n++;
+    }
+
+    _out:
+    if (n == 0 && count != 0) {
+        return -1;
+    }
+    return (ssize_t) n;
+}
+
 #define CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM_SILENT(_socket_i, _failure) do { \
     if (!(_socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)) { \
         CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY_SILENT(_socket_i, _failure); \
@@ -3794,6 +4920,47 @@ CAT_API cat_bool_t cat_socket_write_ex(cat_socket_t *socket, const cat_socket_wr
     return ret;
 }
 
+CAT_API cat_bool_t cat_socket_write_frame(cat_socket_t *socket, const cat_socket_frame_format_t *format, const cat_socket_write_vector_t *vector, unsigned int vector_count)
+{
+    return cat_socket_write_frame_ex(socket, format, vector, vector_count, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API cat_bool_t cat_socket_write_frame_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, const cat_socket_write_vector_t *vector, unsigned int vector_count, cat_timeout_t timeout)
+{
+    cat_socket_write_vector_t *frame_vector, frame_vector_on_stack[8];
+    char header[CAT_SOCKET_FRAME_HEADER_MAX_SIZE];
+    size_t length = cat_socket_write_vector_length(vector, vector_count);
+    cat_bool_t ret;
+
+    if (unlikely(format->length_size < sizeof(uint64_t) && (uint64_t) length >> (format->length_size * 8) != 0)) {
+        cat_update_last_error(CAT_EMSGSIZE, "Frame body length %zu can not be represented in %u bytes", length, (unsigned int) format->length_size);
+        return cat_false;
+    }
+    if (likely(vector_count < CAT_ARRAY_SIZE(frame_vector_on_stack))) {
+        frame_vector = frame_vector_on_stack;
+    } else {
+        frame_vector = (cat_socket_write_vector_t *) cat_malloc(sizeof(*frame_vector) * (vector_count + 1));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(frame_vector == NULL)) {
+            cat_update_last_error_of_syscall("Malloc for frame vector failed");
+            return cat_false;
+        }
+#endif
+    }
+    /* header is sent with the body in one go */
+    cat_socket_frame_header_pack(format, header, length);
+    frame_vector[0] = cat_socket_write_vector_init(header, (cat_socket_vector_length_t) cat_socket_frame_format_get_header_size(format));
+    memcpy(frame_vector + 1, vector, sizeof(*vector) * vector_count);
+
+    ret = cat_socket_write_ex(socket, frame_vector, vector_count + 1, timeout);
+
+    if (frame_vector != frame_vector_on_stack) {
+        cat_free(frame_vector);
+    }
+
+    return ret;
+}
+
 CAT_API ssize_t cat_socket_try_write(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count)
 {
     ssize_t n = cat_socket_try_write_impl(socket, vector, vector_count, NULL, 0);
@@ -3903,6 +5070,188 @@ CAT_API ssize_t cat_socket_try_write_to(cat_socket_t *socket, const cat_socket_w
     return n;
 }
 
+typedef struct cat_socket_post_write_request_s {
+    cat_socket_post_write_release_callback_t release;
+    cat_data_t *data;
+    uv_write_t request;
+} cat_socket_post_write_request_t;
+
+static void cat_socket_post_write_callback(uv_write_t *request, int status)
+{
+    cat_socket_post_write_request_t *post_request = cat_container_of(request, cat_socket_post_write_request_t, request);
+
+    if (unlikely(status != 0)) {
+        CAT_LOG_DEBUG(SOCKET, "Socket post write failed, reason: %s", cat_strerror(status));
+    }
+    if (post_request->release != NULL) {
+        post_request->release(post_request->data);
+    }
+    cat_event_slab_free(post_request, sizeof(*post_request));
+}
+
+CAT_API cat_socket_post_write_result_t cat_socket_post_write(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, size_t max_queue_size, cat_socket_post_write_release_callback_t release, cat_data_t *data)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return CAT_SOCKET_POST_WRITE_FAILED);
+    cat_socket_write_vector_t rest_vector_on_stack[8], *rest_vector = rest_vector_on_stack;
+    cat_socket_post_write_request_t *post_request;
+    unsigned int rest_vector_count = 0, i;
+    size_t length, queue_size;
+    size_t nwrite = 0, offset;
+    int error;
+
+    if (unlikely(!(socket_i->type & CAT_SOCKET_TYPE_FLAG_STREAM))) {
+        cat_update_last_error(CAT_EMISUSE, "Socket is not of type stream");
+        return CAT_SOCKET_POST_WRITE_FAILED;
+    }
+#ifdef CAT_SSL
+    if (unlikely(cat_socket_internal_write_is_encrypted(socket_i))) {
+        cat_update_last_error(CAT_ENOTSUP, "Socket post write does not support SSL");
+        return CAT_SOCKET_POST_WRITE_FAILED;
+    }
+#endif
+
+    length = cat_socket_write_vector_length(vector, vector_count);
+    if (unlikely(length == 0)) {
+        return CAT_SOCKET_POST_WRITE_DONE;
+    }
+    queue_size = socket_i->u.stream.write_queue_size;
+    if (queue_size != 0) {
+        /* never split data if we can not queue all of it */
+        if (queue_size + length > max_queue_size) {
+            return CAT_SOCKET_POST_WRITE_SKIPPED;
+        }
+    } else {
+        ssize_t n = uv_try_write(&socket_i->u.stream, (const uv_buf_t *) vector, vector_count);
+        if (n < 0) {
+            if (unlikely(n != CAT_EAGAIN)) {
+                cat_update_last_error_with_reason((cat_errno_t) n, "Socket post write failed");
+                return CAT_SOCKET_POST_WRITE_FAILED;
+            }
+        } else {
+            nwrite = (size_t) n;
+            if (nwrite == length) {
+                return CAT_SOCKET_POST_WRITE_DONE;
+            }
+        }
+    }
+
+    /* queue the rest of data */
+    offset = nwrite;
+    if (unlikely(vector_count > CAT_ARRAY_SIZE(rest_vector_on_stack))) {
+        rest_vector = (cat_socket_write_vector_t *) cat_malloc(sizeof(*rest_vector) * vector_count);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(rest_vector == NULL)) {
+            cat_update_last_error_of_syscall("Malloc for post write vector failed");
+            goto _error;
+        }
+#endif
+    }
+    for (i = 0; i < vector_count; i++) {
+        if (offset >= vector[i].length) {
+            offset -= vector[i].length;
+            continue;
+        }
+        rest_vector[rest_vector_count].base = vector[i].base + offset;
+        rest_vector[rest_vector_count].length = vector[i].length - (cat_socket_vector_length_t) offset;
+        rest_vector_count++;
+        offset = 0;
+    }
+    post_request = (cat_socket_post_write_request_t *) cat_event_slab_malloc(sizeof(*post_request));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(post_request == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for post write request failed");
+        goto _error;
+    }
+#endif
+    post_request->release = release;
+    post_request->data = data;
+    /* uv_write() copies the vector */
+    error = uv_write(&post_request->request, &socket_i->u.stream, (const uv_buf_t *) rest_vector, rest_vector_count, cat_socket_post_write_callback);
+    if (unlikely(error != 0)) {
+        cat_event_slab_free(post_request, sizeof(*post_request));
+        cat_update_last_error_with_reason(error, "Socket post write failed");
+        goto _error;
+    }
+    if (unlikely(rest_vector != rest_vector_on_stack)) {
+        cat_free(rest_vector);
+    }
+
+    return CAT_SOCKET_POST_WRITE_QUEUED;
+
+    _error:
+    if (rest_vector != rest_vector_on_stack && rest_vector != NULL) {
+        cat_free(rest_vector);
+    }
+    if (nwrite != 0) {
+        /* data has been partially written, stream is broken */
+        cat_socket_internal_unrecoverable_io_error(socket_i);
+    }
+    return CAT_SOCKET_POST_WRITE_FAILED;
+}
+
+CAT_API size_t cat_socket_get_write_queue_size(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return 0);
+
+    if (!(socket_i->type & CAT_SOCKET_TYPE_FLAG_STREAM)) {
+        return 0;
+    }
+
+    return socket_i->u.stream.write_queue_size;
+}
+
+#define CAT_SOCKET_INTERNAL_DGRAM_ONLY(_socket_i, _failure) \
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(_socket_i, CAT_SOCKET_TYPE_FLAG_DGRAM, "Socket is not of type dgram", _failure)
+
+CAT_API ssize_t cat_socket_recvfrom_many(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count)
+{
+    return cat_socket_recvfrom_many_ex(socket, datagrams, count, cat_socket_get_read_timeout_fast(socket));
+}
+
+CAT_API ssize_t cat_socket_recvfrom_many_ex(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
+    CAT_SOCKET_INTERNAL_DGRAM_ONLY(socket_i, return -1);
+
+    CAT_LOG_DEBUG(SOCKET, "recvfrom_many(" CAT_SOCKET_ID_FMT ", %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, count, timeout);
+
+    ssize_t n = cat_socket_internal_recvfrom_many(socket_i, datagrams, count, timeout);
+
+    CAT_LOG_DEBUG(SOCKET, "recvfrom_many(" CAT_SOCKET_ID_FMT ", %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_SSIZE_RET_FMT,
+        socket->id, count, timeout, CAT_LOG_SSIZE_RET_C(n));
+
+    return n;
+}
+
+CAT_API ssize_t cat_socket_sendto_many(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count)
+{
+    return cat_socket_sendto_many_ex(socket, datagrams, count, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API ssize_t cat_socket_sendto_many_ex(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return -1);
+    CAT_SOCKET_INTERNAL_DGRAM_ONLY(socket_i, return -1);
+
+    CAT_LOG_DEBUG(SOCKET, "sendto_many(" CAT_SOCKET_ID_FMT ", %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, count, timeout);
+
+    ssize_t n = cat_socket_internal_sendto_many(socket_i, datagrams, count, timeout);
+
+    CAT_LOG_DEBUG(SOCKET, "sendto_many(" CAT_SOCKET_ID_FMT ", %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_SSIZE_RET_FMT,
+        socket->id, count, timeout, CAT_LOG_SSIZE_RET_C(n));
+
+    return n;
+}
+
+CAT_API cat_bool_t cat_socket_getaddrbyname(cat_socket_t *socket, cat_sockaddr_info_t *address_info, const char *name, size_t name_length, int port)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+
+    return cat_socket_internal_getaddrbyname(socket_i, address_info, name, name_length, port, NULL);
+}
+
 CAT_API ssize_t cat_socket_recv(cat_socket_t *socket, char *buffer, size_t size)
 {
     return cat_socket_recv_ex(socket, buffer, size, cat_socket_get_read_timeout_fast(socket));
@@ -3925,6 +5274,92 @@ CAT_API ssize_t cat_socket_recv_ex(cat_socket_t *socket, char *buffer, size_t si
     return n;
 }
 
+CAT_API ssize_t cat_socket_recv_until(cat_socket_t *socket, char *buffer, size_t size, const char *delimiter, size_t delimiter_length)
+{
+    return cat_socket_recv_until_ex(socket, buffer, size, delimiter, delimiter_length, cat_socket_get_read_timeout_fast(socket));
+}
+
+CAT_API ssize_t cat_socket_recv_until_ex(cat_socket_t *socket, char *buffer, size_t size, const char *delimiter, size_t delimiter_length, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(socket_i, CAT_SOCKET_TYPE_FLAG_STREAM, "Socket should be type of stream", return -1);
+#ifdef CAT_SSL
+    if (unlikely(socket_i->ssl != NULL)) {
+        /* decrypted data can not be put back to the read-ahead buffer */
+        cat_update_last_error(CAT_ENOTSUP, "Socket recv until is not supported on SSL connections");
+        return -1;
+    }
+#endif
+    if (unlikely(delimiter_length == 0 || size < delimiter_length)) {
+        cat_update_last_error(CAT_EINVAL, "Socket recv until buffer size must be greater than or equal to non-empty delimiter length");
+        return -1;
+    }
+
+    CAT_LOG_DEBUG(SOCKET, "recv_until(" CAT_SOCKET_ID_FMT ", " CAT_LOG_READ_BUFFER_FMT ", %zu, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, CAT_LOG_READ_BUFFER_C(buffer), size, delimiter_length, timeout);
+
+    ssize_t n = cat_socket_internal_recv_until(socket_i, buffer, size, delimiter, delimiter_length, timeout);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        char *s;
+        CAT_LOG_DEBUG_D(SOCKET, "recv_until(" CAT_SOCKET_ID_FMT ", %s, %zu, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_SSIZE_RET_FMT,
+            socket->id, cat_log_str_quote(buffer, n < 0 ? 0 : n, &s), size, delimiter_length, timeout, CAT_LOG_SSIZE_RET_C(n));
+        cat_free(s);
+    });
+
+    return n;
+}
+
+CAT_API ssize_t cat_socket_recv_frame(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer)
+{
+    return cat_socket_recv_frame_ex(socket, format, buffer, cat_socket_get_read_timeout_fast(socket));
+}
+
+CAT_API ssize_t cat_socket_recv_frame_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, cat_timeout_t timeout)
+{
+    size_t length;
+    ssize_t n;
+
+    n = cat_socket_recv_frames_ex(socket, format, buffer, &length, 1, timeout);
+    if (unlikely(n <= 0)) {
+        return -1;
+    }
+
+    return (ssize_t) length;
+}
+
+CAT_API ssize_t cat_socket_recv_frames(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, size_t *lengths, size_t count)
+{
+    return cat_socket_recv_frames_ex(socket, format, buffer, lengths, count, cat_socket_get_read_timeout_fast(socket));
+}
+
+CAT_API ssize_t cat_socket_recv_frames_ex(cat_socket_t *socket, const cat_socket_frame_format_t *format, cat_buffer_t *buffer, size_t *lengths, size_t count, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(socket_i, CAT_SOCKET_TYPE_FLAG_STREAM, "Socket should be type of stream", return -1);
+#ifdef CAT_SSL
+    if (unlikely(socket_i->ssl != NULL)) {
+        /* decrypted data can not be put back to the read-ahead buffer */
+        cat_update_last_error(CAT_ENOTSUP, "Socket recv frames is not supported on SSL connections");
+        return -1;
+    }
+#endif
+    if (unlikely(count == 0)) {
+        cat_update_last_error(CAT_EINVAL, "Socket recv frames count can not be 0");
+        return -1;
+    }
+
+    CAT_LOG_DEBUG(SOCKET, "recv_frames(" CAT_SOCKET_ID_FMT ", %zu, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, buffer->length, count, timeout);
+
+    ssize_t n = cat_socket_internal_recv_frames(socket_i, format, buffer, lengths, count, timeout);
+
+    CAT_LOG_DEBUG(SOCKET, "recv_frames(" CAT_SOCKET_ID_FMT ", %zu, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_SSIZE_RET_FMT,
+        socket->id, buffer->length, count, timeout, CAT_LOG_SSIZE_RET_C(n));
+
+    return n;
+}
+
 CAT_API ssize_t cat_socket_try_recv(cat_socket_t *socket, char *buffer, size_t size)
 {
     ssize_t n = cat_socket_try_recv_impl(socket, buffer, size, NULL, NULL);
@@ -4183,6 +5618,18 @@ static ssize_t cat_socket_internal_peekfrom(
         }
     }
     while (1) {
+        /* data may have been buffered in persistent read mode (even during poll) */
+        if (unlikely(cat_socket_internal_has_read_ahead(socket_i))) {
+            const cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+            if (read_ahead->length > 0) {
+                return (ssize_t) cat_socket_read_ahead_copy(read_ahead, buffer, size);
+            }
+            if (read_ahead->error == CAT_EOF) {
+                return 0;
+            }
+            cat_update_last_error_with_reason((cat_errno_t) read_ahead->error, "Socket peek failed");
+            return -1;
+        }
 #ifdef CAT_OS_UNIX_LIKE
         do {
 #endif
@@ -4616,7 +6063,7 @@ static cat_always_inline ssize_t cat_socket_send_file_impl(cat_socket_t *socket,
 
 #ifdef CAT_SOCKET_NATIVE_SENDFILE
 # ifdef CAT_SSL
-    if (!socket_i->ssl)
+    if (!cat_socket_internal_write_is_encrypted(socket_i))
 # endif
     {
         written = cat_socket_internal_native_sendfile(socket_i, file, offset, length, timeout);
@@ -4686,6 +6133,9 @@ static void cat_socket_close_callback(uv_handle_t *handle)
     if (socket_i->cache.peername != NULL) {
         cat_free(socket_i->cache.peername);
     }
+    if (socket_i->read_ahead != NULL) {
+        cat_free(socket_i->read_ahead);
+    }
 
     cat_free(socket_i);
 }
@@ -4738,12 +6188,19 @@ static void cat_socket_internal_close_impl(cat_socket_internal_t *socket_i, cat_
         RB_REMOVE(cat_socket_internal_tree_s, &CAT_SOCKET_G(internal_tree), socket_i);
         /* unref in listen (references are idempotent) */
         uv_ref(&socket_i->u.handle);
+    } else if (socket_i->read_ahead != NULL) {
+        /* note: sockets with read-ahead buffer are in tree for poll emulation */
+        RB_REMOVE(cat_socket_internal_tree_s, &CAT_SOCKET_G(internal_tree), socket_i);
     }
 
 #ifdef CAT_SSL
     if (socket_i->ssl != NULL &&
         cat_ssl_get_shutdown(socket_i->ssl) != (CAT_SSL_SENT_SHUTDOWN | CAT_SSL_RECEIVED_SHUTDOWN)) {
         cat_ssl_set_quiet_shutdown(socket_i->ssl, cat_true);
+        /* otherwise SSL_free() invalidates the session, keep it resumable unless the connection is broken */
+        if (!cat_ssl_is_down(socket_i->ssl)) {
+            cat_ssl_set_shutdown(socket_i->ssl, CAT_SSL_SENT_SHUTDOWN | CAT_SSL_RECEIVED_SHUTDOWN);
+        }
     }
 #endif
 
@@ -4917,6 +6374,11 @@ CAT_API cat_bool_t cat_socket_is_encrypted(const cat_socket_t *socket)
     return socket_i != NULL && cat_socket_internal_is_established(socket_i) &&
            socket_i->ssl != NULL && cat_ssl_is_established(socket_i->ssl);
 }
+
+CAT_API cat_bool_t cat_socket_is_ktls_enabled(const cat_socket_t *socket)
+{
+    return cat_socket_is_encrypted(socket) && cat_ssl_is_ktls_send_enabled(socket->internal->ssl);
+}
 #endif
 
 // TODO: internal version APIs
@@ -4996,13 +6458,27 @@ static cat_errno_t cat_socket_check_liveness_by_fd(cat_socket_fd_t fd)
     return 0;
 }
 
+static cat_errno_t cat_socket_internal_check_liveness(const cat_socket_internal_t *socket_i, cat_socket_fd_t fd)
+{
+    /* data or EOF may have been buffered by persistent read */
+    if (unlikely(cat_socket_internal_has_read_ahead(socket_i))) {
+        const cat_socket_read_ahead_t *read_ahead = socket_i->read_ahead;
+        if (read_ahead->length > 0) {
+            return 0;
+        }
+        return read_ahead->error == CAT_EOF ? CAT_ECONNRESET : (cat_errno_t) read_ahead->error;
+    }
+
+    return cat_socket_check_liveness_by_fd(fd);
+}
+
 CAT_API cat_errno_t cat_socket_get_connection_error(const cat_socket_t *socket)
 {
     CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return CAT_EBADF);
     CAT_SOCKET_INTERNAL_FD_GETTER_SILENT(socket_i, fd, return CAT_EBADF);
     CAT_SOCKET_INTERNAL_SSL_LIVENESS_FAST_CHECK(socket_i, return 0);
 
-    return cat_socket_check_liveness_by_fd(fd);
+    return cat_socket_internal_check_liveness(socket_i, fd);
 }
 
 CAT_API cat_bool_t cat_socket_check_liveness(const cat_socket_t *socket)
@@ -5012,7 +6488,7 @@ CAT_API cat_bool_t cat_socket_check_liveness(const cat_socket_t *socket)
     CAT_SOCKET_INTERNAL_SSL_LIVENESS_FAST_CHECK(socket_i, return cat_true);
     cat_errno_t error;
 
-    error = cat_socket_check_liveness_by_fd(fd);
+    error = cat_socket_internal_check_liveness(socket_i, fd);
 
     if (unlikely(error != 0)) {
         /* there was an unrecoverable error */
@@ -5323,6 +6799,77 @@ CAT_API cat_bool_t cat_socket_set_udp_broadcast(cat_socket_t *socket, cat_bool_t
     return cat_true;
 }
 
+CAT_API cat_bool_t cat_socket_get_udp_gro(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return cat_false);
+
+    return !!(socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_UDP_GRO);
+}
+
+CAT_API cat_bool_t cat_socket_set_udp_gro(cat_socket_t *socket, cat_bool_t enable)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+
+    if (unlikely((socket_i->type & CAT_SOCKET_TYPE_UDP) != CAT_SOCKET_TYPE_UDP)) {
+        cat_update_last_error(CAT_EMISUSE, "Socket is not of type UDP");
+        return cat_false;
+    }
+#ifndef CAT_SOCKET_HAVE_UDP_OFFLOAD
+    if (enable) {
+        cat_update_last_error(CAT_ENOTSUP, "Socket UDP GRO is not supported on this platform");
+        return cat_false;
+    }
+#else
+    if (cat_socket_internal_get_fd_fast(socket_i) != CAT_SOCKET_INVALID_FD) {
+        int error = cat_socket_internal_set_udp_gro(socket_i, enable);
+        if (unlikely(error != 0)) {
+            cat_update_last_error_with_reason(error, "Socket %s UDP GRO failed", enable ? "enable" : "disable");
+            return cat_false;
+        }
+    }
+#endif
+    CAT_SOCKET_INTERNAL_SET_FLAG(socket_i, UDP_GRO, enable);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_socket_get_read_persistent(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return cat_false);
+
+    return !!(socket_i->option_flags & CAT_SOCKET_OPTION_FLAG_READ_PERSISTENT);
+}
+
+CAT_API cat_bool_t cat_socket_set_read_persistent(cat_socket_t *socket, cat_bool_t enable)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+
+    if (unlikely(!(socket_i->type & CAT_SOCKET_TYPE_FLAG_STREAM))) {
+        cat_update_last_error(CAT_EMISUSE, "Socket is not of type stream");
+        return cat_false;
+    }
+    CAT_SOCKET_INTERNAL_SET_FLAG(socket_i, READ_PERSISTENT, enable);
+    /* buffered data is still available for the next read */
+    if (!enable &&
+        (socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_READING) &&
+        !(socket_i->io_flags & CAT_SOCKET_IO_FLAG_READ)) {
+        uv_read_stop(&socket_i->u.stream);
+        socket_i->flags &= ~CAT_SOCKET_INTERNAL_FLAG_READING;
+    }
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_socket_get_global_read_persistent(void)
+{
+    return CAT_SOCKET_G(options.read_persistent);
+}
+
+CAT_API void cat_socket_set_global_read_persistent(cat_bool_t enable)
+{
+    CAT_SOCKET_G(options.read_persistent) = enable;
+}
+
 /* helper */
 
 CAT_API int cat_socket_get_local_free_port(void)
@@ -5442,7 +6989,7 @@ CAT_API cat_bool_t cat_pipe(cat_os_fd_t fds[2], cat_pipe_flags read_flags, cat_p
 
 /* for poll emulation */
 
-static cat_bool_t cat_socket_fd_has_accepted_fd(cat_socket_fd_t fd)
+static cat_bool_t cat_socket_fd_has_pending_input(cat_socket_fd_t fd)
 {
     cat_socket_internal_t lookup;
     cat_socket_internal_t *socket_i;
@@ -5451,6 +6998,9 @@ static cat_bool_t cat_socket_fd_has_accepted_fd(cat_socket_fd_t fd)
     if (socket_i == NULL) {
         return cat_false;
     }
+    if (!(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_SERVER)) {
+        return cat_socket_internal_has_read_ahead(socket_i);
+    }
 #ifndef CAT_OS_WIN
     if (socket_i->type & CAT_SOCKET_TYPE_FLAG_STREAM) {
         return socket_i->u.stream.accepted_fd != -1;
@@ -5479,7 +7029,7 @@ static cat_ret_t cat_socket_poll_one_emulate(cat_os_socket_t fd, cat_pollfd_even
             return ret;
         }
     }
-    if ((events & POLLIN) && cat_socket_fd_has_accepted_fd(fd)) {
+    if ((events & POLLIN) && cat_socket_fd_has_pending_input(fd)) {
         *revents = POLLIN;
         return CAT_RET_OK;
     }
@@ -5499,7 +7049,7 @@ static int cat_socket_poll_emulate(cat_pollfd_t *fds, cat_nfds_t nfds)
     for (i = 0; i < nfds; i++) {
         cat_pollfd_t *fd = &fds[i];
         if ((fd->events & POLLIN) &&
-            cat_socket_fd_has_accepted_fd(fd->fd)) {
+            cat_socket_fd_has_pending_input(fd->fd)) {
             fd->revents = POLLIN;
             n++;
         }
@@ -19,6 +19,12 @@
 #include "cat_ssl.h"
 
 #ifdef CAT_SSL
+
+#include "cat_queue.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
 /*
 This diagram shows how the read and write memory BIO's (rbio & wbio) are
 associated with the socket read and write respectively.  On the inbound flow
@@ -51,6 +57,54 @@ static void cat_ssl_handshake_log(cat_ssl_t *ssl);
 static int cat_ssl_index;
 static int cat_ssl_context_index;
 
+/* session cache */
+
+typedef struct cat_ssl_session_entry_s {
+    cat_queue_node_t node; /* LRU, recently used ones are in the front */
+    struct cat_ssl_session_entry_s *next; /* bucket */
+    SSL_SESSION *session;
+    time_t expire;
+    uint32_t hash;
+    unsigned int key_length;
+    unsigned char key[1];
+} cat_ssl_session_entry_t;
+
+typedef struct cat_ssl_session_store_s {
+    cat_ssl_session_entry_t **buckets;
+    size_t bucket_mask;
+    size_t count;
+    cat_queue_t lru;
+    uint64_t hits;
+    uint64_t misses;
+} cat_ssl_session_store_t;
+
+#define CAT_SSL_TICKET_KEY_NAME_SIZE 16
+#define CAT_SSL_TICKET_KEY_SIZE      32
+/* keep the previous key to decrypt tickets issued before rotation */
+#define CAT_SSL_TICKET_KEY_COUNT     2
+
+typedef struct cat_ssl_ticket_key_s {
+    unsigned char name[CAT_SSL_TICKET_KEY_NAME_SIZE];
+    unsigned char aes_key[CAT_SSL_TICKET_KEY_SIZE];
+    unsigned char hmac_key[CAT_SSL_TICKET_KEY_SIZE];
+} cat_ssl_ticket_key_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_ssl) {
+    size_t session_cache_size;
+    long session_cache_timeout;
+    long ticket_key_lifetime;
+    cat_ssl_session_store_t server_sessions;
+    cat_ssl_session_store_t client_sessions;
+    cat_ssl_ticket_key_t ticket_keys[CAT_SSL_TICKET_KEY_COUNT];
+    unsigned int ticket_key_count;
+    time_t ticket_key_time;
+    uint64_t ticket_key_rotations;
+} CAT_GLOBALS_STRUCT_END(cat_ssl);
+
+CAT_GLOBALS_DECLARE(cat_ssl);
+
+#define CAT_SSL_G(x) CAT_GLOBALS_GET(cat_ssl, x)
+
 static cat_always_inline cat_ssl_t *cat_ssl_get_from_connection(const cat_ssl_connection_t *connection)
 {
     return (cat_ssl_t *) SSL_get_ex_data(connection, cat_ssl_index);
@@ -63,6 +117,81 @@ static cat_always_inline cat_ssl_context_t *cat_ssl_context_get_from_ctx(const c
 }
 #endif
 
+#ifdef CAT_SSL_HAVE_KTLS
+/* a filter on top of the socket BIO, OpenSSL installs keys into the kernel through it (ctrls are forwarded),
+ * records are written through the writer until the kernel is able to encrypt them */
+
+typedef struct cat_ssl_ktls_bio_context_s {
+    cat_ssl_ktls_writer_t writer;
+    void *data;
+} cat_ssl_ktls_bio_context_t;
+
+static BIO_METHOD *cat_ssl_ktls_bio_method;
+
+static int cat_ssl_ktls_bio_write(cat_ssl_bio_t *bio, const char *buffer, int length)
+{
+    cat_ssl_ktls_bio_context_t *context = (cat_ssl_ktls_bio_context_t *) BIO_get_data(bio);
+    cat_ssl_bio_t *next = BIO_next(bio);
+
+    BIO_clear_retry_flags(bio);
+    if (BIO_get_ktls_send(next)) {
+        /* records (and their types) must be sent by the socket BIO now */
+        int n = BIO_write(next, buffer, length);
+        if (n <= 0) {
+            BIO_copy_next_retry(bio);
+        }
+        return n;
+    }
+    if (length <= 0) {
+        return 0;
+    }
+    if (unlikely(!context->writer(context->data, buffer, (size_t) length))) {
+        return -1;
+    }
+
+    return length;
+}
+
+static long cat_ssl_ktls_bio_ctrl(cat_ssl_bio_t *bio, int cmd, long num, void *ptr)
+{
+    return BIO_ctrl(BIO_next(bio), cmd, num, ptr);
+}
+
+static int cat_ssl_ktls_bio_create(cat_ssl_bio_t *bio)
+{
+    BIO_set_init(bio, 1);
+
+    return 1;
+}
+
+static int cat_ssl_ktls_bio_destroy(cat_ssl_bio_t *bio)
+{
+    cat_free(BIO_get_data(bio));
+    BIO_set_data(bio, NULL);
+
+    return 1;
+}
+
+static BIO_METHOD *cat_ssl_ktls_bio_method_create(void)
+{
+    BIO_METHOD *method;
+
+    method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_FILTER, "cat kTLS filter");
+    if (unlikely(method == NULL)) {
+        return NULL;
+    }
+    if (!BIO_meth_set_write(method, cat_ssl_ktls_bio_write) ||
+        !BIO_meth_set_ctrl(method, cat_ssl_ktls_bio_ctrl) ||
+        !BIO_meth_set_create(method, cat_ssl_ktls_bio_create) ||
+        !BIO_meth_set_destroy(method, cat_ssl_ktls_bio_destroy)) {
+        BIO_meth_free(method);
+        return NULL;
+    }
+
+    return method;
+}
+#endif
+
 CAT_API cat_bool_t cat_ssl_module_init(void)
 {
 #ifdef CAT_DEBUG
@@ -113,6 +242,80 @@ CAT_API cat_bool_t cat_ssl_module_init(void)
         CAT_MODULE_ERROR(SSL, "SSL_CTX_get_ex_new_index() failed");
     }
 
+#ifdef CAT_SSL_HAVE_KTLS
+    cat_ssl_ktls_bio_method = cat_ssl_ktls_bio_method_create();
+    if (cat_ssl_ktls_bio_method == NULL) {
+        ERR_print_errors_fp(CAT_LOG_G(error_output));
+        CAT_MODULE_ERROR(SSL, "BIO_meth_new() failed");
+    }
+#endif
+
+    CAT_GLOBALS_REGISTER(cat_ssl);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_module_shutdown(void)
+{
+    CAT_GLOBALS_UNREGISTER(cat_ssl);
+
+#ifdef CAT_SSL_HAVE_KTLS
+    BIO_meth_free(cat_ssl_ktls_bio_method);
+    cat_ssl_ktls_bio_method = NULL;
+#endif
+
+    return cat_true;
+}
+
+static void cat_ssl_session_store_init(cat_ssl_session_store_t *store)
+{
+    store->buckets = NULL;
+    store->bucket_mask = 0;
+    store->count = 0;
+    cat_queue_init(&store->lru);
+    store->hits = 0;
+    store->misses = 0;
+}
+
+static void cat_ssl_session_store_clear(cat_ssl_session_store_t *store)
+{
+    cat_ssl_session_entry_t *entry;
+
+    while ((entry = cat_queue_front_data(&store->lru, cat_ssl_session_entry_t, node))) {
+        cat_queue_remove(&entry->node);
+        SSL_SESSION_free(entry->session);
+        cat_free(entry);
+    }
+    if (store->buckets != NULL) {
+        cat_free(store->buckets);
+        store->buckets = NULL;
+    }
+    store->bucket_mask = 0;
+    store->count = 0;
+}
+
+CAT_API cat_bool_t cat_ssl_runtime_init(void)
+{
+    CAT_SSL_G(session_cache_size) = CAT_SSL_SESSION_CACHE_DEFAULT_SIZE;
+    CAT_SSL_G(session_cache_timeout) = CAT_SSL_SESSION_CACHE_DEFAULT_TIMEOUT;
+    CAT_SSL_G(ticket_key_lifetime) = CAT_SSL_TICKET_KEY_DEFAULT_LIFETIME;
+    cat_ssl_session_store_init(&CAT_SSL_G(server_sessions));
+    cat_ssl_session_store_init(&CAT_SSL_G(client_sessions));
+    /* keys are generated lazily */
+    CAT_SSL_G(ticket_key_count) = 0;
+    CAT_SSL_G(ticket_key_time) = 0;
+    CAT_SSL_G(ticket_key_rotations) = 0;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_runtime_shutdown(void)
+{
+    cat_ssl_session_store_clear(&CAT_SSL_G(server_sessions));
+    cat_ssl_session_store_clear(&CAT_SSL_G(client_sessions));
+    OPENSSL_cleanse(CAT_SSL_G(ticket_keys), sizeof(CAT_SSL_G(ticket_keys)));
+    CAT_SSL_G(ticket_key_count) = 0;
+
     return cat_true;
 }
 
@@ -692,6 +895,395 @@ CAT_API void cat_ssl_context_set_no_compression(cat_ssl_context_t *context)
     SSL_CTX_set_options(context->ctx, SSL_OP_NO_COMPRESSION);
 }
 
+/* session cache */
+
+static cat_always_inline uint32_t cat_ssl_session_key_hash(const unsigned char *key, size_t key_length)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < key_length; i++) {
+        hash ^= key[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static cat_ssl_session_entry_t **cat_ssl_session_store_find(
+    cat_ssl_session_store_t *store, const unsigned char *key, size_t key_length, uint32_t hash
+)
+{
+    cat_ssl_session_entry_t **entry_ptr;
+
+    if (store->buckets == NULL) {
+        return NULL;
+    }
+    entry_ptr = &store->buckets[hash & store->bucket_mask];
+    while (*entry_ptr != NULL) {
+        cat_ssl_session_entry_t *entry = *entry_ptr;
+        if (entry->hash == hash && entry->key_length == key_length &&
+            memcmp(entry->key, key, key_length) == 0) {
+            return entry_ptr;
+        }
+        entry_ptr = &entry->next;
+    }
+
+    return NULL;
+}
+
+static void cat_ssl_session_store_delete(cat_ssl_session_store_t *store, cat_ssl_session_entry_t **entry_ptr)
+{
+    cat_ssl_session_entry_t *entry = *entry_ptr;
+
+    *entry_ptr = entry->next;
+    cat_queue_remove(&entry->node);
+    store->count--;
+    SSL_SESSION_free(entry->session);
+    cat_free(entry);
+}
+
+static void cat_ssl_session_store_remove(cat_ssl_session_store_t *store, const unsigned char *key, size_t key_length)
+{
+    cat_ssl_session_entry_t **entry_ptr;
+
+    entry_ptr = cat_ssl_session_store_find(store, key, key_length, cat_ssl_session_key_hash(key, key_length));
+    if (entry_ptr != NULL) {
+        cat_ssl_session_store_delete(store, entry_ptr);
+    }
+}
+
+/* it takes the ownership of session on success */
+static cat_bool_t cat_ssl_session_store_add(cat_ssl_session_store_t *store, const unsigned char *key, size_t key_length, SSL_SESSION *session)
+{
+    size_t size = CAT_SSL_G(session_cache_size);
+    uint32_t hash = cat_ssl_session_key_hash(key, key_length);
+    cat_ssl_session_entry_t **entry_ptr, *entry;
+
+    if (unlikely(size == 0)) {
+        return cat_false;
+    }
+    if (unlikely(store->buckets == NULL)) {
+        size_t bucket_count = 16;
+        while (bucket_count < size) {
+            bucket_count <<= 1;
+        }
+        store->buckets = (cat_ssl_session_entry_t **) cat_calloc(bucket_count, sizeof(*store->buckets));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(store->buckets == NULL)) {
+            return cat_false;
+        }
+#endif
+        store->bucket_mask = bucket_count - 1;
+    }
+    entry_ptr = cat_ssl_session_store_find(store, key, key_length, hash);
+    if (entry_ptr != NULL) {
+        cat_ssl_session_store_delete(store, entry_ptr);
+    }
+    while (store->count >= size) {
+        /* evict the least recently used one */
+        cat_ssl_session_entry_t *last = cat_queue_back_data(&store->lru, cat_ssl_session_entry_t, node);
+        cat_ssl_session_store_delete(store,
+            cat_ssl_session_store_find(store, last->key, last->key_length, last->hash));
+    }
+    entry = (cat_ssl_session_entry_t *) cat_malloc(offsetof(cat_ssl_session_entry_t, key) + key_length);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(entry == NULL)) {
+        return cat_false;
+    }
+#endif
+    entry->session = session;
+    entry->expire = time(NULL) + CAT_SSL_G(session_cache_timeout);
+    entry->hash = hash;
+    entry->key_length = (unsigned int) key_length;
+    memcpy(entry->key, key, key_length);
+    entry->next = store->buckets[hash & store->bucket_mask];
+    store->buckets[hash & store->bucket_mask] = entry;
+    cat_queue_push_front(&store->lru, &entry->node);
+    store->count++;
+
+    return cat_true;
+}
+
+static SSL_SESSION *cat_ssl_session_store_get(cat_ssl_session_store_t *store, const unsigned char *key, size_t key_length)
+{
+    cat_ssl_session_entry_t **entry_ptr, *entry;
+
+    entry_ptr = cat_ssl_session_store_find(store, key, key_length, cat_ssl_session_key_hash(key, key_length));
+    if (entry_ptr == NULL) {
+        return NULL;
+    }
+    entry = *entry_ptr;
+    if (entry->expire <= time(NULL)) {
+        cat_ssl_session_store_delete(store, entry_ptr);
+        return NULL;
+    }
+    cat_queue_remove(&entry->node);
+    cat_queue_push_front(&store->lru, &entry->node);
+
+    return entry->session;
+}
+
+static int cat_ssl_server_new_session_callback(cat_ssl_connection_t *connection, SSL_SESSION *session)
+{
+    const unsigned char *id;
+    unsigned int id_length;
+
+    (void) connection;
+    id = SSL_SESSION_get_id(session, &id_length);
+    CAT_LOG_DEBUG(SSL, "SSL server new session (id_length=%u)", id_length);
+
+    /* 1 means that we have taken the reference */
+    return cat_ssl_session_store_add(&CAT_SSL_G(server_sessions), id, id_length, session) ? 1 : 0;
+}
+
+static SSL_SESSION *cat_ssl_server_get_session_callback(
+    cat_ssl_connection_t *connection,
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    const
+#endif
+    unsigned char *id, int id_length, int *copy)
+{
+    SSL_SESSION *session;
+
+    (void) connection;
+    session = cat_ssl_session_store_get(&CAT_SSL_G(server_sessions), id, id_length);
+    CAT_LOG_DEBUG(SSL, "SSL server get session (id_length=%d): %s", id_length, session != NULL ? "found" : "not found");
+    /* OpenSSL increases the reference count of the session */
+    *copy = 1;
+
+    return session;
+}
+
+static void cat_ssl_server_remove_session_callback(cat_ssl_ctx_t *ctx, SSL_SESSION *session)
+{
+    const unsigned char *id;
+    unsigned int id_length;
+
+    (void) ctx;
+    id = SSL_SESSION_get_id(session, &id_length);
+    cat_ssl_session_store_remove(&CAT_SSL_G(server_sessions), id, id_length);
+}
+
+static int cat_ssl_client_new_session_callback(cat_ssl_connection_t *connection, SSL_SESSION *session)
+{
+    cat_ssl_t *ssl = cat_ssl_get_from_connection(connection);
+
+    if (ssl == NULL || ssl->session_key.length == 0) {
+        return 0;
+    }
+    CAT_LOG_DEBUG(SSL, "SSL client new session for \"%.*s\"", (int) ssl->session_key.length, ssl->session_key.value);
+
+    return cat_ssl_session_store_add(&CAT_SSL_G(client_sessions),
+        (const unsigned char *) ssl->session_key.value, ssl->session_key.length, session) ? 1 : 0;
+}
+
+static cat_bool_t cat_ssl_ticket_keys_generate(cat_ssl_ticket_key_t *key)
+{
+    if (RAND_bytes(key->name, sizeof(key->name)) != 1 ||
+        RAND_bytes(key->aes_key, sizeof(key->aes_key)) != 1 ||
+        RAND_bytes(key->hmac_key, sizeof(key->hmac_key)) != 1) {
+        cat_ssl_update_last_error(CAT_ESSL, "RAND_bytes() failed");
+        return cat_false;
+    }
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_rotate_ticket_keys(void)
+{
+    cat_ssl_ticket_key_t *keys = CAT_SSL_G(ticket_keys);
+    cat_ssl_ticket_key_t key;
+
+    if (unlikely(!cat_ssl_ticket_keys_generate(&key))) {
+        return cat_false;
+    }
+    memmove(&keys[1], &keys[0], sizeof(keys[0]) * (CAT_SSL_TICKET_KEY_COUNT - 1));
+    keys[0] = key;
+    OPENSSL_cleanse(&key, sizeof(key));
+    if (CAT_SSL_G(ticket_key_count) < CAT_SSL_TICKET_KEY_COUNT) {
+        CAT_SSL_G(ticket_key_count)++;
+    }
+    CAT_SSL_G(ticket_key_time) = time(NULL);
+    CAT_SSL_G(ticket_key_rotations)++;
+    CAT_LOG_DEBUG(SSL, "SSL ticket keys rotated");
+
+    return cat_true;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static int cat_ssl_ticket_key_callback(
+    cat_ssl_connection_t *connection, unsigned char *name, unsigned char *iv,
+    EVP_CIPHER_CTX *cipher_ctx, EVP_MAC_CTX *hmac_ctx, int enc
+)
+#else
+static int cat_ssl_ticket_key_callback(
+    cat_ssl_connection_t *connection, unsigned char *name, unsigned char *iv,
+    EVP_CIPHER_CTX *cipher_ctx, HMAC_CTX *hmac_ctx, int enc
+)
+#endif
+{
+    const EVP_CIPHER *cipher = EVP_aes_256_cbc();
+    cat_ssl_ticket_key_t *keys = CAT_SSL_G(ticket_keys), *key;
+    unsigned int i;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    OSSL_PARAM params[3];
+#endif
+
+    if (enc == 1) {
+        /* encrypt a new ticket with the current key, rotate it if it's expired */
+        if (CAT_SSL_G(ticket_key_count) == 0 ||
+            time(NULL) - CAT_SSL_G(ticket_key_time) >= CAT_SSL_G(ticket_key_lifetime)) {
+            if (unlikely(!cat_ssl_rotate_ticket_keys())) {
+                return -1;
+            }
+        }
+        key = &keys[0];
+        if (RAND_bytes(iv, EVP_CIPHER_iv_length(cipher)) != 1) {
+            return -1;
+        }
+        if (EVP_EncryptInit_ex(cipher_ctx, cipher, NULL, key->aes_key, iv) != 1) {
+            return -1;
+        }
+        memcpy(name, key->name, CAT_SSL_TICKET_KEY_NAME_SIZE);
+        i = 0;
+    } else {
+        for (i = 0; i < CAT_SSL_G(ticket_key_count); i++) {
+            if (memcmp(name, keys[i].name, CAT_SSL_TICKET_KEY_NAME_SIZE) == 0) {
+                break;
+            }
+        }
+        if (i == CAT_SSL_G(ticket_key_count)) {
+            CAT_LOG_DEBUG(SSL, "SSL ticket key not found");
+            /* full handshake */
+            return 0;
+        }
+        key = &keys[i];
+        if (EVP_DecryptInit_ex(cipher_ctx, cipher, NULL, key->aes_key, iv) != 1) {
+            return -1;
+        }
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key->hmac_key, sizeof(key->hmac_key));
+    params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char *) "SHA256", 0);
+    params[2] = OSSL_PARAM_construct_end();
+    if (EVP_MAC_CTX_set_params(hmac_ctx, params) != 1) {
+        return -1;
+    }
+#else
+    if (HMAC_Init_ex(hmac_ctx, key->hmac_key, sizeof(key->hmac_key), EVP_sha256(), NULL) != 1) {
+        return -1;
+    }
+#endif
+
+#ifdef TLS1_3_VERSION
+    /* TLSv1.3 tickets are for single use, always renew it */
+    if (enc != 1 && SSL_version(connection) == TLS1_3_VERSION) {
+        return 2;
+    }
+#endif
+
+    /* 2 means that the ticket is decrypted by the previous key, it should be renewed */
+    return i == 0 ? 1 : 2;
+}
+
+CAT_API cat_bool_t cat_ssl_context_enable_session_cache(cat_ssl_context_t *context, cat_bool_t is_client, const char *session_id_context, size_t session_id_context_length)
+{
+    cat_ssl_ctx_t *ctx = context->ctx;
+
+    if (CAT_SSL_G(session_cache_size) == 0) {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+        return cat_true;
+    }
+    SSL_CTX_set_timeout(ctx, CAT_SSL_G(session_cache_timeout));
+    if (is_client) {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+        SSL_CTX_sess_set_new_cb(ctx, cat_ssl_client_new_session_callback);
+        return cat_true;
+    }
+    /* sessions must not be resumed by servers with different certificates */
+    do {
+        unsigned char md[EVP_MAX_MD_SIZE];
+        unsigned int md_length;
+        if (session_id_context_length > SSL_MAX_SID_CTX_LENGTH) {
+            if (EVP_Digest(session_id_context, session_id_context_length, md, &md_length, EVP_sha1(), NULL) != 1) {
+                cat_ssl_update_last_error(CAT_ESSL, "SSL session id context digest failed");
+                return cat_false;
+            }
+            session_id_context = (const char *) md;
+            session_id_context_length = md_length;
+        }
+        if (SSL_CTX_set_session_id_context(ctx, (const unsigned char *) session_id_context, (unsigned int) session_id_context_length) != 1) {
+            cat_ssl_update_last_error(CAT_ESSL, "SSL_CTX_set_session_id_context() failed");
+            return cat_false;
+        }
+    } while (0);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(ctx, cat_ssl_server_new_session_callback);
+    SSL_CTX_sess_set_get_cb(ctx, cat_ssl_server_get_session_callback);
+    SSL_CTX_sess_set_remove_cb(ctx, cat_ssl_server_remove_session_callback);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, cat_ssl_ticket_key_callback) != 1) {
+#else
+    if (SSL_CTX_set_tlsext_ticket_key_cb(ctx, cat_ssl_ticket_key_callback) != 1) {
+#endif
+        cat_ssl_update_last_error(CAT_ESSL, "SSL set ticket key callback failed");
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+CAT_API void cat_ssl_set_session_cache_size(size_t size)
+{
+    CAT_SSL_G(session_cache_size) = size;
+    /* buckets are resized lazily */
+    cat_ssl_clear_session_cache();
+}
+
+CAT_API size_t cat_ssl_get_session_cache_size(void)
+{
+    return CAT_SSL_G(session_cache_size);
+}
+
+CAT_API void cat_ssl_set_session_cache_timeout(long timeout)
+{
+    CAT_SSL_G(session_cache_timeout) = timeout;
+}
+
+CAT_API long cat_ssl_get_session_cache_timeout(void)
+{
+    return CAT_SSL_G(session_cache_timeout);
+}
+
+CAT_API void cat_ssl_set_ticket_key_lifetime(long lifetime)
+{
+    CAT_SSL_G(ticket_key_lifetime) = lifetime;
+}
+
+CAT_API long cat_ssl_get_ticket_key_lifetime(void)
+{
+    return CAT_SSL_G(ticket_key_lifetime);
+}
+
+CAT_API void cat_ssl_clear_session_cache(void)
+{
+    cat_ssl_session_store_clear(&CAT_SSL_G(server_sessions));
+    cat_ssl_session_store_clear(&CAT_SSL_G(client_sessions));
+}
+
+CAT_API void cat_ssl_get_session_cache_stats(cat_ssl_session_cache_stats_t *stats)
+{
+    stats->server_hits = CAT_SSL_G(server_sessions).hits;
+    stats->server_misses = CAT_SSL_G(server_sessions).misses;
+    stats->client_hits = CAT_SSL_G(client_sessions).hits;
+    stats->client_misses = CAT_SSL_G(client_sessions).misses;
+    stats->server_count = CAT_SSL_G(server_sessions).count;
+    stats->client_count = CAT_SSL_G(client_sessions).count;
+    stats->ticket_key_rotations = CAT_SSL_G(ticket_key_rotations);
+}
+
 CAT_API cat_ssl_t *cat_ssl_create(cat_ssl_t *ssl, cat_ssl_context_t *context)
 {
     cat_ssl_connection_t *connection;
@@ -744,6 +1336,7 @@ CAT_API cat_ssl_t *cat_ssl_create(cat_ssl_t *ssl, cat_ssl_context_t *context)
     ssl->connection = connection;
     ssl->context = context;
     ssl->allow_self_signed = cat_false;
+    cat_string_init(&ssl->session_key);
 
     return ssl;
 
@@ -769,6 +1362,7 @@ CAT_API cat_ssl_t *cat_ssl_create(cat_ssl_t *ssl, cat_ssl_context_t *context)
 
 CAT_API void cat_ssl_close(cat_ssl_t *ssl)
 {
+    cat_string_close(&ssl->session_key);
     cat_buffer_close(&ssl->write_buffer);
     cat_buffer_close(&ssl->read_buffer);
     /* ibio will be free'd by SSL_free */
@@ -845,6 +1439,39 @@ CAT_API cat_bool_t cat_ssl_set_sni_server_name(cat_ssl_t *ssl, const char *name)
     return cat_true;
 }
 
+CAT_API cat_bool_t cat_ssl_set_session_key(cat_ssl_t *ssl, const char *key, size_t key_length)
+{
+    SSL_SESSION *session;
+
+    cat_string_close(&ssl->session_key);
+    if (unlikely(!cat_string_create(&ssl->session_key, key, key_length))) {
+        cat_update_last_error_of_syscall("Malloc for SSL session key failed");
+        return cat_false;
+    }
+    session = cat_ssl_session_store_get(&CAT_SSL_G(client_sessions), (const unsigned char *) key, key_length);
+    if (session == NULL) {
+        return cat_true;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (!SSL_SESSION_is_resumable(session)) {
+        cat_ssl_session_store_remove(&CAT_SSL_G(client_sessions), (const unsigned char *) key, key_length);
+        return cat_true;
+    }
+#endif
+    if (unlikely(SSL_set_session(ssl->connection, session) != 1)) {
+        cat_ssl_update_last_error(CAT_ESSL, "SSL_set_session() failed");
+        return cat_false;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    /* TLSv1.3 tickets are for single use */
+    if (SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION) {
+        cat_ssl_session_store_remove(&CAT_SSL_G(client_sessions), (const unsigned char *) key, key_length);
+    }
+#endif
+
+    return cat_true;
+}
+
 CAT_API cat_bool_t cat_ssl_is_established(const cat_ssl_t *ssl)
 {
     return ssl->flags & CAT_SSL_FLAG_HANDSHAKE_OK;
@@ -865,6 +1492,15 @@ CAT_API cat_ssl_ret_t cat_ssl_handshake(cat_ssl_t *ssl)
     CAT_LOG_DEBUG(SSL, "SSL_do_handshake(%p): %d", ssl, n);
     if (n == 1) {
         ssl->flags |= CAT_SSL_FLAG_HANDSHAKE_OK;
+        if (SSL_CTX_sess_get_new_cb(SSL_get_SSL_CTX(connection)) != NULL) {
+            cat_ssl_session_store_t *store = SSL_is_server(connection) ?
+                &CAT_SSL_G(server_sessions) : &CAT_SSL_G(client_sessions);
+            if (SSL_session_reused(connection)) {
+                store->hits++;
+            } else {
+                store->misses++;
+            }
+        }
         CAT_LOG_DEBUG_VA(SSL, {
             cat_ssl_handshake_log(ssl);
         });
@@ -885,6 +1521,11 @@ CAT_API cat_ssl_ret_t cat_ssl_handshake(cat_ssl_t *ssl)
     int error = cat_ssl_get_error(ssl, n);
 
     if (error == SSL_ERROR_WANT_WRITE) {
+        if (ssl->flags & CAT_SSL_FLAG_KTLS_PREPARED) {
+            /* it writes to the socket directly */
+            CAT_LOG_DEBUG(SSL, "SSL_ERROR_WANT_WRITE");
+            return CAT_SSL_RET_WANT_WRITE;
+        }
         fprintf(stderr, "SSL handshake should never return SSL_ERROR_WANT_WRITE with BIO mode.");
         abort();
     }
@@ -902,6 +1543,79 @@ CAT_API cat_ssl_ret_t cat_ssl_handshake(cat_ssl_t *ssl)
     return CAT_SSL_RET_ERROR;
 }
 
+#ifdef CAT_SSL_HAVE_KTLS
+CAT_API cat_bool_t cat_ssl_ktls_prepare(cat_ssl_t *ssl, int fd, cat_ssl_ktls_writer_t writer, void *data)
+{
+    cat_ssl_connection_t *connection = ssl->connection;
+    cat_ssl_ktls_bio_context_t *context;
+    cat_ssl_bio_t *fbio, *sbio;
+
+    CAT_ASSERT(!(ssl->flags & CAT_SSL_FLAG_HANDSHAKE_OK));
+
+    context = (cat_ssl_ktls_bio_context_t *) cat_malloc(sizeof(*context));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(context == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for SSL kTLS BIO context failed");
+        return cat_false;
+    }
+#endif
+    context->writer = writer;
+    context->data = data;
+    fbio = BIO_new(cat_ssl_ktls_bio_method);
+    if (unlikely(fbio == NULL)) {
+        cat_free(context);
+        cat_ssl_update_last_error(CAT_ESSL, "BIO_new() failed");
+        return cat_false;
+    }
+    BIO_set_data(fbio, context);
+    sbio = BIO_new_socket(fd, BIO_NOCLOSE);
+    if (unlikely(sbio == NULL)) {
+        BIO_free(fbio);
+        cat_ssl_update_last_error(CAT_ESSL, "BIO_new_socket() failed");
+        return cat_false;
+    }
+    BIO_push(fbio, sbio);
+    CAT_LOG_DEBUG(SSL, "SSL_set_options(%p, SSL_OP_ENABLE_KTLS)", ssl);
+    SSL_set_options(connection, SSL_OP_ENABLE_KTLS);
+    /* records are still read from the BIO pair,
+     * ibio is still referenced by SSL as rbio */
+    SSL_set0_wbio(connection, fbio);
+    ssl->flags |= CAT_SSL_FLAG_KTLS_PREPARED;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_ktls_complete(cat_ssl_t *ssl)
+{
+    cat_ssl_connection_t *connection = ssl->connection;
+    cat_ssl_bio_t *ibio;
+
+    CAT_ASSERT(ssl->flags & CAT_SSL_FLAG_KTLS_PREPARED);
+    CAT_ASSERT(ssl->flags & CAT_SSL_FLAG_HANDSHAKE_OK);
+    ssl->flags ^= CAT_SSL_FLAG_KTLS_PREPARED;
+
+    if (BIO_get_ktls_send(SSL_get_wbio(connection))) {
+        CAT_LOG_DEBUG(SSL, "SSL(%p) kTLS send is enabled", ssl);
+        ssl->flags |= CAT_SSL_FLAG_KTLS_SEND;
+        return cat_true;
+    }
+
+    /* cipher or kernel is not supported, switch back to the BIO pair */
+    CAT_LOG_DEBUG(SSL, "SSL(%p) kTLS send is not available", ssl);
+    ibio = SSL_get_rbio(connection);
+    BIO_up_ref(ibio);
+    SSL_set0_wbio(connection, ibio);
+    SSL_clear_options(connection, SSL_OP_ENABLE_KTLS);
+
+    return cat_false;
+}
+#endif
+
+CAT_API cat_bool_t cat_ssl_is_ktls_send_enabled(const cat_ssl_t *ssl)
+{
+    return !!(ssl->flags & CAT_SSL_FLAG_KTLS_SEND);
+}
+
 CAT_API cat_bool_t cat_ssl_verify_peer(cat_ssl_t *ssl, cat_bool_t allow_self_signed)
 {
     cat_ssl_connection_t *connection = ssl->connection;
@@ -42,6 +42,36 @@ CAT_API const char *cat_strlchr(const char *s, const char *last, char c)
     return NULL;
 }
 
+CAT_API const char *cat_memmem(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length)
+{
+    const char *p = haystack, *last;
+
+    if (unlikely(needle_length == 0)) {
+        return haystack;
+    }
+    if (unlikely(haystack_length < needle_length)) {
+        return NULL;
+    }
+    if (needle_length == 1) {
+        return (const char *) memchr(haystack, *needle, haystack_length);
+    }
+    /* the last position where needle may start */
+    last = haystack + (haystack_length - needle_length);
+    while (1) {
+        p = (const char *) memchr(p, *needle, last - p + 1);
+        if (p == NULL) {
+            return NULL;
+        }
+        if (memcmp(p + 1, needle + 1, needle_length - 1) == 0) {
+            return p;
+        }
+        if (p == last) {
+            return NULL;
+        }
+        p++;
+    }
+}
+
 /* Copy a string returning a pointer to its end */
 CAT_API char *cat_stpcpy(char *dest, const char *src)
 {
@@ -104,33 +104,68 @@ CAT_API char *cat_time_format_msec(cat_msec_t msec)
 #undef SECOND
 }
 
-typedef union {
+CAT_API CAT_GLOBALS_DECLARE(cat_time);
+
+typedef struct cat_timer_s {
+    cat_queue_node_t node;
+    cat_msec_t expire;
     cat_coroutine_t *coroutine;
-    uv_handle_t handle;
-    uv_timer_t timer;
+    uint16_t slot;
 } cat_timer_t;
 
-static void cat_timer_callback(uv_timer_t* handle)
+CAT_API cat_bool_t cat_time_module_init(void)
 {
-    cat_timer_t *timer = (cat_timer_t *) handle;
-    cat_coroutine_t *coroutine = timer->coroutine;
+    CAT_GLOBALS_REGISTER(cat_time);
 
-    timer->coroutine = NULL;
-    cat_coroutine_schedule(coroutine, TIME, "Timer");
+    return cat_true;
 }
 
-static void cat_timer_close_callback(uv_handle_t *handle)
+CAT_API cat_bool_t cat_time_module_shutdown(void)
 {
-    cat_timer_t *timer = cat_container_of(handle, cat_timer_t, handle);
-    cat_free(timer);
+    CAT_GLOBALS_UNREGISTER(cat_time);
+
+    return cat_true;
 }
 
-static cat_timer_t *cat_timer_wait(cat_msec_t msec)
+CAT_API cat_bool_t cat_time_runtime_init(void)
 {
-    cat_timer_t *timer;
-    cat_bool_t ret;
+    size_t i;
+
+    (void) uv_timer_init(&CAT_EVENT_G(loop), &CAT_TIME_G(timer));
+    CAT_TIME_G(timer).flags |= UV_HANDLE_INTERNAL;
+    CAT_TIME_G(current) = CAT_EVENT_G(loop).time;
+    CAT_TIME_G(scheduled) = 0;
+    CAT_TIME_G(count) = 0;
+    memset(CAT_TIME_G(bitmap), 0, sizeof(CAT_TIME_G(bitmap)));
+    for (i = 0; i < CAT_ARRAY_SIZE(CAT_TIME_G(slots)); i++) {
+        cat_queue_init(&CAT_TIME_G(slots)[i]);
+    }
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_time_runtime_shutdown(void)
+{
+    CAT_ASSERT(CAT_TIME_G(count) == 0);
+
+    uv_close((uv_handle_t *) &CAT_TIME_G(timer), NULL);
+
+    return cat_true;
+}
+
+CAT_API cat_timer_stats_t *cat_time_get_timer_stats(cat_timer_stats_t *stats)
+{
+    stats->count = CAT_TIME_G(count);
+
+    return stats;
+}
+
+/* timers are allocated from the slab of event loop */
+
+static cat_always_inline cat_timer_t *cat_timer_alloc(void)
+{
+    cat_timer_t *timer = (cat_timer_t *) cat_event_slab_malloc(sizeof(*timer));
 
-    timer = (cat_timer_t *) cat_malloc(sizeof(*timer));;
 #if CAT_ALLOC_HANDLE_ERRORS
     if (unlikely(timer == NULL)) {
         cat_update_last_error_of_syscall("Malloc for timer failed");
@@ -138,21 +173,288 @@ static cat_timer_t *cat_timer_wait(cat_msec_t msec)
     }
 #endif
 
-    (void) uv_timer_init(&CAT_EVENT_G(loop), &timer->timer);
-    (void) uv_timer_start(&timer->timer, cat_timer_callback, msec, 0);
+    return timer;
+}
+
+static cat_always_inline void cat_timer_free(cat_timer_t *timer)
+{
+    cat_event_slab_free(timer, sizeof(*timer));
+}
+
+/* timer wheel */
+
+#define CAT_TIMER_WHEEL_SLOT_NONE UINT16_MAX
+
+static cat_always_inline void cat_timer_wheel_bitmap_set(uint16_t slot)
+{
+    CAT_TIME_G(bitmap)[slot / 64] |= (UINT64_C(1) << (slot % 64));
+}
+
+static cat_always_inline void cat_timer_wheel_bitmap_clear(uint16_t slot)
+{
+    CAT_TIME_G(bitmap)[slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+}
+
+static cat_always_inline uint64_t cat_timer_wheel_level_bitmap(unsigned int level)
+{
+    /* each level has exactly 64 slots, it is one bitmap word */
+    return CAT_TIME_G(bitmap)[(CAT_TIMER_WHEEL_ROOT_SIZE / 64) + level];
+}
+
+static cat_always_inline unsigned int cat_timer_wheel_level_shift(unsigned int level)
+{
+    return CAT_TIMER_WHEEL_ROOT_BITS + level * CAT_TIMER_WHEEL_LEVEL_BITS;
+}
+
+static void cat_timer_wheel_add(cat_timer_t *timer)
+{
+    cat_msec_t current = CAT_TIME_G(current);
+    cat_msec_t expire = timer->expire;
+    uint16_t slot;
+
+    if (expire < current) {
+        /* overdue, run it in the next tick */
+        slot = (uint16_t) (current & CAT_TIMER_WHEEL_ROOT_MASK);
+    } else if (expire - current < CAT_TIMER_WHEEL_ROOT_SIZE) {
+        slot = (uint16_t) (expire & CAT_TIMER_WHEEL_ROOT_MASK);
+    } else {
+        unsigned int level, shift = 0;
+        for (level = 0; level < CAT_TIMER_WHEEL_LEVELS; level++) {
+            shift = cat_timer_wheel_level_shift(level);
+            if (expire - current < (UINT64_C(1) << (shift + CAT_TIMER_WHEEL_LEVEL_BITS))) {
+                break;
+            }
+        }
+        if (unlikely(level == CAT_TIMER_WHEEL_LEVELS)) {
+            /* out of range, put it on the farthest slot,
+             * it will be re-added when the slot is cascaded */
+            level = CAT_TIMER_WHEEL_LEVELS - 1;
+            expire = current + (UINT64_C(1) << (shift + CAT_TIMER_WHEEL_LEVEL_BITS)) - 1;
+        }
+        slot = (uint16_t) (CAT_TIMER_WHEEL_ROOT_SIZE + level * CAT_TIMER_WHEEL_LEVEL_SIZE +
+            ((expire >> shift) & CAT_TIMER_WHEEL_LEVEL_MASK));
+    }
+
+    timer->slot = slot;
+    cat_queue_push_back(&CAT_TIME_G(slots)[slot], &timer->node);
+    cat_timer_wheel_bitmap_set(slot);
+}
+
+static cat_always_inline void cat_timer_wheel_detach(uint16_t slot, cat_queue_t *queue)
+{
+    cat_queue_t *slot_queue = &CAT_TIME_G(slots)[slot];
+
+    cat_queue_init(queue);
+    if (!cat_queue_empty(slot_queue)) {
+        cat_queue_next(queue) = cat_queue_next(slot_queue);
+        cat_queue_prev(queue) = cat_queue_prev(slot_queue);
+        cat_queue_next_prev(queue) = queue;
+        cat_queue_prev_next(queue) = queue;
+        cat_queue_init(slot_queue);
+    }
+    cat_timer_wheel_bitmap_clear(slot);
+}
+
+/* returns true if we should continue to cascade the higher level */
+static cat_bool_t cat_timer_wheel_cascade(unsigned int level)
+{
+    unsigned int index = (unsigned int) ((CAT_TIME_G(current) >> cat_timer_wheel_level_shift(level)) & CAT_TIMER_WHEEL_LEVEL_MASK);
+    uint16_t slot = (uint16_t) (CAT_TIMER_WHEEL_ROOT_SIZE + level * CAT_TIMER_WHEEL_LEVEL_SIZE + index);
+    cat_queue_t queue;
+    cat_timer_t *timer;
+
+    if (cat_timer_wheel_level_bitmap(level) & (UINT64_C(1) << index)) {
+        cat_timer_wheel_detach(slot, &queue);
+        while ((timer = cat_queue_front_data(&queue, cat_timer_t, node))) {
+            cat_queue_remove(&timer->node);
+            cat_timer_wheel_add(timer);
+        }
+    }
+
+    return index == 0;
+}
+
+/* returns a lower bound of the nearest expire time */
+static cat_msec_t cat_timer_wheel_next(void)
+{
+    cat_msec_t current = CAT_TIME_G(current);
+    cat_msec_t next = UINT64_MAX;
+    unsigned int index = (unsigned int) (current & CAT_TIMER_WHEEL_ROOT_MASK);
+    unsigned int level, word;
+    cat_bool_t wrapped = cat_false;
+
+    for (word = 0; word < CAT_TIMER_WHEEL_ROOT_SIZE / 64; word++) {
+        uint64_t bits = CAT_TIME_G(bitmap)[word];
+        if (word < index / 64) {
+            wrapped = wrapped || bits != 0;
+            continue;
+        }
+        if (word == index / 64) {
+            uint64_t mask = (UINT64_C(1) << (index % 64)) - 1;
+            wrapped = wrapped || (bits & mask) != 0;
+            bits &= ~mask;
+        }
+        if (bits != 0) {
+            next = (current & ~((cat_msec_t) CAT_TIMER_WHEEL_ROOT_MASK)) + word * 64 + cat_ctz64(bits);
+            break;
+        }
+    }
+    if (next == UINT64_MAX && wrapped) {
+        /* they belong to the next round */
+        next = (current | CAT_TIMER_WHEEL_ROOT_MASK) + 1;
+    }
+
+    for (level = 0; level < CAT_TIMER_WHEEL_LEVELS; level++) {
+        uint64_t bits = cat_timer_wheel_level_bitmap(level);
+        unsigned int shift, start;
+        cat_msec_t base, candidate;
+        if (bits == 0) {
+            continue;
+        }
+        shift = cat_timer_wheel_level_shift(level);
+        base = current >> shift;
+        if ((current & ((UINT64_C(1) << shift) - 1)) != 0) {
+            /* slot of the current base has already been cascaded */
+            base++;
+        }
+        start = (unsigned int) (base & CAT_TIMER_WHEEL_LEVEL_MASK);
+        if (start != 0) {
+            bits = (bits >> start) | (bits << (CAT_TIMER_WHEEL_LEVEL_SIZE - start));
+        }
+        candidate = (base + cat_ctz64(bits)) << shift;
+        if (candidate < next) {
+            next = candidate;
+        }
+    }
+
+    return next;
+}
+
+static void cat_timer_wheel_callback(uv_timer_t *handle);
+
+static void cat_timer_wheel_schedule(cat_msec_t expire)
+{
+    uv_timer_t *handle = &CAT_TIME_G(timer);
+    cat_msec_t now = CAT_EVENT_G(loop).time;
+
+    CAT_TIME_G(scheduled) = expire;
+    (void) uv_timer_start(handle, cat_timer_wheel_callback, expire > now ? expire - now : 0, 0);
+}
+
+static void cat_timer_wheel_run(cat_msec_t now)
+{
+    while (CAT_TIME_G(current) <= now) {
+        cat_msec_t current = CAT_TIME_G(current);
+        unsigned int index = (unsigned int) (current & CAT_TIMER_WHEEL_ROOT_MASK);
+        cat_queue_t queue;
+        cat_timer_t *timer;
+
+        if (CAT_TIME_G(count) == 0) {
+            CAT_TIME_G(current) = now + 1;
+            break;
+        }
+        if (index == 0) {
+            unsigned int level;
+            for (level = 0; level < CAT_TIMER_WHEEL_LEVELS; level++) {
+                if (!cat_timer_wheel_cascade(level)) {
+                    break;
+                }
+            }
+        }
+        if (!(CAT_TIME_G(bitmap)[index / 64] & (UINT64_C(1) << (index % 64)))) {
+            /* skip empty slots, but never skip the cascade points */
+            cat_msec_t next = cat_timer_wheel_next();
+            CAT_TIME_G(current) = CAT_MAX(CAT_MIN(next, now + 1), current + 1);
+            continue;
+        }
+        CAT_TIME_G(current) = current + 1;
+        cat_timer_wheel_detach((uint16_t) index, &queue);
+        while ((timer = cat_queue_front_data(&queue, cat_timer_t, node))) {
+            cat_coroutine_t *coroutine = timer->coroutine;
+            cat_queue_remove(&timer->node);
+            timer->slot = CAT_TIMER_WHEEL_SLOT_NONE;
+            timer->coroutine = NULL;
+            CAT_TIME_G(count)--;
+            cat_coroutine_schedule(coroutine, TIME, "Timer");
+        }
+    }
+}
+
+static void cat_timer_wheel_callback(uv_timer_t *handle)
+{
+    (void) handle;
+
+    cat_timer_wheel_run(CAT_EVENT_G(loop).time);
+
+    if (CAT_TIME_G(count) == 0) {
+        uv_timer_stop(&CAT_TIME_G(timer));
+    } else {
+        cat_timer_wheel_schedule(cat_timer_wheel_next());
+    }
+}
+
+static void cat_timer_start(cat_timer_t *timer)
+{
+    if (CAT_TIME_G(count) == 0) {
+        /* nothing to catch up */
+        CAT_TIME_G(current) = CAT_EVENT_G(loop).time;
+    }
+    cat_timer_wheel_add(timer);
+    CAT_TIME_G(count)++;
+    if (!uv_is_active((uv_handle_t *) &CAT_TIME_G(timer)) || timer->expire < CAT_TIME_G(scheduled)) {
+        cat_timer_wheel_schedule(timer->expire);
+    }
+}
+
+static void cat_timer_stop(cat_timer_t *timer)
+{
+    uint16_t slot = timer->slot;
+
+    cat_queue_remove(&timer->node);
+    if (cat_queue_empty(&CAT_TIME_G(slots)[slot])) {
+        cat_timer_wheel_bitmap_clear(slot);
+    }
+    timer->slot = CAT_TIMER_WHEEL_SLOT_NONE;
+    if (--CAT_TIME_G(count) == 0) {
+        uv_timer_stop(&CAT_TIME_G(timer));
+    }
+    /* otherwise let it wake up once and reschedule */
+}
+
+/* OK: timed out, NONE: canceled, ERROR: error occurred */
+static cat_ret_t cat_timer_wait(cat_msec_t msec, cat_msec_t *expire)
+{
+    cat_timer_t *timer;
+    cat_bool_t ret, timedout;
+
+    timer = cat_timer_alloc();
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(timer == NULL)) {
+        return CAT_RET_ERROR;
+    }
+#endif
 
     timer->coroutine = CAT_COROUTINE_G(current);
+    timer->expire = CAT_EVENT_G(loop).time + msec;
+    cat_timer_start(timer);
 
     ret = cat_coroutine_yield(NULL, NULL);
 
-    uv_close(&timer->handle, cat_timer_close_callback);
+    timedout = timer->coroutine == NULL;
+    if (!timedout) {
+        cat_timer_stop(timer);
+    }
+    if (expire != NULL) {
+        *expire = timer->expire;
+    }
+    cat_timer_free(timer);
 
     if (unlikely(!ret)) {
         cat_update_last_error_with_previous("Time sleep failed");
-        return NULL;
+        return CAT_RET_ERROR;
     }
 
-    return timer;
+    return timedout ? CAT_RET_OK : CAT_RET_NONE;
 }
 
 static void cat_time_wait_0_callback(cat_event_loop_defer_task_t *task, cat_data_t *data)
@@ -191,11 +493,11 @@ static cat_always_inline cat_bool_t cat_time_wait_impl(cat_timeout_t timeout)
         }
         return cat_true;
     } else {
-        cat_timer_t *timer = cat_timer_wait(timeout);
-        if (unlikely(timer == NULL)) {
+        cat_ret_t ret = cat_timer_wait(timeout, NULL);
+        if (unlikely(ret == CAT_RET_ERROR)) {
             return cat_false;
         }
-        if (unlikely(timer->coroutine == NULL)) {
+        if (unlikely(ret == CAT_RET_OK)) {
             cat_update_last_error(CAT_ETIMEDOUT, "Timed out for " CAT_TIMEOUT_FMT " ms", timeout);
             return cat_false;
         }
@@ -222,13 +524,7 @@ static cat_always_inline cat_ret_t cat_time_delay_impl(cat_timeout_t timeout)
     } else if (timeout == 0) {
         return cat_time_delay_0();
     } else {
-        cat_timer_t *timer = cat_timer_wait(timeout);
-        if (unlikely(timer == NULL)) {
-            return CAT_RET_ERROR;
-        }
-        if (timer->coroutine == NULL) {
-            return CAT_RET_OK;
-        }
+        return cat_timer_wait(timeout, NULL);
     }
 
     return CAT_RET_NONE;
@@ -251,22 +547,23 @@ static cat_always_inline cat_msec_t cat_time_msleep_impl(cat_msec_t msec)
         (void) cat_time_delay_0();
         // even if error, the number of seconds left to sleep is always 0...
     } else {
-        cat_timer_t *timer;
+        cat_msec_t expire;
+        cat_ret_t ret;
 
-        timer = cat_timer_wait(msec);
+        ret = cat_timer_wait(msec, &expire);
 
-        if (unlikely(timer == NULL)) {
+        if (unlikely(ret == CAT_RET_ERROR)) {
             return msec;
         }
 
-        if (unlikely(timer->coroutine != NULL)) {
+        if (unlikely(ret == CAT_RET_NONE)) {
             cat_update_last_error(CAT_ECANCELED, "Time waiter has been canceled");
-            if (unlikely(timer->timer.timeout <= CAT_EVENT_G(loop).time)) {
+            if (unlikely(expire <= CAT_EVENT_G(loop).time)) {
                 /* blocking IO lead it to be negative or 0
                 * we can not know the real reserve time */
                 return msec;
             }
-            return timer->timer.timeout - CAT_EVENT_G(loop).time;
+            return expire - CAT_EVENT_G(loop).time;
         }
     }
 
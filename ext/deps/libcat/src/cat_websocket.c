@@ -159,58 +159,210 @@ CAT_API void cat_websocket_header_set_payload_info(cat_websocket_header_t *heade
     cat_websocket_header_set_masking_key(header, masking_key);
 }
 
-/* The difference between mask1 and mask2 is that
- * mask1 only needs to do calculate for the p++,
- * but mask2 should not only calculate for the from++, but also for the to++,
- * and for very large data, the amount of calculation is relatively reduced.
+/* Mask kernels, they all work for both in-place (from == to) and out-of-place masking,
+ * the key has been rotated by the index before, so that every kernel starts at key octet 0,
+ * and since all vector widths are multiples of 4, the tail is handed to the scalar one.
  *
  * @notice x % (2 ^ k) is equivalent to x & (2 ^ k - 1)
  */
-static void cat_websocket_mask1(char *data, uint64_t length, const char *masking_key, uint64_t index)
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CAT_WEBSOCKET_MASK_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ >= 5)
+#define CAT_WEBSOCKET_MASK_USE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CAT_WEBSOCKET_MASK_USE_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* below this length, vector kernels have nothing to do */
+#define CAT_WEBSOCKET_MASK_VECTOR_MIN_LENGTH 16
+
+typedef void (*cat_websocket_mask_kernel_t)(const char *from, char *to, uint64_t length, const char *masking_key);
+
+static void cat_websocket_mask_scalar(const char *from, char *to, uint64_t length, const char *masking_key)
 {
-    char *p = data;
-    const char *pe = p + length;
+    uint64_t i = 0;
 #ifdef CAT_L64
-    if (p + sizeof(uint64_t) <= pe) {
-        for (; p < pe && ((index & (sizeof(uint64_t) - 1)) != 0); p++, index++) {
-            *p ^= masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
-        }
-        uint64_t masking_key_u64 = ((uint64_t) (*((uint32_t *) masking_key)) << 32) | *((uint32_t *) masking_key);
-        uint64_t unmasked_length_of_u64 = pe - p;
-        unmasked_length_of_u64 = unmasked_length_of_u64 - (unmasked_length_of_u64 & (sizeof(uint64_t) - 1));
-        index += unmasked_length_of_u64;
-        const char *pe_of_u64 = p + unmasked_length_of_u64;
-        for (; p < pe_of_u64; p += sizeof(uint64_t)) {
-            *((uint64_t *) p) ^= masking_key_u64;
-        }
+    uint32_t masking_key_u32;
+    uint64_t masking_key_u64;
+    memcpy(&masking_key_u32, masking_key, sizeof(masking_key_u32));
+    masking_key_u64 = ((uint64_t) masking_key_u32 << 32) | masking_key_u32;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t u64;
+        memcpy(&u64, from + i, sizeof(u64));
+        u64 ^= masking_key_u64;
+        memcpy(to + i, &u64, sizeof(u64));
     }
 #endif
-    for (; p < pe; index++, p++) {
-        *p ^= masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
+    for (; i < length; i++) {
+        to[i] = from[i] ^ masking_key[i & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
     }
 }
 
-static void cat_websocket_mask2(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
+#ifdef CAT_WEBSOCKET_MASK_USE_SSE2
+static void cat_websocket_mask_sse2(const char *from, char *to, uint64_t length, const char *masking_key)
 {
-    const char *to_end = to + length;
-#ifdef CAT_L64
-    if (to + sizeof(uint64_t) <= to_end) {
-        for (; to < to_end && ((index & (sizeof(uint64_t) - 1)) != 0); from++, to++, index++) {
-            *to = *from ^ masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
+    int32_t masking_key_i32;
+    uint64_t i = 0;
+    memcpy(&masking_key_i32, masking_key, sizeof(masking_key_i32));
+    const __m128i vkey = _mm_set1_epi32(masking_key_i32);
+    for (; i + 64 <= length; i += 64) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *) (from + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (from + i + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *) (from + i + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *) (from + i + 48));
+        _mm_storeu_si128((__m128i *) (to + i), _mm_xor_si128(v0, vkey));
+        _mm_storeu_si128((__m128i *) (to + i + 16), _mm_xor_si128(v1, vkey));
+        _mm_storeu_si128((__m128i *) (to + i + 32), _mm_xor_si128(v2, vkey));
+        _mm_storeu_si128((__m128i *) (to + i + 48), _mm_xor_si128(v3, vkey));
+    }
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (from + i));
+        _mm_storeu_si128((__m128i *) (to + i), _mm_xor_si128(v, vkey));
+    }
+    cat_websocket_mask_scalar(from + i, to + i, length - i, masking_key);
+}
+#endif
+
+#ifdef CAT_WEBSOCKET_MASK_USE_AVX2
+__attribute__((target("avx2")))
+static void cat_websocket_mask_avx2(const char *from, char *to, uint64_t length, const char *masking_key)
+{
+    int32_t masking_key_i32;
+    uint64_t i = 0;
+    memcpy(&masking_key_i32, masking_key, sizeof(masking_key_i32));
+    const __m256i vkey = _mm256_set1_epi32(masking_key_i32);
+    for (; i + 128 <= length; i += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) (from + i));
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (from + i + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *) (from + i + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *) (from + i + 96));
+        _mm256_storeu_si256((__m256i *) (to + i), _mm256_xor_si256(v0, vkey));
+        _mm256_storeu_si256((__m256i *) (to + i + 32), _mm256_xor_si256(v1, vkey));
+        _mm256_storeu_si256((__m256i *) (to + i + 64), _mm256_xor_si256(v2, vkey));
+        _mm256_storeu_si256((__m256i *) (to + i + 96), _mm256_xor_si256(v3, vkey));
+    }
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (from + i));
+        _mm256_storeu_si256((__m256i *) (to + i), _mm256_xor_si256(v, vkey));
+    }
+    cat_websocket_mask_scalar(from + i, to + i, length - i, masking_key);
+}
+#endif
+
+#ifdef CAT_WEBSOCKET_MASK_USE_NEON
+static void cat_websocket_mask_neon(const char *from, char *to, uint64_t length, const char *masking_key)
+{
+    uint32_t masking_key_u32;
+    uint64_t i = 0;
+    memcpy(&masking_key_u32, masking_key, sizeof(masking_key_u32));
+    const uint8x16_t vkey = vreinterpretq_u8_u32(vdupq_n_u32(masking_key_u32));
+    for (; i + 64 <= length; i += 64) {
+        uint8x16_t v0 = vld1q_u8((const uint8_t *) (from + i));
+        uint8x16_t v1 = vld1q_u8((const uint8_t *) (from + i + 16));
+        uint8x16_t v2 = vld1q_u8((const uint8_t *) (from + i + 32));
+        uint8x16_t v3 = vld1q_u8((const uint8_t *) (from + i + 48));
+        vst1q_u8((uint8_t *) (to + i), veorq_u8(v0, vkey));
+        vst1q_u8((uint8_t *) (to + i + 16), veorq_u8(v1, vkey));
+        vst1q_u8((uint8_t *) (to + i + 32), veorq_u8(v2, vkey));
+        vst1q_u8((uint8_t *) (to + i + 48), veorq_u8(v3, vkey));
+    }
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *) (from + i));
+        vst1q_u8((uint8_t *) (to + i), veorq_u8(v, vkey));
+    }
+    cat_websocket_mask_scalar(from + i, to + i, length - i, masking_key);
+}
+#endif
+
+typedef struct cat_websocket_mask_kernel_info_s {
+    const char *name;
+    cat_websocket_mask_kernel_t kernel;
+} cat_websocket_mask_kernel_info_t;
+
+static const cat_websocket_mask_kernel_info_t cat_websocket_mask_kernels[] = {
+#ifdef CAT_WEBSOCKET_MASK_USE_AVX2
+    { "avx2", cat_websocket_mask_avx2 },
+#endif
+#ifdef CAT_WEBSOCKET_MASK_USE_SSE2
+    { "sse2", cat_websocket_mask_sse2 },
+#endif
+#ifdef CAT_WEBSOCKET_MASK_USE_NEON
+    { "neon", cat_websocket_mask_neon },
+#endif
+    { "scalar", cat_websocket_mask_scalar },
+};
+
+static const cat_websocket_mask_kernel_info_t *cat_websocket_mask_kernel_info;
+
+static cat_bool_t cat_websocket_mask_kernel_is_supported(const cat_websocket_mask_kernel_info_t *info)
+{
+#ifdef CAT_WEBSOCKET_MASK_USE_AVX2
+    if (info->kernel == cat_websocket_mask_avx2) {
+        __builtin_cpu_init();
+        return !!__builtin_cpu_supports("avx2");
+    }
+#endif
+#if defined(CAT_WEBSOCKET_MASK_USE_SSE2) && !defined(__SSE2__) && defined(__GNUC__)
+    if (info->kernel == cat_websocket_mask_sse2) {
+        __builtin_cpu_init();
+        return !!__builtin_cpu_supports("sse2");
+    }
+#endif
+    (void) info;
+    return cat_true;
+}
+
+/* the first supported kernel in the list is the best one,
+ * $CAT_WEBSOCKET_MASK_KERNEL can be used to force a (supported) one, e.g. for benchmark */
+static const cat_websocket_mask_kernel_info_t *cat_websocket_mask_kernel_resolve(void)
+{
+    const cat_websocket_mask_kernel_info_t *info, *preferred = NULL;
+    char *name = cat_env_get_silent("CAT_WEBSOCKET_MASK_KERNEL", NULL);
+    size_t n;
+
+    for (n = 0; n < CAT_ARRAY_SIZE(cat_websocket_mask_kernels); n++) {
+        info = &cat_websocket_mask_kernels[n];
+        if (!cat_websocket_mask_kernel_is_supported(info)) {
+            continue;
+        }
+        if (preferred == NULL) {
+            preferred = info;
         }
-        uint64_t masking_key_u64 = ((uint64_t) (*((uint32_t *) masking_key)) << 32) | *((uint32_t *) masking_key);
-        uint64_t unmasked_length_of_u64 = to_end - to;
-        unmasked_length_of_u64 = unmasked_length_of_u64 - (unmasked_length_of_u64 & (sizeof(uint64_t) - 1));
-        index += unmasked_length_of_u64;
-        const char *to_end_of_u64 = to + unmasked_length_of_u64;
-        for (; to < to_end_of_u64; to += sizeof(uint64_t), from += sizeof(uint64_t)) {
-            *((uint64_t *) to) = *((uint64_t *) from) ^ masking_key_u64;
+        if (name != NULL && strcmp(name, info->name) == 0) {
+            preferred = info;
+            break;
         }
     }
-#endif
-    for (; to < to_end; index++, to++, from++) {
-        *to = *from ^ masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
+    if (name != NULL) {
+        cat_free(name);
     }
+
+    return preferred;
+}
+
+static cat_always_inline const cat_websocket_mask_kernel_info_t *cat_websocket_mask_get_kernel_info(void)
+{
+    /* resolving is idempotent, so racing threads just do it more than once */
+    const cat_websocket_mask_kernel_info_t *info = cat_websocket_mask_kernel_info;
+    if (unlikely(info == NULL)) {
+        info = cat_websocket_mask_kernel_resolve();
+        cat_websocket_mask_kernel_info = info;
+    }
+    return info;
+}
+
+CAT_API const char *cat_websocket_mask_get_kernel_name(void)
+{
+    return cat_websocket_mask_get_kernel_info()->name;
 }
 
 CAT_API void cat_websocket_mask(const char *from, char *to, uint64_t length, const char *masking_key)
@@ -225,18 +377,23 @@ CAT_API void cat_websocket_unmask(char *data, uint64_t length, const char *maski
 
 CAT_API void cat_websocket_mask_ex(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
 {
-    cat_bool_t masking_key_is_empty = masking_key == NULL || memcmp(masking_key, CAT_STRS(CAT_WEBSOCKET_EMPTY_MASKING_KEY)) == 0;
+    char rotated_masking_key[CAT_WEBSOCKET_MASKING_KEY_LENGTH];
+    uint8_t n;
 
-    if (from == to) {
-        if (!masking_key_is_empty) {
-            cat_websocket_mask1(to, length, masking_key, index);
-        }
-    } else {
-        if (masking_key_is_empty) {
+    if (masking_key == NULL || memcmp(masking_key, CAT_STRS(CAT_WEBSOCKET_EMPTY_MASKING_KEY)) == 0) {
+        if (from != to) {
             memmove(to, from, length);
-        } else {
-            cat_websocket_mask2(from, to, length, masking_key, index);
         }
+        return;
+    }
+    /* rotate the key so that payload octet 0 is masked by key octet 0 */
+    for (n = 0; n < CAT_WEBSOCKET_MASKING_KEY_LENGTH; n++) {
+        rotated_masking_key[n] = masking_key[(index + n) & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
+    }
+    if (length < CAT_WEBSOCKET_MASK_VECTOR_MIN_LENGTH) {
+        cat_websocket_mask_scalar(from, to, length, rotated_masking_key);
+    } else {
+        cat_websocket_mask_get_kernel_info()->kernel(from, to, length, rotated_masking_key);
     }
 }
 
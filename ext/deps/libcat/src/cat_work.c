@@ -51,12 +51,12 @@ static void cat_work_after_done(uv_work_t *request, int status)
     if (context->cleanup != NULL) {
         context->cleanup(context->data);
     }
-    cat_free(context);
+    cat_event_slab_free(context, sizeof(*context));
 }
 
 CAT_API cat_bool_t cat_work(cat_work_kind_t kind, cat_work_function_t function, cat_work_cleanup_callback_t cleanup, cat_data_t *data, cat_timeout_t timeout)
 {
-    cat_work_context_t *context = (cat_work_context_t *) cat_malloc(sizeof(*context));
+    cat_work_context_t *context = (cat_work_context_t *) cat_event_slab_malloc(sizeof(*context));
     cat_bool_t ret;
 
 #if CAT_ALLOC_HANDLE_ERRORS
@@ -68,6 +68,8 @@ typedef enum swow_runtime_state_e {
 
 ZEND_BEGIN_MODULE_GLOBALS(swow)
     swow_runtime_state_t runtime_state;
+    /* 0 for the main thread, see Swow\Thread */
+    zend_long thread_id;
     struct {
         bool enable;
         bool async_file;
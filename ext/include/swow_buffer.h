@@ -47,9 +47,49 @@ typedef struct swow_buffer_s {
     zend_object std;
 } swow_buffer_t;
 
+/* buffer strings are allocated in power-of-two size classes (of the string value, header is not counted in),
+ * strings released by buffers (which are not referenced by others) are cached per runtime,
+ * so that buffers can be reused without touching the heap, and grown in place within the class */
+#define SWOW_BUFFER_POOL_MIN_CLASS_SHIFT   8  /* 256B */
+/* larger ones are huge blocks which are mapped from the OS directly */
+#define SWOW_BUFFER_POOL_MAX_CLASS_SHIFT   20 /* 1MiB */
+#define SWOW_BUFFER_POOL_CLASS_COUNT       (SWOW_BUFFER_POOL_MAX_CLASS_SHIFT - SWOW_BUFFER_POOL_MIN_CLASS_SHIFT + 1)
+#define SWOW_BUFFER_POOL_DEFAULT_MAX_BYTES (16 * 1024 * 1024)
+/* pages of cached strings larger than it are given back to the OS on trim */
+#define SWOW_BUFFER_POOL_ADVISE_SIZE       (64 * 1024)
+
+typedef struct swow_buffer_pool_class_s {
+    size_t count;
+    /* linked by the first pointer of the string value */
+    zend_string *strings;
+} swow_buffer_pool_class_t;
+
+typedef struct swow_buffer_pool_s {
+    bool enabled;
+    size_t max_bytes;
+    size_t count;
+    size_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t reallocs;
+    uint64_t in_place_reallocs;
+    uint64_t advised_bytes;
+    swow_buffer_pool_class_t classes[SWOW_BUFFER_POOL_CLASS_COUNT];
+} swow_buffer_pool_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(swow_buffer) {
+    swow_buffer_pool_t pool;
+} CAT_GLOBALS_STRUCT_END(swow_buffer);
+
+extern SWOW_API CAT_GLOBALS_DECLARE(swow_buffer);
+
+#define SWOW_BUFFER_G(x) CAT_GLOBALS_GET(swow_buffer, x)
+
 /* loader */
 
 zend_result swow_buffer_module_init(INIT_FUNC_ARGS);
+zend_result swow_buffer_runtime_init(INIT_FUNC_ARGS);
+zend_result swow_buffer_runtime_shutdown(SHUTDOWN_FUNC_ARGS);
 
 /* helper */
 
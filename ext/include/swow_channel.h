@@ -69,6 +69,11 @@ static zend_always_inline swow_channel_t *swow_channel_get_from_object(zend_obje
     return cat_container_of(object, swow_channel_t, std);
 }
 
+static zend_always_inline bool swow_channel_has_constructed(swow_channel_t *s_channel)
+{
+    return s_channel->channel.dtor == (cat_channel_data_dtor_t) zval_ptr_dtor;
+}
+
 static zend_always_inline swow_selector_t *swow_selector_get_from_object(zend_object *object)
 {
     return cat_container_of(object, swow_selector_t, std);
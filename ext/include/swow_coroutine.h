@@ -36,6 +36,8 @@ extern "C" {
 #define SWOW_COROUTINE_DEFAULT_STACK_PAGE_SIZE (4 * 1024)
 #define SWOW_COROUTINE_MAX_STACK_PAGE_SIZE     (256 * 1024)
 
+#define SWOW_COROUTINE_VM_STACK_POOL_CLASS_COUNT 4
+
 #define SWOW_COROUTINE_SWAP_JIT_GLOBALS     1
 #define SWOW_COROUTINE_SWAP_ERROR_HANDING   1
 #if PHP_VERSION_ID < 80100
@@ -123,6 +125,24 @@ typedef enum swow_coroutine_runtime_state_e {
     SWOW_COROUTINE_RUNTIME_STATE_IN_SHUTDOWN
 } swow_coroutine_runtime_state_t;
 
+/* VM stack pages of dead coroutines are cached by page size,
+ * it shares the max count with the C stack pool */
+typedef struct swow_coroutine_vm_stack_pool_class_s {
+    /* page size of this class (0 means unused) */
+    size_t size;
+    size_t count;
+    /* linked by prev */
+    zend_vm_stack pages;
+} swow_coroutine_vm_stack_pool_class_t;
+
+typedef struct swow_coroutine_vm_stack_pool_s {
+    size_t count;
+    size_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    swow_coroutine_vm_stack_pool_class_t classes[SWOW_COROUTINE_VM_STACK_POOL_CLASS_COUNT];
+} swow_coroutine_vm_stack_pool_t;
+
 CAT_GLOBALS_STRUCT_BEGIN(swow_coroutine) {
     /* ini */
     size_t default_stack_page_size;
@@ -132,6 +152,7 @@ CAT_GLOBALS_STRUCT_BEGIN(swow_coroutine) {
     swow_coroutine_runtime_state_t runtime_state;
     HashTable *map;
     cat_queue_t deadlock_handlers;
+    swow_coroutine_vm_stack_pool_t vm_stack_pool;
     /* internal special */
     cat_coroutine_jump_t original_jump;
     cat_coroutine_t *original_main;
@@ -192,6 +213,8 @@ SWOW_API swow_coroutine_t *swow_coroutine_get_from(const swow_coroutine_t *s_cor
 SWOW_API swow_coroutine_t *swow_coroutine_get_previous(const swow_coroutine_t *s_coroutine);
 SWOW_API void *swow_coroutine_get_stack_base(const swow_coroutine_t *s_coroutine);
 SWOW_API void* swow_coroutine_get_stack_limit(const swow_coroutine_t *s_coroutine);
+/* resident bytes of both C stack and VM stack */
+SWOW_API size_t swow_coroutine_get_stack_resident_size(const swow_coroutine_t *s_coroutine);
 
 /* globals (options) */
 SWOW_API size_t swow_coroutine_set_default_stack_page_size(size_t size);
@@ -26,6 +26,8 @@ extern "C" {
 
 #include "cat_dns.h"
 
+extern SWOW_API zend_class_entry *swow_dns_ce;
+
 /* loader */
 
 zend_result swow_dns_module_init(INIT_FUNC_ARGS);
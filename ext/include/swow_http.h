@@ -25,6 +25,7 @@ extern "C" {
 #include "swow.h"
 
 #include "cat_http.h"
+#include "cat_fs.h"
 
 extern SWOW_API zend_class_entry *swow_http_http_ce;
 
@@ -34,9 +35,59 @@ extern SWOW_API zend_class_entry *swow_http_parser_ce;
 extern SWOW_API zend_object_handlers swow_http_parser_handlers;
 extern SWOW_API zend_class_entry *swow_http_parser_exception_ce;
 
+/* offsets are relative to the start of the data buffer (ZSTR_VAL) passed to executeHead(),
+ * not to its start argument, so the buffer must not be truncated until the head is completed */
+typedef struct swow_http_parser_header_s {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t value_offset;
+    uint32_t value_length;
+    /* lowercase name (with hash), it is NULL until the value arrives */
+    zend_string *name;
+} swow_http_parser_header_t;
+
+typedef struct swow_http_parser_head_s {
+    swow_http_parser_header_t *headers;
+    uint32_t count;
+    uint32_t size;
+    /* url (request) or reason phrase (response) */
+    uint32_t line_offset;
+    uint32_t line_length;
+    /* the last data event, to join data which is split into pieces */
+    cat_http_parser_event_t last_event;
+    bool completed;
+    /* lowercase names seen on this parser (e.g. keep-alive connection), indexed by hash */
+    HashTable *names;
+} swow_http_parser_head_t;
+
+/* multipart body is parsed natively part by part,
+ * part data is copied (or spooled to disk), so the data buffer can be truncated between executions */
+typedef struct swow_http_parser_multipart_s {
+    /* where file parts are spooled to (system temporary directory if it is NULL) */
+    zend_string *spool_directory;
+    /* file parts are kept in memory until their size exceeds it */
+    size_t memory_threshold;
+    /* lowercase name => value */
+    zval headers;
+    smart_str header_name;
+    smart_str header_value;
+    cat_http_parser_event_t last_event;
+    bool is_file;
+    /* the part can be fetched */
+    bool completed;
+    smart_str data;
+    zend_string *file_path;
+    cat_file_t file;
+    size_t size;
+    /* UPLOAD_ERR_* */
+    int error;
+} swow_http_parser_multipart_t;
+
 typedef struct swow_http_parser_s {
     cat_http_parser_t parser;
     size_t data_offset;
+    swow_http_parser_head_t head;
+    swow_http_parser_multipart_t multipart;
     zend_object std;
 } swow_http_parser_t;
 
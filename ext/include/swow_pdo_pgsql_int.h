@@ -130,11 +130,24 @@ typedef struct {
     char *errmsg;
 } pdo_pgsql_error_info;
 
+typedef enum {
+    PDO_PGSQL_PIPELINE_ENTRY_EXECUTE,
+    PDO_PGSQL_PIPELINE_ENTRY_PREPARE,
+    PDO_PGSQL_PIPELINE_ENTRY_DISCARD,
+} pdo_pgsql_pipeline_entry_type;
+
+/* a query which has been sent in pipeline mode but its result has not been read */
+typedef struct {
+    pdo_pgsql_pipeline_entry_type type;
+    pdo_stmt_t *stmt; /* NULL if the statement has been destroyed */
+} pdo_pgsql_pipeline_entry;
+
 /* stuff we use in a pgsql database handle */
 typedef struct {
     PGconn        *server;
     unsigned     attached:1;
-    unsigned     _reserved:31;
+    unsigned     in_pipeline:1;
+    unsigned     _reserved:30;
     pdo_pgsql_error_info    einfo;
     Oid         pgoid;
     unsigned int    stmt_counter;
@@ -144,6 +157,9 @@ typedef struct {
     bool        disable_native_prepares; /* deprecated since 5.6 */
     bool        disable_prepares;
     HashTable       *lob_streams;
+    pdo_pgsql_pipeline_entry *pipeline_entries;
+    uint32_t        pipeline_count;
+    uint32_t        pipeline_size;
 } pdo_pgsql_db_handle;
 
 typedef struct {
@@ -163,6 +179,7 @@ typedef struct {
     Oid *param_types;
     int                     current_row;
     bool is_prepared;
+    bool columns_pending; /* executed in pipeline mode before columns are known */
 } pdo_pgsql_stmt;
 
 typedef struct {
@@ -207,6 +224,13 @@ extern const php_stream_ops swow_pdo_pgsql_lob_stream_ops;
 void swow_pdo_libpq_version(char *buf, size_t len);
 void swow_pdo_pgsql_close_lob_streams(pdo_dbh_t *dbh);
 
+#ifdef CAT_PQ_HAVE_PIPELINE
+void swow_pdo_pgsql_pipeline_enqueue(pdo_dbh_t *dbh, pdo_stmt_t *stmt, pdo_pgsql_pipeline_entry_type type);
+void swow_pdo_pgsql_pipeline_forget(pdo_dbh_t *dbh, pdo_stmt_t *stmt);
+bool swow_pdo_pgsql_pipeline_discard(pdo_dbh_t *dbh, const char *query);
+bool swow_pdo_pgsql_stmt_pipeline_result(pdo_stmt_t *stmt, PGresult *result, pdo_pgsql_pipeline_entry_type type);
+#endif
+
 #endif
 
 #endif /* PHP_PDO_PGSQL_INT_H */
@@ -122,6 +122,15 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_WITH_TENTATIVE_RETURN_TYPE_INFO_EX(arginfo_class_PDO_PGSql_Ext_pgsqlGetPid, 0, 0, IS_LONG, 0)
 ZEND_END_ARG_INFO()
 
+#ifdef CAT_PQ_HAVE_PIPELINE
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_PDO_PGSql_Ext_pgsqlEnterPipelineMode, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+#define arginfo_class_PDO_PGSql_Ext_pgsqlPipelineSync arginfo_class_PDO_PGSql_Ext_pgsqlEnterPipelineMode
+
+#define arginfo_class_PDO_PGSql_Ext_pgsqlExitPipelineMode arginfo_class_PDO_PGSql_Ext_pgsqlEnterPipelineMode
+#endif
+
 
 ZEND_METHOD(PDO_PGSql_Ext, pgsqlCopyFromArray);
 ZEND_METHOD(PDO_PGSql_Ext, pgsqlCopyFromFile);
@@ -132,6 +141,11 @@ ZEND_METHOD(PDO_PGSql_Ext, pgsqlLOBOpen);
 ZEND_METHOD(PDO_PGSql_Ext, pgsqlLOBUnlink);
 ZEND_METHOD(PDO_PGSql_Ext, pgsqlGetNotify);
 ZEND_METHOD(PDO_PGSql_Ext, pgsqlGetPid);
+#ifdef CAT_PQ_HAVE_PIPELINE
+ZEND_METHOD(PDO_PGSql_Ext, pgsqlEnterPipelineMode);
+ZEND_METHOD(PDO_PGSql_Ext, pgsqlPipelineSync);
+ZEND_METHOD(PDO_PGSql_Ext, pgsqlExitPipelineMode);
+#endif
 
 
 static const zend_function_entry class_PDO_PGSql_Ext_methods[] = {
@@ -144,6 +158,11 @@ static const zend_function_entry class_PDO_PGSql_Ext_methods[] = {
     ZEND_ME(PDO_PGSql_Ext, pgsqlLOBUnlink, arginfo_class_PDO_PGSql_Ext_pgsqlLOBUnlink, ZEND_ACC_PUBLIC)
     ZEND_ME(PDO_PGSql_Ext, pgsqlGetNotify, arginfo_class_PDO_PGSql_Ext_pgsqlGetNotify, ZEND_ACC_PUBLIC)
     ZEND_ME(PDO_PGSql_Ext, pgsqlGetPid, arginfo_class_PDO_PGSql_Ext_pgsqlGetPid, ZEND_ACC_PUBLIC)
+#ifdef CAT_PQ_HAVE_PIPELINE
+    ZEND_ME(PDO_PGSql_Ext, pgsqlEnterPipelineMode, arginfo_class_PDO_PGSql_Ext_pgsqlEnterPipelineMode, ZEND_ACC_PUBLIC)
+    ZEND_ME(PDO_PGSql_Ext, pgsqlPipelineSync, arginfo_class_PDO_PGSql_Ext_pgsqlPipelineSync, ZEND_ACC_PUBLIC)
+    ZEND_ME(PDO_PGSql_Ext, pgsqlExitPipelineMode, arginfo_class_PDO_PGSql_Ext_pgsqlExitPipelineMode, ZEND_ACC_PUBLIC)
+#endif
     ZEND_FE_END
 };
 #endif
@@ -0,0 +1,66 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef SWOW_POOL_H
+#define SWOW_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "swow.h"
+
+#include "cat_pool.h"
+
+extern SWOW_API zend_class_entry *swow_pool_ce;
+extern SWOW_API zend_object_handlers swow_pool_handlers;
+extern SWOW_API zend_class_entry *swow_pool_exception_ce;
+
+/* items are objects, they are stored as zend_object pointers in the pool */
+typedef struct swow_pool_s {
+    cat_pool_t pool;
+    cat_bool_t constructed;
+    swow_fcall_storage_t creator;
+    swow_fcall_storage_t checker;
+    /* objects evicted in the event loop, they are released in the PHP context later */
+    HashTable *evicted;
+    /* objects handed out by get() (indexed by handle), put() only accepts them,
+     * they are referenced here so that their handles can not be reused by other objects */
+    HashTable in_use;
+    zend_object std;
+} swow_pool_t;
+
+/* loader */
+
+zend_result swow_pool_module_init(INIT_FUNC_ARGS);
+
+/* helper*/
+
+static zend_always_inline swow_pool_t *swow_pool_get_from_handle(cat_pool_t *pool)
+{
+    return cat_container_of(pool, swow_pool_t, pool);
+}
+
+static zend_always_inline swow_pool_t *swow_pool_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_pool_t, std);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SWOW_POOL_H */
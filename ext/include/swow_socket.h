@@ -33,6 +33,8 @@ extern SWOW_API zend_class_entry *swow_socket_exception_ce;
 
 typedef struct swow_socket_s {
     cat_socket_t socket;
+    /* for recvFrame()/sendFrame() */
+    cat_socket_frame_format_t frame_format;
     zend_object std;
 } swow_socket_t;
 
@@ -41,6 +43,7 @@ typedef struct swow_socket_s {
 zend_result swow_socket_module_init(INIT_FUNC_ARGS);
 zend_result swow_socket_module_shutdown(INIT_FUNC_ARGS);
 zend_result swow_socket_runtime_init(INIT_FUNC_ARGS);
+zend_result swow_socket_runtime_shutdown(SHUTDOWN_FUNC_ARGS);
 
 /* helper*/
 
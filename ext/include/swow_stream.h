@@ -80,6 +80,9 @@ typedef struct swow_netstream_data_s {
 #endif
 } swow_netstream_data_t;
 
+/* same as php_open_temporary_fd() but the file is created without blocking the event loop */
+SWOW_API int swow_open_temporary_fd(const char *dir, const char *pfx, zend_string **opened_path_p);
+
 zend_result swow_stream_module_init(INIT_FUNC_ARGS);
 zend_result swow_stream_runtime_init(INIT_FUNC_ARGS);
 zend_result swow_stream_runtime_shutdown(INIT_FUNC_ARGS);
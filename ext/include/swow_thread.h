@@ -0,0 +1,77 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef SWOW_THREAD_H
+#define SWOW_THREAD_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "swow.h"
+
+#include "cat_async.h"
+
+extern SWOW_API zend_class_entry *swow_thread_ce;
+extern SWOW_API zend_object_handlers swow_thread_handlers;
+
+extern SWOW_API zend_class_entry *swow_thread_queue_ce;
+extern SWOW_API zend_object_handlers swow_thread_queue_handlers;
+
+extern SWOW_API zend_class_entry *swow_thread_exception_ce;
+
+/* every thread runs a PHP request with its own Swow runtime (event loop and scheduler),
+ * they talk to each other by named thread queues (cat_async_queue_t) */
+
+typedef struct swow_thread_s {
+    zend_long id;
+    uv_thread_t tid;
+    /* the thread pushes its exit status here */
+    cat_async_queue_t *exit_queue;
+    zend_long exit_status;
+    cat_bool_t started;
+    cat_bool_t joined;
+    zend_object std;
+} swow_thread_t;
+
+typedef struct swow_thread_queue_s {
+    zend_string *name;
+    cat_async_queue_t *queue;
+    zend_object std;
+} swow_thread_queue_t;
+
+/* loader */
+
+zend_result swow_thread_module_init(INIT_FUNC_ARGS);
+zend_result swow_thread_module_shutdown(INIT_FUNC_ARGS);
+
+/* helper*/
+
+static zend_always_inline swow_thread_t *swow_thread_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_thread_t, std);
+}
+
+static zend_always_inline swow_thread_queue_t *swow_thread_queue_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_thread_queue_t, std);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SWOW_THREAD_H */
@@ -18,11 +18,17 @@
 
 #include "swow_buffer.h"
 
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+
 SWOW_API zend_class_entry *swow_buffer_ce;
 SWOW_API zend_object_handlers swow_buffer_handlers;
 
 SWOW_API zend_class_entry *swow_buffer_exception_ce;
 
+SWOW_API CAT_GLOBALS_DECLARE(swow_buffer);
+
 #define VECTOR_POSITION_FMT "[%u][%u] "
 #define VECTOR_POSTION_C    vector_index, arg_num - 1
 #define ZEND_LONG_ARG_FMT   "($%s = " ZEND_LONG_FMT ") "
@@ -259,6 +265,10 @@ static void swow_buffer_free_object(zend_object *object)
     zend_object_std_dtor(&s_buffer->std);
 }
 
+static zend_always_inline size_t swow_buffer_pool_get_class_size(int index);
+static void swow_buffer_pool_shrink(size_t max_bytes);
+static void swow_buffer_pool_trim(void);
+
 #define getThisBuffer() (swow_buffer_get_from_object(Z_OBJ_P(ZEND_THIS)))
 
 #define SWOW_BUFFER_GETTER(_s_buffer, _buffer) \
@@ -309,6 +319,68 @@ static PHP_METHOD(Swow_Buffer, alignSize)
     RETURN_LONG(size);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Buffer_getPoolStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Buffer, getPoolStats)
+{
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+    zval z_classes;
+    int index;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init(&z_classes);
+    for (index = 0; index < SWOW_BUFFER_POOL_CLASS_COUNT; index++) {
+        if (pool->classes[index].count != 0) {
+            add_index_long(&z_classes, swow_buffer_pool_get_class_size(index), (zend_long) pool->classes[index].count);
+        }
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "hits", (zend_long) pool->hits);
+    add_assoc_long(return_value, "misses", (zend_long) pool->misses);
+    add_assoc_long(return_value, "reallocs", (zend_long) pool->reallocs);
+    add_assoc_long(return_value, "in_place_reallocs", (zend_long) pool->in_place_reallocs);
+    add_assoc_long(return_value, "advised_bytes", (zend_long) pool->advised_bytes);
+    add_assoc_long(return_value, "count", (zend_long) pool->count);
+    add_assoc_long(return_value, "bytes", (zend_long) pool->bytes);
+    add_assoc_long(return_value, "max_bytes", (zend_long) pool->max_bytes);
+    add_assoc_zval(return_value, "classes", &z_classes);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Buffer_setPoolMaxBytes, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, bytes, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Buffer, setPoolMaxBytes)
+{
+    zend_long bytes;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(bytes)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(bytes < 0)) {
+        zend_argument_value_error(1, "can not be negative");
+        RETURN_THROWS();
+    }
+
+    SWOW_BUFFER_G(pool).max_bytes = (size_t) bytes;
+    swow_buffer_pool_shrink((size_t) bytes);
+    swow_buffer_pool_trim();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Buffer_trimPool, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Buffer, trimPool)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    swow_buffer_pool_trim();
+}
+
 static PHP_METHOD_EX(Swow_Buffer, create)
 {
     SWOW_BUFFER_GETTER(s_buffer, buffer);
@@ -923,6 +995,9 @@ static PHP_METHOD(Swow_Buffer, __unserialize)
 
 static const zend_function_entry swow_buffer_methods[] = {
     PHP_ME(Swow_Buffer, alignSize,         arginfo_class_Swow_Buffer_alignSize,         ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Buffer, getPoolStats,      arginfo_class_Swow_Buffer_getPoolStats,      ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Buffer, setPoolMaxBytes,   arginfo_class_Swow_Buffer_setPoolMaxBytes,   ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Buffer, trimPool,          arginfo_class_Swow_Buffer_trimPool,          ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Buffer, __construct,       arginfo_class_Swow_Buffer___construct,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Buffer, alloc,             arginfo_class_Swow_Buffer_alloc,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Buffer, getSize,           arginfo_class_Swow_Buffer_getSize,           ZEND_ACC_PUBLIC)
@@ -989,9 +1064,184 @@ static zend_result swow_buffer_cast_object(zend_object *object, zval *result, in
     return zend_std_cast_object_tostring(object, result, type);
 }
 
+/* buffer pool */
+
+static zend_always_inline size_t swow_buffer_pool_get_class_size(int index)
+{
+    return ((size_t) 1) << (index + SWOW_BUFFER_POOL_MIN_CLASS_SHIFT);
+}
+
+/* returns the smallest class which can hold the string value in this size,
+ * or -1 if strings in this size are not pooled */
+static int swow_buffer_pool_get_class_index(size_t size)
+{
+    int index;
+
+    for (index = 0; index < SWOW_BUFFER_POOL_CLASS_COUNT; index++) {
+        if (size <= swow_buffer_pool_get_class_size(index)) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+/* returns the largest class which the block can serve, or -1 if it is not pooled */
+static int swow_buffer_pool_get_block_class_index(size_t block_size)
+{
+    size_t size;
+    int index;
+
+    if (block_size < _ZSTR_STRUCT_SIZE(swow_buffer_pool_get_class_size(0))) {
+        return -1;
+    }
+    size = block_size - _ZSTR_STRUCT_SIZE(0);
+    for (index = SWOW_BUFFER_POOL_CLASS_COUNT - 1; index >= 0; index--) {
+        if (size >= swow_buffer_pool_get_class_size(index)) {
+            /* too large to be cached as the largest class */
+            if (size >= swow_buffer_pool_get_class_size(index) * 2) {
+                return -1;
+            }
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+static zend_always_inline size_t swow_buffer_pool_get_class_block_size(int index)
+{
+    /* the class is the size of the string value, the header is not counted in,
+     * so that power-of-two sized buffers do not spill into the next class */
+    return _ZSTR_STRUCT_SIZE(swow_buffer_pool_get_class_size(index));
+}
+
+static zend_always_inline zend_string *swow_buffer_pool_class_pop(swow_buffer_pool_t *pool, swow_buffer_pool_class_t *pool_class)
+{
+    zend_string *string = pool_class->strings;
+
+    pool_class->strings = *((zend_string **) ZSTR_VAL(string));
+    pool_class->count--;
+    pool->count--;
+    pool->bytes -= zend_mem_block_size(string);
+
+    return string;
+}
+
+static zend_always_inline bool swow_buffer_pool_is_available(const swow_buffer_pool_t *pool)
+{
+    /* block size is unknown if the custom heap is in use (e.g. USE_ZEND_ALLOC=0) */
+    return pool->enabled && is_zend_mm();
+}
+
+static zend_string *swow_buffer_pool_alloc(size_t size)
+{
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+    swow_buffer_pool_class_t *pool_class;
+    zend_string *string;
+    int index;
+
+    if (!swow_buffer_pool_is_available(pool) ||
+        (index = swow_buffer_pool_get_class_index(size)) < 0) {
+        return zend_string_alloc(size, false);
+    }
+    pool_class = &pool->classes[index];
+    if (pool_class->count == 0) {
+        pool->misses++;
+        string = (zend_string *) emalloc(swow_buffer_pool_get_class_block_size(index));
+    } else {
+        string = swow_buffer_pool_class_pop(pool, pool_class);
+        pool->hits++;
+    }
+    GC_SET_REFCOUNT(string, 1);
+    GC_TYPE_INFO(string) = GC_STRING;
+    ZSTR_H(string) = 0;
+
+    return string;
+}
+
+static void swow_buffer_pool_release(zend_string *string)
+{
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+    swow_buffer_pool_class_t *pool_class;
+    size_t block_size;
+    int index;
+
+    if (
+        /* string is still referenced by others */
+        GC_REFCOUNT(string) != 1 ||
+        ZSTR_IS_INTERNED(string) ||
+        (GC_FLAGS(string) & IS_STR_PERSISTENT) ||
+        !swow_buffer_pool_is_available(pool)
+    ) {
+        zend_string_release(string);
+        return;
+    }
+    block_size = zend_mem_block_size(string);
+    index = swow_buffer_pool_get_block_class_index(block_size);
+    if (index < 0 || pool->bytes + block_size > pool->max_bytes) {
+        efree(string);
+        return;
+    }
+    pool_class = &pool->classes[index];
+    *((zend_string **) ZSTR_VAL(string)) = pool_class->strings;
+    /* length of the cached string is the size of advised pages, see swow_buffer_pool_trim() */
+    ZSTR_LEN(string) = 0;
+    pool_class->strings = string;
+    pool_class->count++;
+    pool->count++;
+    pool->bytes += block_size;
+}
+
+static void swow_buffer_pool_shrink(size_t max_bytes)
+{
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+    int index;
+
+    /* larger ones go first */
+    for (index = SWOW_BUFFER_POOL_CLASS_COUNT - 1; index >= 0 && pool->bytes > max_bytes; index--) {
+        swow_buffer_pool_class_t *pool_class = &pool->classes[index];
+        while (pool_class->count > 0 && pool->bytes > max_bytes) {
+            efree(swow_buffer_pool_class_pop(pool, pool_class));
+        }
+    }
+}
+
+static void swow_buffer_pool_trim(void)
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_DONTNEED)
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+    size_t page_size = cat_getpagesize();
+    int index;
+
+    for (index = SWOW_BUFFER_POOL_CLASS_COUNT - 1; index >= 0; index--) {
+        zend_string *string;
+        if (swow_buffer_pool_get_class_block_size(index) < SWOW_BUFFER_POOL_ADVISE_SIZE) {
+            break;
+        }
+        /* keep the address range, but give the pages back to the OS,
+         * the first page is kept since the list pointer is stored in it */
+        for (string = pool->classes[index].strings; string != NULL; string = *((zend_string **) ZSTR_VAL(string))) {
+            char *start, *end;
+            if (ZSTR_LEN(string) != 0) {
+                continue;
+            }
+            start = (char *) ZEND_MM_ALIGNED_SIZE_EX((uintptr_t) ZSTR_VAL(string) + sizeof(zend_string *), page_size);
+            /* the memory block may not end on a page boundary (e.g. 16K/64K pages),
+             * and madvise() would round the length up into the neighbouring allocations */
+            end = (char *) (((uintptr_t) string + zend_mem_block_size(string)) & ~((uintptr_t) page_size - 1));
+            if (start < end && madvise(start, end - start, MADV_DONTNEED) == 0) {
+                ZSTR_LEN(string) = end - start;
+                pool->advised_bytes += end - start;
+            }
+        }
+    }
+#endif
+}
+
 static char *swow_buffer_alloc_standard(size_t size)
 {
-    zend_string *string = zend_string_alloc(size, 0);
+    zend_string *string = swow_buffer_pool_alloc(size);
 
     ZSTR_VAL(string)[ZSTR_LEN(string) = 0] = '\0';
 
@@ -1000,6 +1250,7 @@ static char *swow_buffer_alloc_standard(size_t size)
 
 static char *swow_buffer_realloc_standard(char *old_value, size_t new_size)
 {
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
     zend_string *old_string = old_value != NULL ? swow_buffer_get_string_from_value(old_value) : NULL;
     zend_string *new_string;
     size_t old_length = old_string != NULL ? ZSTR_LEN(old_string) : 0;
@@ -1022,10 +1273,24 @@ static char *swow_buffer_realloc_standard(char *old_value, size_t new_size)
     }
 
     if (do_erealloc) {
-        new_string = (zend_string *) erealloc(old_string, ZEND_MM_ALIGNED_SIZE(_ZSTR_STRUCT_SIZE(new_size)));
+        size_t block_size = ZEND_MM_ALIGNED_SIZE(_ZSTR_STRUCT_SIZE(new_size));
+        int index;
+        if (swow_buffer_pool_is_available(pool) &&
+            (index = swow_buffer_pool_get_class_index(new_size)) >= 0) {
+            /* it is done in place if the new size is still in the same class,
+             * or there are free pages behind it */
+            block_size = swow_buffer_pool_get_class_block_size(index);
+            new_string = (zend_string *) erealloc(old_string, block_size);
+            pool->reallocs++;
+            if (new_string == old_string) {
+                pool->in_place_reallocs++;
+            }
+        } else {
+            new_string = (zend_string *) erealloc(old_string, block_size);
+        }
         zend_string_forget_hash_val(new_string);
     } else {
-        new_string = zend_string_alloc(new_size, false);
+        new_string = swow_buffer_pool_alloc(new_size);
         memcpy(ZSTR_VAL(new_string), ZSTR_VAL(old_string), new_length);
         if (old_string != NULL && !ZSTR_IS_INTERNED(old_string)) {
             GC_DELREF(old_string);
@@ -1045,8 +1310,8 @@ static void swow_buffer_update_standard(char *value, size_t new_length)
 
 static void swow_buffer_free_standard(char *value)
 {
-    /* Notice: string maybe interned or persistent, so we should use zend_string_release() here */
-    zend_string_release(swow_buffer_get_string_from_value(value));
+    /* Notice: string maybe interned or persistent, it will be released as usual in that case */
+    swow_buffer_pool_release(swow_buffer_get_string_from_value(value));
 }
 
 SWOW_API const cat_buffer_allocator_t swow_buffer_allocator = {
@@ -1066,6 +1331,8 @@ zend_result swow_buffer_module_init(INIT_FUNC_ARGS)
         return FAILURE;
     }
 
+    CAT_GLOBALS_REGISTER(swow_buffer);
+
     swow_buffer_ce = swow_register_internal_class(
         "Swow\\Buffer", NULL, swow_buffer_methods,
         &swow_buffer_handlers, NULL,
@@ -1086,3 +1353,24 @@ zend_result swow_buffer_module_init(INIT_FUNC_ARGS)
 
     return SUCCESS;
 }
+
+zend_result swow_buffer_runtime_init(INIT_FUNC_ARGS)
+{
+    swow_buffer_pool_t *pool = &SWOW_BUFFER_G(pool);
+
+    memset(pool, 0, sizeof(*pool));
+    pool->max_bytes = SWOW_BUFFER_POOL_DEFAULT_MAX_BYTES;
+    pool->enabled = true;
+
+    return SUCCESS;
+}
+
+zend_result swow_buffer_runtime_shutdown(SHUTDOWN_FUNC_ARGS)
+{
+    /* buffers may still be released after runtime shutdown,
+     * they should not be cached in a dead heap */
+    SWOW_BUFFER_G(pool).enabled = false;
+    swow_buffer_pool_shrink(0);
+
+    return SUCCESS;
+}
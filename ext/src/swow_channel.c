@@ -26,11 +26,6 @@ SWOW_API zend_class_entry *swow_selector_ce;
 SWOW_API zend_object_handlers swow_selector_handlers;
 SWOW_API zend_class_entry *swow_selector_exception_ce;
 
-static zend_always_inline bool swow_channel_has_constructed(swow_channel_t *s_channel)
-{
-    return s_channel->channel.dtor == (cat_channel_data_dtor_t) zval_ptr_dtor;
-}
-
 static zend_object *swow_channel_create_object(zend_class_entry *ce)
 {
     swow_channel_t *s_channel = swow_object_alloc(swow_channel_t, ce, swow_channel_handlers);
@@ -169,6 +164,104 @@ static PHP_METHOD(Swow_Channel, pop)
     }
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_pushMany, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Channel, pushMany)
+{
+    SWOW_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    HashTable *data;
+    zend_long timeout = -1;
+    zval *z_data, *z_buffer;
+    uint32_t count, pushed, n = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT(data)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    count = zend_hash_num_elements(data);
+    if (UNEXPECTED(count == 0)) {
+        RETURN_THIS();
+    }
+    z_buffer = safe_emalloc(count, sizeof(*z_buffer), 0);
+    ZEND_HASH_FOREACH_VAL(data, z_data) {
+        ZVAL_COPY_DEREF(&z_buffer[n], z_data);
+        n++;
+    } ZEND_HASH_FOREACH_END();
+
+    pushed = cat_channel_push_many(channel, z_buffer, count, timeout);
+    /* the ones which have been pushed are owned by channel now */
+    for (n = pushed; n < count; n++) {
+        zval_ptr_dtor(&z_buffer[n]);
+    }
+    efree(z_buffer);
+
+    if (UNEXPECTED(pushed != count)) {
+        swow_throw_exception_with_last(swow_channel_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+#define SWOW_CHANNEL_POP_MANY_MIN_BATCH_SIZE 1024
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_popMany, 0, 1, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Channel, popMany)
+{
+    SWOW_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    zend_long count;
+    zend_long timeout = -1;
+    zval *z_buffer;
+    cat_channel_size_t size, popped, n;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_LONG(count)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(count <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    if (channel->capacity == 0) {
+        /* unbuffered, elements are taken from the producers which are waiting */
+        size = SWOW_CHANNEL_POP_MANY_MIN_BATCH_SIZE;
+    } else {
+        /* it can not take more than the capacity at once,
+         * and we do not know how many ones would come if it is empty now */
+        size = CAT_MIN(channel->capacity, CAT_MAX(channel->length, SWOW_CHANNEL_POP_MANY_MIN_BATCH_SIZE));
+    }
+    if ((zend_ulong) count < size) {
+        size = (cat_channel_size_t) count;
+    }
+    z_buffer = safe_emalloc(size, sizeof(*z_buffer), 0);
+
+    popped = cat_channel_pop_many(channel, z_buffer, size, timeout);
+
+    if (UNEXPECTED(popped == 0)) {
+        efree(z_buffer);
+        swow_throw_exception_with_last(swow_channel_exception_ce);
+        RETURN_THROWS();
+    }
+
+    array_init_size(return_value, popped);
+    for (n = 0; n < popped; n++) {
+        zend_hash_next_index_insert_new(Z_ARRVAL_P(return_value), &z_buffer[n]);
+    }
+    efree(z_buffer);
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_close, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
 
@@ -317,6 +410,8 @@ static const zend_function_entry swow_channel_methods[] = {
     PHP_ME(Swow_Channel, __construct,  arginfo_class_Swow_Channel___construct,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, push,         arginfo_class_Swow_Channel_push,         ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, pop,          arginfo_class_Swow_Channel_pop,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Channel, pushMany,     arginfo_class_Swow_Channel_pushMany,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Channel, popMany,      arginfo_class_Swow_Channel_popMany,      ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, close,        arginfo_class_Swow_Channel_close,        ZEND_ACC_PUBLIC)
     /* status */
     PHP_ME(Swow_Channel, getCapacity,  arginfo_class_Swow_Channel_getCapacity,  ZEND_ACC_PUBLIC)
@@ -344,10 +439,11 @@ static HashTable *swow_channel_get_gc(zend_object *object, zval **gc_data, int *
     }
 
     zend_get_gc_buffer *zgc_buffer = zend_get_gc_buffer_create();
+    cat_channel_size_t n;
 
-    CAT_QUEUE_FOREACH_DATA_START(&channel->u.buffered.storage, cat_channel_bucket_t, node, bucket) {
-        zend_get_gc_buffer_add_zval(zgc_buffer, (zval *) bucket->data);
-    } CAT_QUEUE_FOREACH_DATA_END();
+    for (n = 0; n < channel->length; n++) {
+        zend_get_gc_buffer_add_zval(zgc_buffer, (zval *) cat_channel_get_buffered_data(channel, n));
+    }
 
     zend_get_gc_buffer_use(zgc_buffer, gc_data, gc_count);
 
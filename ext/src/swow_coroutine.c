@@ -324,6 +324,100 @@ static zval *swow_coroutine_function(zval *z_data)
     return NULL;
 }
 
+/* VM stack pool */
+
+static zend_always_inline size_t swow_coroutine_vm_stack_get_page_size(zend_vm_stack stack)
+{
+    return ((char *) stack->end) - ((char *) stack);
+}
+
+static swow_coroutine_vm_stack_pool_class_t *swow_coroutine_vm_stack_pool_get_class(size_t size, bool create)
+{
+    swow_coroutine_vm_stack_pool_t *pool = &SWOW_COROUTINE_G(vm_stack_pool);
+    swow_coroutine_vm_stack_pool_class_t *unused = NULL;
+    size_t i;
+
+    for (i = 0; i < SWOW_COROUTINE_VM_STACK_POOL_CLASS_COUNT; i++) {
+        swow_coroutine_vm_stack_pool_class_t *stack_class = &pool->classes[i];
+        if (stack_class->size == size) {
+            return stack_class;
+        }
+        /* prefer the one which has never been used */
+        if (stack_class->count == 0 && (unused == NULL || stack_class->size == 0)) {
+            unused = stack_class;
+        }
+    }
+    if (create && unused != NULL) {
+        unused->size = size;
+        return unused;
+    }
+
+    return NULL;
+}
+
+static zend_vm_stack swow_coroutine_vm_stack_alloc(size_t size)
+{
+    swow_coroutine_vm_stack_pool_t *pool = &SWOW_COROUTINE_G(vm_stack_pool);
+    swow_coroutine_vm_stack_pool_class_t *stack_class;
+    zend_vm_stack stack;
+
+    /* only page sizes of coroutine construction have their classes,
+     * pages grown by the VM in other sizes are not cached */
+    stack_class = swow_coroutine_vm_stack_pool_get_class(size, true);
+    if (stack_class == NULL || stack_class->count == 0) {
+        pool->misses++;
+        return (zend_vm_stack) emalloc(size);
+    }
+    stack = stack_class->pages;
+    stack_class->pages = stack->prev;
+    stack_class->count--;
+    pool->count--;
+    pool->bytes -= size;
+    pool->hits++;
+
+    return stack;
+}
+
+/* pages grown by the VM (zend_vm_stack_extend()) are recycled too if they are in the same size */
+static void swow_coroutine_vm_stack_free(zend_vm_stack stack)
+{
+    swow_coroutine_vm_stack_pool_t *pool = &SWOW_COROUTINE_G(vm_stack_pool);
+    swow_coroutine_vm_stack_pool_class_t *stack_class;
+    size_t size = swow_coroutine_vm_stack_get_page_size(stack);
+
+    if (SWOW_COROUTINE_G(runtime_state) != SWOW_COROUTINE_RUNTIME_STATE_RUNNING ||
+        pool->count >= cat_coroutine_get_stack_pool_max_count() ||
+        /* pages on the heap can not be released partially, so it is a hard limit here */
+        pool->bytes + size > cat_coroutine_get_stack_pool_high_water_mark() ||
+        (stack_class = swow_coroutine_vm_stack_pool_get_class(size, false)) == NULL) {
+        efree(stack);
+        return;
+    }
+    stack->prev = stack_class->pages;
+    stack_class->pages = stack;
+    stack_class->count++;
+    pool->count++;
+    pool->bytes += size;
+}
+
+static void swow_coroutine_vm_stack_pool_shrink(size_t count, size_t bytes)
+{
+    swow_coroutine_vm_stack_pool_t *pool = &SWOW_COROUTINE_G(vm_stack_pool);
+    size_t i;
+
+    for (i = 0; i < SWOW_COROUTINE_VM_STACK_POOL_CLASS_COUNT && (pool->count > count || pool->bytes > bytes); i++) {
+        swow_coroutine_vm_stack_pool_class_t *stack_class = &pool->classes[i];
+        while (stack_class->count > 0 && (pool->count > count || pool->bytes > bytes)) {
+            zend_vm_stack stack = stack_class->pages;
+            stack_class->pages = stack->prev;
+            stack_class->count--;
+            pool->count--;
+            pool->bytes -= stack_class->size;
+            efree(stack);
+        }
+    }
+}
+
 static cat_bool_t swow_coroutine_construct(swow_coroutine_t *s_coroutine, zval *z_callable, size_t stack_page_size, size_t c_stack_size)
 {
     swow_coroutine_executor_t *executor;
@@ -354,8 +448,8 @@ static cat_bool_t swow_coroutine_construct(swow_coroutine_t *s_coroutine, zval *
         coroutine->flags |= SWOW_COROUTINE_FLAG_HAS_EXECUTOR | SWOW_COROUTINE_FLAG_ACCEPT_ZVAL_DATA;
         /* align stack page size */
         stack_page_size = swow_coroutine_align_stack_page_size(stack_page_size);
-        /* alloc vm stack memory */
-        vm_stack = (zend_vm_stack) emalloc(stack_page_size);
+        /* alloc vm stack memory (it grows on demand by the VM) */
+        vm_stack = swow_coroutine_vm_stack_alloc(stack_page_size);
         /* assign the end to executor */
         executor = (swow_coroutine_executor_t *) ZEND_VM_STACK_ELEMENTS(vm_stack);
         /* init executor */
@@ -441,7 +535,7 @@ static void swow_coroutine_shutdown(swow_coroutine_t *s_coroutine)
         zend_vm_stack stack = executor->vm_stack;
         do {
             zend_vm_stack prev = stack->prev;
-            efree(stack);
+            swow_coroutine_vm_stack_free(stack);
             stack = prev;
         } while (stack);
     } else {
@@ -958,6 +1052,30 @@ SWOW_API void* swow_coroutine_get_stack_limit(const swow_coroutine_t *s_coroutin
 }
 #endif
 
+SWOW_API size_t swow_coroutine_get_stack_resident_size(const swow_coroutine_t *s_coroutine)
+{
+    const swow_coroutine_executor_t *executor = s_coroutine->executor;
+    zend_vm_stack stack;
+    size_t size;
+
+    if (!cat_coroutine_is_available(&s_coroutine->coroutine)) {
+        return 0;
+    }
+    /* only touched pages of C stack are resident (main coroutine runs on the system stack) */
+    size = cat_coroutine_get_stack_resident_size(&s_coroutine->coroutine);
+    /* VM stack pages are allocated on demand */
+    if (s_coroutine == swow_coroutine_get_current()) {
+        stack = EG(vm_stack);
+    } else {
+        stack = executor != NULL ? executor->vm_stack : NULL;
+    }
+    for (; stack != NULL; stack = stack->prev) {
+        size += swow_coroutine_vm_stack_get_page_size(stack);
+    }
+
+    return size;
+}
+
 /* globals (options) */
 
 SWOW_API size_t swow_coroutine_set_default_stack_page_size(size_t size)
@@ -2156,6 +2274,97 @@ static PHP_METHOD(Swow_Coroutine, getAll)
     RETURN_ARR(zend_array_dup(map));
 }
 
+#define arginfo_class_Swow_Coroutine_getStackPoolStats arginfo_class_Swow_Coroutine_getAll
+
+static PHP_METHOD(Swow_Coroutine, getStackPoolStats)
+{
+    cat_coroutine_stack_pool_stats_t stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_coroutine_get_stack_pool_stats(&stats);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "hits", (zend_long) stats.hits);
+    add_assoc_long(return_value, "misses", (zend_long) stats.misses);
+    add_assoc_long(return_value, "trims", (zend_long) stats.trims);
+    add_assoc_long(return_value, "count", (zend_long) stats.count);
+    add_assoc_long(return_value, "bytes", (zend_long) stats.bytes);
+    add_assoc_long(return_value, "resident_bytes", (zend_long) stats.resident_bytes);
+    add_assoc_long(return_value, "vm_hits", (zend_long) SWOW_COROUTINE_G(vm_stack_pool).hits);
+    add_assoc_long(return_value, "vm_misses", (zend_long) SWOW_COROUTINE_G(vm_stack_pool).misses);
+    add_assoc_long(return_value, "vm_count", (zend_long) SWOW_COROUTINE_G(vm_stack_pool).count);
+    add_assoc_long(return_value, "vm_bytes", (zend_long) SWOW_COROUTINE_G(vm_stack_pool).bytes);
+    add_assoc_long(return_value, "max_count", (zend_long) cat_coroutine_get_stack_pool_max_count());
+    add_assoc_long(return_value, "high_water_mark", (zend_long) cat_coroutine_get_stack_pool_high_water_mark());
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Coroutine_setStackPoolMaxCount, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, count, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Coroutine, setStackPoolMaxCount)
+{
+    zend_long count;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(count)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(count < 0)) {
+        zend_argument_value_error(1, "can not be negative");
+        RETURN_THROWS();
+    }
+
+    cat_coroutine_set_stack_pool_max_count((size_t) count);
+    swow_coroutine_vm_stack_pool_shrink((size_t) count, SIZE_MAX);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Coroutine_setStackPoolHighWaterMark, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, size, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Coroutine, setStackPoolHighWaterMark)
+{
+    zend_long size;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(size)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(size < 0)) {
+        zend_argument_value_error(1, "can not be negative");
+        RETURN_THROWS();
+    }
+
+    cat_coroutine_set_stack_pool_high_water_mark((size_t) size);
+    swow_coroutine_vm_stack_pool_shrink(SIZE_MAX, (size_t) size);
+}
+
+#define arginfo_class_Swow_Coroutine_getStackResidentSize arginfo_class_Swow_Coroutine_getId
+
+static PHP_METHOD(Swow_Coroutine, getStackResidentSize)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG((zend_long) swow_coroutine_get_stack_resident_size(getThisCoroutine()));
+}
+
+#define arginfo_class_Swow_Coroutine_getTotalStackResidentSize arginfo_class_Swow_Coroutine_getId
+
+static PHP_METHOD(Swow_Coroutine, getTotalStackResidentSize)
+{
+    size_t size = 0;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    ZEND_HASH_FOREACH_VAL(SWOW_COROUTINE_G(map), zval *z_coroutine) {
+        size += swow_coroutine_get_stack_resident_size(swow_coroutine_get_from_object(Z_OBJ_P(z_coroutine)));
+    } ZEND_HASH_FOREACH_END();
+
+    RETURN_LONG((zend_long) size);
+}
+
 #define arginfo_class_Swow_Coroutine___debugInfo arginfo_class_Swow_Coroutine_getAll
 
 static PHP_METHOD(Swow_Coroutine, __debugInfo)
@@ -2259,6 +2468,11 @@ static const zend_function_entry swow_coroutine_methods[] = {
     PHP_ME(Swow_Coroutine, count,                   arginfo_class_Swow_Coroutine_count,                   ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Coroutine, get,                     arginfo_class_Swow_Coroutine_get,                     ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Coroutine, getAll,                  arginfo_class_Swow_Coroutine_getAll,                  ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Coroutine, getStackPoolStats,       arginfo_class_Swow_Coroutine_getStackPoolStats,       ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Coroutine, setStackPoolMaxCount,    arginfo_class_Swow_Coroutine_setStackPoolMaxCount,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Coroutine, setStackPoolHighWaterMark, arginfo_class_Swow_Coroutine_setStackPoolHighWaterMark, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Coroutine, getStackResidentSize,    arginfo_class_Swow_Coroutine_getStackResidentSize,    ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Coroutine, getTotalStackResidentSize, arginfo_class_Swow_Coroutine_getTotalStackResidentSize, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     /* magic */
     PHP_ME(Swow_Coroutine, __debugInfo,             arginfo_class_Swow_Coroutine___debugInfo,             ZEND_ACC_PUBLIC)
     /* debug */
@@ -2736,6 +2950,8 @@ zend_result swow_coroutine_runtime_init(INIT_FUNC_ARGS)
 
     SWOW_COROUTINE_G(in_autoload) = NULL;
 
+    memset(&SWOW_COROUTINE_G(vm_stack_pool), 0, sizeof(SWOW_COROUTINE_G(vm_stack_pool)));
+
     /* create s_coroutine map */
     do {
         zval z_tmp;
@@ -2772,6 +2988,9 @@ zend_result swow_coroutine_runtime_shutdown(SHUTDOWN_FUNC_ARGS)
     zend_array_release_gc(SWOW_COROUTINE_G(map));
     SWOW_COROUTINE_G(map) = NULL;
 
+    /* drain VM stack pool */
+    swow_coroutine_vm_stack_pool_shrink(0, 0);
+
     /* recover resume */
     cat_coroutine_register_jump(
         SWOW_COROUTINE_G(original_jump)
@@ -19,6 +19,7 @@
 #include "swow_debug.h"
 
 #include "swow_coroutine.h"
+#include "swow_event.h"
 
 #include "zend_generators.h"
 
@@ -486,10 +487,46 @@ static PHP_FUNCTION(Swow_Debug_registerExtendedStatementHandler)
     RETURN_OBJ_COPY(&handler->std);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_Swow_Debug_getSlabStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_FUNCTION(Swow_Debug_getSlabStats)
+{
+    cat_slab_stats_t stats;
+    zval z_classes;
+    size_t i;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_event_get_slab_stats(&stats);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "page_count", (zend_long) stats.page_count);
+    add_assoc_long(return_value, "page_bytes", (zend_long) stats.page_bytes);
+    add_assoc_long(return_value, "used_bytes", (zend_long) stats.used_bytes);
+    add_assoc_long(return_value, "large_count", (zend_long) stats.large_count);
+    array_init(&z_classes);
+    for (i = 0; i < CAT_ARRAY_SIZE(stats.classes); i++) {
+        const cat_slab_class_stats_t *class_stats = &stats.classes[i];
+        zval z_class;
+        if (class_stats->page_count == 0) {
+            continue;
+        }
+        array_init(&z_class);
+        add_assoc_long(&z_class, "count", (zend_long) class_stats->count);
+        add_assoc_long(&z_class, "free_count", (zend_long) class_stats->free_count);
+        add_assoc_long(&z_class, "page_count", (zend_long) class_stats->page_count);
+        add_index_zval(&z_classes, (zend_ulong) class_stats->size, &z_class);
+    }
+    add_assoc_zval(return_value, "classes", &z_classes);
+}
+
 static const zend_function_entry swow_debug_functions[] = {
     PHP_FENTRY(Swow\\Debug\\buildTraceAsString, PHP_FN(Swow_Debug_buildTraceAsString), arginfo_Swow_Debug_buildTraceAsString, 0)
     /* for breakpoint debugging  */
     PHP_FENTRY(Swow\\Debug\\registerExtendedStatementHandler, PHP_FN(Swow_Debug_registerExtendedStatementHandler), arginfo_Swow_Debug_registerExtendedStatementHandler, 0)
+    /* memory of the event loop slab */
+    PHP_FENTRY(Swow\\Debug\\getSlabStats, PHP_FN(Swow_Debug_getSlabStats), arginfo_Swow_Debug_getSlabStats, 0)
     PHP_FE_END
 };
 
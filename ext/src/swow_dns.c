@@ -90,6 +90,99 @@ static const zend_function_entry swow_dns_functions[] = {
     PHP_FE_END
 };
 
+SWOW_API zend_class_entry *swow_dns_ce;
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Dns_getCacheStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Dns, getCacheStats)
+{
+    cat_dns_cache_stats_t stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_dns_cache_get_stats(&stats);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "hits", (zend_long) stats.hits);
+    add_assoc_long(return_value, "negative_hits", (zend_long) stats.negative_hits);
+    add_assoc_long(return_value, "misses", (zend_long) stats.misses);
+    add_assoc_long(return_value, "coalesced", (zend_long) stats.coalesced);
+    add_assoc_long(return_value, "evictions", (zend_long) stats.evictions);
+    add_assoc_long(return_value, "size", (zend_long) stats.size);
+    add_assoc_long(return_value, "capacity", (zend_long) stats.capacity);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Dns_clearCache, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Dns, clearCache)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_dns_cache_clear();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Dns_getCacheCapacity, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Dns_setCacheCapacity, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, capacity, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+#define arginfo_class_Swow_Dns_getCacheTtl arginfo_class_Swow_Dns_getCacheCapacity
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Dns_setCacheTtl, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, ttl, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+#define arginfo_class_Swow_Dns_getCacheNegativeTtl arginfo_class_Swow_Dns_getCacheCapacity
+
+#define arginfo_class_Swow_Dns_setCacheNegativeTtl arginfo_class_Swow_Dns_setCacheTtl
+
+#define SWOW_DNS_CACHE_OPTION_API_GEN(Name, name, type) \
+\
+static PHP_METHOD(Swow_Dns, getCache##Name) \
+{ \
+    ZEND_PARSE_PARAMETERS_NONE(); \
+    \
+    RETURN_LONG((zend_long) cat_dns_cache_get_##name()); \
+} \
+\
+static PHP_METHOD(Swow_Dns, setCache##Name) \
+{ \
+    zend_long value; \
+    \
+    ZEND_PARSE_PARAMETERS_START(1, 1) \
+        Z_PARAM_LONG(value) \
+    ZEND_PARSE_PARAMETERS_END(); \
+    \
+    if (UNEXPECTED(value < 0)) { \
+        zend_argument_value_error(1, "can not be negative"); \
+        RETURN_THROWS(); \
+    } \
+    \
+    cat_dns_cache_set_##name((type) value); \
+}
+
+SWOW_DNS_CACHE_OPTION_API_GEN(Capacity,        capacity,     size_t);
+SWOW_DNS_CACHE_OPTION_API_GEN(Ttl,             ttl,      cat_msec_t);
+SWOW_DNS_CACHE_OPTION_API_GEN(NegativeTtl, negative_ttl, cat_msec_t);
+
+#undef SWOW_DNS_CACHE_OPTION_API_GEN
+
+static const zend_function_entry swow_dns_methods[] = {
+    PHP_ME(Swow_Dns, getCacheStats,       arginfo_class_Swow_Dns_getCacheStats,       ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, clearCache,          arginfo_class_Swow_Dns_clearCache,          ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, getCacheCapacity,    arginfo_class_Swow_Dns_getCacheCapacity,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, setCacheCapacity,    arginfo_class_Swow_Dns_setCacheCapacity,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, getCacheTtl,         arginfo_class_Swow_Dns_getCacheTtl,         ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, setCacheTtl,         arginfo_class_Swow_Dns_setCacheTtl,         ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, getCacheNegativeTtl, arginfo_class_Swow_Dns_getCacheNegativeTtl, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Dns, setCacheNegativeTtl, arginfo_class_Swow_Dns_setCacheNegativeTtl, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+
 static bool has_sockets_extension = false;
 static bool af_constants_checked = false;
 
@@ -108,6 +201,12 @@ zend_result swow_dns_module_init(INIT_FUNC_ARGS)
         return FAILURE;
     }
 
+    swow_dns_ce = swow_register_internal_class(
+        "Swow\\Dns", NULL, swow_dns_methods,
+        NULL, NULL, cat_false, cat_false,
+        swow_create_object_deny, NULL, 0
+    );
+
     REGISTER_LONG_CONSTANT("AF_UNSPEC", AF_UNSPEC, CONST_PERSISTENT);
     if (!zend_hash_str_find_ptr(&module_registry, ZEND_STRL("sockets"))) {
         REGISTER_LONG_CONSTANT("AF_INET", AF_INET, CONST_PERSISTENT);
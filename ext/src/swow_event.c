@@ -21,6 +21,9 @@
 #include "swow_defer.h"
 #include "swow_coroutine.h"
 
+#include "cat_fs.h" /* for fs_fork() */
+#include "cat_poll.h" /* for poll_fork() */
+
 static cat_bool_t swow_event_scheduler_run(void)
 {
     swow_coroutine_t *s_coroutine;
@@ -77,6 +80,9 @@ static PHP_FUNCTION(swow_pcntl_fork)
         /* Fork event loop in child process
          * TODO: kill all coroutines?  */
         cat_event_fork();
+        cat_fs_fork();
+        cat_poll_fork();
+        cat_log_async_fork();
     }
 }
 
@@ -31,6 +31,7 @@
  */
 
 #include "swow.h"
+#include "swow_stream.h"
 #include "cat_fs.h"
 #include "cat_work.h"
 #include "cat_time.h"
@@ -899,7 +900,7 @@ static int swow_do_open_temporary_file(const char *path, const char *pfx, zend_s
     return fd;
 }
 
-static int swow_open_temporary_fd(const char *dir, const char *pfx, zend_string **opened_path_p)
+SWOW_API int swow_open_temporary_fd(const char *dir, const char *pfx, zend_string **opened_path_p)
 {
     int fd;
     const char *temp_dir;
@@ -19,6 +19,8 @@
 #include "swow_http.h"
 
 #include "swow_buffer.h"
+#include "swow_socket.h"
+#include "swow_stream.h"
 
 #include "swow_errno.h" /* for errno register */
 
@@ -54,16 +56,87 @@ static const zend_function_entry swow_http_status_methods[] = {
 
 /* Parser */
 
+static void swow_http_parser_multipart_init(swow_http_parser_multipart_t *multipart)
+{
+    memset(multipart, 0, sizeof(*multipart));
+    ZVAL_UNDEF(&multipart->headers);
+    multipart->file = -1;
+}
+
 static zend_object *swow_http_parser_create_object(zend_class_entry *ce)
 {
     swow_http_parser_t *s_parser = swow_object_alloc(swow_http_parser_t, ce, swow_http_parser_handlers);
 
     cat_http_parser_init(&s_parser->parser);
     s_parser->data_offset = 0;
+    memset(&s_parser->head, 0, sizeof(s_parser->head));
+    swow_http_parser_multipart_init(&s_parser->multipart);
 
     return &s_parser->std;
 }
 
+static void swow_http_parser_head_clear(swow_http_parser_head_t *head)
+{
+    uint32_t n;
+
+    for (n = 0; n < head->count; n++) {
+        if (head->headers[n].name != NULL) {
+            zend_string_release(head->headers[n].name);
+        }
+    }
+    head->count = 0;
+    head->line_offset = 0;
+    head->line_length = 0;
+    head->last_event = CAT_HTTP_PARSER_EVENT_NONE;
+    head->completed = false;
+}
+
+/* the spooled file is removed if the part has not been fetched */
+static void swow_http_parser_multipart_clear(swow_http_parser_multipart_t *multipart)
+{
+    zval_ptr_dtor(&multipart->headers);
+    ZVAL_UNDEF(&multipart->headers);
+    smart_str_free(&multipart->header_name);
+    smart_str_free(&multipart->header_value);
+    smart_str_free(&multipart->data);
+    /* it may be called on object free, do not yield here */
+    if (multipart->file != -1) {
+        (void) close(multipart->file);
+        multipart->file = -1;
+    }
+    if (multipart->file_path != NULL) {
+        (void) VCWD_UNLINK(ZSTR_VAL(multipart->file_path));
+        zend_string_release(multipart->file_path);
+        multipart->file_path = NULL;
+    }
+    multipart->last_event = CAT_HTTP_PARSER_EVENT_NONE;
+    multipart->is_file = false;
+    multipart->completed = false;
+    multipart->size = 0;
+    multipart->error = 0;
+}
+
+static void swow_http_parser_free_object(zend_object *object)
+{
+    swow_http_parser_t *s_parser = swow_http_parser_get_from_object(object);
+    swow_http_parser_head_t *head = &s_parser->head;
+
+    swow_http_parser_multipart_clear(&s_parser->multipart);
+    if (s_parser->multipart.spool_directory != NULL) {
+        zend_string_release(s_parser->multipart.spool_directory);
+    }
+    swow_http_parser_head_clear(head);
+    if (head->headers != NULL) {
+        efree(head->headers);
+    }
+    if (head->names != NULL) {
+        zend_hash_destroy(head->names);
+        FREE_HASHTABLE(head->names);
+    }
+
+    zend_object_std_dtor(&s_parser->std);
+}
+
 #define getThisParser() (swow_http_parser_get_from_object(Z_OBJ_P(ZEND_THIS)))
 
 #define SWOW_HTTP_PARSER_GETTER(_sparser, _parser) \
@@ -437,6 +510,598 @@ static PHP_METHOD(Swow_Http_Parser, reset)
 
     cat_http_parser_reset(parser);
     s_parser->data_offset = 0;
+    swow_http_parser_head_clear(&s_parser->head);
+    swow_http_parser_multipart_clear(&s_parser->multipart);
+
+    RETURN_THIS();
+}
+
+/* head */
+
+#define SWOW_HTTP_PARSER_HEAD_EVENTS ( \
+    CAT_HTTP_PARSER_EVENT_URL | \
+    CAT_HTTP_PARSER_EVENT_STATUS | \
+    CAT_HTTP_PARSER_EVENT_HEADER_FIELD | \
+    CAT_HTTP_PARSER_EVENT_HEADER_VALUE | \
+    CAT_HTTP_PARSER_EVENT_HEADERS_COMPLETE \
+)
+
+#ifndef SWOW_HTTP_PARSER_HEADER_NAME_CACHE_SIZE
+#define SWOW_HTTP_PARSER_HEADER_NAME_CACHE_SIZE 64
+#endif
+
+/* it is the same as zend_string_hash_val(zend_string_tolower(name)) */
+static zend_always_inline zend_ulong swow_http_parser_hash_lowercase_name(const char *name, size_t length)
+{
+    zend_ulong hash = Z_UL(5381);
+
+    for (; length > 0; length--) {
+        hash = ((hash << 5) + hash) + (zend_uchar) zend_tolower_ascii(*name++);
+    }
+
+#if SIZEOF_ZEND_LONG == 8
+    return hash | Z_UL(0x8000000000000000);
+#else
+    return hash | Z_UL(0x80000000);
+#endif
+}
+
+static zend_string *swow_http_parser_head_get_lowercase_name(swow_http_parser_head_t *head, const char *name, size_t length)
+{
+    zend_ulong hash = swow_http_parser_hash_lowercase_name(name, length);
+    zend_string *lowercase_name;
+    zval *z_name;
+
+    if (UNEXPECTED(head->names == NULL)) {
+        ALLOC_HASHTABLE(head->names);
+        zend_hash_init(head->names, 8, NULL, ZVAL_PTR_DTOR, 0);
+    }
+    z_name = zend_hash_index_find(head->names, hash);
+    if (z_name != NULL) {
+        lowercase_name = Z_STR_P(z_name);
+        if (EXPECTED(zend_binary_strcasecmp(ZSTR_VAL(lowercase_name), ZSTR_LEN(lowercase_name), name, length) == 0)) {
+            return zend_string_copy(lowercase_name);
+        }
+    }
+    lowercase_name = zend_string_alloc(length, false);
+    zend_str_tolower_copy(ZSTR_VAL(lowercase_name), name, length);
+    ZSTR_H(lowercase_name) = hash;
+    if (z_name == NULL && zend_hash_num_elements(head->names) < SWOW_HTTP_PARSER_HEADER_NAME_CACHE_SIZE) {
+        zval z_new_name;
+        ZVAL_STR_COPY(&z_new_name, lowercase_name);
+        zend_hash_index_add_new(head->names, hash, &z_new_name);
+    }
+
+    return lowercase_name;
+}
+
+static zend_always_inline void swow_http_parser_head_complete_name(swow_http_parser_head_t *head, const char *base)
+{
+    swow_http_parser_header_t *header;
+
+    if (head->count == 0) {
+        return;
+    }
+    header = &head->headers[head->count - 1];
+    if (header->name == NULL) {
+        header->name = swow_http_parser_head_get_lowercase_name(head, base + header->name_offset, header->name_length);
+    }
+}
+
+static bool swow_http_parser_head_handle_event(swow_http_parser_head_t *head, const cat_http_parser_t *parser, const char *base)
+{
+    cat_http_parser_event_t event = parser->event;
+    uint32_t offset = (uint32_t) (parser->data - base);
+    uint32_t length = (uint32_t) parser->data_length;
+    bool continued = event == head->last_event;
+    uint32_t *span_offset, *span_length;
+    swow_http_parser_header_t *header;
+
+    switch (event) {
+        case CAT_HTTP_PARSER_EVENT_URL:
+        case CAT_HTTP_PARSER_EVENT_STATUS:
+            span_offset = &head->line_offset;
+            span_length = &head->line_length;
+            break;
+        case CAT_HTTP_PARSER_EVENT_HEADER_FIELD:
+            if (!continued) {
+                swow_http_parser_head_complete_name(head, base);
+                if (UNEXPECTED(head->count == head->size)) {
+                    head->size = head->size == 0 ? 16 : head->size * 2;
+                    head->headers = safe_erealloc(head->headers, head->size, sizeof(*head->headers), 0);
+                }
+                header = &head->headers[head->count++];
+                header->value_offset = offset;
+                header->value_length = 0;
+                header->name = NULL;
+            }
+            header = &head->headers[head->count - 1];
+            span_offset = &header->name_offset;
+            span_length = &header->name_length;
+            break;
+        case CAT_HTTP_PARSER_EVENT_HEADER_VALUE:
+            if (!continued) {
+                swow_http_parser_head_complete_name(head, base);
+            }
+            header = &head->headers[head->count - 1];
+            span_offset = &header->value_offset;
+            span_length = &header->value_length;
+            break;
+        default:
+            return true;
+    }
+    if (!continued) {
+        *span_offset = offset;
+        *span_length = length;
+    } else if (EXPECTED(*span_offset + *span_length == offset)) {
+        *span_length += length;
+    } else {
+        swow_throw_exception(swow_http_parser_exception_ce, CAT_EMISUSE, "Head data should not be moved before the head is completed");
+        return false;
+    }
+    head->last_event = event;
+
+    return true;
+}
+
+#define arginfo_class_Swow_Http_Parser_executeHead arginfo_class_Swow_Http_Parser_execute
+
+static PHP_METHOD(Swow_Http_Parser, executeHead)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_head_t *head = &s_parser->head;
+    cat_http_parser_events_t events;
+    zend_string *string;
+    zend_long start = 0;
+    zend_long length = -1;
+    const char *ptr;
+    size_t parsed_length = 0;
+    bool ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        SWOW_PARAM_STRINGABLE_EXPECT_BUFFER_FOR_READING(string)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* check args and initialize */
+    ptr = swow_string_get_readable_space(string, start, &length, 1);
+
+    if (UNEXPECTED(ptr == NULL)) {
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(ZSTR_LEN(string) > UINT32_MAX)) {
+        zend_argument_value_error(1, "is too long");
+        RETURN_THROWS();
+    }
+
+    if (head->completed) {
+        swow_http_parser_head_clear(head);
+    }
+
+    /* run parser over the data until the head is completed or more data is needed,
+     * events which are not related to head will stop it as well */
+    events = cat_http_parser_get_events(parser);
+    cat_http_parser_set_events(parser, events | SWOW_HTTP_PARSER_HEAD_EVENTS);
+    while (true) {
+        ret = cat_http_parser_execute(parser, ptr + parsed_length, length - parsed_length);
+        if (UNEXPECTED(!ret)) {
+            break;
+        }
+        parsed_length += parser->parsed_length;
+        if (parser->event & CAT_HTTP_PARSER_EVENT_FLAG_DATA) {
+            ret = swow_http_parser_head_handle_event(head, parser, ZSTR_VAL(string));
+            if (UNEXPECTED(!ret)) {
+                break;
+            }
+        } else if (parser->event != CAT_HTTP_PARSER_EVENT_MESSAGE_BEGIN) {
+            break;
+        }
+    }
+    cat_http_parser_set_events(parser, events);
+
+    if (UNEXPECTED(!ret)) {
+        if (!EG(exception)) {
+            swow_throw_exception_with_last(swow_http_parser_exception_ce);
+        }
+        RETURN_THROWS();
+    }
+
+    if (parser->event == CAT_HTTP_PARSER_EVENT_HEADERS_COMPLETE) {
+        swow_http_parser_head_complete_name(head, ZSTR_VAL(string));
+        head->completed = true;
+    }
+    s_parser->data_offset = 0;
+
+    RETURN_LONG(parsed_length);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_getHeaderIndex, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, getHeaderIndex)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_head_t *head = &s_parser->head;
+    swow_http_parser_header_t *header;
+    zval *z_spans, z_new_spans;
+    uint32_t n;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+    (void) parser;
+
+    array_init_size(return_value, head->count);
+    for (n = 0, header = head->headers; n < head->count; n++, header++) {
+        if (UNEXPECTED(header->name == NULL)) {
+            /* incomplete one */
+            continue;
+        }
+        z_spans = zend_hash_find_known_hash(Z_ARRVAL_P(return_value), header->name);
+        if (z_spans == NULL) {
+            array_init_size(&z_new_spans, 4);
+            z_spans = zend_hash_add_new(Z_ARRVAL_P(return_value), header->name, &z_new_spans);
+        }
+        add_next_index_long(z_spans, header->name_offset);
+        add_next_index_long(z_spans, header->name_length);
+        add_next_index_long(z_spans, header->value_offset);
+        add_next_index_long(z_spans, header->value_length);
+    }
+}
+
+#define arginfo_class_Swow_Http_Parser_getUriOrReasonPhraseIndex arginfo_class_Swow_Http_Parser_getHeaderIndex
+
+static PHP_METHOD(Swow_Http_Parser, getUriOrReasonPhraseIndex)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_head_t *head = &s_parser->head;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+    (void) parser;
+
+    array_init_size(return_value, 2);
+    add_next_index_long(return_value, head->line_offset);
+    add_next_index_long(return_value, head->line_length);
+}
+
+/* multipart */
+
+#define SWOW_HTTP_PARSER_MULTIPART_EVENTS ( \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_DATA_BEGIN | \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_HEADER_FIELD | \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_HEADER_VALUE | \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_HEADERS_COMPLETE | \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_BODY | \
+    CAT_HTTP_PARSER_EVENT_MULTIPART_DATA_END \
+)
+
+/* the same as UPLOAD_ERR_* */
+#define SWOW_HTTP_UPLOAD_ERR_OK         0
+#define SWOW_HTTP_UPLOAD_ERR_NO_TMP_DIR 6
+#define SWOW_HTTP_UPLOAD_ERR_CANT_WRITE 7
+
+static void swow_http_parser_multipart_add_header(swow_http_parser_multipart_t *multipart)
+{
+    zend_string *name;
+    zval z_value;
+
+    if (multipart->header_name.s == NULL) {
+        return;
+    }
+    name = smart_str_extract(&multipart->header_name);
+    zend_str_tolower(ZSTR_VAL(name), ZSTR_LEN(name));
+    ZVAL_STR(&z_value, smart_str_extract(&multipart->header_value));
+    zend_symtable_update(Z_ARRVAL(multipart->headers), name, &z_value);
+    zend_string_release(name);
+}
+
+/* it is a file part if Content-Disposition has a non-empty filename or filename* (RFC 5987) parameter,
+ * keep it in line with the Content-Disposition parsing of Swow\Http\Protocol\ReceiverTrait */
+static bool swow_http_parser_multipart_is_file(swow_http_parser_multipart_t *multipart)
+{
+    zval *z_content_disposition;
+    const char *p, *end;
+
+    z_content_disposition = zend_hash_str_find(Z_ARRVAL(multipart->headers), ZEND_STRL("content-disposition"));
+    if (z_content_disposition == NULL) {
+        return false;
+    }
+    p = Z_STRVAL_P(z_content_disposition);
+    end = p + Z_STRLEN_P(z_content_disposition);
+    while ((p = memchr(p, ';', end - p)) != NULL) {
+        bool extended = false;
+        p++;
+        while (p < end && *p == ' ') {
+            p++;
+        }
+        if ((size_t) (end - p) < CAT_STRLEN("filename") || strncasecmp(p, "filename", CAT_STRLEN("filename")) != 0) {
+            continue;
+        }
+        p += CAT_STRLEN("filename");
+        if (p < end && *p == '*') {
+            extended = true;
+            p++;
+        }
+        while (p < end && *p == ' ') {
+            p++;
+        }
+        if (p == end || *p != '=') {
+            continue;
+        }
+        p++;
+        while (p < end && (*p == ' ' || *p == '"')) {
+            p++;
+        }
+        if (extended) {
+            /* charset'language'value-chars */
+            const char *value_end = memchr(p, ';', end - p);
+            const char *quote;
+            if (value_end == NULL) {
+                value_end = end;
+            }
+            quote = memchr(p, '\'', value_end - p);
+            if (quote == NULL || (quote = memchr(quote + 1, '\'', value_end - (quote + 1))) == NULL) {
+                continue;
+            }
+            p = quote + 1;
+        }
+        if (p < end && *p != ';' && *p != '"') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool swow_http_parser_multipart_write_file(swow_http_parser_multipart_t *multipart, const char *data, size_t length)
+{
+    while (length > 0) {
+        ssize_t n = cat_fs_write(multipart->file, data, length);
+        if (UNEXPECTED(n <= 0)) {
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+
+    return true;
+}
+
+static void swow_http_parser_multipart_write(swow_http_parser_multipart_t *multipart, const char *data, size_t length)
+{
+    multipart->size += length;
+    if (!multipart->is_file) {
+        smart_str_appendl(&multipart->data, data, length);
+        return;
+    }
+    if (UNEXPECTED(multipart->error != SWOW_HTTP_UPLOAD_ERR_OK)) {
+        /* discard the rest */
+        return;
+    }
+    if (multipart->file_path == NULL) {
+        if (multipart->size <= multipart->memory_threshold) {
+            smart_str_appendl(&multipart->data, data, length);
+            return;
+        }
+        multipart->file = swow_open_temporary_fd(
+            multipart->spool_directory != NULL ? ZSTR_VAL(multipart->spool_directory) : NULL,
+            "swow_uploaded_file_", &multipart->file_path
+        );
+        if (UNEXPECTED(multipart->file < 0)) {
+            multipart->file = -1;
+            multipart->error = SWOW_HTTP_UPLOAD_ERR_NO_TMP_DIR;
+            smart_str_free(&multipart->data);
+            return;
+        }
+        if (multipart->data.s != NULL) {
+            bool ret = swow_http_parser_multipart_write_file(multipart, ZSTR_VAL(multipart->data.s), ZSTR_LEN(multipart->data.s));
+            smart_str_free(&multipart->data);
+            if (UNEXPECTED(!ret)) {
+                multipart->error = SWOW_HTTP_UPLOAD_ERR_CANT_WRITE;
+                return;
+            }
+        }
+    }
+    if (UNEXPECTED(!swow_http_parser_multipart_write_file(multipart, data, length))) {
+        multipart->error = SWOW_HTTP_UPLOAD_ERR_CANT_WRITE;
+    }
+}
+
+static void swow_http_parser_multipart_handle_event(swow_http_parser_multipart_t *multipart, const cat_http_parser_t *parser)
+{
+    cat_http_parser_event_t event = parser->event;
+    bool continued = event == multipart->last_event;
+
+    switch (event) {
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_DATA_BEGIN:
+            /* the previous part was not fetched */
+            swow_http_parser_multipart_clear(multipart);
+            array_init(&multipart->headers);
+            break;
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_HEADER_FIELD:
+            if (!continued) {
+                swow_http_parser_multipart_add_header(multipart);
+            }
+            smart_str_appendl(&multipart->header_name, parser->data, parser->data_length);
+            break;
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_HEADER_VALUE:
+            smart_str_appendl(&multipart->header_value, parser->data, parser->data_length);
+            break;
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_HEADERS_COMPLETE:
+            swow_http_parser_multipart_add_header(multipart);
+            multipart->is_file = swow_http_parser_multipart_is_file(multipart);
+            break;
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_BODY:
+            if (parser->data_length > 0) {
+                swow_http_parser_multipart_write(multipart, parser->data, parser->data_length);
+            }
+            break;
+        case CAT_HTTP_PARSER_EVENT_MULTIPART_DATA_END:
+            if (multipart->file != -1) {
+                if (UNEXPECTED(cat_fs_close(multipart->file) != 0 && multipart->error == SWOW_HTTP_UPLOAD_ERR_OK)) {
+                    multipart->error = SWOW_HTTP_UPLOAD_ERR_CANT_WRITE;
+                }
+                multipart->file = -1;
+            }
+            multipart->completed = true;
+            break;
+        default:
+            break;
+    }
+    multipart->last_event = event;
+}
+
+#define arginfo_class_Swow_Http_Parser_executeMultipart arginfo_class_Swow_Http_Parser_execute
+
+static PHP_METHOD(Swow_Http_Parser, executeMultipart)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_multipart_t *multipart = &s_parser->multipart;
+    cat_http_parser_events_t events;
+    zend_string *string;
+    zend_long start = 0;
+    zend_long length = -1;
+    const char *ptr;
+    size_t parsed_length = 0;
+    bool ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        SWOW_PARAM_STRINGABLE_EXPECT_BUFFER_FOR_READING(string)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* check args and initialize */
+    ptr = swow_string_get_readable_space(string, start, &length, 1);
+
+    if (UNEXPECTED(ptr == NULL)) {
+        RETURN_THROWS();
+    }
+
+    /* run parser over the data until a part is completed or more data is needed,
+     * part headers and data are consumed here, so there is no round trip for each piece of data,
+     * events which are not related to multipart will stop it as well */
+    events = cat_http_parser_get_events(parser);
+    cat_http_parser_set_events(parser, events | SWOW_HTTP_PARSER_MULTIPART_EVENTS);
+    while (true) {
+        ret = cat_http_parser_execute(parser, ptr + parsed_length, length - parsed_length);
+        if (UNEXPECTED(!ret)) {
+            break;
+        }
+        parsed_length += parser->parsed_length;
+        if (!(parser->event & CAT_HTTP_PARSER_EVENT_FLAG_MULTIPART)) {
+            break;
+        }
+        swow_http_parser_multipart_handle_event(multipart, parser);
+        if (parser->event == CAT_HTTP_PARSER_EVENT_MULTIPART_DATA_END) {
+            break;
+        }
+    }
+    cat_http_parser_set_events(parser, events);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_http_parser_exception_ce);
+        RETURN_THROWS();
+    }
+    s_parser->data_offset = 0;
+
+    RETURN_LONG(parsed_length);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_getMultipartPart, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, getMultipartPart)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_multipart_t *multipart = &s_parser->multipart;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+    (void) parser;
+
+    if (UNEXPECTED(!multipart->completed)) {
+        swow_throw_exception(swow_http_parser_exception_ce, CAT_EMISUSE, "Multipart part is not completed");
+        RETURN_THROWS();
+    }
+
+    array_init_size(return_value, 5);
+    add_assoc_zval(return_value, "headers", &multipart->headers);
+    ZVAL_UNDEF(&multipart->headers);
+    add_assoc_str(return_value, "data", smart_str_extract(&multipart->data));
+    if (multipart->file_path != NULL) {
+        add_assoc_str(return_value, "tmp_name", multipart->file_path);
+        multipart->file_path = NULL;
+    } else {
+        add_assoc_null(return_value, "tmp_name");
+    }
+    add_assoc_long(return_value, "size", multipart->size);
+    add_assoc_long(return_value, "error", multipart->error);
+    swow_http_parser_multipart_clear(multipart);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_getMultipartSpoolDirectory, 0, 0, IS_STRING, 1)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, getMultipartSpoolDirectory)
+{
+    swow_http_parser_multipart_t *multipart = &getThisParser()->multipart;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (multipart->spool_directory == NULL) {
+        RETURN_NULL();
+    }
+    RETURN_STR_COPY(multipart->spool_directory);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_setMultipartSpoolDirectory, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, directory, IS_STRING, 1)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, setMultipartSpoolDirectory)
+{
+    swow_http_parser_multipart_t *multipart = &getThisParser()->multipart;
+    zend_string *directory;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR_OR_NULL(directory)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (multipart->spool_directory != NULL) {
+        zend_string_release(multipart->spool_directory);
+    }
+    multipart->spool_directory = (directory != NULL && ZSTR_LEN(directory) > 0) ? zend_string_copy(directory) : NULL;
+
+    RETURN_THIS();
+}
+
+#define arginfo_class_Swow_Http_Parser_getMultipartMemoryThreshold arginfo_class_Swow_Http_Parser_getType
+
+static PHP_METHOD(Swow_Http_Parser, getMultipartMemoryThreshold)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(getThisParser()->multipart.memory_threshold);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_setMultipartMemoryThreshold, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, threshold, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, setMultipartMemoryThreshold)
+{
+    zend_long threshold;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(threshold)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(threshold < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+    getThisParser()->multipart.memory_threshold = threshold;
 
     RETURN_THIS();
 }
@@ -463,6 +1128,15 @@ static const zend_function_entry swow_http_parser_methods[] = {
     PHP_ME(Swow_Http_Parser, getEvents,             arginfo_class_Swow_Http_Parser_getEvents,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, setEvents,             arginfo_class_Swow_Http_Parser_setEvents,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, execute,               arginfo_class_Swow_Http_Parser_execute,               ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, executeHead,           arginfo_class_Swow_Http_Parser_executeHead,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getHeaderIndex,        arginfo_class_Swow_Http_Parser_getHeaderIndex,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getUriOrReasonPhraseIndex, arginfo_class_Swow_Http_Parser_getUriOrReasonPhraseIndex, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, executeMultipart,      arginfo_class_Swow_Http_Parser_executeMultipart,      ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getMultipartPart,      arginfo_class_Swow_Http_Parser_getMultipartPart,      ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getMultipartSpoolDirectory,  arginfo_class_Swow_Http_Parser_getMultipartSpoolDirectory,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, setMultipartSpoolDirectory,  arginfo_class_Swow_Http_Parser_setMultipartSpoolDirectory,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getMultipartMemoryThreshold, arginfo_class_Swow_Http_Parser_getMultipartMemoryThreshold, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, setMultipartMemoryThreshold, arginfo_class_Swow_Http_Parser_setMultipartMemoryThreshold, ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getEvent,              arginfo_class_Swow_Http_Parser_getEvent,              ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getEventName,          arginfo_class_Swow_Http_Parser_getEventName,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getPreviousEvent,      arginfo_class_Swow_Http_Parser_getPreviousEvent,      ZEND_ACC_PUBLIC)
@@ -506,7 +1180,7 @@ static zend_always_inline size_t swow_http_get_header_length(zend_string *header
     return size;
 }
 
-static zend_always_inline size_t swow_http_get_message_length(HashTable *headers, zend_string *body)
+static zend_always_inline size_t swow_http_get_head_length(HashTable *headers)
 {
     zend_string *header_name;
     zval *z_header_value;
@@ -527,11 +1201,14 @@ static zend_always_inline size_t swow_http_get_message_length(HashTable *headers
 
     size += CAT_STRLEN("\r\n");
 
-    size += ZSTR_LEN(body);
-
     return size;
 }
 
+static zend_always_inline size_t swow_http_get_message_length(HashTable *headers, zend_string *body)
+{
+    return swow_http_get_head_length(headers) + ZSTR_LEN(body);
+}
+
 static zend_always_inline char *swow_http_pack_header(char *p, zend_string *header_name, zval *z_header_value)
 {
     if (ZVAL_IS_NULL(z_header_value)) {
@@ -571,12 +1248,19 @@ static zend_always_inline char *swow_http_pack_headers(char *p, HashTable *heade
     return p;
 }
 
-static zend_always_inline char *swow_http_pack_message(char *p, HashTable *headers, zend_string *body)
+static zend_always_inline char *swow_http_pack_head(char *p, HashTable *headers)
 {
     p = swow_http_pack_headers(p, headers);
 
     p = cat_strnappend(p, CAT_STRL("\r\n"));
 
+    return p;
+}
+
+static zend_always_inline char *swow_http_pack_message(char *p, HashTable *headers, zend_string *body)
+{
+    p = swow_http_pack_head(p, headers);
+
     if (ZSTR_LEN(body) > 0) {
         p = cat_strnappend(p, ZSTR_VAL(body), ZSTR_LEN(body));
     }
@@ -586,6 +1270,55 @@ static zend_always_inline char *swow_http_pack_message(char *p, HashTable *heade
     return p;
 }
 
+typedef struct swow_http_response_line_s {
+    const char *protocol_version;
+    size_t protocol_version_length;
+    const char *status_code;
+    size_t status_code_length;
+    const char *reason_phrase;
+    size_t reason_phrase_length;
+    char status_code_buffer[MAX_LENGTH_OF_LONG + 1];
+} swow_http_response_line_t;
+
+/* returns the length of the response line */
+static zend_always_inline size_t swow_http_response_line_init(
+    swow_http_response_line_t *line,
+    const char *protocol_version, size_t protocol_version_length,
+    zend_long status_code,
+    const char *reason_phrase, size_t reason_phrase_length
+)
+{
+    char *status_code_string_eof = line->status_code_buffer + sizeof(line->status_code_buffer) - 1;
+
+    line->protocol_version = protocol_version;
+    line->protocol_version_length = protocol_version_length;
+    line->status_code = zend_print_long_to_buf(status_code_string_eof, status_code);
+    line->status_code_length = status_code_string_eof - line->status_code;
+    if (reason_phrase_length == 0) {
+        reason_phrase = cat_http_status_get_reason(status_code);
+        reason_phrase_length = strlen(reason_phrase);
+    }
+    line->reason_phrase = reason_phrase;
+    line->reason_phrase_length = reason_phrase_length;
+
+    return CAT_STRLEN("HTTP/") + protocol_version_length + CAT_STRLEN(" ") +
+           line->status_code_length + CAT_STRLEN(" ") +
+           reason_phrase_length + CAT_STRLEN("\r\n");
+}
+
+static zend_always_inline char *swow_http_pack_response_line(char *p, const swow_http_response_line_t *line)
+{
+    p = cat_strnappend(p, CAT_STRL("HTTP/"));
+    p = cat_strnappend(p, line->protocol_version, line->protocol_version_length);
+    p = cat_strnappend(p, CAT_STRL(" "));
+    p = cat_strnappend(p, line->status_code, line->status_code_length);
+    p = cat_strnappend(p, CAT_STRL(" "));
+    p = cat_strnappend(p, line->reason_phrase, line->reason_phrase_length);
+    p = cat_strnappend(p, CAT_STRL("\r\n"));
+
+    return p;
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Http_packRequest, 0, 2, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO(0, method, IS_STRING, 0)
     ZEND_ARG_OBJ_TYPE_MASK(0, uri, Stringable, MAY_BE_STRING, NULL)
@@ -652,9 +1385,6 @@ static PHP_METHOD(Swow_Http_Http, packResponse)
     zend_string *response;
     /* arguments */
     zend_long status_code;
-    char status_code_buffer[MAX_LENGTH_OF_LONG + 1];
-    char *status_code_string, *status_code_string_eof;
-    size_t status_code_length;
     char *reason_phrase = NULL;
     size_t reason_phrase_length = 0;
     HashTable *headers = (HashTable *) &zend_empty_array;
@@ -663,6 +1393,7 @@ static PHP_METHOD(Swow_Http_Http, packResponse)
     char *protocol_version = (char *) "1.1";
     size_t protocol_version_length = CAT_STRLEN("1.1");
     /* pack */
+    swow_http_response_line_t line;
     char *p;
     size_t size;
 
@@ -675,39 +1406,219 @@ static PHP_METHOD(Swow_Http_Http, packResponse)
         Z_PARAM_STRING(protocol_version, protocol_version_length)
     ZEND_PARSE_PARAMETERS_END();
 
-    status_code_string_eof = status_code_buffer + sizeof(status_code_buffer) - 1;
-    status_code_string = zend_print_long_to_buf(status_code_string_eof, status_code);
-    status_code_length = status_code_string_eof - status_code_string;
-    if (reason_phrase_length == 0) {
-        reason_phrase = (char *) cat_http_status_get_reason(status_code);
-        reason_phrase_length = strlen(reason_phrase);
-    }
-
-    size = CAT_STRLEN("HTTP/") + protocol_version_length + CAT_STRLEN(" ") +
-           status_code_length + CAT_STRLEN(" ") +
-           reason_phrase_length + CAT_STRLEN("\r\n");
+    size = swow_http_response_line_init(&line, protocol_version, protocol_version_length, status_code, reason_phrase, reason_phrase_length);
 
     size += swow_http_get_message_length(headers, body);
 
     response = zend_string_alloc(size, 0);
 
     p = ZSTR_VAL(response);
-    p = cat_strnappend(p, CAT_STRL("HTTP/"));
-    p = cat_strnappend(p, protocol_version, protocol_version_length);
-    p = cat_strnappend(p, CAT_STRL(" "));
-    p = cat_strnappend(p, status_code_string, status_code_length);
-    p = cat_strnappend(p, CAT_STRL(" "));
-    p = cat_strnappend(p, reason_phrase, reason_phrase_length);
-    p = cat_strnappend(p, CAT_STRL("\r\n"));
+    p = swow_http_pack_response_line(p, &line);
 
     (void) swow_http_pack_message(p, headers, body);
 
     RETURN_STR(response);
 }
 
+#define SWOW_HTTP_HEAD_BUFFER_SIZE 1024
+
+/* "\r\n" (end of the previous chunk) + hex length + "\r\n" */
+#define SWOW_HTTP_CHUNK_PREFIX_SIZE (CAT_STRLEN("\r\n") + sizeof(size_t) * 2 + CAT_STRLEN("\r\n"))
+
+static zend_always_inline char *swow_http_pack_chunk_length(char *p, size_t length)
+{
+    char buffer[sizeof(size_t) * 2], *start = buffer + sizeof(buffer);
+
+    do {
+        *--start = "0123456789abcdef"[length & 0xf];
+        length >>= 4;
+    } while (length != 0);
+
+    return cat_strnappend(p, start, buffer + sizeof(buffer) - start);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Http_sendResponse, 0, 2, IS_VOID, 0)
+    ZEND_ARG_OBJ_INFO(0, socket, Swow\\Socket, 0)
+    ZEND_ARG_TYPE_INFO(0, statusCode, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, reasonPhrase, IS_STRING, 0, "\'\'")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, headers, IS_ARRAY, 0, "[]")
+    ZEND_ARG_OBJ_TYPE_MASK(0, body, Stringable, MAY_BE_STRING|MAY_BE_ARRAY, "\'\'")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, protocolVersion, IS_STRING, 0, "Swow\\Http\\Http::DEFAULT_PROTOCOL_VERSION")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+/* Only the head is packed, it is written together with the body (or chunks)
+ * by one vectored write, so that the body is never copied. */
+static PHP_METHOD(Swow_Http_Http, sendResponse)
+{
+    cat_socket_t *socket;
+    /* arguments */
+    zend_object *socket_object;
+    zend_long status_code;
+    char *reason_phrase = NULL;
+    size_t reason_phrase_length = 0;
+    HashTable *headers = (HashTable *) &zend_empty_array;
+    zval *z_body = NULL;
+    char *protocol_version = (char *) "1.1";
+    size_t protocol_version_length = CAT_STRLEN("1.1");
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    /* head */
+    swow_http_response_line_t line;
+    char head_on_stack[SWOW_HTTP_HEAD_BUFFER_SIZE], *head, *head_on_heap = NULL;
+    size_t head_length;
+    /* body (or chunks) */
+    zend_string *body = zend_empty_string;
+    HashTable *chunks = NULL;
+    char prefixes_on_stack[SWOW_HTTP_CHUNK_PREFIX_SIZE * 8], *prefixes = prefixes_on_stack, *prefixes_on_heap = NULL;
+    /* chunk values are copied to hold the references until the write is done */
+    zval values_on_stack[8], *values = values_on_stack, *values_on_heap = NULL;
+    uint32_t value_count = 0;
+    cat_socket_write_vector_t vector_on_stack[1 + 8 * 2 + 1], *vector = vector_on_stack, *vector_on_heap = NULL;
+    uint32_t vector_count = 0;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(2, 7)
+        Z_PARAM_OBJ_OF_CLASS(socket_object, swow_socket_ce)
+        Z_PARAM_LONG(status_code)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STRING(reason_phrase, reason_phrase_length)
+        Z_PARAM_ARRAY_HT(headers)
+        Z_PARAM_ZVAL(z_body)
+        Z_PARAM_STRING(protocol_version, protocol_version_length)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socket = &swow_socket_get_from_object(socket_object)->socket;
+
+    if (z_body != NULL) {
+        if (Z_TYPE_P(z_body) == IS_ARRAY) {
+            chunks = Z_ARR_P(z_body);
+        } else if (UNEXPECTED(!swow_parse_arg_stringable_expect_buffer_for_reading(z_body, &body, 5))) {
+            zend_argument_type_error(5, "must be of type Stringable, array or string, %s given", zend_zval_type_name(z_body));
+            RETURN_THROWS();
+        }
+    }
+
+    /* head */
+    head_length = swow_http_response_line_init(&line, protocol_version, protocol_version_length, status_code, reason_phrase, reason_phrase_length);
+    head_length += swow_http_get_head_length(headers);
+    if (EXPECTED(head_length <= sizeof(head_on_stack))) {
+        head = head_on_stack;
+    } else {
+        head = head_on_heap = emalloc(head_length);
+    }
+    (void) swow_http_pack_head(swow_http_pack_response_line(head, &line), headers);
+    vector[0].base = head;
+    vector[0].length = head_length;
+    vector_count = 1;
+
+    /* body */
+    if (chunks == NULL) {
+        if (ZSTR_LEN(body) > 0) {
+            vector[1].base = ZSTR_VAL(body);
+            vector[1].length = ZSTR_LEN(body);
+            vector_count = 2;
+        }
+    } else {
+        uint32_t chunk_count = zend_hash_num_elements(chunks);
+        uint32_t chunk_index = 0;
+        zval *z_chunk;
+        char *prefix;
+
+        if (UNEXPECTED(chunk_count > CAT_ARRAY_SIZE(values_on_stack))) {
+            values = values_on_heap = safe_emalloc(chunk_count, sizeof(*values), 0);
+            prefixes = prefixes_on_heap = safe_emalloc(chunk_count, SWOW_HTTP_CHUNK_PREFIX_SIZE, 0);
+            vector = vector_on_heap = safe_emalloc(chunk_count * 2 + 2, sizeof(*vector), 0);
+            vector[0] = vector_on_stack[0];
+        }
+        prefix = prefixes;
+        ZEND_HASH_FOREACH_VAL(chunks, z_chunk) {
+            zval *z_value = &values[value_count];
+            swow_buffer_t *s_buffer = NULL;
+            zend_string *string = NULL;
+            const char *ptr;
+            zend_long length = -1;
+            char *p;
+
+            /* do not touch elements of the array, it may be shared */
+            ZVAL_COPY(z_value, z_chunk);
+            if (UNEXPECTED(!swow_parse_arg_buffer_or_stringable_for_reading(z_value, &s_buffer, &string, 5))) {
+                zend_argument_type_error(5, "[%u] must be of type string or %s, %s given", chunk_index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_chunk));
+                zval_ptr_dtor(z_value);
+                goto _error;
+            }
+            value_count++;
+            ptr = swow_buffer_or_string_get_readable_space_v(s_buffer, string, 0, &length, 5, chunk_index, 1);
+            if (UNEXPECTED(ptr == NULL)) {
+                goto _error;
+            }
+            chunk_index++;
+            /* empty chunk means the last chunk, skip it */
+            if (length == 0) {
+                continue;
+            }
+            if (s_buffer != NULL) {
+                /* hold the buffer string to make sure data is immutable (COW) */
+                zend_string *buffer_string = swow_buffer_get_string(s_buffer);
+                zend_object_release(&s_buffer->std);
+                ZVAL_STR_COPY(z_value, buffer_string);
+            }
+            p = prefix;
+            if (vector_count > 1) {
+                p = cat_strnappend(p, CAT_STRL("\r\n"));
+            }
+            p = swow_http_pack_chunk_length(p, length);
+            p = cat_strnappend(p, CAT_STRL("\r\n"));
+            vector[vector_count].base = prefix;
+            vector[vector_count].length = p - prefix;
+            vector[vector_count + 1].base = ptr;
+            vector[vector_count + 1].length = length;
+            vector_count += 2;
+            prefix += SWOW_HTTP_CHUNK_PREFIX_SIZE;
+        } ZEND_HASH_FOREACH_END();
+        if (vector_count > 1) {
+            vector[vector_count].base = "\r\n0\r\n\r\n";
+            vector[vector_count].length = CAT_STRLEN("\r\n0\r\n\r\n");
+        } else {
+            vector[vector_count].base = "0\r\n\r\n";
+            vector[vector_count].length = CAT_STRLEN("0\r\n\r\n");
+        }
+        vector_count++;
+    }
+
+    if (timeout_is_null) {
+        timeout = cat_socket_get_write_timeout(socket);
+    }
+
+    ret = cat_socket_write_ex(socket, vector, vector_count, timeout);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        goto _error;
+    }
+
+    if (0) {
+        _error:
+        ZEND_ASSERT_HAS_EXCEPTION();
+    }
+    while (value_count--) {
+        zval_ptr_dtor(&values[value_count]);
+    }
+    if (UNEXPECTED(values_on_heap != NULL)) {
+        efree(values_on_heap);
+        efree(prefixes_on_heap);
+        efree(vector_on_heap);
+    }
+    if (UNEXPECTED(head_on_heap != NULL)) {
+        efree(head_on_heap);
+    }
+}
+
 static const zend_function_entry swow_http_http_methods[] = {
     PHP_ME(Swow_Http_Http, packRequest,  arginfo_class_Swow_Http_Http_packRequest,  ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Http_Http, packResponse, arginfo_class_Swow_Http_Http_packResponse, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Http_Http, sendResponse, arginfo_class_Swow_Http_Http_sendResponse, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -740,7 +1651,7 @@ zend_result swow_http_module_init(INIT_FUNC_ARGS)
         "Swow\\Http\\Parser", NULL, swow_http_parser_methods,
         &swow_http_parser_handlers, NULL,
         cat_false, cat_false,
-        swow_http_parser_create_object, NULL,
+        swow_http_parser_create_object, swow_http_parser_free_object,
         XtOffsetOf(swow_http_parser_t, std)
     );
     zend_declare_class_constant_long(swow_http_parser_ce, ZEND_STRL("TYPE_BOTH"), CAT_HTTP_PARSER_TYPE_BOTH);
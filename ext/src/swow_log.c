@@ -185,9 +185,140 @@ static PHP_METHOD(Swow_Log, setTypes)
     CAT_LOG_G(types) = types;
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Log_write, 0, 2, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, type, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, message, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Log, write)
+{
+    zend_long type;
+    zend_string *message;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_LONG(type)
+        Z_PARAM_STR(message)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(type != CAT_LOG_TYPE_DEBUG && type != CAT_LOG_TYPE_INFO &&
+                   type != CAT_LOG_TYPE_NOTICE && type != CAT_LOG_TYPE_WARNING)) {
+        zend_argument_value_error(1, "must be one of Swow\\Log::TYPE_DEBUG, Swow\\Log::TYPE_INFO, Swow\\Log::TYPE_NOTICE or Swow\\Log::TYPE_WARNING");
+        RETURN_THROWS();
+    }
+    if (!(type & CAT_LOG_G(types))) {
+        return;
+    }
+    /* it is written as a libcat log record (instead of a PHP error), so it goes through the async log if it is enabled */
+    cat_log_standard((cat_log_type_t) type, "USER" CAT_SOURCE_POSITION_CC, CAT_UNCODED, "%.*s", (int) ZSTR_LEN(message), ZSTR_VAL(message));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Log_enableAsync, 0, 0, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, bufferSize, IS_LONG, 0, "Swow\\Log::ASYNC_DEFAULT_BUFFER_SIZE")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, backpressure, IS_LONG, 0, "Swow\\Log::BACKPRESSURE_DROP")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, sampleRate, IS_LONG, 0, "10")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Log, enableAsync)
+{
+    zend_long buffer_size = CAT_LOG_ASYNC_DEFAULT_BUFFER_SIZE;
+    zend_long backpressure = CAT_LOG_ASYNC_BACKPRESSURE_DROP;
+    zend_long sample_rate = 10;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 3)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(buffer_size)
+        Z_PARAM_LONG(backpressure)
+        Z_PARAM_LONG(sample_rate)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(buffer_size <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(backpressure != CAT_LOG_ASYNC_BACKPRESSURE_DROP &&
+                   backpressure != CAT_LOG_ASYNC_BACKPRESSURE_BLOCK &&
+                   backpressure != CAT_LOG_ASYNC_BACKPRESSURE_SAMPLE)) {
+        zend_argument_value_error(2, "is unrecognized");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(sample_rate <= 0 || sample_rate > UINT_MAX)) {
+        zend_argument_value_error(3, "must be greater than 0 and less than or equal to %u", UINT_MAX);
+        RETURN_THROWS();
+    }
+
+    ret = cat_log_async_enable((size_t) buffer_size, (cat_log_async_backpressure_t) backpressure, (unsigned int) sample_rate);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_exception_ce);
+        RETURN_THROWS();
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Log_disableAsync, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Log, disableAsync)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_log_async_disable();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Log_isAsync, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Log, isAsync)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_log_async_is_enabled());
+}
+
+#define arginfo_class_Swow_Log_flush arginfo_class_Swow_Log_disableAsync
+
+static PHP_METHOD(Swow_Log, flush)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_log_async_flush();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Log_getAsyncStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Log, getAsyncStats)
+{
+    cat_log_async_stats_t stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (!cat_log_async_get_stats(&stats)) {
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "records", (zend_long) stats.records);
+    add_assoc_long(return_value, "bytes", (zend_long) stats.bytes);
+    add_assoc_long(return_value, "batches", (zend_long) stats.batches);
+    add_assoc_long(return_value, "dropped", (zend_long) stats.dropped);
+    add_assoc_long(return_value, "sampled_out", (zend_long) stats.sampled_out);
+    add_assoc_long(return_value, "blocked", (zend_long) stats.blocked);
+    add_assoc_long(return_value, "direct", (zend_long) stats.direct);
+    add_assoc_long(return_value, "write_errors", (zend_long) stats.write_errors);
+    add_assoc_long(return_value, "buffer_size", (zend_long) stats.buffer_size);
+    add_assoc_long(return_value, "pending_bytes", (zend_long) stats.pending_bytes);
+}
+
 static const zend_function_entry swow_log_methods[] = {
     PHP_ME(Swow_Log, getTypes,       arginfo_class_Swow_Log_getTypes,       ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Log, setTypes,       arginfo_class_Swow_Log_setTypes,       ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, write,          arginfo_class_Swow_Log_write,          ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, enableAsync,    arginfo_class_Swow_Log_enableAsync,    ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, disableAsync,   arginfo_class_Swow_Log_disableAsync,   ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, isAsync,        arginfo_class_Swow_Log_isAsync,        ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, flush,          arginfo_class_Swow_Log_flush,          ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Log, getAsyncStats,  arginfo_class_Swow_Log_getAsyncStats,  ZEND_ACC_STATIC | ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -209,6 +340,10 @@ zend_result swow_log_module_init(INIT_FUNC_ARGS)
     zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("TYPES_DEFAULT"),      CAT_LOG_TYPES_DEFAULT);
     zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("TYPES_ABNORMAL"),     CAT_LOG_TYPES_ABNORMAL);
     zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("TYPES_UNFILTERABLE"), CAT_LOG_TYPES_UNFILTERABLE);
+    zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("BACKPRESSURE_DROP"),  CAT_LOG_ASYNC_BACKPRESSURE_DROP);
+    zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("BACKPRESSURE_BLOCK"), CAT_LOG_ASYNC_BACKPRESSURE_BLOCK);
+    zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("BACKPRESSURE_SAMPLE"), CAT_LOG_ASYNC_BACKPRESSURE_SAMPLE);
+    zend_declare_class_constant_long(swow_log_ce, ZEND_STRL("ASYNC_DEFAULT_BUFFER_SIZE"), CAT_LOG_ASYNC_DEFAULT_BUFFER_SIZE);
 
     return SUCCESS;
 }
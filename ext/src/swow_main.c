@@ -26,6 +26,7 @@
 #include "swow_coroutine.h"
 #include "swow_channel.h"
 #include "swow_sync.h"
+#include "swow_pool.h"
 #include "swow_event.h"
 #include "swow_time.h"
 #include "swow_buffer.h"
@@ -39,6 +40,7 @@
 #include "swow_http.h"
 #include "swow_websocket.h"
 #include "swow_proc_open.h"
+#include "swow_thread.h"
 
 #include "swow_curl.h"
 
@@ -215,6 +217,7 @@ PHP_MINIT_FUNCTION(swow)
         swow_coroutine_module_init,
         swow_channel_module_init,
         swow_sync_module_init,
+        swow_pool_module_init,
         swow_event_module_init,
         swow_time_module_init,
         swow_buffer_module_init,
@@ -227,6 +230,7 @@ PHP_MINIT_FUNCTION(swow)
         swow_ipaddress_init,
         swow_http_module_init,
         swow_websocket_module_init,
+        swow_thread_module_init,
 #ifdef CAT_OS_WAIT
         swow_proc_open_module_init,
 #endif
@@ -270,10 +274,12 @@ PHP_MSHUTDOWN_FUNCTION(swow)
 #ifdef CAT_OS_WAIT
         swow_proc_open_module_shutdown,
 #endif
+        swow_thread_module_shutdown,
         swow_closure_module_shutdown,
         swow_watchdog_module_shutdown,
         swow_stream_module_shutdown,
         swow_socket_module_shutdown,
+        swow_time_module_shutdown,
         swow_event_module_shutdown,
         swow_coroutine_module_shutdown,
         swow_debug_module_shutdown,
@@ -315,6 +321,8 @@ PHP_RINIT_FUNCTION(swow)
         swow_debug_runtime_init,
         swow_coroutine_runtime_init,
         swow_event_runtime_init,
+        swow_time_runtime_init,
+        swow_buffer_runtime_init,
         swow_socket_runtime_init,
         swow_dns_runtime_init,
         swow_stream_runtime_init,
@@ -362,7 +370,10 @@ PHP_RSHUTDOWN_FUNCTION(swow)
 #endif
         swow_watchdog_runtime_shutdown,
         swow_stream_runtime_shutdown,
+        swow_socket_runtime_shutdown,
+        swow_buffer_runtime_shutdown,
         swow_event_runtime_shutdown,
+        swow_time_runtime_shutdown,
         swow_coroutine_runtime_shutdown,
         swow_debug_runtime_shutdown,
         swow_runtime_shutdown,
@@ -245,7 +245,7 @@ static int pgsql_handle_closer(pdo_dbh_t *dbh) /* {{{ */
             H->lob_streams = NULL;
         }
         if (H->server) {
-            PQfinish(H->server);
+            cat_pq_finish(H->server);
             H->server = NULL;
         }
         if (H->einfo.errmsg) {
@@ -1518,9 +1518,13 @@ static void pgsql_handle_closer(pdo_dbh_t *dbh) /* {{{ */
             H->lob_streams = NULL;
         }
         if (H->server) {
-            PQfinish(H->server);
+            cat_pq_finish(H->server);
             H->server = NULL;
         }
+        if (H->pipeline_entries) {
+            pefree(H->pipeline_entries, dbh->is_persistent);
+            H->pipeline_entries = NULL;
+        }
         if (H->einfo.errmsg) {
             pefree(H->einfo.errmsg, dbh->is_persistent);
             H->einfo.errmsg = NULL;
@@ -2464,6 +2468,221 @@ PHP_METHOD(PDO_PGSql_Ext, pgsqlGetPid)
 }
 /* }}} */
 
+#ifdef CAT_PQ_HAVE_PIPELINE
+void swow_pdo_pgsql_pipeline_enqueue(pdo_dbh_t *dbh, pdo_stmt_t *stmt, pdo_pgsql_pipeline_entry_type type)
+{
+    pdo_pgsql_db_handle *H = (pdo_pgsql_db_handle *)dbh->driver_data;
+    pdo_pgsql_pipeline_entry *entry;
+
+    if (H->pipeline_count == H->pipeline_size) {
+        H->pipeline_size = H->pipeline_size ? H->pipeline_size * 2 : 16;
+        H->pipeline_entries = safe_perealloc(H->pipeline_entries, H->pipeline_size, sizeof(*entry), 0, dbh->is_persistent);
+    }
+    entry = &H->pipeline_entries[H->pipeline_count++];
+    entry->type = type;
+    entry->stmt = stmt;
+}
+
+void swow_pdo_pgsql_pipeline_forget(pdo_dbh_t *dbh, pdo_stmt_t *stmt)
+{
+    pdo_pgsql_db_handle *H = (pdo_pgsql_db_handle *)dbh->driver_data;
+    uint32_t i;
+
+    /* result of it would be discarded */
+    for (i = 0; i < H->pipeline_count; i++) {
+        if (H->pipeline_entries[i].stmt == stmt) {
+            H->pipeline_entries[i].type = PDO_PGSQL_PIPELINE_ENTRY_DISCARD;
+            H->pipeline_entries[i].stmt = NULL;
+        }
+    }
+}
+
+bool swow_pdo_pgsql_pipeline_discard(pdo_dbh_t *dbh, const char *query)
+{
+    pdo_pgsql_db_handle *H = (pdo_pgsql_db_handle *)dbh->driver_data;
+
+    if (!PQsendQueryParams(H->server, query, 0, NULL, NULL, NULL, NULL, 0)) {
+        return false;
+    }
+    swow_pdo_pgsql_pipeline_enqueue(dbh, NULL, PDO_PGSQL_PIPELINE_ENTRY_DISCARD);
+
+    return true;
+}
+
+/* mark a sync point and read results of all queued queries in order */
+static bool pdo_pgsql_pipeline_sync(pdo_dbh_t *dbh)
+{
+    pdo_pgsql_db_handle *H = (pdo_pgsql_db_handle *)dbh->driver_data;
+    pdo_pgsql_error_info failed_einfo = { NULL, 0, 0, NULL };
+    pdo_error_type failed_sqlstate;
+    bool failed = false;
+    PGresult *result;
+    uint32_t i;
+
+    if (!cat_pq_pipeline_sync(H->server)) {
+        H->pipeline_count = 0;
+        pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, PHP_PDO_PGSQL_CONNECTION_FAILURE_SQLSTATE);
+        return false;
+    }
+
+    for (i = 0; i < H->pipeline_count; i++) {
+        pdo_pgsql_pipeline_entry *entry = &H->pipeline_entries[i];
+        PGresult *extra_result;
+
+        if (!cat_pq_wait_result(H->server) || (result = PQgetResult(H->server)) == NULL) {
+            H->pipeline_count = 0;
+            if (failed_einfo.errmsg) {
+                efree(failed_einfo.errmsg);
+            }
+            pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, PHP_PDO_PGSQL_CONNECTION_FAILURE_SQLSTATE);
+            return false;
+        }
+        /* results of each query are terminated by NULL */
+        while (cat_pq_wait_result(H->server) && (extra_result = PQgetResult(H->server)) != NULL) {
+            PQclear(extra_result);
+        }
+        if (entry->stmt == NULL) {
+            PQclear(result);
+            continue;
+        }
+        if (!swow_pdo_pgsql_stmt_pipeline_result(entry->stmt, result, entry->type) && !failed) {
+            /* the einfo is shared by all statements, keep the first error
+             * before it is overwritten by the following aborted ones */
+            failed = true;
+            failed_einfo.file = H->einfo.file;
+            failed_einfo.line = H->einfo.line;
+            failed_einfo.errcode = H->einfo.errcode;
+            if (H->einfo.errmsg) {
+                failed_einfo.errmsg = estrdup(H->einfo.errmsg);
+            }
+            strcpy(failed_sqlstate, entry->stmt->error_code);
+        }
+    }
+    H->pipeline_count = 0;
+
+    if (!cat_pq_wait_result(H->server) || (result = PQgetResult(H->server)) == NULL) {
+        if (failed_einfo.errmsg) {
+            efree(failed_einfo.errmsg);
+        }
+        pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, PHP_PDO_PGSQL_CONNECTION_FAILURE_SQLSTATE);
+        return false;
+    }
+    if (PQresultStatus(result) != PGRES_PIPELINE_SYNC) {
+        if (failed_einfo.errmsg) {
+            efree(failed_einfo.errmsg);
+        }
+        pdo_pgsql_error_msg(dbh, PQresultStatus(result), "Unexpected result in pipeline mode");
+        PQclear(result);
+        return false;
+    }
+    PQclear(result);
+
+    if (failed) {
+        /* report the first error, others can be found on statements */
+        _swow_pdo_pgsql_error(dbh, NULL, failed_einfo.errcode, failed_sqlstate, failed_einfo.errmsg, failed_einfo.file, failed_einfo.line);
+        if (failed_einfo.errmsg) {
+            efree(failed_einfo.errmsg);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+/* {{{ Enter pipeline mode, statements are executed without waiting until pgsqlPipelineSync() is called,
+ * libpq refuses synchronous commands in pipeline mode, so PDO::exec(), transactions,
+ * lastInsertId() and the pgsqlCopy*()/pgsqlLOB*() methods fail until pgsqlExitPipelineMode() */
+PHP_METHOD(PDO_PGSql_Ext, pgsqlEnterPipelineMode)
+{
+    pdo_dbh_t *dbh;
+    pdo_pgsql_db_handle *H;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    dbh = Z_PDO_DBH_P(ZEND_THIS);
+    PDO_CONSTRUCT_CHECK;
+    PDO_DBH_CLEAR_ERR();
+
+    H = (pdo_pgsql_db_handle *)dbh->driver_data;
+
+    if (H->in_pipeline) {
+        RETURN_TRUE;
+    }
+    if (!PQenterPipelineMode(H->server)) {
+        pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, NULL);
+        PDO_HANDLE_DBH_ERR();
+        RETURN_FALSE;
+    }
+    H->in_pipeline = 1;
+
+    RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ Read results of all statements executed in pipeline mode, returns false if any of them failed */
+PHP_METHOD(PDO_PGSql_Ext, pgsqlPipelineSync)
+{
+    pdo_dbh_t *dbh;
+    pdo_pgsql_db_handle *H;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    dbh = Z_PDO_DBH_P(ZEND_THIS);
+    PDO_CONSTRUCT_CHECK;
+    PDO_DBH_CLEAR_ERR();
+
+    H = (pdo_pgsql_db_handle *)dbh->driver_data;
+
+    if (!H->in_pipeline) {
+        pdo_pgsql_error_msg(dbh, PGRES_FATAL_ERROR, "Not in pipeline mode");
+        PDO_HANDLE_DBH_ERR();
+        RETURN_FALSE;
+    }
+    if (!pdo_pgsql_pipeline_sync(dbh)) {
+        PDO_HANDLE_DBH_ERR();
+        RETURN_FALSE;
+    }
+
+    RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ Exit pipeline mode, pending results are read before that */
+PHP_METHOD(PDO_PGSql_Ext, pgsqlExitPipelineMode)
+{
+    pdo_dbh_t *dbh;
+    pdo_pgsql_db_handle *H;
+    bool ret = true;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    dbh = Z_PDO_DBH_P(ZEND_THIS);
+    PDO_CONSTRUCT_CHECK;
+    PDO_DBH_CLEAR_ERR();
+
+    H = (pdo_pgsql_db_handle *)dbh->driver_data;
+
+    if (!H->in_pipeline) {
+        RETURN_TRUE;
+    }
+    if (H->pipeline_count != 0) {
+        ret = pdo_pgsql_pipeline_sync(dbh);
+    }
+    if (!PQexitPipelineMode(H->server)) {
+        pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, NULL);
+        PDO_HANDLE_DBH_ERR();
+        RETURN_FALSE;
+    }
+    H->in_pipeline = 0;
+    if (!ret) {
+        PDO_HANDLE_DBH_ERR();
+    }
+
+    RETURN_BOOL(ret);
+}
+/* }}} */
+#endif
+
 static const zend_function_entry *pdo_pgsql_get_driver_methods(pdo_dbh_t *dbh, int kind)
 {
     switch (kind) {
@@ -777,6 +777,12 @@ static int pgsql_stmt_dtor(pdo_stmt_t *stmt)
         && IS_OBJ_VALID(EG(objects_store).object_buckets[Z_OBJ_HANDLE(stmt->database_object_handle)])
         && !(OBJ_FLAGS(Z_OBJ(stmt->database_object_handle)) & IS_OBJ_FREE_CALLED);
 
+#ifdef CAT_PQ_HAVE_PIPELINE
+    if (server_obj_usable && S->H->pipeline_count != 0) {
+        swow_pdo_pgsql_pipeline_forget(stmt->dbh, stmt);
+    }
+#endif
+
     if (S->result) {
         /* free the resource */
         PQclear(S->result);
@@ -790,6 +796,15 @@ static int pgsql_stmt_dtor(pdo_stmt_t *stmt)
             PGresult *res;
 
             spprintf(&q, 0, "DEALLOCATE %s", S->stmt_name);
+#ifdef CAT_PQ_HAVE_PIPELINE
+            if (H->in_pipeline) {
+                if (!swow_pdo_pgsql_pipeline_discard(stmt->dbh, q)) {
+                    /* it will be released with the session */
+                    pdo_pgsql_error(stmt->dbh, PGRES_FATAL_ERROR, NULL);
+                }
+                res = NULL;
+            } else
+#endif
             res = cat_pq_exec(H->server, q);
             efree(q);
             if (res) {
@@ -827,6 +842,15 @@ static int pgsql_stmt_dtor(pdo_stmt_t *stmt)
             PGresult *res;
 
             spprintf(&q, 0, "CLOSE %s", S->cursor_name);
+#ifdef CAT_PQ_HAVE_PIPELINE
+            if (H->in_pipeline) {
+                if (!swow_pdo_pgsql_pipeline_discard(stmt->dbh, q)) {
+                    /* it will be released with the session */
+                    pdo_pgsql_error(stmt->dbh, PGRES_FATAL_ERROR, NULL);
+                }
+                res = NULL;
+            } else
+#endif
             res = cat_pq_exec(H->server, q);
             efree(q);
             if (res) PQclear(res);
@@ -844,6 +868,123 @@ static int pgsql_stmt_dtor(pdo_stmt_t *stmt)
     return 1;
 }
 
+static void pgsql_stmt_update_result_info(pdo_stmt_t *stmt, ExecStatusType status)
+{
+    pdo_pgsql_stmt *S = (pdo_pgsql_stmt*)stmt->driver_data;
+    pdo_pgsql_db_handle *H = S->H;
+
+    stmt->column_count = (int) PQnfields(S->result);
+    if (S->cols == NULL) {
+        S->cols = ecalloc(stmt->column_count, sizeof(pdo_pgsql_column));
+    }
+
+    if (status == PGRES_COMMAND_OK) {
+        stmt->row_count = ZEND_ATOL(PQcmdTuples(S->result));
+        H->pgoid = PQoidValue(S->result);
+    } else {
+        stmt->row_count = (zend_long)PQntuples(S->result);
+    }
+}
+
+#ifdef CAT_PQ_HAVE_PIPELINE
+/* send the query without waiting, the result will be read by pgsqlPipelineSync() */
+static int pgsql_stmt_pipeline_execute(pdo_stmt_t *stmt)
+{
+    pdo_pgsql_stmt *S = (pdo_pgsql_stmt*)stmt->driver_data;
+    pdo_pgsql_db_handle *H = S->H;
+    int n_params = stmt->bound_params ? zend_hash_num_elements(stmt->bound_params) : 0;
+    int ret;
+
+    if (S->cursor_name) {
+        pdo_pgsql_error_stmt_msg(stmt, PGRES_FATAL_ERROR, "HY000", "Scrollable cursors are not supported in pipeline mode");
+        return 0;
+    }
+
+    if (S->stmt_name) {
+        if (!S->is_prepared) {
+            if (!PQsendPrepare(H->server, S->stmt_name, ZSTR_VAL(S->query), n_params, S->param_types)) {
+                pdo_pgsql_error_stmt(stmt, PGRES_FATAL_ERROR, NULL);
+                return 0;
+            }
+            swow_pdo_pgsql_pipeline_enqueue(stmt->dbh, stmt, PDO_PGSQL_PIPELINE_ENTRY_PREPARE);
+            /* if it failed, the following execution would be aborted and we will reset it then */
+            S->is_prepared = 1;
+        }
+        ret = PQsendQueryPrepared(H->server, S->stmt_name, n_params,
+                (const char**)S->param_values,
+                S->param_lengths,
+                S->param_formats,
+                0);
+    } else if (stmt->supports_placeholders == PDO_PLACEHOLDER_NAMED) {
+        ret = PQsendQueryParams(H->server, ZSTR_VAL(S->query), n_params,
+                S->param_types,
+                (const char**)S->param_values,
+                S->param_lengths,
+                S->param_formats,
+                0);
+    } else {
+        /* simple query protocol is not allowed in pipeline mode */
+        ret = PQsendQueryParams(H->server, ZSTR_VAL(stmt->active_query_string), 0, NULL, NULL, NULL, NULL, 0);
+    }
+    if (!ret) {
+        pdo_pgsql_error_stmt(stmt, PGRES_FATAL_ERROR, NULL);
+        return 0;
+    }
+    swow_pdo_pgsql_pipeline_enqueue(stmt->dbh, stmt, PDO_PGSQL_PIPELINE_ENTRY_EXECUTE);
+
+    /* we know nothing until the result is read */
+    if (!stmt->executed) {
+        stmt->column_count = 0;
+        S->columns_pending = 1;
+    }
+    stmt->row_count = 0;
+
+    return 1;
+}
+
+bool swow_pdo_pgsql_stmt_pipeline_result(pdo_stmt_t *stmt, PGresult *result, pdo_pgsql_pipeline_entry_type type)
+{
+    pdo_pgsql_stmt *S = (pdo_pgsql_stmt*)stmt->driver_data;
+    ExecStatusType status = PQresultStatus(result);
+
+    if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+        if (type == PDO_PGSQL_PIPELINE_ENTRY_PREPARE) {
+            S->is_prepared = 0;
+        }
+        /* PGRES_PIPELINE_ABORTED has no sqlstate (reported as HY000),
+         * do not let it override the real error (e.g. its prepare failed) */
+        if (status != PGRES_PIPELINE_ABORTED || strcmp(stmt->error_code, PDO_ERR_NONE) == 0) {
+            pdo_pgsql_error_stmt(stmt, status, pdo_pgsql_sqlstate(result));
+        }
+        PQclear(result);
+        return false;
+    }
+    if (type == PDO_PGSQL_PIPELINE_ENTRY_PREPARE) {
+        PQclear(result);
+        return true;
+    }
+
+    if (S->result) {
+        PQclear(S->result);
+    }
+    S->result = result;
+    S->current_row = 0;
+    pgsql_stmt_update_result_info(stmt, status);
+
+    if (S->columns_pending) {
+        /* PDO described zero columns after the first execution,
+         * free them so that they will be described again on fetching */
+        if (stmt->columns != NULL) {
+            efree(stmt->columns);
+            stmt->columns = NULL;
+        }
+        S->columns_pending = 0;
+    }
+
+    return true;
+}
+#endif
+
 static int pgsql_stmt_execute(pdo_stmt_t *stmt)
 {
     pdo_pgsql_stmt *S = (pdo_pgsql_stmt*)stmt->driver_data;
@@ -860,6 +1001,12 @@ static int pgsql_stmt_execute(pdo_stmt_t *stmt)
 
     S->current_row = 0;
 
+#ifdef CAT_PQ_HAVE_PIPELINE
+    if (H->in_pipeline) {
+        return pgsql_stmt_pipeline_execute(stmt);
+    }
+#endif
+
     if (S->cursor_name) {
         char *q = NULL;
 
@@ -958,17 +1105,7 @@ stmt_retry:
         return 0;
     }
 
-    stmt->column_count = (int) PQnfields(S->result);
-    if (S->cols == NULL) {
-        S->cols = ecalloc(stmt->column_count, sizeof(pdo_pgsql_column));
-    }
-
-    if (status == PGRES_COMMAND_OK) {
-        stmt->row_count = ZEND_ATOL(PQcmdTuples(S->result));
-        H->pgoid = PQoidValue(S->result);
-    } else {
-        stmt->row_count = (zend_long)PQntuples(S->result);
-    }
+    pgsql_stmt_update_result_info(stmt, status);
 
     if (in_trans && !stmt->dbh->methods->in_transaction(stmt->dbh)) {
         swow_pdo_pgsql_close_lob_streams(stmt->dbh);
@@ -0,0 +1,556 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#include "swow_pool.h"
+#include "swow_socket.h"
+
+SWOW_API zend_class_entry *swow_pool_ce;
+SWOW_API zend_object_handlers swow_pool_handlers;
+SWOW_API zend_class_entry *swow_pool_exception_ce;
+
+#define SWOW_POOL_DEFAULT_MAX_SIZE 64
+
+static void swow_pool_release_evicted(swow_pool_t *s_pool)
+{
+    if (s_pool->evicted != NULL) {
+        HashTable *evicted = s_pool->evicted;
+        s_pool->evicted = NULL;
+        zend_array_destroy(evicted);
+    }
+}
+
+static zend_always_inline bool swow_pool_is_in_event_loop(void)
+{
+    return cat_coroutine_get_current() == cat_coroutine_get_scheduler();
+}
+
+static cat_data_t *swow_pool_create_item(cat_pool_t *pool)
+{
+    swow_pool_t *s_pool = swow_pool_get_from_handle(pool);
+    zend_fcall_info fci;
+    zval retval;
+
+    fci.size = sizeof(fci);
+    ZVAL_UNDEF(&fci.function_name);
+    fci.object = NULL;
+    fci.param_count = 0;
+    fci.named_params = NULL;
+    fci.retval = &retval;
+    (void) zend_call_function(&fci, &s_pool->creator.fcc);
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        zval_ptr_dtor(&retval);
+        cat_update_last_error(CAT_ECANCELED, "Pool creator threw an exception");
+        return NULL;
+    }
+    if (UNEXPECTED(Z_TYPE(retval) != IS_OBJECT)) {
+        cat_update_last_error(CAT_EINVAL, "Pool creator must return an object, %s returned", zend_zval_type_name(&retval));
+        zval_ptr_dtor(&retval);
+        return NULL;
+    }
+
+    /* the reference is owned by the pool now */
+    return Z_OBJ(retval);
+}
+
+static void swow_pool_destroy_item(cat_pool_t *pool, cat_data_t *item)
+{
+    swow_pool_t *s_pool = swow_pool_get_from_handle(pool);
+    zend_object *object = (zend_object *) item;
+
+    if (UNEXPECTED(swow_pool_is_in_event_loop())) {
+        /* releasing objects may call userland destructors,
+         * so we only close sockets here and release objects later */
+        zval z_object;
+        if (instanceof_function(object->ce, swow_socket_ce)) {
+            cat_socket_t *socket = &swow_socket_get_from_object(object)->socket;
+            if (cat_socket_is_available(socket)) {
+                cat_socket_close(socket);
+            }
+        }
+        if (s_pool->evicted == NULL) {
+            s_pool->evicted = zend_new_array(0);
+        }
+        ZVAL_OBJ(&z_object, object);
+        zend_hash_next_index_insert_new(s_pool->evicted, &z_object);
+        return;
+    }
+
+    OBJ_RELEASE(object);
+}
+
+static cat_bool_t swow_pool_check_item(cat_pool_t *pool, cat_data_t *item)
+{
+    swow_pool_t *s_pool = swow_pool_get_from_handle(pool);
+    zend_object *object = (zend_object *) item;
+
+    if (!swow_fcall_storage_is_available(&s_pool->checker)) {
+        if (instanceof_function(object->ce, swow_socket_ce)) {
+            return cat_socket_check_liveness(&swow_socket_get_from_object(object)->socket);
+        }
+        return cat_true;
+    }
+
+    zend_fcall_info fci;
+    zval z_item, retval;
+    bool ret;
+
+    ZVAL_OBJ(&z_item, object);
+    fci.size = sizeof(fci);
+    ZVAL_UNDEF(&fci.function_name);
+    fci.object = NULL;
+    fci.param_count = 1;
+    fci.params = &z_item;
+    fci.named_params = NULL;
+    fci.retval = &retval;
+    (void) zend_call_function(&fci, &s_pool->checker.fcc);
+    /* hand it out if checker threw, get() will put it back as a broken one */
+    ret = EG(exception) != NULL || zend_is_true(&retval);
+    zval_ptr_dtor(&retval);
+
+    return ret;
+}
+
+static zend_object *swow_pool_create_object(zend_class_entry *ce)
+{
+    swow_pool_t *s_pool = swow_object_alloc(swow_pool_t, ce, swow_pool_handlers);
+
+    s_pool->constructed = cat_false;
+    ZVAL_UNDEF(&s_pool->creator.z_callable);
+    ZVAL_UNDEF(&s_pool->checker.z_callable);
+    s_pool->evicted = NULL;
+    zend_hash_init(&s_pool->in_use, 0, NULL, ZVAL_PTR_DTOR, 0);
+
+    return &s_pool->std;
+}
+
+static void swow_pool_dtor_object(zend_object *object)
+{
+    swow_pool_t *s_pool = swow_pool_get_from_object(object);
+
+    /* try to call __destruct first */
+    zend_objects_destroy_object(object);
+
+    /* close the pool and release idle items */
+    if (s_pool->constructed && cat_pool_is_available(&s_pool->pool)) {
+        cat_pool_close(&s_pool->pool);
+    }
+    swow_pool_release_evicted(s_pool);
+}
+
+static void swow_pool_free_object(zend_object *object)
+{
+    swow_pool_t *s_pool = swow_pool_get_from_object(object);
+
+    if (s_pool->constructed && cat_pool_is_available(&s_pool->pool)) {
+        cat_pool_close(&s_pool->pool);
+    }
+    swow_pool_release_evicted(s_pool);
+    /* items which have never been put back */
+    zend_hash_destroy(&s_pool->in_use);
+    if (swow_fcall_storage_is_available(&s_pool->creator)) {
+        swow_fcall_storage_release(&s_pool->creator);
+    }
+    if (swow_fcall_storage_is_available(&s_pool->checker)) {
+        swow_fcall_storage_release(&s_pool->checker);
+    }
+
+    zend_object_std_dtor(&s_pool->std);
+}
+
+#define SWOW_POOL_GETTER_INTERNAL(object, s_pool, pool) \
+    swow_pool_t *s_pool = swow_pool_get_from_object(object); \
+    cat_pool_t *pool = &s_pool->pool
+
+#define SWOW_POOL_CHECK(s_pool) do { \
+    if (UNEXPECTED(!s_pool->constructed)) { \
+        zend_throw_error(NULL, "%s must construct first", ZEND_THIS_NAME); \
+        RETURN_THROWS(); \
+    } \
+} while (0)
+
+#define SWOW_POOL_GETTER(s_pool, pool) \
+        SWOW_POOL_GETTER_INTERNAL(Z_OBJ_P(ZEND_THIS), s_pool, pool)
+
+#define SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool) \
+        SWOW_POOL_GETTER(s_pool, pool); \
+        SWOW_POOL_CHECK(s_pool); \
+        swow_pool_release_evicted(s_pool)
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Pool___construct, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, creator, IS_CALLABLE, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxSize, IS_LONG, 0, "Swow\\Pool::DEFAULT_MAX_SIZE")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, minSize, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, idleTimeout, IS_LONG, 0, "-1")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, checker, IS_CALLABLE, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, __construct)
+{
+    SWOW_POOL_GETTER(s_pool, pool);
+    swow_fcall_storage_t creator, checker;
+    zend_long max_size = SWOW_POOL_DEFAULT_MAX_SIZE;
+    zend_long min_size = 0;
+    zend_long idle_timeout = -1;
+    cat_pool_options_t options;
+    zend_fcall_info fci = empty_fcall_info;
+
+    if (UNEXPECTED(s_pool->constructed)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    checker.fcc = empty_fcall_info_cache;
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        SWOW_PARAM_FCALL(creator)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max_size)
+        Z_PARAM_LONG(min_size)
+        Z_PARAM_LONG(idle_timeout)
+        Z_PARAM_FUNC_OR_NULL(fci, checker.fcc)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max_size <= 0 || max_size > UINT32_MAX)) {
+        zend_argument_value_error(2, "must be greater than 0 and less than or equal to %u", UINT32_MAX);
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(min_size < 0 || min_size > max_size)) {
+        zend_argument_value_error(3, "can not be negative or greater than max size");
+        RETURN_THROWS();
+    }
+
+    options.max_size = (uint32_t) max_size;
+    options.min_size = (uint32_t) min_size;
+    options.idle_timeout = (cat_timeout_t) idle_timeout;
+    if (UNEXPECTED(cat_pool_create(pool, &options, swow_pool_create_item, swow_pool_destroy_item, swow_pool_check_item, NULL) == NULL)) {
+        swow_throw_exception_with_last(swow_pool_exception_ce);
+        RETURN_THROWS();
+    }
+
+    ZVAL_COPY(&s_pool->creator.z_callable, &creator.z_callable);
+    s_pool->creator.fcc = creator.fcc;
+    if (ZEND_FCI_INITIALIZED(fci)) {
+        ZVAL_COPY(&s_pool->checker.z_callable, &fci.function_name);
+        s_pool->checker.fcc = checker.fcc;
+    }
+    s_pool->constructed = cat_true;
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_get, 0, 0, IS_OBJECT, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, get)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+    zend_long timeout = -1;
+    zend_object *object;
+    zval z_object;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    object = (zend_object *) cat_pool_get(pool, timeout);
+
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        /* creator or checker threw */
+        if (object != NULL) {
+            (void) cat_pool_put(pool, object, cat_true);
+        }
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(object == NULL)) {
+        swow_throw_exception_with_last(swow_pool_exception_ce);
+        RETURN_THROWS();
+    }
+
+    /* transfer the reference to the caller, and keep one for put() check */
+    ZVAL_OBJ_COPY(&z_object, object);
+    zend_hash_index_add_new(&s_pool->in_use, object->handle, &z_object);
+    RETURN_OBJ(object);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_put, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, item, IS_OBJECT, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, broken, _IS_BOOL, 0, "false")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, put)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+    zend_object *object;
+    zval *z_object;
+    bool broken = false;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_OBJ(object)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(broken)
+    ZEND_PARSE_PARAMETERS_END();
+
+    z_object = zend_hash_index_find(&s_pool->in_use, object->handle);
+    if (UNEXPECTED(z_object == NULL || Z_OBJ_P(z_object) != object)) {
+        swow_throw_exception(swow_pool_exception_ce, CAT_EMISUSE, "Item does not belong to the pool or has already been put back");
+        RETURN_THROWS();
+    }
+    /* the reference held by in_use is transferred to the pool */
+    GC_ADDREF(object);
+    zend_hash_index_del(&s_pool->in_use, object->handle);
+    ret = cat_pool_put(pool, object, broken);
+
+    if (UNEXPECTED(!ret)) {
+        zval z_item;
+        ZVAL_OBJ(&z_item, object);
+        zend_hash_index_add_new(&s_pool->in_use, object->handle, &z_item);
+        swow_throw_exception_with_last(swow_pool_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_fill, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, fill)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+    uint32_t count;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    count = cat_pool_fill(pool);
+
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(cat_pool_get_size(pool) < pool->options.min_size)) {
+        swow_throw_exception_with_last(swow_pool_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(count);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_close, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, close)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    ret = cat_pool_close(pool);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_pool_exception_ce);
+        RETURN_THROWS();
+    }
+}
+
+/* status */
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_getSize, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, getSize)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_pool_get_size(pool));
+}
+
+#define arginfo_class_Swow_Pool_getIdleCount arginfo_class_Swow_Pool_getSize
+
+static PHP_METHOD(Swow_Pool, getIdleCount)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_pool_get_idle_count(pool));
+}
+
+#define arginfo_class_Swow_Pool_getMaxSize arginfo_class_Swow_Pool_getSize
+
+static PHP_METHOD(Swow_Pool, getMaxSize)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(pool->options.max_size);
+}
+
+#define arginfo_class_Swow_Pool_getMinSize arginfo_class_Swow_Pool_getSize
+
+static PHP_METHOD(Swow_Pool, getMinSize)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(pool->options.min_size);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_isAvailable, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, isAvailable)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_pool_is_available(pool));
+}
+
+#define arginfo_class_Swow_Pool_hasWaiters arginfo_class_Swow_Pool_isAvailable
+
+static PHP_METHOD(Swow_Pool, hasWaiters)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_pool_has_waiters(pool));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool_getStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+/* times are in microseconds */
+static PHP_METHOD(Swow_Pool, getStats)
+{
+    SWOW_POOL_GETTER_CONSTRUCTED(s_pool, pool);
+    const cat_pool_stats_t *stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    stats = cat_pool_get_stats(pool);
+    array_init(return_value);
+    add_assoc_long(return_value, "size", cat_pool_get_size(pool));
+    add_assoc_long(return_value, "idle", cat_pool_get_idle_count(pool));
+    add_assoc_long(return_value, "get_count", stats->get_count);
+    add_assoc_long(return_value, "put_count", stats->put_count);
+    add_assoc_long(return_value, "wait_count", stats->wait_count);
+    add_assoc_long(return_value, "timeout_count", stats->timeout_count);
+    add_assoc_long(return_value, "total_wait_time", stats->total_wait_time / 1000);
+    add_assoc_long(return_value, "max_wait_time", stats->max_wait_time / 1000);
+    add_assoc_long(return_value, "create_count", stats->create_count);
+    add_assoc_long(return_value, "create_failure_count", stats->create_failure_count);
+    add_assoc_long(return_value, "total_create_time", stats->total_create_time / 1000);
+    add_assoc_long(return_value, "max_create_time", stats->max_create_time / 1000);
+    add_assoc_long(return_value, "destroy_count", stats->destroy_count);
+    add_assoc_long(return_value, "check_failure_count", stats->check_failure_count);
+    add_assoc_long(return_value, "eviction_count", stats->eviction_count);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Pool___debugInfo, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Pool, __debugInfo)
+{
+    SWOW_POOL_GETTER(s_pool, pool);
+    zval z_debug_info;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (UNEXPECTED(!s_pool->constructed)) {
+        return;
+    }
+
+    array_init(&z_debug_info);
+    add_assoc_long(&z_debug_info, "size", cat_pool_get_size(pool));
+    add_assoc_long(&z_debug_info, "idle", cat_pool_get_idle_count(pool));
+    add_assoc_long(&z_debug_info, "min_size", pool->options.min_size);
+    add_assoc_long(&z_debug_info, "max_size", pool->options.max_size);
+    add_assoc_bool(&z_debug_info, "available", cat_pool_is_available(pool));
+
+    RETURN_DEBUG_INFO_WITH_PROPERTIES(&z_debug_info);
+}
+
+static const zend_function_entry swow_pool_methods[] = {
+    PHP_ME(Swow_Pool, __construct,  arginfo_class_Swow_Pool___construct,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, get,          arginfo_class_Swow_Pool_get,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, put,          arginfo_class_Swow_Pool_put,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, fill,         arginfo_class_Swow_Pool_fill,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, close,        arginfo_class_Swow_Pool_close,        ZEND_ACC_PUBLIC)
+    /* status */
+    PHP_ME(Swow_Pool, getSize,      arginfo_class_Swow_Pool_getSize,      ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, getIdleCount, arginfo_class_Swow_Pool_getIdleCount, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, getMaxSize,   arginfo_class_Swow_Pool_getMaxSize,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, getMinSize,   arginfo_class_Swow_Pool_getMinSize,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, isAvailable,  arginfo_class_Swow_Pool_isAvailable,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, hasWaiters,   arginfo_class_Swow_Pool_hasWaiters,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Pool, getStats,     arginfo_class_Swow_Pool_getStats,     ZEND_ACC_PUBLIC)
+    /* magic */
+    PHP_ME(Swow_Pool, __debugInfo,  arginfo_class_Swow_Pool___debugInfo,  ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+static HashTable *swow_pool_get_gc(zend_object *object, zval **gc_data, int *gc_count)
+{
+    SWOW_POOL_GETTER_INTERNAL(object, s_pool, pool);
+    zend_get_gc_buffer *zgc_buffer = zend_get_gc_buffer_create();
+    uint32_t n;
+
+    zend_get_gc_buffer_add_zval(zgc_buffer, &s_pool->creator.z_callable);
+    zend_get_gc_buffer_add_zval(zgc_buffer, &s_pool->checker.z_callable);
+    if (s_pool->constructed) {
+        zval *z_object;
+        for (n = 0; n < cat_pool_get_idle_count(pool); n++) {
+            zend_get_gc_buffer_add_obj(zgc_buffer, (zend_object *) cat_pool_get_idle_item(pool, n));
+        }
+        ZEND_HASH_FOREACH_VAL(&s_pool->in_use, z_object) {
+            zend_get_gc_buffer_add_zval(zgc_buffer, z_object);
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    zend_get_gc_buffer_use(zgc_buffer, gc_data, gc_count);
+
+    return zend_std_get_properties(object);
+}
+
+zend_result swow_pool_module_init(INIT_FUNC_ARGS)
+{
+    swow_pool_ce = swow_register_internal_class(
+        "Swow\\Pool", NULL, swow_pool_methods,
+        &swow_pool_handlers, NULL,
+        cat_false, cat_false,
+        swow_pool_create_object,
+        swow_pool_free_object,
+        XtOffsetOf(swow_pool_t, std)
+    );
+    swow_pool_handlers.get_gc = swow_pool_get_gc;
+    swow_pool_handlers.dtor_obj = swow_pool_dtor_object;
+
+    zend_declare_class_constant_long(swow_pool_ce, ZEND_STRL("DEFAULT_MAX_SIZE"), SWOW_POOL_DEFAULT_MAX_SIZE);
+
+    swow_pool_exception_ce = swow_register_internal_class(
+        "Swow\\PoolException", swow_exception_ce, NULL, NULL, NULL, cat_true, cat_true, NULL, NULL, 0
+    );
+
+    return SUCCESS;
+}
@@ -18,9 +18,13 @@
 
 #include "swow_socket.h"
 #include "swow_buffer.h"
+#include "swow_channel.h" /* for Socket->acceptLoop(channel) */
+#include "swow_coroutine.h" /* for Socket->acceptLoop(callable) */
 
 #include "swow_stream.h" /* for Socket->open(stream) */
 
+#include "cat_time.h" /* for Socket->acceptLoop() */
+
 SWOW_API zend_class_entry *swow_socket_ce;
 SWOW_API zend_object_handlers swow_socket_handlers;
 
@@ -37,6 +41,8 @@ static zend_object *swow_socket_create_object(zend_class_entry *ce)
     swow_socket_t *s_socket = swow_object_alloc(swow_socket_t, ce, swow_socket_handlers);
 
     cat_socket_init(&s_socket->socket);
+    /* uint32 big-endian length prefix by default */
+    (void) cat_socket_frame_format_init(&s_socket->frame_format, 4, cat_false, 0, 0);
 
     return &s_socket->std;
 }
@@ -450,32 +456,19 @@ static PHP_METHOD(Swow_Socket, listen)
     RETURN_THIS();
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_accept, 0, 0, IS_STATIC, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
-ZEND_END_ARG_INFO()
-
-static PHP_METHOD(Swow_Socket, accept)
+/* wait for a connection (up to timeout) if wait is true, otherwise only take the pending one without blocking */
+static swow_socket_t *swow_socket_accept_connection(swow_socket_t *s_server, zend_class_entry *ce, zend_long timeout, bool wait)
 {
-    SWOW_SOCKET_GETTER(s_server, server);
+    cat_socket_t *server = &s_server->socket;
     cat_socket_type_t server_type = cat_socket_get_simple_type(server);
-    zend_long timeout;
-    bool timeout_is_null = 1;
     swow_socket_t *s_connection;
     cat_socket_t *connection;
     cat_bool_t ret;
 
-    ZEND_PARSE_PARAMETERS_START(0, 1)
-        Z_PARAM_OPTIONAL
-        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
-    ZEND_PARSE_PARAMETERS_END();
-
-    s_connection = swow_socket_get_from_object(
-        swow_socket_create_object(Z_OBJCE_P(ZEND_THIS))
-    );
+    s_connection = swow_socket_get_from_object(swow_socket_create_object(ce));
     connection = &s_connection->socket;
-    if (timeout_is_null) {
-        timeout = cat_socket_get_accept_timeout(server);
-    }
+    /* connections inherit the frame format of the server */
+    s_connection->frame_format = s_server->frame_format;
 
     if (likely(server_type != CAT_SOCKET_TYPE_ANY)) {
         ret = cat_socket_create(connection, server_type) != NULL;
@@ -484,7 +477,11 @@ static PHP_METHOD(Swow_Socket, accept)
         }
     } /* else server has not been constructed, but error will be triggered later in socket_accept() */
 
-    ret = cat_socket_accept_ex(server, connection, timeout);
+    if (wait) {
+        ret = cat_socket_accept_ex(server, connection, timeout);
+    } else {
+        ret = cat_socket_try_accept(server, connection);
+    }
 
     if (UNEXPECTED(!ret)) {
         if (server_type != CAT_SOCKET_TYPE_ANY) {
@@ -492,6 +489,35 @@ static PHP_METHOD(Swow_Socket, accept)
         }
         _creation_error:
         zend_object_release(&s_connection->std);
+        return NULL;
+    }
+
+    return s_connection;
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_accept, 0, 0, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, accept)
+{
+    SWOW_SOCKET_GETTER(s_server, server);
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    swow_socket_t *s_connection;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (timeout_is_null) {
+        timeout = cat_socket_get_accept_timeout(server);
+    }
+
+    s_connection = swow_socket_accept_connection(s_server, Z_OBJCE_P(ZEND_THIS), timeout, true);
+
+    if (UNEXPECTED(s_connection == NULL)) {
         swow_throw_exception_with_last(swow_socket_exception_ce);
         RETURN_THROWS();
     }
@@ -499,6 +525,137 @@ static PHP_METHOD(Swow_Socket, accept)
     RETURN_OBJ(&s_connection->std);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_acceptBatch, 0, 0, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxCount, IS_LONG, 0, "64")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, acceptBatch)
+{
+    SWOW_SOCKET_GETTER(s_server, server);
+    zend_long max_count = 64;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    swow_socket_t *s_connection;
+
+    ZEND_PARSE_PARAMETERS_START(0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max_count)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max_count <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_accept_timeout(server);
+    }
+
+    s_connection = swow_socket_accept_connection(s_server, Z_OBJCE_P(ZEND_THIS), timeout, true);
+
+    if (UNEXPECTED(s_connection == NULL)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    array_init(return_value);
+    add_next_index_object(return_value, &s_connection->std);
+    /* then drain the connections which are already pending,
+     * the error (if any) will be reported by the next call */
+    while (--max_count > 0) {
+        s_connection = swow_socket_accept_connection(s_server, Z_OBJCE_P(ZEND_THIS), 0, false);
+        if (s_connection == NULL) {
+            break;
+        }
+        add_next_index_object(return_value, &s_connection->std);
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_acceptLoop, 0, 1, IS_VOID, 0)
+    ZEND_ARG_OBJ_TYPE_MASK(0, handler, Swow\\Channel, MAY_BE_CALLABLE, NULL)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxCountPerTick, IS_LONG, 0, "64")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, acceptLoop)
+{
+    SWOW_SOCKET_GETTER(s_server, server);
+    zval *z_handler;
+    zend_long max_count_per_tick = 64;
+    cat_channel_t *channel = NULL;
+    swow_socket_t *s_connection;
+    zend_long count;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ZVAL(z_handler)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max_count_per_tick)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (Z_TYPE_P(z_handler) == IS_OBJECT && instanceof_function(Z_OBJCE_P(z_handler), swow_channel_ce)) {
+        swow_channel_t *s_channel = swow_channel_get_from_object(Z_OBJ_P(z_handler));
+        if (UNEXPECTED(!swow_channel_has_constructed(s_channel))) {
+            zend_argument_value_error(1, "must be a constructed channel");
+            RETURN_THROWS();
+        }
+        channel = &s_channel->channel;
+    } else if (UNEXPECTED(!zend_is_callable(z_handler, 0, NULL))) {
+        zend_argument_type_error(1, "must be of type Swow\\Channel|callable, %s given", zend_zval_type_name(z_handler));
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(max_count_per_tick <= 0)) {
+        zend_argument_value_error(2, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    while (1) {
+        for (count = 0; count < max_count_per_tick; count++) {
+            zval z_connection;
+            /* only the first one of each tick waits for the new connection */
+            s_connection = swow_socket_accept_connection(s_server, Z_OBJCE_P(ZEND_THIS), -1, count == 0);
+            if (s_connection == NULL) {
+                if (count > 0) {
+                    /* backlog has been drained */
+                    break;
+                }
+                if (!cat_socket_is_available(server)) {
+                    /* server has been closed */
+                    return;
+                }
+                swow_throw_exception_with_last(swow_socket_exception_ce);
+                RETURN_THROWS();
+            }
+            ZVAL_OBJ(&z_connection, &s_connection->std);
+            if (channel != NULL) {
+                if (UNEXPECTED(!cat_channel_push(channel, &z_connection, -1))) {
+                    zval_ptr_dtor(&z_connection);
+                    swow_throw_exception_with_last(swow_channel_exception_ce);
+                    RETURN_THROWS();
+                }
+            } else {
+                swow_coroutine_t *s_coroutine = swow_coroutine_create(z_handler);
+                if (UNEXPECTED(s_coroutine == NULL)) {
+                    zval_ptr_dtor(&z_connection);
+                    swow_throw_exception_with_last(swow_coroutine_exception_ce);
+                    RETURN_THROWS();
+                }
+                ret = swow_coroutine_resume(s_coroutine, &z_connection, NULL);
+                swow_coroutine_close(s_coroutine);
+                zval_ptr_dtor(&z_connection);
+                if (UNEXPECTED(!ret)) {
+                    swow_throw_exception_with_last(swow_coroutine_exception_ce);
+                    RETURN_THROWS();
+                }
+            }
+        }
+        if (count == max_count_per_tick) {
+            /* do not starve the established connections when there is a connection flood */
+            (void) cat_time_delay(0);
+        }
+    }
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_acceptTo, 0, 1, IS_STATIC, 0)
     ZEND_ARG_OBJ_INFO(0, connection, Swow\\Socket, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
@@ -616,6 +773,8 @@ static PHP_METHOD(Swow_Socket, enableCrypto)
         swow_hash_str_fetch_str(options_array, "certificate_key", &options.certificate_key);
         swow_hash_str_fetch_bool(options_array, "no_ticket", &options.no_ticket);
         swow_hash_str_fetch_bool(options_array, "no_compression", &options.no_compression);
+        swow_hash_str_fetch_bool(options_array, "no_session_cache", &options.no_session_cache);
+        swow_hash_str_fetch_bool(options_array, "ktls", &options.ktls);
         swow_hash_str_fetch_str(options_array, "passphrase", &options.passphrase);
         // TODO: SNI related things
         if (is_client) {
@@ -871,159 +1030,534 @@ static PHP_METHOD(Swow_Socket, recvDataFrom)
     SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_LVAL_P(return_value) == 0);
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_peek, 0, 1, IS_LONG, 0)
-    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "0")
-ZEND_END_ARG_INFO()
-
-static PHP_METHOD(Swow_Socket, peek)
-{
-    PHP_METHOD_CALL(Swow_Socket, _read, 1, 0, 1);
-}
-
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_peekFrom, 0, 1, IS_LONG, 0)
-    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
-    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, address, "null")
-    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, port, "null")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "0")
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvBatch, 0, 1, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, buffers, IS_ARRAY, 0)
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, addresses, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, ports, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, segmentSizes, "null")
 ZEND_END_ARG_INFO()
 
-static PHP_METHOD(Swow_Socket, peekFrom)
-{
-    PHP_METHOD_CALL(Swow_Socket, _read, 1, 1, 1);
-}
-
-static PHP_METHOD_EX(Swow_Socket, _readString, bool once, bool may_address, bool peek)
+static PHP_METHOD(Swow_Socket, recvBatch)
 {
     SWOW_SOCKET_GETTER(s_socket, socket);
-    uint32_t max_num_args;
-    zend_string *string;
-    zend_long size = CAT_BUFFER_COMMON_SIZE;
-    zval *z_address = NULL, *z_port = NULL;
+    HashTable *buffers_array;
+    zval *z_addresses = NULL, *z_ports = NULL, *z_segment_sizes = NULL;
     zend_long timeout;
-    bool timeout_is_null = !peek;
-    char *ptr;
-    cat_bool_t want_address;
-    ssize_t ret;
-
-    max_num_args = 2;
-    if (may_address) {
-        max_num_args += 2;
-    }
-    if (peek) {
-        timeout = 0;
-    }
-
-    ZEND_PARSE_PARAMETERS_START(0, max_num_args)
+    bool timeout_is_null = 1;
+    cat_socket_datagram_t *datagrams;
+    swow_buffer_t **s_buffers;
+    uint32_t count, locked_count = 0, index = 0;
+    zval *z_buffer;
+    ssize_t n, i;
+
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        Z_PARAM_ARRAY_HT(buffers_array)
         Z_PARAM_OPTIONAL
-        Z_PARAM_LONG(size)
-        if (may_address) {
-            Z_PARAM_ZVAL(z_address)
-            Z_PARAM_ZVAL(z_port)
-        }
+        Z_PARAM_ZVAL(z_addresses)
+        Z_PARAM_ZVAL(z_ports)
         Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+        Z_PARAM_ZVAL(z_segment_sizes)
     ZEND_PARSE_PARAMETERS_END();
 
-    /* check args and initialize */
-    if (UNEXPECTED(size <= 0)) {
-        zend_argument_value_error(1, "must be greater than 0");
+    count = zend_hash_num_elements(buffers_array);
+    if (UNEXPECTED(count == 0)) {
+        zend_argument_value_error(1, "can not be empty");
         RETURN_THROWS();
     }
     if (timeout_is_null) {
         timeout = cat_socket_get_read_timeout(socket);
     }
-    string = zend_string_alloc(size, 0);
-    if (!may_address) {
-        want_address = cat_false;
-    } else {
-        want_address = z_address != NULL || z_port != NULL;
+
+    datagrams = (cat_socket_datagram_t *) emalloc(sizeof(*datagrams) * count);
+    s_buffers = (swow_buffer_t **) emalloc(sizeof(*s_buffers) * count);
+
+    /* check args and lock buffers,
+     * every received datagram replaces the content of its buffer */
+    ZEND_HASH_FOREACH_VAL(buffers_array, z_buffer) {
+        swow_buffer_t *s_buffer;
+        zend_long size = -1;
+        char *ptr;
+        ZVAL_DEREF(z_buffer);
+        if (UNEXPECTED(Z_TYPE_P(z_buffer) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(z_buffer), swow_buffer_ce))) {
+            zend_argument_type_error(1, "[%u] must be of type %s, %s given", index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_buffer));
+            goto _error;
+        }
+        s_buffer = swow_buffer_get_from_object(Z_OBJ_P(z_buffer));
+        ptr = swow_buffer_get_writable_space_v(s_buffer, 0, &size, 1, index, 0);
+        if (UNEXPECTED(ptr == NULL)) {
+            goto _error;
+        }
+        SWOW_BUFFER_LOCK_EX(s_buffer, goto _error);
+        swow_buffer_cow(s_buffer);
+        /* buffer value may be changed by COW */
+        datagrams[index].buffer = s_buffer->buffer.value;
+        datagrams[index].size = (size_t) size;
+        s_buffers[locked_count++] = s_buffer;
+        index++;
+    } ZEND_HASH_FOREACH_END();
+
+    n = cat_socket_recvfrom_many_ex(socket, datagrams, count, timeout);
+
+    for (i = 0; i < (ssize_t) locked_count; i++) {
+        if (i < n) {
+            swow_buffer_update(s_buffers[i], datagrams[i].length);
+        }
+        SWOW_BUFFER_UNLOCK(s_buffers[i]);
     }
+    locked_count = 0;
 
-    ptr = ZSTR_VAL(string);
-    while (1) {
-        if (!want_address) {
-            if (!peek) {
-                if (!once) {
-                    ret = cat_socket_read_ex(socket, ptr, size, timeout);
-                } else {
-                    ret = cat_socket_recv_ex(socket, ptr, size, timeout);
-                }
-            } else {
-                ret = cat_socket_peek_ex(socket, ptr, size, timeout);
-            }
-        } else {
+    if (z_addresses != NULL || z_ports != NULL) {
+        zval z_address_list, z_port_list;
+        if (z_addresses != NULL) {
+            array_init_size(&z_address_list, n > 0 ? (uint32_t) n : 0);
+        }
+        if (z_ports != NULL) {
+            array_init_size(&z_port_list, n > 0 ? (uint32_t) n : 0);
+        }
+        for (i = 0; i < n; i++) {
             char address[CAT_SOCKADDR_MAX_PATH];
             size_t address_length = sizeof(address);
-            int port;
-            if (!peek) {
-                ZEND_ASSERT(once);
-                ret = cat_socket_recv_from_ex(socket, ptr, size, address, &address_length, &port, timeout);
-            } else {
-                ret = cat_socket_peek_from_ex(socket, ptr, size, address, &address_length, &port, timeout);
+            int port = 0;
+            if (datagrams[i].address.length == 0 ||
+                cat_sockaddr_to_name_silent(&datagrams[i].address.address.common, datagrams[i].address.length, address, &address_length, &port) != 0) {
+                address_length = 0;
             }
-            if (z_address != NULL) {
-                if (address_length == 0 || address_length > sizeof(address)) {
-                    ZEND_TRY_ASSIGN_REF_EMPTY_STRING(z_address);
-                } else {
-                    ZEND_TRY_ASSIGN_REF_STRINGL(z_address, address, address_length);
-                }
+            if (z_addresses != NULL) {
+                add_next_index_stringl(&z_address_list, address, address_length);
             }
-            if (z_port != NULL) {
-                ZEND_TRY_ASSIGN_REF_LONG(z_port, port);
+            if (z_ports != NULL) {
+                add_next_index_long(&z_port_list, port);
             }
         }
-        break;
+        if (z_addresses != NULL) {
+            ZEND_TRY_ASSIGN_REF_ARR(z_addresses, Z_ARR(z_address_list));
+        }
+        if (z_ports != NULL) {
+            ZEND_TRY_ASSIGN_REF_ARR(z_ports, Z_ARR(z_port_list));
+        }
     }
-
-    /* solve string return value */
-    if (EXPECTED(ret > 0)) {
-        ZSTR_VAL(string)[ZSTR_LEN(string) = ret] = '\0';
-    } else {
-        zend_string_release_ex(string, 0);
-        string = zend_empty_string;
+    if (z_segment_sizes != NULL) {
+        zval z_segment_size_list;
+        array_init_size(&z_segment_size_list, n > 0 ? (uint32_t) n : 0);
+        for (i = 0; i < n; i++) {
+            add_next_index_long(&z_segment_size_list, (zend_long) datagrams[i].segment_size);
+        }
+        ZEND_TRY_ASSIGN_REF_ARR(z_segment_sizes, Z_ARR(z_segment_size_list));
     }
 
     /* also for socket exception getReturnValue */
-    RETVAL_STR(string);
+    RETVAL_LONG(n);
 
-    /* handle error */
-    if (UNEXPECTED(ret < 0 || (!once && ret != size))) {
+    if (UNEXPECTED(n < 0)) {
         swow_throw_call_exception_with_last(swow_socket_exception_ce);
-        RETURN_THROWS();
+        goto _error;
     }
-}
-
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_readString, 0, 0, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "Swow\\Buffer::COMMON_SIZE")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
-ZEND_END_ARG_INFO()
 
-static PHP_METHOD(Swow_Socket, readString)
-{
-    PHP_METHOD_CALL(Swow_Socket, _readString, 0, 0, 0);
+    if (0) {
+        _error:
+        ZEND_ASSERT_HAS_EXCEPTION();
+        while (locked_count--) {
+            SWOW_BUFFER_UNLOCK(s_buffers[locked_count]);
+        }
+    }
+    efree(s_buffers);
+    efree(datagrams);
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvString, 0, 0, IS_STRING, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "Swow\\Buffer::COMMON_SIZE")
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvUntil, 0, 2, IS_LONG, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO(0, delimiter, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxLength, IS_LONG, 0, "-1")
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
 ZEND_END_ARG_INFO()
 
-static PHP_METHOD(Swow_Socket, recvString)
+static PHP_METHOD(Swow_Socket, recvUntil)
 {
-    PHP_METHOD_CALL(Swow_Socket, _readString, 1, 0, 0);
-}
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    zend_object *buffer_object;
+    zend_string *delimiter;
+    zend_long max_length = -1;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    swow_buffer_t *s_buffer;
+    cat_buffer_t *buffer;
+    ssize_t ret;
 
-#define arginfo_class_Swow_Socket_recvStringData arginfo_class_Swow_Socket_recvString
+    ZEND_PARSE_PARAMETERS_START(2, 4)
+        Z_PARAM_OBJ_OF_CLASS(buffer_object, swow_buffer_ce)
+        Z_PARAM_STR(delimiter)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max_length)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
 
-static PHP_METHOD(Swow_Socket, recvStringData)
-{
-    PHP_METHOD_CALL(Swow_Socket, recvString);
-    SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_STRLEN_P(return_value) == 0);
-}
+    /* check args and initialize */
+    s_buffer = swow_buffer_get_from_object(buffer_object);
+    buffer = &s_buffer->buffer;
+    if (UNEXPECTED(ZSTR_LEN(delimiter) == 0)) {
+        zend_argument_value_error(2, "can not be empty");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(max_length != -1 && (max_length < 0 || (size_t) max_length < ZSTR_LEN(delimiter)))) {
+        zend_argument_value_error(3, "must be -1 or greater than or equal to the length of argument #2 ($delimiter)");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+
+    SWOW_BUFFER_LOCK(s_buffer);
+
+    swow_buffer_cow(s_buffer);
+
+    /* the frame is appended to the buffer,
+     * grow it if the writable space is not enough */
+    if (max_length == -1) {
+        max_length = buffer->size - buffer->length;
+    } else if ((size_t) max_length > buffer->size - buffer->length) {
+        if (UNEXPECTED(!cat_buffer_extend(buffer, buffer->length + max_length))) {
+            SWOW_BUFFER_UNLOCK(s_buffer);
+            swow_throw_exception_with_last(swow_buffer_exception_ce);
+            RETURN_THROWS();
+        }
+    }
+    if (UNEXPECTED((size_t) max_length < ZSTR_LEN(delimiter))) {
+        SWOW_BUFFER_UNLOCK(s_buffer);
+        zend_argument_value_error(1, "does not have enough writable space for the delimiter");
+        RETURN_THROWS();
+    }
+
+    ret = cat_socket_recv_until_ex(
+        socket, buffer->value + buffer->length, max_length,
+        ZSTR_VAL(delimiter), ZSTR_LEN(delimiter), timeout
+    );
+
+    SWOW_BUFFER_UNLOCK(s_buffer);
+
+    if (EXPECTED(ret > 0)) {
+        swow_buffer_virtual_write(s_buffer, buffer->length, ret);
+    }
+
+    /* also for socket exception getReturnValue */
+    RETVAL_LONG(ret);
+
+    /* handle error */
+    if (UNEXPECTED(ret < 0)) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setFrameFormat, 0, 0, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, lengthSize, IS_LONG, 0, "4")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, littleEndian, _IS_BOOL, 0, "false")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, lengthOffset, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxLength, IS_LONG, 0, "0")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setFrameFormat)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    zend_long length_size = 4;
+    bool little_endian = 0;
+    zend_long length_offset = 0;
+    zend_long max_length = 0;
+    cat_socket_frame_format_t format;
+
+    ZEND_PARSE_PARAMETERS_START(0, 4)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(length_size)
+        Z_PARAM_BOOL(little_endian)
+        Z_PARAM_LONG(length_offset)
+        Z_PARAM_LONG(max_length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(length_size != 1 && length_size != 2 && length_size != 4 && length_size != 8)) {
+        zend_argument_value_error(1, "must be 1, 2, 4 or 8");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(length_offset < 0 || length_offset > CAT_SOCKET_FRAME_HEADER_MAX_SIZE - length_size)) {
+        zend_argument_value_error(3, "must be between 0 and " ZEND_LONG_FMT, (zend_long) (CAT_SOCKET_FRAME_HEADER_MAX_SIZE - length_size));
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(max_length < 0)) {
+        zend_argument_value_error(4, "can not be negative");
+        RETURN_THROWS();
+    }
+
+    (void) socket;
+    if (UNEXPECTED(!cat_socket_frame_format_init(&format, length_size, little_endian, length_offset, max_length))) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+    s_socket->frame_format = format;
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_getFrameFormat, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, getFrameFormat)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    const cat_socket_frame_format_t *format = &s_socket->frame_format;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    (void) socket;
+    array_init(return_value);
+    add_assoc_long(return_value, "length_size", format->length_size);
+    add_assoc_bool(return_value, "little_endian", format->little_endian);
+    add_assoc_long(return_value, "length_offset", (zend_long) format->length_offset);
+    add_assoc_long(return_value, "max_length", (zend_long) format->max_length);
+}
+
+#define SWOW_SOCKET_RECV_FRAMES_MAX_COUNT 65536
+
+static PHP_METHOD_EX(Swow_Socket, _recvFrame, bool batch)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    zend_object *buffer_object;
+    zend_long max_count = 1;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    swow_buffer_t *s_buffer;
+    size_t lengths_on_stack[16], *lengths = lengths_on_stack;
+    ssize_t n, i;
+
+    ZEND_PARSE_PARAMETERS_START(1, batch ? 3 : 2)
+        Z_PARAM_OBJ_OF_CLASS(buffer_object, swow_buffer_ce)
+        Z_PARAM_OPTIONAL
+        if (batch) {
+            Z_PARAM_LONG(max_count)
+        }
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* check args and initialize */
+    s_buffer = swow_buffer_get_from_object(buffer_object);
+    if (UNEXPECTED(max_count <= 0)) {
+        zend_argument_value_error(2, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+    /* it is limited by the data which has been received, so a huge one is meaningless */
+    if (UNEXPECTED(max_count > SWOW_SOCKET_RECV_FRAMES_MAX_COUNT)) {
+        max_count = SWOW_SOCKET_RECV_FRAMES_MAX_COUNT;
+    }
+    if (UNEXPECTED((size_t) max_count > CAT_ARRAY_SIZE(lengths_on_stack))) {
+        lengths = (size_t *) safe_emalloc((size_t) max_count, sizeof(*lengths), 0);
+    }
+
+    SWOW_BUFFER_LOCK_EX(s_buffer, goto _out);
+
+    /* bodies are appended to the buffer, and buffer will be extended if needed */
+    swow_buffer_cow(s_buffer);
+
+    n = cat_socket_recv_frames_ex(socket, &s_socket->frame_format, &s_buffer->buffer, lengths, max_count, timeout);
+
+    SWOW_BUFFER_UNLOCK(s_buffer);
+
+    if (UNEXPECTED(n < 0)) {
+        /* also for socket exception getReturnValue */
+        RETVAL_LONG(n);
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        goto _out;
+    }
+
+    if (!batch) {
+        RETVAL_LONG((zend_long) lengths[0]);
+    } else {
+        array_init_size(return_value, (uint32_t) n);
+        for (i = 0; i < n; i++) {
+            add_next_index_long(return_value, (zend_long) lengths[i]);
+        }
+    }
+
+    _out:
+    if (UNEXPECTED(lengths != lengths_on_stack)) {
+        efree(lengths);
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvFrame, 0, 1, IS_LONG, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, recvFrame)
+{
+    PHP_METHOD_CALL(Swow_Socket, _recvFrame, 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvFrames, 0, 1, IS_ARRAY, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxCount, IS_LONG, 0, "64")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, recvFrames)
+{
+    PHP_METHOD_CALL(Swow_Socket, _recvFrame, 1);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_peek, 0, 1, IS_LONG, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "0")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, peek)
+{
+    PHP_METHOD_CALL(Swow_Socket, _read, 1, 0, 1);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_peekFrom, 0, 1, IS_LONG, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, address, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, port, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "0")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, peekFrom)
+{
+    PHP_METHOD_CALL(Swow_Socket, _read, 1, 1, 1);
+}
+
+static PHP_METHOD_EX(Swow_Socket, _readString, bool once, bool may_address, bool peek)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    uint32_t max_num_args;
+    zend_string *string;
+    zend_long size = CAT_BUFFER_COMMON_SIZE;
+    zval *z_address = NULL, *z_port = NULL;
+    zend_long timeout;
+    bool timeout_is_null = !peek;
+    char *ptr;
+    cat_bool_t want_address;
+    ssize_t ret;
+
+    max_num_args = 2;
+    if (may_address) {
+        max_num_args += 2;
+    }
+    if (peek) {
+        timeout = 0;
+    }
+
+    ZEND_PARSE_PARAMETERS_START(0, max_num_args)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(size)
+        if (may_address) {
+            Z_PARAM_ZVAL(z_address)
+            Z_PARAM_ZVAL(z_port)
+        }
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* check args and initialize */
+    if (UNEXPECTED(size <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+    string = zend_string_alloc(size, 0);
+    if (!may_address) {
+        want_address = cat_false;
+    } else {
+        want_address = z_address != NULL || z_port != NULL;
+    }
+
+    ptr = ZSTR_VAL(string);
+    while (1) {
+        if (!want_address) {
+            if (!peek) {
+                if (!once) {
+                    ret = cat_socket_read_ex(socket, ptr, size, timeout);
+                } else {
+                    ret = cat_socket_recv_ex(socket, ptr, size, timeout);
+                }
+            } else {
+                ret = cat_socket_peek_ex(socket, ptr, size, timeout);
+            }
+        } else {
+            char address[CAT_SOCKADDR_MAX_PATH];
+            size_t address_length = sizeof(address);
+            int port;
+            if (!peek) {
+                ZEND_ASSERT(once);
+                ret = cat_socket_recv_from_ex(socket, ptr, size, address, &address_length, &port, timeout);
+            } else {
+                ret = cat_socket_peek_from_ex(socket, ptr, size, address, &address_length, &port, timeout);
+            }
+            if (z_address != NULL) {
+                if (address_length == 0 || address_length > sizeof(address)) {
+                    ZEND_TRY_ASSIGN_REF_EMPTY_STRING(z_address);
+                } else {
+                    ZEND_TRY_ASSIGN_REF_STRINGL(z_address, address, address_length);
+                }
+            }
+            if (z_port != NULL) {
+                ZEND_TRY_ASSIGN_REF_LONG(z_port, port);
+            }
+        }
+        break;
+    }
+
+    /* solve string return value */
+    if (EXPECTED(ret > 0)) {
+        ZSTR_VAL(string)[ZSTR_LEN(string) = ret] = '\0';
+    } else {
+        zend_string_release_ex(string, 0);
+        string = zend_empty_string;
+    }
+
+    /* also for socket exception getReturnValue */
+    RETVAL_STR(string);
+
+    /* handle error */
+    if (UNEXPECTED(ret < 0 || (!once && ret != size))) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_readString, 0, 0, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "Swow\\Buffer::COMMON_SIZE")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, readString)
+{
+    PHP_METHOD_CALL(Swow_Socket, _readString, 0, 0, 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvString, 0, 0, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "Swow\\Buffer::COMMON_SIZE")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, recvString)
+{
+    PHP_METHOD_CALL(Swow_Socket, _readString, 1, 0, 0);
+}
+
+#define arginfo_class_Swow_Socket_recvStringData arginfo_class_Swow_Socket_recvString
+
+static PHP_METHOD(Swow_Socket, recvStringData)
+{
+    PHP_METHOD_CALL(Swow_Socket, recvString);
+    SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_STRLEN_P(return_value) == 0);
+}
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvStringFrom, 0, 0, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "Swow\\Buffer::COMMON_SIZE")
@@ -1067,7 +1601,7 @@ static PHP_METHOD(Swow_Socket, peekStringFrom)
     PHP_METHOD_CALL(Swow_Socket, _readString, 1, 1, 1);
 }
 
-static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address)
+static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address, bool frame)
 {
     SWOW_SOCKET_GETTER(s_socket, socket);
     uint32_t max_num_args;
@@ -1185,7 +1719,8 @@ static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address)
                     length = -1;
                     vector_list_array_index++;
                 } ZEND_HASH_FOREACH_END();
-                if (UNEXPECTED(vector_count == 0)) {
+                /* a frame with empty body still has its header */
+                if (UNEXPECTED(vector_count == 0) && !frame) {
                     goto _return;
                 }
             } while (0);
@@ -1202,11 +1737,226 @@ static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address)
             Z_PARAM_LONG(port)
         }
         Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
-    ZEND_PARSE_PARAMETERS_END_EX(goto _error);
+    ZEND_PARSE_PARAMETERS_END_EX(goto _error);
+
+    /* check args and initialize */
+    if (single) {
+        ptr = swow_buffer_or_string_get_readable_space(s_buffer, string, start, &length, 1);
+        if (UNEXPECTED(ptr == NULL)) {
+            goto _error;
+        }
+        if (s_buffer != NULL) {
+            zend_string *buffer_string = swow_buffer_get_string(s_buffer);
+            if (buffer_string != NULL) {
+                strings[buffer_count++] = zend_string_copy(buffer_string);
+            }
+        }
+        vector[0].base = ptr;
+        vector[0].length = length;
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+
+    /* write */
+    if (frame) {
+        ret = cat_socket_write_frame_ex(socket, &s_socket->frame_format, vector, vector_count, timeout);
+    } else if (!may_address || address == NULL || ZSTR_LEN(address) == 0) {
+        ret = cat_socket_write_ex(socket, vector, vector_count, timeout);
+    } else {
+        ret = cat_socket_write_to_ex(socket, vector, vector_count, ZSTR_VAL(address), ZSTR_LEN(address), port, timeout);
+    }
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        goto _error;
+    }
+
+    _return:
+    RETVAL_THIS();
+
+    if (0) {
+        _error:
+        ZEND_ASSERT_HAS_EXCEPTION();
+    }
+    while (buffer_count--) {
+        zend_string_release(strings[buffer_count]);
+    }
+    if (UNEXPECTED(strings_on_heap != NULL)) {
+        efree(strings_on_heap);
+    }
+    if (UNEXPECTED(vector_list_on_heap != NULL)) {
+        efree(vector_list_on_heap);
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_write, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, vector, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, write)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 0, 0, 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_writeTo, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, vector, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, writeTo)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 0, 1, 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_send, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, start, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "-1")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, send)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 1, 0, 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendTo, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, start, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "-1")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, sendTo)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 1, 1, 0);
+}
+
+#define arginfo_class_Swow_Socket_writeFrame arginfo_class_Swow_Socket_write
+
+static PHP_METHOD(Swow_Socket, writeFrame)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 0, 0, 1);
+}
+
+#define arginfo_class_Swow_Socket_sendFrame arginfo_class_Swow_Socket_send
+
+static PHP_METHOD(Swow_Socket, sendFrame)
+{
+    PHP_METHOD_CALL(Swow_Socket, _write, 1, 0, 1);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendBatch, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, datagrams, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, segmentSize, IS_LONG, 0, "0")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, sendBatch)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    HashTable *datagrams_array;
+    zend_string *address = NULL;
+    zend_long port = 0;
+    bool port_is_null = 1;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    zend_long segment_size = 0;
+    cat_sockaddr_info_t default_address;
+    cat_socket_datagram_t *datagrams;
+    /* Use addref/release for buffer strings to make sure data is immutable (COW) */
+    zend_string **strings;
+    uint32_t count, buffer_count = 0, index = 0;
+    zval *z_datagram;
+    ssize_t n;
+
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        Z_PARAM_ARRAY_HT(datagrams_array)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_OR_NULL(address)
+        Z_PARAM_LONG_OR_NULL(port, port_is_null)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+        Z_PARAM_LONG(segment_size)
+    ZEND_PARSE_PARAMETERS_END();
 
-    /* check args and initialize */
-    if (single) {
-        ptr = swow_buffer_or_string_get_readable_space(s_buffer, string, start, &length, 1);
+    count = zend_hash_num_elements(datagrams_array);
+    if (UNEXPECTED(count == 0)) {
+        zend_argument_value_error(1, "can not be empty");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(segment_size < 0 || segment_size > UINT16_MAX)) {
+        zend_argument_value_error(5, "must be between 0 and %u", UINT16_MAX);
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_write_timeout(socket);
+    }
+    default_address.length = 0;
+    if (address != NULL && ZSTR_LEN(address) != 0) {
+        if (UNEXPECTED(!cat_socket_getaddrbyname(socket, &default_address, ZSTR_VAL(address), ZSTR_LEN(address), port))) {
+            swow_throw_call_exception_with_last(swow_socket_exception_ce);
+            RETURN_THROWS();
+        }
+    }
+
+    datagrams = (cat_socket_datagram_t *) emalloc(sizeof(*datagrams) * count);
+    strings = (zend_string **) emalloc(sizeof(*strings) * count);
+
+    ZEND_HASH_FOREACH_VAL(datagrams_array, z_datagram) {
+        cat_socket_datagram_t *datagram = &datagrams[index];
+        swow_buffer_t *s_buffer = NULL;
+        zend_string *string = NULL;
+        zend_string *datagram_address = NULL;
+        zend_long datagram_port = port;
+        zend_long length = -1;
+        const char *ptr;
+        ZVAL_DEREF(z_datagram);
+        if (Z_TYPE_P(z_datagram) == IS_ARRAY) {
+            /* [$data, $address, $port] */
+            zval *z_tmp;
+            uint32_t item_index = 0;
+            ZEND_HASH_FOREACH_VAL(Z_ARR_P(z_datagram), z_tmp) {
+                ZVAL_DEREF(z_tmp);
+                if (item_index == 0) {
+                    if (!swow_parse_arg_buffer_or_stringable_for_reading(z_tmp, &s_buffer, &string, 1)) {
+                        zend_argument_type_error(1, "[%u][0] ($data) must be of type string or %s, %s given", index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                } else if (item_index == 1) {
+                    if (Z_TYPE_P(z_tmp) == IS_STRING) {
+                        datagram_address = Z_STR_P(z_tmp);
+                    } else if (UNEXPECTED(Z_TYPE_P(z_tmp) != IS_NULL)) {
+                        zend_argument_type_error(1, "[%u][1] ($address) must be of type ?string, %s given", index, zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                } else if (item_index == 2) {
+                    if (Z_TYPE_P(z_tmp) != IS_NULL && UNEXPECTED(!swow_parse_arg_long(z_tmp, &datagram_port, NULL, false, 1))) {
+                        zend_argument_type_error(1, "[%u][2] ($port) must be of type ?int, %s given", index, zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                } else {
+                    zend_argument_value_error(1, "[%u] must have at most 3 elements", index);
+                    goto _error;
+                }
+                item_index++;
+            } ZEND_HASH_FOREACH_END();
+            if (UNEXPECTED(item_index == 0)) {
+                zend_argument_value_error(1, "[%u] can not be empty", index);
+                goto _error;
+            }
+        } else if (!swow_parse_arg_buffer_or_stringable_for_reading(z_datagram, &s_buffer, &string, 1)) {
+            zend_argument_type_error(1, "[%u] must be of type string, array or %s, %s given", index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_datagram));
+            goto _error;
+        }
+        ptr = swow_buffer_or_string_get_readable_space_v(s_buffer, string, 0, &length, 1, index, 1);
         if (UNEXPECTED(ptr == NULL)) {
             goto _error;
         }
@@ -1216,26 +1966,27 @@ static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address)
                 strings[buffer_count++] = zend_string_copy(buffer_string);
             }
         }
-        vector[0].base = ptr;
-        vector[0].length = length;
-    }
-    if (timeout_is_null) {
-        timeout = cat_socket_get_read_timeout(socket);
-    }
+        datagram->buffer = (char *) ptr;
+        datagram->length = (size_t) length;
+        datagram->segment_size = (size_t) segment_size;
+        if (datagram_address != NULL && ZSTR_LEN(datagram_address) != 0) {
+            if (UNEXPECTED(!cat_socket_getaddrbyname(socket, &datagram->address, ZSTR_VAL(datagram_address), ZSTR_LEN(datagram_address), datagram_port))) {
+                swow_throw_call_exception_with_last(swow_socket_exception_ce);
+                goto _error;
+            }
+        } else {
+            datagram->address = default_address;
+        }
+        index++;
+    } ZEND_HASH_FOREACH_END();
 
-    /* write */
-    if (!may_address || address == NULL || ZSTR_LEN(address) == 0) {
-        ret = cat_socket_write_ex(socket, vector, vector_count, timeout);
-    } else {
-        ret = cat_socket_write_to_ex(socket, vector, vector_count, ZSTR_VAL(address), ZSTR_LEN(address), port, timeout);
-    }
+    n = cat_socket_sendto_many_ex(socket, datagrams, count, timeout);
 
-    if (UNEXPECTED(!ret)) {
+    if (UNEXPECTED(n != (ssize_t) count)) {
         swow_throw_call_exception_with_last(swow_socket_exception_ce);
         goto _error;
     }
 
-    _return:
     RETVAL_THIS();
 
     if (0) {
@@ -1245,60 +1996,112 @@ static PHP_METHOD_EX(Swow_Socket, _write, bool single, bool may_address)
     while (buffer_count--) {
         zend_string_release(strings[buffer_count]);
     }
-    if (UNEXPECTED(strings_on_heap != NULL)) {
-        efree(strings_on_heap);
-    }
-    if (UNEXPECTED(vector_list_on_heap != NULL)) {
-        efree(vector_list_on_heap);
-    }
+    efree(strings);
+    efree(datagrams);
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_write, 0, 1, IS_STATIC, 0)
-    ZEND_ARG_TYPE_INFO(0, vector, IS_ARRAY, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
-ZEND_END_ARG_INFO()
-
-static PHP_METHOD(Swow_Socket, write)
+static void swow_socket_broadcast_release(cat_data_t *data)
 {
-    PHP_METHOD_CALL(Swow_Socket, _write, 0, 0);
+    zend_string_release((zend_string *) data);
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_writeTo, 0, 1, IS_STATIC, 0)
-    ZEND_ARG_TYPE_INFO(0, vector, IS_ARRAY, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_broadcast, 0, 2, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, targets, IS_ARRAY, 0)
+    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, maxQueueSize, IS_LONG, 0, "Swow\\Socket::DEFAULT_BROADCAST_MAX_QUEUE_SIZE")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, failures, "null")
 ZEND_END_ARG_INFO()
 
-static PHP_METHOD(Swow_Socket, writeTo)
+static PHP_METHOD(Swow_Socket, broadcast)
 {
-    PHP_METHOD_CALL(Swow_Socket, _write, 0, 1);
-}
+    HashTable *targets;
+    swow_buffer_t *s_buffer;
+    zend_string *string;
+    zend_long max_queue_size = CAT_SOCKET_POST_WRITE_DEFAULT_MAX_QUEUE_SIZE;
+    zval *z_failures = NULL, z_failures_array;
+    cat_socket_write_vector_t vector;
+    zend_long length = -1;
+    zend_long done_count = 0, queued_count = 0, skipped_count = 0, failed_count = 0;
+    zend_string *data;
+    zend_string *key;
+    zend_ulong index;
+    zval *z_target;
+
+    ZEND_PARSE_PARAMETERS_START(2, 4)
+        Z_PARAM_ARRAY_HT(targets)
+        SWOW_PARAM_BUFFER_OR_STRINGABLE_FOR_READING(s_buffer, string)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max_queue_size)
+        Z_PARAM_ZVAL(z_failures)
+    ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_send, 0, 1, IS_STATIC, 0)
-    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, start, IS_LONG, 0, "0")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "-1")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
-ZEND_END_ARG_INFO()
+    if (UNEXPECTED(max_queue_size < 0)) {
+        zend_argument_value_error(3, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+    vector.base = (char *) swow_buffer_or_string_get_readable_space(s_buffer, string, 0, &length, 2);
+    if (UNEXPECTED(vector.base == NULL)) {
+        RETURN_THROWS();
+    }
+    vector.length = (cat_socket_vector_length_t) length;
+    /* data may be still referenced by the write queues after we returned,
+     * use addref/release to make sure it is immutable (COW) and alive */
+    data = s_buffer != NULL ? swow_buffer_get_string(s_buffer) : string;
+    if (z_failures != NULL) {
+        array_init(&z_failures_array);
+    }
 
-static PHP_METHOD(Swow_Socket, send)
-{
-    PHP_METHOD_CALL(Swow_Socket, _write, 1, 0);
-}
+    ZEND_HASH_FOREACH_KEY_VAL(targets, index, key, z_target) {
+        cat_socket_post_write_result_t result;
+        cat_socket_t *socket;
+        ZVAL_DEREF(z_target);
+        if (UNEXPECTED(Z_TYPE_P(z_target) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(z_target), swow_socket_ce))) {
+            zend_argument_type_error(1, "must be an array of %s, %s given", ZSTR_VAL(swow_socket_ce->name), zend_zval_type_name(z_target));
+            goto _error;
+        }
+        socket = &swow_socket_get_from_object(Z_OBJ_P(z_target))->socket;
+        result = cat_socket_post_write(socket, &vector, 1, (size_t) max_queue_size, swow_socket_broadcast_release, data);
+        switch (result) {
+            case CAT_SOCKET_POST_WRITE_DONE:
+                done_count++;
+                continue;
+            case CAT_SOCKET_POST_WRITE_QUEUED:
+                zend_string_addref(data);
+                queued_count++;
+                continue;
+            case CAT_SOCKET_POST_WRITE_SKIPPED:
+                skipped_count++;
+                break;
+            case CAT_SOCKET_POST_WRITE_FAILED:
+                failed_count++;
+                break;
+        }
+        if (z_failures != NULL) {
+            zval z_errno;
+            ZVAL_LONG(&z_errno, result == CAT_SOCKET_POST_WRITE_SKIPPED ? CAT_ENOBUFS : cat_get_last_error_code());
+            if (key != NULL) {
+                zend_hash_update(Z_ARRVAL(z_failures_array), key, &z_errno);
+            } else {
+                zend_hash_index_update(Z_ARRVAL(z_failures_array), index, &z_errno);
+            }
+        }
+    } ZEND_HASH_FOREACH_END();
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendTo, 0, 1, IS_STATIC, 0)
-    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, start, IS_LONG, 0, "0")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, length, IS_LONG, 0, "-1")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
-ZEND_END_ARG_INFO()
+    if (z_failures != NULL) {
+        ZEND_TRY_ASSIGN_REF_VALUE(z_failures, &z_failures_array);
+    }
+    array_init_size(return_value, 4);
+    add_assoc_long_ex(return_value, ZEND_STRL("done"), done_count);
+    add_assoc_long_ex(return_value, ZEND_STRL("queued"), queued_count);
+    add_assoc_long_ex(return_value, ZEND_STRL("skipped"), skipped_count);
+    add_assoc_long_ex(return_value, ZEND_STRL("failed"), failed_count);
+    return;
 
-static PHP_METHOD(Swow_Socket, sendTo)
-{
-    PHP_METHOD_CALL(Swow_Socket, _write, 1, 1);
+    _error:
+    if (z_failures != NULL) {
+        zval_ptr_dtor(&z_failures_array);
+    }
+    RETURN_THROWS();
 }
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendHandle, 0, 1, IS_STATIC, 0)
@@ -1436,6 +2239,22 @@ SWOW_SOCKET_IS_XXX_API_GEN(ServerConnection, server_connection)
 
 SWOW_SOCKET_IS_XXX_API_GEN(Client, client)
 
+#define arginfo_class_Swow_Socket_isKtlsEnabled arginfo_class_Swow_Socket_close
+
+static PHP_METHOD(Swow_Socket, isKtlsEnabled)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    RETURN_BOOL(cat_socket_is_ktls_enabled(socket));
+#else
+    (void) socket;
+    RETURN_FALSE;
+#endif
+}
+
 #define arginfo_class_Swow_Socket_getConnectionError arginfo_class_Swow_Socket_getId
 
 static PHP_METHOD(Swow_Socket, getConnectionError)
@@ -1628,6 +2447,196 @@ static PHP_METHOD(Swow_Socket, setTcpKeepAlive)
     RETURN_THIS();
 }
 
+#define arginfo_class_Swow_Socket_setUdpGro arginfo_class_Swow_Socket_setTcpNodelay
+
+static PHP_METHOD(Swow_Socket, setUdpGro)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    bool enable = cat_true;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(enable)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ret = cat_socket_set_udp_gro(socket, enable);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+#define arginfo_class_Swow_Socket_isReadPersistent arginfo_class_Swow_Socket_close
+
+static PHP_METHOD(Swow_Socket, isReadPersistent)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_socket_get_read_persistent(socket));
+}
+
+#define arginfo_class_Swow_Socket_setReadPersistent arginfo_class_Swow_Socket_setTcpNodelay
+
+static PHP_METHOD(Swow_Socket, setReadPersistent)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    bool enable = cat_true;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(enable)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ret = cat_socket_set_read_persistent(socket, enable);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_getGlobalReadPersistent, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, getGlobalReadPersistent)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_socket_get_global_read_persistent());
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalReadPersistent, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, enable, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalReadPersistent)
+{
+    bool enable;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_BOOL(enable)
+    ZEND_PARSE_PARAMETERS_END();
+
+    cat_socket_set_global_read_persistent(enable);
+}
+
+#define SWOW_SOCKET_SSL_NOT_ENABLED() do { \
+    zend_throw_error(NULL, "SSL support is not enabled, " \
+        "`--enable-" SWOW_MODULE_NAME_LC "-ssl` must be configured while compiling %s extension", SWOW_MODULE_NAME); \
+    RETURN_THROWS(); \
+} while (0)
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setSslSessionCacheOptions, 0, 0, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, ticketKeyLifetime, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setSslSessionCacheOptions)
+{
+    zend_long size = 0, timeout = 0, ticket_key_lifetime = 0;
+    bool size_is_null = true, timeout_is_null = true, ticket_key_lifetime_is_null = true;
+
+    ZEND_PARSE_PARAMETERS_START(0, 3)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(size, size_is_null)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+        Z_PARAM_LONG_OR_NULL(ticket_key_lifetime, ticket_key_lifetime_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+#ifdef CAT_SSL
+    if (!size_is_null) {
+        if (UNEXPECTED(size < 0)) {
+            zend_argument_value_error(1, "must be greater than or equal to 0");
+            RETURN_THROWS();
+        }
+        cat_ssl_set_session_cache_size((size_t) size);
+    }
+    if (!timeout_is_null) {
+        if (UNEXPECTED(timeout <= 0)) {
+            zend_argument_value_error(2, "must be greater than 0");
+            RETURN_THROWS();
+        }
+        cat_ssl_set_session_cache_timeout((long) timeout);
+    }
+    if (!ticket_key_lifetime_is_null) {
+        if (UNEXPECTED(ticket_key_lifetime <= 0)) {
+            zend_argument_value_error(3, "must be greater than 0");
+            RETURN_THROWS();
+        }
+        cat_ssl_set_ticket_key_lifetime((long) ticket_key_lifetime);
+    }
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_getSslSessionCacheStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, getSslSessionCacheStats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    cat_ssl_session_cache_stats_t stats;
+
+    cat_ssl_get_session_cache_stats(&stats);
+    array_init_size(return_value, 10);
+    add_assoc_long(return_value, "size", (zend_long) cat_ssl_get_session_cache_size());
+    add_assoc_long(return_value, "timeout", (zend_long) cat_ssl_get_session_cache_timeout());
+    add_assoc_long(return_value, "ticket_key_lifetime", (zend_long) cat_ssl_get_ticket_key_lifetime());
+    add_assoc_long(return_value, "server_count", (zend_long) stats.server_count);
+    add_assoc_long(return_value, "server_hits", (zend_long) stats.server_hits);
+    add_assoc_long(return_value, "server_misses", (zend_long) stats.server_misses);
+    add_assoc_long(return_value, "client_count", (zend_long) stats.client_count);
+    add_assoc_long(return_value, "client_hits", (zend_long) stats.client_hits);
+    add_assoc_long(return_value, "client_misses", (zend_long) stats.client_misses);
+    add_assoc_long(return_value, "ticket_key_rotations", (zend_long) stats.ticket_key_rotations);
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_rotateSslTicketKeys, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, rotateSslTicketKeys)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    if (UNEXPECTED(!cat_ssl_rotate_ticket_keys())) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+#define arginfo_class_Swow_Socket_clearSslSessionCache arginfo_class_Swow_Socket_rotateSslTicketKeys
+
+static PHP_METHOD(Swow_Socket, clearSslSessionCache)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    cat_ssl_clear_session_cache();
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket___debugInfo, 0, 0, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
@@ -1709,6 +2718,8 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, bind,                      arginfo_class_Swow_Socket_bind,                ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, listen,                    arginfo_class_Swow_Socket_listen,              ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, accept,                    arginfo_class_Swow_Socket_accept,              ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, acceptBatch,               arginfo_class_Swow_Socket_acceptBatch,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, acceptLoop,                arginfo_class_Swow_Socket_acceptLoop,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, acceptTo,                  arginfo_class_Swow_Socket_acceptTo,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, connect,                   arginfo_class_Swow_Socket_connect,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, enableCrypto,              arginfo_class_Swow_Socket_enableCrypto,        ZEND_ACC_PUBLIC)
@@ -1721,6 +2732,12 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, recvData,                  arginfo_class_Swow_Socket_recvData,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, recvFrom,                  arginfo_class_Swow_Socket_recvFrom,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, recvDataFrom,              arginfo_class_Swow_Socket_recvDataFrom,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, recvBatch,                 arginfo_class_Swow_Socket_recvBatch,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, recvUntil,                 arginfo_class_Swow_Socket_recvUntil,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, setFrameFormat,            arginfo_class_Swow_Socket_setFrameFormat,      ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, getFrameFormat,            arginfo_class_Swow_Socket_getFrameFormat,      ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, recvFrame,                 arginfo_class_Swow_Socket_recvFrame,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, recvFrames,                arginfo_class_Swow_Socket_recvFrames,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, peek,                      arginfo_class_Swow_Socket_peek,                ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, peekFrom,                  arginfo_class_Swow_Socket_peekFrom,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, readString,                arginfo_class_Swow_Socket_readString,          ZEND_ACC_PUBLIC)
@@ -1734,6 +2751,10 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, writeTo,                   arginfo_class_Swow_Socket_writeTo,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, send,                      arginfo_class_Swow_Socket_send,                ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, sendTo,                    arginfo_class_Swow_Socket_sendTo,              ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, writeFrame,                arginfo_class_Swow_Socket_writeFrame,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, sendFrame,                 arginfo_class_Swow_Socket_sendFrame,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, sendBatch,                 arginfo_class_Swow_Socket_sendBatch,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, broadcast,                 arginfo_class_Swow_Socket_broadcast,           ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Socket, sendHandle,                arginfo_class_Swow_Socket_sendHandle,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, sendFile,                  arginfo_class_Swow_Socket_sendFile,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, close,                     arginfo_class_Swow_Socket_close,               ZEND_ACC_PUBLIC)
@@ -1744,6 +2765,7 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, isServer,                  arginfo_class_Swow_Socket_isServer,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, isServerConnection,        arginfo_class_Swow_Socket_isServerConnection,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, isClient,                  arginfo_class_Swow_Socket_isClient,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, isKtlsEnabled,             arginfo_class_Swow_Socket_isKtlsEnabled,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getConnectionError,        arginfo_class_Swow_Socket_getConnectionError,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, checkLiveness,             arginfo_class_Swow_Socket_checkLiveness,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getIoState,                arginfo_class_Swow_Socket_getIoState,          ZEND_ACC_PUBLIC)
@@ -1751,11 +2773,14 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, getIoStateNaming,          arginfo_class_Swow_Socket_getIoStateNaming,    ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getRecvBufferSize,         arginfo_class_Swow_Socket_getRecvBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getSendBufferSize,         arginfo_class_Swow_Socket_getSendBufferSize,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, isReadPersistent,          arginfo_class_Swow_Socket_isReadPersistent,    ZEND_ACC_PUBLIC)
     /* setter */
     PHP_ME(Swow_Socket, setRecvBufferSize,         arginfo_class_Swow_Socket_setRecvBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setSendBufferSize,         arginfo_class_Swow_Socket_setSendBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setTcpNodelay,             arginfo_class_Swow_Socket_setTcpNodelay,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setTcpKeepAlive,           arginfo_class_Swow_Socket_setTcpKeepAlive,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, setUdpGro,                 arginfo_class_Swow_Socket_setUdpGro,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, setReadPersistent,         arginfo_class_Swow_Socket_setReadPersistent,   ZEND_ACC_PUBLIC)
     /* magic */
     PHP_ME(Swow_Socket, __debugInfo,               arginfo_class_Swow_Socket___debugInfo,         ZEND_ACC_PUBLIC)
     /* globals */
@@ -1774,6 +2799,12 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, setGlobalHandshakeTimeout, arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Socket, setGlobalReadTimeout,      arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Socket, setGlobalWriteTimeout,     arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, getGlobalReadPersistent,   arginfo_class_Swow_Socket_getGlobalReadPersistent, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalReadPersistent,   arginfo_class_Swow_Socket_setGlobalReadPersistent, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setSslSessionCacheOptions, arginfo_class_Swow_Socket_setSslSessionCacheOptions, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, getSslSessionCacheStats,   arginfo_class_Swow_Socket_getSslSessionCacheStats, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, rotateSslTicketKeys,       arginfo_class_Swow_Socket_rotateSslTicketKeys, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, clearSslSessionCache,      arginfo_class_Swow_Socket_clearSslSessionCache, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -1799,6 +2830,7 @@ zend_result swow_socket_module_init(INIT_FUNC_ARGS)
     /* constants */
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("INVALID_FD"), CAT_SOCKET_INVALID_FD);
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("DEFAULT_BACKLOG"), CAT_SOCKET_DEFAULT_BACKLOG);
+    zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("DEFAULT_BROADCAST_MAX_QUEUE_SIZE"), CAT_SOCKET_POST_WRITE_DEFAULT_MAX_QUEUE_SIZE);
 #define SWOW_SOCKET_TYPE_FLAG_GEN(name, value) \
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("TYPE_FLAG_" #name), (value));
     CAT_SOCKET_TYPE_FLAG_MAP(SWOW_SOCKET_TYPE_FLAG_GEN)
@@ -1825,6 +2857,11 @@ zend_result swow_socket_module_init(INIT_FUNC_ARGS)
 
 zend_result swow_socket_module_shutdown(INIT_FUNC_ARGS)
 {
+#ifdef CAT_SSL
+    if (!cat_ssl_module_shutdown()) {
+        return FAILURE;
+    }
+#endif
     if (!cat_socket_module_shutdown()) {
         return FAILURE;
     }
@@ -1837,6 +2874,25 @@ zend_result swow_socket_runtime_init(INIT_FUNC_ARGS)
     if (!cat_socket_runtime_init()) {
         return FAILURE;
     }
+#ifdef CAT_SSL
+    if (!cat_ssl_runtime_init()) {
+        return FAILURE;
+    }
+#endif
+
+    return SUCCESS;
+}
+
+zend_result swow_socket_runtime_shutdown(SHUTDOWN_FUNC_ARGS)
+{
+    if (!cat_socket_runtime_shutdown()) {
+        return FAILURE;
+    }
+#ifdef CAT_SSL
+    if (!cat_ssl_runtime_shutdown()) {
+        return FAILURE;
+    }
+#endif
 
     return SUCCESS;
 }
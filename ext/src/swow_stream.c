@@ -23,6 +23,7 @@
 #include "cat_socket.h"
 #include "cat_time.h" /* for time_tv2to() */
 #include "cat_poll.h" /* for select() */
+#include "cat_fs.h"
 
 #include "streams/php_streams_int.h"
 #include "ext/standard/file.h"
@@ -792,6 +793,9 @@ static int swow_stream_enable_crypto(php_stream *stream,
         if (!GET_VER_OPT("disable_compression") || zend_is_true(val)) {
             options.no_compression = cat_true;
         }
+        if (GET_VER_OPT("ktls") && zend_is_true(val)) {
+            options.ktls = cat_true;
+        }
         GET_VER_OPT_STRING("peer_name", options.peer_name);
         if (is_client) {
             /* If SNI is explicitly disabled we're finished here */
@@ -2248,6 +2252,37 @@ PHP_FUNCTION(swow_stream_poll_one)
     }
     RETURN_LONG(revents);
 }
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_swow_stream_poll_get_stats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(swow_stream_poll_get_stats)
+{
+    cat_poll_registry_stats_t stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_poll_get_registry_stats(&stats);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "adds", (zend_long) stats.adds);
+    add_assoc_long(return_value, "mods", (zend_long) stats.mods);
+    add_assoc_long(return_value, "dels", (zend_long) stats.dels);
+    add_assoc_long(return_value, "fallbacks", (zend_long) stats.fallbacks);
+    add_assoc_long(return_value, "count", (zend_long) stats.count);
+}
+/* }}} */
+
+/* {{{ proto string stream_get_fs_engine() */
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_swow_stream_get_fs_engine, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(swow_stream_get_fs_engine)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STRING(cat_fs_get_engine_name());
+}
 /* }}} */
 
 static zend_class_entry *socket_ce = (zend_class_entry *) -1;
@@ -2409,6 +2444,8 @@ static const zend_function_entry swow_stream_functions[] = {
     PHP_FENTRY(stream_select, PHP_FN(swow_stream_select), arginfo_swow_stream_select, 0)
     PHP_FENTRY(stream_select_unlimited, PHP_FN(swow_stream_select_unlimited), arginfo_swow_stream_select_unlimited, 0)
     PHP_FENTRY(stream_poll_one, PHP_FN(swow_stream_poll_one), arginfo_swow_stream_poll_one, 0)
+    PHP_FENTRY(stream_poll_get_stats, PHP_FN(swow_stream_poll_get_stats), arginfo_swow_stream_poll_get_stats, 0)
+    PHP_FENTRY(stream_get_fs_engine, PHP_FN(swow_stream_get_fs_engine), arginfo_swow_stream_get_fs_engine, 0)
     PHP_FE_END
 };
 
@@ -2426,6 +2463,14 @@ zend_result swow_stream_module_init(INIT_FUNC_ARGS)
 
     CAT_GLOBALS_REGISTER(swow_stream);
 
+    if (!cat_fs_module_init()) {
+        return FAILURE;
+    }
+
+    if (!cat_poll_module_init()) {
+        return FAILURE;
+    }
+
     REGISTER_LONG_CONSTANT("STREAM_POLLNONE", POLLNONE, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("STREAM_POLLIN", POLLIN, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("STREAM_POLLPRI", POLLPRI, CONST_PERSISTENT);
@@ -2497,6 +2542,14 @@ zend_result swow_stream_module_shutdown(INIT_FUNC_ARGS)
     // unhook std ops
     memcpy(&php_stream_stdio_ops, &swow_stream_stdio_ops_sync, sizeof(php_stream_stdio_ops));
 
+    if (!cat_poll_module_shutdown()) {
+        return FAILURE;
+    }
+
+    if (!cat_fs_module_shutdown()) {
+        return FAILURE;
+    }
+
     CAT_GLOBALS_UNREGISTER(swow_stream);
 
     return SUCCESS;
@@ -2510,6 +2563,14 @@ zend_result swow_stream_runtime_init(INIT_FUNC_ARGS)
     // prepare tty sockets (FIXME: Why won't Zend bzero() it when we are in ZTS?)
     memset(SWOW_STREAM_G(tty_sockets), 0, sizeof(SWOW_STREAM_G(tty_sockets)));
 
+    if (!cat_fs_runtime_init()) {
+        return FAILURE;
+    }
+
+    if (!cat_poll_runtime_init()) {
+        return FAILURE;
+    }
+
     if (socket_ce == (zend_class_entry *) -1) {
         socket_ce = (zend_class_entry *) zend_hash_str_find_ptr(CG(class_table), ZEND_STRL("socket"));
     }
@@ -2536,5 +2597,13 @@ zend_result swow_stream_runtime_shutdown(INIT_FUNC_ARGS)
     SWOW_STREAM_G(hooking_tty) = false;
     SWOW_STREAM_G(hooking_stdio_ops) = false;
 
+    if (!cat_poll_runtime_shutdown()) {
+        return FAILURE;
+    }
+
+    if (!cat_fs_runtime_shutdown()) {
+        return FAILURE;
+    }
+
     return SUCCESS;
 }
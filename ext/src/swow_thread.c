@@ -17,17 +17,600 @@
  */
 
 #include "swow_thread.h"
+#include "swow_socket.h"
 
-SWOW_API zend_class_entry *swow_thread_wait_reference_ce;
-SWOW_API zend_object_handlers swow_thread_wait_reference_handlers;
+#include "SAPI.h"
+#include "php_main.h"
+
+SWOW_API zend_class_entry *swow_thread_ce;
+SWOW_API zend_object_handlers swow_thread_handlers;
+
+SWOW_API zend_class_entry *swow_thread_queue_ce;
+SWOW_API zend_object_handlers swow_thread_queue_handlers;
 
 SWOW_API zend_class_entry *swow_thread_exception_ce;
 
-SWOW_API CAT_GLOBALS_DECLARE(swow_thread)
+/* process-wide states (protected by mutex) */
+
+typedef struct swow_thread_queue_entry_s {
+    cat_queue_node_t node;
+    cat_async_queue_t *queue;
+    size_t name_length;
+    char name[1];
+} swow_thread_queue_entry_t;
+
+static uv_mutex_t swow_thread_mutex;
+static cat_queue_t swow_thread_queue_entries;
+static zend_long swow_thread_last_id;
+
+/* thread routine */
+
+#ifdef ZTS
+typedef struct swow_thread_context_s {
+    zend_long id;
+    cat_async_queue_t *exit_queue;
+    /* argv[0] is the filename */
+    int argc;
+    char **argv;
+} swow_thread_context_t;
+
+static void swow_thread_context_free(swow_thread_context_t *context)
+{
+    int i;
+
+    for (i = 0; i < context->argc; i++) {
+        cat_sys_free(context->argv[i]);
+    }
+    cat_sys_free(context->argv);
+    if (context->exit_queue != NULL) {
+        cat_async_queue_release(context->exit_queue);
+    }
+    cat_sys_free(context);
+}
+
+static void swow_thread_routine(void *arg)
+{
+    swow_thread_context_t *context = (swow_thread_context_t *) arg;
+    zend_long exit_status = 255;
+    char buffer[MAX_LENGTH_OF_LONG + 1];
+    int length;
+
+    (void) ts_resource(0);
+# ifdef COMPILE_DL_SWOW
+    ZEND_TSRMLS_CACHE_UPDATE();
+# endif
+    SWOW_G(thread_id) = context->id;
+
+    /* run the script as a CLI request,
+     * Swow runtime (event loop and scheduler) would be initialized in RINIT */
+    SG(server_context) = NULL;
+    SG(options) |= SAPI_OPTION_NO_CHDIR;
+    SG(request_info).argc = context->argc;
+    SG(request_info).argv = context->argv;
+    SG(request_info).path_translated = context->argv[0];
+    PG(expose_php) = 0;
+    PG(auto_globals_jit) = 1;
+
+    if (php_request_startup() == SUCCESS) {
+        zend_file_handle file_handle;
+        SG(headers_sent) = 1;
+        SG(request_info).no_headers = 1;
+        zend_stream_init_filename(&file_handle, context->argv[0]);
+        php_execute_script(&file_handle);
+        exit_status = EG(exit_status);
+# if PHP_VERSION_ID >= 80100
+        zend_destroy_file_handle(&file_handle);
+# endif
+    }
+    php_request_shutdown(NULL);
+
+    SG(request_info).argc = 0;
+    SG(request_info).argv = NULL;
+    SG(request_info).path_translated = NULL;
+
+    length = snprintf(buffer, sizeof(buffer), ZEND_LONG_FMT, exit_status);
+    (void) cat_async_queue_push(context->exit_queue, buffer, length);
+    swow_thread_context_free(context);
+
+    ts_free_thread();
+}
+#endif
+
+/* Thread */
+
+#define SWOW_THREAD_GETTER(_s_thread) \
+    swow_thread_t *_s_thread = swow_thread_get_from_object(Z_OBJ_P(ZEND_THIS))
+
+static zend_object *swow_thread_create_object(zend_class_entry *ce)
+{
+    swow_thread_t *s_thread = swow_object_alloc(swow_thread_t, ce, swow_thread_handlers);
+
+    s_thread->id = 0;
+    s_thread->exit_queue = NULL;
+    s_thread->exit_status = 0;
+    s_thread->started = cat_false;
+    s_thread->joined = cat_false;
+
+    return &s_thread->std;
+}
+
+static void swow_thread_free_object(zend_object *object)
+{
+    swow_thread_t *s_thread = swow_thread_get_from_object(object);
+
+    if (s_thread->started && !s_thread->joined) {
+        /* we can not leave it running without owner, wait for it in blocking way */
+        (void) uv_thread_join(&s_thread->tid);
+    }
+    if (s_thread->exit_queue != NULL) {
+        cat_async_queue_release(s_thread->exit_queue);
+    }
+
+    zend_object_std_dtor(&s_thread->std);
+}
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Thread___construct, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, filename, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, arguments, IS_ARRAY, 0, "[]")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, __construct)
+{
+    SWOW_THREAD_GETTER(s_thread);
+    zend_string *filename;
+    HashTable *arguments = NULL;
+
+    if (UNEXPECTED(s_thread->started)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_PATH_STR(filename)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_HT(arguments)
+    ZEND_PARSE_PARAMETERS_END();
+
+#ifndef ZTS
+    (void) filename;
+    (void) arguments;
+    swow_throw_exception(swow_thread_exception_ce, CAT_ENOTSUP, "Thread requires ZTS build of PHP");
+    RETURN_THROWS();
+#else
+    swow_thread_context_t *context;
+    zval *z_argument;
+    int error;
+
+    if (arguments != NULL) {
+        ZEND_HASH_FOREACH_VAL(arguments, z_argument) {
+            if (UNEXPECTED(Z_TYPE_P(z_argument) != IS_STRING)) {
+                zend_argument_type_error(2, "must be an array of strings, %s given in it", zend_zval_type_name(z_argument));
+                RETURN_THROWS();
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    /* everything passed to the thread is allocated by the system allocator */
+    context = (swow_thread_context_t *) cat_sys_malloc(sizeof(*context));
+    context->argc = 0;
+    context->argv = (char **) cat_sys_malloc(sizeof(char *) * (1 + (arguments != NULL ? zend_hash_num_elements(arguments) : 0) + 1));
+    context->argv[context->argc++] = cat_sys_strndup(ZSTR_VAL(filename), ZSTR_LEN(filename));
+    if (arguments != NULL) {
+        ZEND_HASH_FOREACH_VAL(arguments, z_argument) {
+            context->argv[context->argc++] = cat_sys_strndup(Z_STRVAL_P(z_argument), Z_STRLEN_P(z_argument));
+        } ZEND_HASH_FOREACH_END();
+    }
+    context->argv[context->argc] = NULL;
+    context->exit_queue = cat_async_queue_create();
+    if (UNEXPECTED(context->exit_queue == NULL)) {
+        swow_thread_context_free(context);
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+    uv_mutex_lock(&swow_thread_mutex);
+    context->id = ++swow_thread_last_id;
+    uv_mutex_unlock(&swow_thread_mutex);
+
+    s_thread->id = context->id;
+    s_thread->exit_queue = cat_async_queue_addref(context->exit_queue);
+
+    error = uv_thread_create(&s_thread->tid, swow_thread_routine, context);
+
+    if (UNEXPECTED(error != 0)) {
+        swow_thread_context_free(context);
+        cat_update_last_error_with_reason(error, "Thread create failed");
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    s_thread->started = cat_true;
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_getId, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, getId)
+{
+    SWOW_THREAD_GETTER(s_thread);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(s_thread->id);
+}
+
+#define arginfo_class_Swow_Thread_isJoined arginfo_class_Swow_Thread_isRunning
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_isRunning, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, isRunning)
+{
+    SWOW_THREAD_GETTER(s_thread);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(s_thread->started && !s_thread->joined && cat_async_queue_count(s_thread->exit_queue) == 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_join, 0, 0, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, join)
+{
+    SWOW_THREAD_GETTER(s_thread);
+    zend_long timeout = -1;
+    cat_async_message_t *message;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(!s_thread->started)) {
+        swow_throw_exception(swow_thread_exception_ce, CAT_ESRCH, "Thread has not been started");
+        RETURN_THROWS();
+    }
+
+    if (!s_thread->joined) {
+        /* only current coroutine waits, event loop keeps running */
+        message = cat_async_queue_pop(s_thread->exit_queue, timeout);
+        if (UNEXPECTED(message == NULL)) {
+            swow_throw_exception_with_last(swow_thread_exception_ce);
+            RETURN_THROWS();
+        }
+        s_thread->exit_status = ZEND_STRTOL(message->data, NULL, 10);
+        cat_async_message_free(message);
+        /* request has been shutdown, it will exit soon */
+        (void) uv_thread_join(&s_thread->tid);
+        s_thread->joined = cat_true;
+    }
+
+    RETURN_LONG(s_thread->exit_status);
+}
+
+#define arginfo_class_Swow_Thread_getCurrentId arginfo_class_Swow_Thread_getId
+
+static PHP_METHOD(Swow_Thread, getCurrentId)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(SWOW_G(thread_id));
+}
+
+#define arginfo_class_Swow_Thread_getCpuCount arginfo_class_Swow_Thread_getId
+
+static PHP_METHOD(Swow_Thread, getCpuCount)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(uv_available_parallelism());
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_class_Swow_Thread_listen, 0, 2, Swow\\Socket, 0)
+    ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, port, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, backlog, IS_LONG, 0, "Swow\\Socket::DEFAULT_BACKLOG")
+ZEND_END_ARG_INFO()
+
+/* every thread binds its own listening socket on the same address with SO_REUSEPORT,
+ * then kernel distributes incoming connections to them */
+static PHP_METHOD(Swow_Thread, listen)
+{
+    zend_string *name;
+    zend_long port;
+    zend_long backlog = CAT_SOCKET_DEFAULT_BACKLOG;
+    zend_object *object;
+    cat_socket_t *socket;
+
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_STR(name)
+        Z_PARAM_LONG(port)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(backlog)
+    ZEND_PARSE_PARAMETERS_END();
+
+    object = swow_object_create(swow_socket_ce);
+    socket = cat_socket_create(&swow_socket_get_from_object(object)->socket, CAT_SOCKET_TYPE_TCP);
+    if (UNEXPECTED(socket == NULL)) {
+        goto _error;
+    }
+    if (UNEXPECTED(!cat_socket_bind_to_ex(socket, ZSTR_VAL(name), ZSTR_LEN(name), port, CAT_SOCKET_BIND_FLAG_REUSEPORT))) {
+        goto _error;
+    }
+    if (UNEXPECTED(!cat_socket_listen(socket, backlog))) {
+        goto _error;
+    }
+
+    RETURN_OBJ(object);
 
-CAT_GLOBALS_CTOR_DECLARE_SZ(swow_thread)
+    _error:
+    swow_throw_exception_with_last(swow_socket_exception_ce);
+    zend_object_release(object);
+    RETURN_THROWS();
+}
+
+static const zend_function_entry swow_thread_methods[] = {
+    PHP_ME(Swow_Thread, __construct,  arginfo_class_Swow_Thread___construct,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, getId,        arginfo_class_Swow_Thread_getId,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, isRunning,    arginfo_class_Swow_Thread_isRunning,    ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, join,         arginfo_class_Swow_Thread_join,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, getCurrentId, arginfo_class_Swow_Thread_getCurrentId, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Thread, getCpuCount,  arginfo_class_Swow_Thread_getCpuCount,  ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Thread, listen,       arginfo_class_Swow_Thread_listen,       ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+
+/* Thread\Queue */
+
+#define SWOW_THREAD_QUEUE_GETTER(_s_queue, _queue) \
+    swow_thread_queue_t *_s_queue = swow_thread_queue_get_from_object(Z_OBJ_P(ZEND_THIS)); \
+    cat_async_queue_t *_queue = _s_queue->queue
+
+#define SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(_s_queue, _queue) \
+    SWOW_THREAD_QUEUE_GETTER(_s_queue, _queue); \
+    if (UNEXPECTED(_queue == NULL)) { \
+        zend_throw_error(NULL, "%s must construct first", ZEND_THIS_NAME); \
+        RETURN_THROWS(); \
+    }
+
+static cat_async_queue_t *swow_thread_queue_open(const char *name, size_t name_length)
+{
+    swow_thread_queue_entry_t *entry;
+    cat_async_queue_t *queue = NULL;
+
+    uv_mutex_lock(&swow_thread_mutex);
+    CAT_QUEUE_FOREACH_DATA_START(&swow_thread_queue_entries, swow_thread_queue_entry_t, node, existing_entry) {
+        if (existing_entry->name_length == name_length && memcmp(existing_entry->name, name, name_length) == 0) {
+            queue = cat_async_queue_addref(existing_entry->queue);
+            break;
+        }
+    } CAT_QUEUE_FOREACH_DATA_END();
+    if (queue == NULL) {
+        /* the registry holds a reference until module shutdown */
+        queue = cat_async_queue_create();
+        if (EXPECTED(queue != NULL)) {
+            entry = (swow_thread_queue_entry_t *) cat_sys_malloc(offsetof(swow_thread_queue_entry_t, name) + name_length + 1);
+            entry->queue = queue;
+            entry->name_length = name_length;
+            memcpy(entry->name, name, name_length);
+            entry->name[name_length] = '\0';
+            cat_queue_push_back(&swow_thread_queue_entries, &entry->node);
+            queue = cat_async_queue_addref(queue);
+        }
+    }
+    uv_mutex_unlock(&swow_thread_mutex);
+
+    return queue;
+}
+
+static zend_object *swow_thread_queue_create_object(zend_class_entry *ce)
+{
+    swow_thread_queue_t *s_queue = swow_object_alloc(swow_thread_queue_t, ce, swow_thread_queue_handlers);
+
+    s_queue->name = NULL;
+    s_queue->queue = NULL;
+
+    return &s_queue->std;
+}
+
+static void swow_thread_queue_free_object(zend_object *object)
+{
+    swow_thread_queue_t *s_queue = swow_thread_queue_get_from_object(object);
+
+    if (s_queue->queue != NULL) {
+        cat_async_queue_release(s_queue->queue);
+    }
+    if (s_queue->name != NULL) {
+        zend_string_release(s_queue->name);
+    }
+
+    zend_object_std_dtor(&s_queue->std);
+}
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Thread_Queue___construct, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Queue, __construct)
+{
+    SWOW_THREAD_QUEUE_GETTER(s_queue, queue);
+    zend_string *name;
+
+    if (UNEXPECTED(queue != NULL)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(name)
+    ZEND_PARSE_PARAMETERS_END();
+
+    queue = swow_thread_queue_open(ZSTR_VAL(name), ZSTR_LEN(name));
+
+    if (UNEXPECTED(queue == NULL)) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    s_queue->name = zend_string_copy(name);
+    s_queue->queue = queue;
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Queue_getName, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Queue, getName)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    (void) queue;
+    RETURN_STR_COPY(s_queue->name);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Queue_push, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, message, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Queue, push)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+    zend_string *message;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(message)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ret = cat_async_queue_push(queue, ZSTR_VAL(message), ZSTR_LEN(message));
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Queue_pop, 0, 0, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Queue, pop)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+    zend_long timeout = -1;
+    cat_async_message_t *message;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    message = cat_async_queue_pop(queue, timeout);
+
+    if (UNEXPECTED(message == NULL)) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETVAL_STRINGL(message->data, message->length);
+    cat_async_message_free(message);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Queue_close, 0, 0, IS_STATIC, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Queue, close)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_async_queue_close(queue);
+
+    RETURN_THIS();
+}
+
+#define arginfo_class_Swow_Thread_Queue_isClosed arginfo_class_Swow_Thread_isRunning
+
+static PHP_METHOD(Swow_Thread_Queue, isClosed)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_async_queue_is_closed(queue));
+}
+
+#define arginfo_class_Swow_Thread_Queue_count arginfo_class_Swow_Thread_getId
+
+static PHP_METHOD(Swow_Thread_Queue, count)
+{
+    SWOW_THREAD_QUEUE_GETTER_CONSTRUCTED(s_queue, queue);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_async_queue_count(queue));
+}
+
+static const zend_function_entry swow_thread_queue_methods[] = {
+    PHP_ME(Swow_Thread_Queue, __construct, arginfo_class_Swow_Thread_Queue___construct, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, getName,     arginfo_class_Swow_Thread_Queue_getName,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, push,        arginfo_class_Swow_Thread_Queue_push,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, pop,         arginfo_class_Swow_Thread_Queue_pop,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, close,       arginfo_class_Swow_Thread_Queue_close,       ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, isClosed,    arginfo_class_Swow_Thread_Queue_isClosed,    ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Queue, count,       arginfo_class_Swow_Thread_Queue_count,       ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
 
 zend_result swow_thread_module_init(INIT_FUNC_ARGS)
 {
+    if (uv_mutex_init(&swow_thread_mutex) != 0) {
+        return FAILURE;
+    }
+    cat_queue_init(&swow_thread_queue_entries);
+    swow_thread_last_id = 0;
+
+    swow_thread_ce = swow_register_internal_class(
+        "Swow\\Thread", NULL, swow_thread_methods,
+        &swow_thread_handlers, NULL,
+        cat_false, cat_false,
+        swow_thread_create_object,
+        swow_thread_free_object,
+        XtOffsetOf(swow_thread_t, std)
+    );
+
+    swow_thread_queue_ce = swow_register_internal_class(
+        "Swow\\Thread\\Queue", NULL, swow_thread_queue_methods,
+        &swow_thread_queue_handlers, NULL,
+        cat_false, cat_false,
+        swow_thread_queue_create_object,
+        swow_thread_queue_free_object,
+        XtOffsetOf(swow_thread_queue_t, std)
+    );
+
+    swow_thread_exception_ce = swow_register_internal_class(
+        "Swow\\ThreadException", swow_exception_ce, NULL, NULL, NULL, cat_true, cat_true, NULL, NULL, 0
+    );
+
+    return SUCCESS;
+}
+
+zend_result swow_thread_module_shutdown(INIT_FUNC_ARGS)
+{
+    swow_thread_queue_entry_t *entry;
+
+    while ((entry = cat_queue_front_data(&swow_thread_queue_entries, swow_thread_queue_entry_t, node))) {
+        cat_queue_remove(&entry->node);
+        cat_async_queue_release(entry->queue);
+        cat_sys_free(entry);
+    }
+    uv_mutex_destroy(&swow_thread_mutex);
+
     return SUCCESS;
 }
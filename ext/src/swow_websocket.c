@@ -509,7 +509,7 @@ static PHP_METHOD(Swow_WebSocket_WebSocket, mask)
     SWOW_WEBSOCKET_HEADER_MASKING_KEY_CHECK(masking_key, 4);
 
     if (UNEXPECTED(masking_key == NULL ||
-        memcmp(masking_key, CAT_STRS(CAT_WEBSOCKET_EMPTY_MASKING_KEY)) == 0)) {
+        memcmp(ZSTR_VAL(masking_key), CAT_STRS(CAT_WEBSOCKET_EMPTY_MASKING_KEY)) == 0)) {
         RETURN_STR_COPY(data);
     }
     ptr = swow_string_get_readable_space(data, start, &length, 1);
@@ -558,9 +558,20 @@ static PHP_METHOD(Swow_WebSocket_WebSocket, unmask)
     cat_websocket_unmask_ex(ptr, length, masking_key != NULL ? ZSTR_VAL(masking_key) : NULL, index);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_WebSocket_WebSocket_getMaskKernel, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_WebSocket_WebSocket, getMaskKernel)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STRING(cat_websocket_mask_get_kernel_name());
+}
+
 static const zend_function_entry swow_websocket_websocket_methods[] = {
-    PHP_ME(Swow_WebSocket_WebSocket, mask,   arginfo_class_Swow_WebSocket_WebSocket_mask,   ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
-    PHP_ME(Swow_WebSocket_WebSocket, unmask, arginfo_class_Swow_WebSocket_WebSocket_unmask, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, mask,          arginfo_class_Swow_WebSocket_WebSocket_mask,          ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, unmask,        arginfo_class_Swow_WebSocket_WebSocket_unmask,        ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, getMaskKernel, arginfo_class_Swow_WebSocket_WebSocket_getMaskKernel, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -0,0 +1,105 @@
+--TEST--
+swow_buffer: pool
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+
+$stats = Buffer::getPoolStats();
+foreach (['hits', 'misses', 'reallocs', 'in_place_reallocs', 'advised_bytes', 'count', 'bytes', 'max_bytes'] as $key) {
+    Assert::keyExists($stats, $key);
+    Assert::greaterThanEq($stats[$key], 0);
+}
+Assert::isArray($stats['classes']);
+
+/* the pool does not work with the custom heap */
+$pooled = getenv('USE_ZEND_ALLOC') !== '0';
+
+/* released buffers are reused */
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+$buffer->append('foo');
+$buffer = null;
+$stats = Buffer::getPoolStats();
+if ($pooled) {
+    Assert::greaterThan($stats['count'], 0);
+}
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+Assert::same($buffer->getSize(), Buffer::COMMON_SIZE);
+Assert::same($buffer->getLength(), 0);
+Assert::same($buffer->toString(), '');
+$after = Buffer::getPoolStats();
+if ($pooled) {
+    Assert::same($after['hits'], $stats['hits'] + 1);
+    Assert::same($after['count'], $stats['count'] - 1);
+    /* power-of-two sized buffers are cached in the class of their own size */
+    Assert::greaterThan($stats['classes'][Buffer::COMMON_SIZE] ?? 0, 0);
+    Assert::lessThan($stats['bytes'] - $after['bytes'], Buffer::COMMON_SIZE * 2);
+}
+
+/* strings which are still referenced are not cached */
+$buffer->append('bar');
+$string = $buffer->toString();
+$stats = Buffer::getPoolStats();
+$buffer = null;
+Assert::same(Buffer::getPoolStats()['count'], $stats['count']);
+Assert::same($string, 'bar');
+
+/* grow in place within the size class */
+$buffer = new Buffer(1000);
+$buffer->append('baz');
+$stats = Buffer::getPoolStats();
+$buffer->realloc(1001);
+$after = Buffer::getPoolStats();
+if ($pooled) {
+    Assert::same($after['in_place_reallocs'], $stats['in_place_reallocs'] + 1);
+}
+Assert::same($buffer->toString(), 'baz');
+$buffer->extend(256 * 1024);
+Assert::same($buffer->toString(), 'baz');
+
+/* pages of large ones are given back to the OS on trim only */
+$stats = Buffer::getPoolStats();
+$buffer = null;
+$after = Buffer::getPoolStats();
+Assert::same($after['advised_bytes'], $stats['advised_bytes']);
+Buffer::trimPool();
+$after = Buffer::getPoolStats();
+if ($pooled) {
+    Assert::greaterThan($after['advised_bytes'], $stats['advised_bytes']);
+    /* they are advised only once */
+    Buffer::trimPool();
+    Assert::same(Buffer::getPoolStats()['advised_bytes'], $after['advised_bytes']);
+}
+$buffer = new Buffer(256 * 1024);
+$buffer->append(str_repeat('x', 256 * 1024));
+Assert::same($buffer->toString(), str_repeat('x', 256 * 1024));
+$buffer = null;
+
+/* disable it */
+Buffer::setPoolMaxBytes(0);
+$stats = Buffer::getPoolStats();
+Assert::same($stats['max_bytes'], 0);
+Assert::same($stats['count'], 0);
+Assert::same($stats['bytes'], 0);
+Assert::same($stats['classes'], []);
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+$buffer = null;
+Assert::same(Buffer::getPoolStats()['count'], 0);
+
+try {
+    Buffer::setPoolMaxBytes(-1);
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+Swow\Buffer::setPoolMaxBytes(): Argument #1 ($bytes) can not be negative
+Done
@@ -0,0 +1,92 @@
+--TEST--
+swow_channel: pushMany and popMany
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Channel;
+use Swow\ChannelException;
+use Swow\Coroutine;
+
+foreach ([0, 1, 7, 100] as $c) {
+    $channel = new Channel($c);
+    Coroutine::run(static function () use ($channel): void {
+        $n = 0;
+        while ($n < TEST_MAX_LOOPS) {
+            $batch = [];
+            for ($i = mt_rand(1, 16); $i-- && $n < TEST_MAX_LOOPS;) {
+                $batch[] = $n++;
+            }
+            $channel->pushMany($batch);
+        }
+        $channel->push(-1);
+    });
+    $expected = 0;
+    while (true) {
+        $batch = $channel->popMany(mt_rand(1, 32));
+        Assert::greaterThanEq(count($batch), 1);
+        foreach ($batch as $value) {
+            if ($value === -1) {
+                break 2;
+            }
+            Assert::same($value, $expected++);
+        }
+    }
+    Assert::same($expected, TEST_MAX_LOOPS);
+}
+
+/* unbuffered, it drains the producers which are waiting */
+$channel = new Channel();
+for ($n = 0; $n < 5; $n++) {
+    Coroutine::run(static function () use ($channel, $n): void {
+        $channel->push($n);
+    });
+}
+Assert::same($channel->popMany(3), [0, 1, 2]);
+Assert::same($channel->popMany(10), [3, 4]);
+
+/* partial push */
+$channel = new Channel(2);
+try {
+    $channel->pushMany(['a', 'b', 'c'], 0);
+    echo "Never here\n";
+} catch (ChannelException $exception) {
+    echo "Timed out\n";
+}
+var_dump($channel->getLength());
+var_dump($channel->popMany(10));
+
+/* wait on empty */
+try {
+    $channel->popMany(10, 0);
+    echo "Never here\n";
+} catch (ChannelException $exception) {
+    echo "Timed out\n";
+}
+try {
+    $channel->popMany(0);
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . PHP_EOL;
+}
+Assert::same($channel->pushMany([]), $channel);
+
+echo "Done\n";
+
+?>
+--EXPECTF--
+Timed out
+int(2)
+array(2) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  string(1) "b"
+}
+Timed out
+%s(): Argument #1 ($count) must be greater than 0
+Done
@@ -0,0 +1,66 @@
+--TEST--
+swow_coroutine: stack pool
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+
+$stats = Coroutine::getStackPoolStats();
+foreach (['hits', 'misses', 'trims', 'count', 'bytes', 'resident_bytes', 'max_count', 'high_water_mark'] as $key) {
+    Assert::keyExists($stats, $key);
+    Assert::greaterThanEq($stats[$key], 0);
+}
+
+$n = 100;
+for ($i = 0; $i < $n; $i++) {
+    Coroutine::run(static function (): void { });
+}
+$after = Coroutine::getStackPoolStats();
+Assert::same(($after['hits'] + $after['misses']) - ($stats['hits'] + $stats['misses']), $n);
+Assert::lessThanEq($after['count'], $after['max_count']);
+Assert::lessThanEq($after['resident_bytes'], $after['bytes']);
+
+/* VM stack pages grown for a huge call frame are not cached */
+$stats = Coroutine::getStackPoolStats();
+Coroutine::run(static function (): void {
+    Assert::same(max(...range(1, 100000)), 100000);
+});
+$after = Coroutine::getStackPoolStats();
+Assert::lessThan($after['vm_bytes'] - $stats['vm_bytes'], 100000 * 16);
+
+/* idle stacks are released but still cached, cached VM stack pages are released */
+Coroutine::setStackPoolHighWaterMark(0);
+$stats = Coroutine::getStackPoolStats();
+Assert::same($stats['high_water_mark'], 0);
+Assert::same($stats['resident_bytes'], 0);
+Assert::same($stats['vm_count'], 0);
+Assert::same($stats['vm_bytes'], 0);
+Coroutine::run(static function (): void { });
+Assert::same(Coroutine::getStackPoolStats()['vm_bytes'], 0);
+
+/* disable it */
+Coroutine::setStackPoolMaxCount(0);
+$stats = Coroutine::getStackPoolStats();
+Assert::same($stats['max_count'], 0);
+Assert::same($stats['count'], 0);
+Assert::same($stats['bytes'], 0);
+Coroutine::run(static function (): void { });
+Assert::same(Coroutine::getStackPoolStats()['count'], 0);
+
+try {
+    Coroutine::setStackPoolMaxCount(-1);
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+Swow\Coroutine::setStackPoolMaxCount(): Argument #1 ($count) can not be negative
+Done
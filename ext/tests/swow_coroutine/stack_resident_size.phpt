@@ -0,0 +1,57 @@
+--TEST--
+swow_coroutine: stack resident size
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+
+/* VM stack pages are recycled */
+$stats = Coroutine::getStackPoolStats();
+foreach (['vm_hits', 'vm_misses', 'vm_count', 'vm_bytes'] as $key) {
+    Assert::keyExists($stats, $key);
+    Assert::greaterThanEq($stats[$key], 0);
+}
+Coroutine::run(static function (): void { });
+Coroutine::run(static function (): void { });
+$after = Coroutine::getStackPoolStats();
+Assert::same(($after['vm_hits'] + $after['vm_misses']) - ($stats['vm_hits'] + $stats['vm_misses']), 2);
+Assert::greaterThan($after['vm_hits'], $stats['vm_hits']);
+Assert::greaterThan($after['vm_count'], 0);
+
+/* only touched pages are resident */
+$idle = Coroutine::run(static function (): void {
+    Coroutine::yield();
+});
+$idleSize = $idle->getStackResidentSize();
+Assert::greaterThan($idleSize, 0);
+Assert::lessThan($idleSize, 256 * 1024);
+
+/* VM stack grows on demand */
+$deep = Coroutine::run(static function (): void {
+    $recursion = static function (int $n) use (&$recursion): void {
+        if ($n > 0) {
+            $recursion($n - 1);
+        } else {
+            Coroutine::yield();
+        }
+    };
+    $recursion(1000);
+});
+Assert::greaterThan($deep->getStackResidentSize(), $idleSize);
+Assert::greaterThanEq(Coroutine::getTotalStackResidentSize(), $idleSize + $deep->getStackResidentSize());
+Assert::greaterThan(Coroutine::getCurrent()->getStackResidentSize(), 0);
+
+$idle->resume();
+$deep->resume();
+Assert::same($idle->getStackResidentSize(), 0);
+Assert::same($deep->getStackResidentSize(), 0);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
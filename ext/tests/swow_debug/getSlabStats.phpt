@@ -0,0 +1,62 @@
+--TEST--
+swow_debug: getSlabStats
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Extension;
+use Swow\Sync\WaitReference;
+
+use function Swow\Debug\getSlabStats;
+
+function getSlabUsedCount(array $stats): int
+{
+    return array_sum(array_column($stats['classes'], 'count'));
+}
+
+$before = getSlabStats();
+$wr = new WaitReference();
+for ($n = 0; $n < 100; $n++) {
+    Coroutine::run(static function () use ($wr): void {
+        msleep(10);
+    });
+}
+/* timers of sleeping coroutines are in the slab */
+$during = getSlabStats();
+WaitReference::wait($wr);
+if (!Extension::isBuiltWith('asan')) {
+    Assert::greaterThan($during['page_count'], 0);
+    Assert::greaterThanEq(getSlabUsedCount($during) - getSlabUsedCount($before), 100);
+    Assert::lessThan($during['large_count'] - $before['large_count'], 100);
+    /* and they are given back to the free lists */
+    $after = getSlabStats();
+    Assert::lessThan(getSlabUsedCount($after), getSlabUsedCount($during));
+    Assert::greaterThanEq($after['page_count'], $during['page_count']);
+} else {
+    /* ASan sees every object, nothing is served from the slab */
+    Assert::same($during['page_count'], 0);
+}
+
+$stats = getSlabStats();
+Assert::same(array_keys($stats), ['page_count', 'page_bytes', 'used_bytes', 'large_count', 'classes']);
+$pageCount = 0;
+foreach ($stats['classes'] as $size => $class) {
+    Assert::same($size % 16, 0);
+    Assert::greaterThan($class['page_count'], 0);
+    $pageCount += $class['page_count'];
+}
+Assert::same($pageCount, $stats['page_count']);
+if ($stats['page_count'] > 0) {
+    Assert::same($stats['page_bytes'] % $stats['page_count'], 0);
+    Assert::lessThanEq($stats['used_bytes'], $stats['page_bytes']);
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,82 @@
+--TEST--
+swow_dns: cache
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Dns;
+use Swow\Sync\WaitReference;
+
+Dns::clearCache();
+Assert::same(Dns::getCacheStats()['size'], 0);
+Assert::same(Dns::getCacheStats()['capacity'], Dns::getCacheCapacity());
+
+// concurrent lookups share one request
+$stats = Dns::getCacheStats();
+$wr = new WaitReference();
+for ($n = 0; $n < 10; $n++) {
+    Coroutine::run(static function () use ($wr): void {
+        Assert::notSame(gethostbyname('localhost'), 'localhost');
+    });
+}
+WaitReference::wait($wr);
+$newStats = Dns::getCacheStats();
+Assert::same($newStats['misses'] - $stats['misses'], 1);
+Assert::same($newStats['coalesced'] - $stats['coalesced'], 9);
+Assert::same($newStats['size'], 1);
+
+// hit
+gethostbyname('localhost');
+Assert::same(Dns::getCacheStats()['hits'] - $newStats['hits'], 1);
+
+// expired
+$ttl = Dns::getCacheTtl();
+Dns::clearCache();
+Dns::setCacheTtl(1);
+$stats = Dns::getCacheStats();
+gethostbyname('localhost');
+msleep(10);
+gethostbyname('localhost');
+Assert::same(Dns::getCacheStats()['misses'] - $stats['misses'], 2);
+Dns::setCacheTtl($ttl);
+
+// eviction (numeric hosts are resolved without any network access)
+$capacity = Dns::getCacheCapacity();
+Dns::clearCache();
+Dns::setCacheCapacity(2);
+$stats = Dns::getCacheStats();
+for ($n = 1; $n <= 5; $n++) {
+    Assert::same(gethostbyname("127.0.0.{$n}"), "127.0.0.{$n}");
+}
+$newStats = Dns::getCacheStats();
+Assert::same($newStats['size'], 2);
+Assert::same($newStats['evictions'] - $stats['evictions'], 3);
+// the least recently used ones have been evicted
+gethostbyname('127.0.0.5');
+Assert::same(Dns::getCacheStats()['hits'] - $newStats['hits'], 1);
+gethostbyname('127.0.0.1');
+Assert::same(Dns::getCacheStats()['misses'] - $newStats['misses'], 1);
+Assert::same(Dns::getCacheStats()['evictions'] - $stats['evictions'], 4);
+
+// disabled
+Dns::setCacheCapacity(0);
+$stats = Dns::getCacheStats();
+Assert::same($stats['size'], 0);
+gethostbyname('localhost');
+Assert::same(Dns::getCacheStats()['size'], 0);
+Assert::same(Dns::getCacheStats()['misses'], $stats['misses']);
+Dns::setCacheCapacity($capacity);
+
+Assert::throws(static function (): void {
+    Dns::setCacheNegativeTtl(-1);
+}, ValueError::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,26 @@
+--TEST--
+swow_fs: concurrent file operations
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!is_writable(sys_get_temp_dir()), 'temp dir is not writable');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$dir = sys_get_temp_dir() . '/swow-test-concurrent-io';
+require __DIR__ . '/concurrent_io.inc';
+
+echo 'Done' . PHP_EOL;
+?>
+--CLEAN--
+<?php
+$dir = sys_get_temp_dir() . '/swow-test-concurrent-io';
+foreach (glob("{$dir}/*") ?: [] as $file) {
+    @unlink($file);
+}
+@rmdir($dir);
+?>
+--EXPECT--
+Done
@@ -0,0 +1,28 @@
+--TEST--
+swow_fs: concurrent file operations on the thread pool
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!is_writable(sys_get_temp_dir()), 'temp dir is not writable');
+?>
+--ENV--
+CAT_FS_IO_URING=0
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$dir = sys_get_temp_dir() . '/swow-test-concurrent-io-thread-pool';
+require __DIR__ . '/concurrent_io.inc';
+
+echo 'Done' . PHP_EOL;
+?>
+--CLEAN--
+<?php
+$dir = sys_get_temp_dir() . '/swow-test-concurrent-io-thread-pool';
+foreach (glob("{$dir}/*") ?: [] as $file) {
+    @unlink($file);
+}
+@rmdir($dir);
+?>
+--EXPECT--
+Done
@@ -0,0 +1,81 @@
+--TEST--
+swow_http: parse the whole head at once
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Http\Parser;
+
+$request = "GET /foo?bar=baz HTTP/1.1\r\n" .
+    "Host: example.com\r\n" .
+    "X-Test: value1\r\n" .
+    "x-test: value2\r\n" .
+    "X-Empty:\r\n" .
+    "Content-Length: 5\r\n" .
+    "\r\n" .
+    'hello';
+
+$parser = (new Parser())->setType(Parser::TYPE_REQUEST)->setEvents(Parser::EVENTS_NONE);
+
+// feed it byte by byte to make sure that split data will be joined
+$buffer = new Buffer(4096);
+$parsedOffset = 0;
+for ($n = 0; $n < strlen($request); $n++) {
+    $buffer->append($request[$n]);
+    $parsedOffset += $parser->executeHead($buffer, $parsedOffset);
+    if ($parser->getEvent() === Parser::EVENT_HEADERS_COMPLETE) {
+        break;
+    }
+    Assert::same($parser->getEvent(), Parser::EVENT_NONE);
+}
+Assert::same($parser->getEvent(), Parser::EVENT_HEADERS_COMPLETE);
+Assert::same($parser->getMethod(), 'GET');
+Assert::same($parser->getContentLength(), 5);
+
+[$offset, $length] = $parser->getUriOrReasonPhraseIndex();
+var_dump($buffer->read($offset, $length));
+foreach ($parser->getHeaderIndex() as $name => $spans) {
+    $values = [];
+    for ($i = 0; $i < count($spans); $i += 4) {
+        $values[] = $buffer->read($spans[$i], $spans[$i + 1]) . '=' . $buffer->read($spans[$i + 2], $spans[$i + 3]);
+    }
+    echo "{$name}: " . implode(', ', $values) . "\n";
+}
+
+// body is parsed by execute() as usual
+$parser->setEvents(Parser::EVENT_BODY | Parser::EVENT_MESSAGE_COMPLETE);
+$parsedOffset += $parser->execute($buffer, $parsedOffset);
+Assert::same($parser->getEvent(), Parser::EVENT_BODY);
+$parsedOffset += $parser->execute($buffer, $parsedOffset);
+Assert::same($parser->getEvent(), Parser::EVENT_MESSAGE_COMPLETE);
+
+// the next message on the same parser, index is renewed
+$response = "HTTP/1.1 404 Not Found\r\nCONTENT-LENGTH: 0\r\n\r\n";
+$parser->reset()->setType(Parser::TYPE_RESPONSE);
+$parsedOffset = $parser->executeHead($response);
+Assert::same($parsedOffset, strlen($response));
+Assert::same($parser->getStatusCode(), 404);
+[$offset, $length] = $parser->getUriOrReasonPhraseIndex();
+var_dump(substr($response, $offset, $length));
+var_dump(array_keys($parser->getHeaderIndex()));
+
+echo "Done\n";
+
+?>
+--EXPECT--
+string(12) "/foo?bar=baz"
+host: Host=example.com
+x-test: X-Test=value1, x-test=value2
+x-empty: X-Empty=
+content-length: Content-Length=5
+string(9) "Not Found"
+array(1) {
+  [0]=>
+  string(14) "content-length"
+}
+Done
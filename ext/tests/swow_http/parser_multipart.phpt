@@ -0,0 +1,163 @@
+--TEST--
+swow_http: multipart parser functionality
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Http\Parser;
+
+$boundary = '----SwowBoundary' . bin2hex(random_bytes(8));
+$fileData = str_repeat(getRandomBytes(64), 256);
+$body =
+    "--{$boundary}\r\n" .
+    "Content-Disposition: form-data; name=\"foo\"\r\n" .
+    "\r\n" .
+    "bar\r\n" .
+    "--{$boundary}\r\n" .
+    "Content-Disposition: form-data; name=\"file\"; filename=\"file.bin\"\r\n" .
+    "Content-Type: application/octet-stream\r\n" .
+    "\r\n" .
+    "{$fileData}\r\n" .
+    "--{$boundary}\r\n" .
+    "Content-Disposition: form-data; name=\"small\"; filename=\"small.txt\"\r\n" .
+    "\r\n" .
+    "small\r\n" .
+    "--{$boundary}\r\n" .
+    "Content-Disposition: form-data; name=\"euro\"; filename*=UTF-8''%E2%82%AC.txt\r\n" .
+    "\r\n" .
+    "euro\r\n" .
+    "--{$boundary}--\r\n";
+$request =
+    "POST /upload HTTP/1.1\r\n" .
+    "Host: localhost\r\n" .
+    "Content-Type: multipart/form-data; boundary={$boundary}\r\n" .
+    'Content-Length: ' . strlen($body) . "\r\n" .
+    "\r\n" .
+    $body;
+
+$spoolDirectory = sys_get_temp_dir() . '/swow_multipart_' . getmypid();
+mkdir($spoolDirectory);
+
+$parse = static function (Parser $parser, int $pieceSize) use ($request): array {
+    $buffer = new Buffer(Buffer::COMMON_SIZE);
+    $parts = [];
+    $offset = 0;
+    $headCompleted = false;
+    $headOffset = 0;
+    while (true) {
+        if ($offset < strlen($request)) {
+            $buffer->append(substr($request, $offset, $pieceSize));
+            $offset += $pieceSize;
+        }
+        while (true) {
+            if (!$headCompleted) {
+                // head data is referenced by index, keep it until the head is completed
+                $headOffset += $parser->executeHead($buffer, $headOffset);
+            } else {
+                // part data is copied, so it can be truncated at once
+                $buffer->truncateFrom($parser->executeMultipart($buffer));
+            }
+            $event = $parser->getEvent();
+            if ($event === Parser::EVENT_HEADERS_COMPLETE) {
+                Assert::true($parser->isMultipart());
+                $buffer->truncateFrom($headOffset);
+                $headCompleted = true;
+            } elseif ($event === Parser::EVENT_MULTIPART_DATA_END) {
+                $parts[] = $parser->getMultipartPart();
+            } elseif ($event === Parser::EVENT_MESSAGE_COMPLETE) {
+                return $parts;
+            } elseif ($event === Parser::EVENT_NONE) {
+                break;
+            }
+        }
+    }
+};
+
+// spooled to disk
+$parser = new Parser();
+$parser->setType(Parser::TYPE_REQUEST)->setEvents(Parser::EVENT_HEADERS_COMPLETE | Parser::EVENT_MESSAGE_COMPLETE);
+Assert::null($parser->getMultipartSpoolDirectory());
+Assert::same($parser->getMultipartMemoryThreshold(), 0);
+$parser->setMultipartSpoolDirectory($spoolDirectory);
+Assert::same($parser->getMultipartSpoolDirectory(), $spoolDirectory);
+foreach ([1, 7, 1024, strlen($request)] as $pieceSize) {
+    $parts = $parse($parser, $pieceSize);
+    Assert::count($parts, 4);
+
+    Assert::same($parts[0]['headers'], ['content-disposition' => 'form-data; name="foo"']);
+    Assert::same($parts[0]['data'], 'bar');
+    Assert::null($parts[0]['tmp_name']);
+    Assert::same($parts[0]['size'], 3);
+    Assert::same($parts[0]['error'], UPLOAD_ERR_OK);
+
+    Assert::same($parts[1]['headers'], [
+        'content-disposition' => 'form-data; name="file"; filename="file.bin"',
+        'content-type' => 'application/octet-stream',
+    ]);
+    Assert::same($parts[1]['data'], '');
+    Assert::same(dirname($parts[1]['tmp_name']), realpath($spoolDirectory));
+    Assert::same(file_get_contents($parts[1]['tmp_name']), $fileData);
+    Assert::same($parts[1]['size'], strlen($fileData));
+    Assert::same($parts[1]['error'], UPLOAD_ERR_OK);
+    unlink($parts[1]['tmp_name']);
+
+    Assert::same(file_get_contents($parts[2]['tmp_name']), 'small');
+    Assert::same($parts[2]['size'], 5);
+    unlink($parts[2]['tmp_name']);
+
+    // filename* (RFC 5987) makes it a file part as well
+    Assert::same(file_get_contents($parts[3]['tmp_name']), 'euro');
+    unlink($parts[3]['tmp_name']);
+
+    $parser->reset();
+}
+
+// small files are kept in memory
+$parser->setMultipartMemoryThreshold(1024);
+Assert::same($parser->getMultipartMemoryThreshold(), 1024);
+$parts = $parse($parser, 512);
+Assert::same(file_get_contents($parts[1]['tmp_name']), $fileData);
+unlink($parts[1]['tmp_name']);
+Assert::null($parts[2]['tmp_name']);
+Assert::same($parts[2]['data'], 'small');
+Assert::same($parts[2]['size'], 5);
+Assert::null($parts[3]['tmp_name']);
+Assert::same($parts[3]['data'], 'euro');
+$parser->reset();
+
+// part is not completed
+Assert::throws(static function () use ($parser): void {
+    $parser->getMultipartPart();
+}, Swow\Http\ParserException::class);
+
+// invalid threshold
+Assert::throws(static function () use ($parser): void {
+    $parser->setMultipartMemoryThreshold(-1);
+}, ValueError::class);
+
+// parts which are not fetched are removed
+$parser->setMultipartMemoryThreshold(0);
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+$buffer->append($request);
+$parser->executeHead($buffer);
+$buffer->truncateFrom($parser->getParsedLength());
+$parsedOffset = 0;
+do {
+    $parsedOffset += $parser->executeMultipart($buffer, $parsedOffset);
+} while ($parser->getEvent() !== Parser::EVENT_MESSAGE_COMPLETE);
+$parser->reset();
+Assert::same(scandir($spoolDirectory), ['.', '..']);
+$parser->setMultipartSpoolDirectory(null);
+Assert::null($parser->getMultipartSpoolDirectory());
+
+rmdir($spoolDirectory);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
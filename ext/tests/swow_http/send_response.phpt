@@ -0,0 +1,108 @@
+--TEST--
+swow_http: sendResponse
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Http\Http;
+use Swow\Socket;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$client = new Socket(Socket::TYPE_TCP);
+Coroutine::run(static function () use ($server, $client): void {
+    $client->connect($server->getSockAddress(), $server->getSockPort());
+});
+$connection = $server->accept();
+
+$headers = [
+    'Server' => 'swow',
+    'X-Test-Header' => ['value1', 'value2'],
+    'X-Null-Header' => null,
+];
+
+/* plain body */
+$body = str_repeat('x', 32 * 1024);
+Http::sendResponse($connection, 200, '', $headers + ['Content-Length' => strlen($body)], $body);
+$expected = Http::packResponse(200, '', $headers + ['Content-Length' => strlen($body)], $body);
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* Buffer body, reason phrase and protocol version */
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+$buffer->append('hello world');
+Http::sendResponse($connection, 418, "I'm a teapot", ['Content-Length' => 11], $buffer, '1.0');
+$expected = "HTTP/1.0 418 I'm a teapot\r\nContent-Length: 11\r\n\r\nhello world";
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* no body */
+Http::sendResponse($connection, 204);
+$expected = "HTTP/1.1 204 No Content\r\n\r\n";
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* large head */
+$largeHeaders = ['X-Large-Header' => str_repeat('y', 4096)];
+Http::sendResponse($connection, 200, '', $largeHeaders);
+$expected = Http::packResponse(200, '', $largeHeaders);
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* chunked */
+$chunks = ['foo', '', new Buffer(0), str_repeat('z', 0x1234), $buffer];
+Http::sendResponse($connection, 200, '', ['Transfer-Encoding' => 'chunked'], $chunks);
+$expected = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" .
+    "3\r\nfoo\r\n" .
+    "1234\r\n" . str_repeat('z', 0x1234) . "\r\n" .
+    "b\r\nhello world\r\n" .
+    "0\r\n\r\n";
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* many chunks */
+$chunks = array_map(static fn(int $n): string => str_repeat('c', $n), range(1, 32));
+Http::sendResponse($connection, 200, '', ['Transfer-Encoding' => 'chunked'], $chunks);
+$expected = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+foreach ($chunks as $chunk) {
+    $expected .= dechex(strlen($chunk)) . "\r\n{$chunk}\r\n";
+}
+$expected .= "0\r\n\r\n";
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* no chunks */
+Http::sendResponse($connection, 200, '', ['Transfer-Encoding' => 'chunked'], []);
+$expected = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n";
+Assert::same($client->readString(strlen($expected)), $expected);
+
+/* the array of chunks is not modified */
+$stringable = new class() implements Stringable {
+    public function __toString(): string
+    {
+        return 'stringable';
+    }
+};
+$chunks = [$stringable];
+Http::sendResponse($connection, 200, '', [], $chunks);
+$expected = "HTTP/1.1 200 OK\r\n\r\na\r\nstringable\r\n0\r\n\r\n";
+Assert::same($client->readString(strlen($expected)), $expected);
+Assert::same($chunks[0], $stringable);
+
+/* bad chunk */
+Assert::throws(static function () use ($connection): void {
+    Http::sendResponse($connection, 200, '', [], ['foo', []]);
+}, TypeError::class);
+
+$connection->close();
+$client->close();
+
+/* closed */
+Assert::throws(static function () use ($connection): void {
+    Http::sendResponse($connection, 200);
+}, Swow\SocketException::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
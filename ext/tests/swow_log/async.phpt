@@ -0,0 +1,92 @@
+--TEST--
+swow_log: async log
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(Swow\Log::isAsync(), 'Async log is enabled by env');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Log;
+
+Assert::false(Log::isAsync());
+// nothing to do
+Log::flush();
+Assert::same(Log::getAsyncStats()['buffer_size'], 0);
+
+Log::enableAsync(10000, Log::BACKPRESSURE_SAMPLE, 4);
+Assert::true(Log::isAsync());
+$stats = Log::getAsyncStats();
+foreach (['records', 'bytes', 'batches', 'dropped', 'sampled_out', 'blocked', 'direct', 'write_errors', 'pending_bytes'] as $key) {
+    Assert::same($stats[$key], 0);
+}
+// aligned to power of 2
+Assert::same($stats['buffer_size'], 16384);
+Log::flush();
+Assert::same(Log::getAsyncStats()['pending_bytes'], 0);
+
+// records go through the ring buffer
+Log::setTypes(Log::getTypes() | Log::TYPE_INFO);
+for ($n = 0; $n < 3; $n++) {
+    Log::write(Log::TYPE_INFO, "record {$n}");
+}
+Log::flush();
+$stats = Log::getAsyncStats();
+Assert::same($stats['records'], 3);
+Assert::greaterThan($stats['bytes'], 0);
+Assert::greaterThan($stats['batches'], 0);
+Assert::same($stats['pending_bytes'], 0);
+echo "flushed\n";
+
+// backpressure on a small ring buffer
+$message = str_repeat('x', 1000);
+foreach ([Log::BACKPRESSURE_DROP => 'dropped', Log::BACKPRESSURE_SAMPLE => 'sampled_out'] as $backpressure => $key) {
+    Log::enableAsync(4096, $backpressure, 2);
+    for ($n = 0; $n < 1000; $n++) {
+        Log::write(Log::TYPE_INFO, $message);
+    }
+    Log::flush();
+    $stats = Log::getAsyncStats();
+    Assert::greaterThan($stats[$key], 0);
+    Assert::same($stats['records'] + $stats['dropped'] + $stats['sampled_out'], 1000);
+    Assert::same($stats['pending_bytes'], 0);
+}
+
+// re-enable with new options
+Log::enableAsync();
+Assert::same(Log::getAsyncStats()['buffer_size'], Log::ASYNC_DEFAULT_BUFFER_SIZE);
+Log::disableAsync();
+Assert::false(Log::isAsync());
+Log::disableAsync();
+
+try {
+    Log::write(Log::TYPE_ERROR, 'foo');
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+
+foreach ([[0], [1024, 3], [1024, Log::BACKPRESSURE_SAMPLE, 0]] as $arguments) {
+    try {
+        Log::enableAsync(...$arguments);
+        echo "Never here\n";
+    } catch (ValueError $exception) {
+        echo $exception->getMessage() . "\n";
+    }
+}
+Assert::false(Log::isAsync());
+
+echo "Done\n";
+?>
+--EXPECTF--
+%sInfo: <USER> record 0
+%sInfo: <USER> record 1
+%sInfo: <USER> record 2
+flushed
+%ASwow\Log::write(): Argument #1 ($type) must be one of Swow\Log::TYPE_DEBUG, Swow\Log::TYPE_INFO, Swow\Log::TYPE_NOTICE or Swow\Log::TYPE_WARNING
+Swow\Log::enableAsync(): Argument #1 ($bufferSize) must be greater than 0
+Swow\Log::enableAsync(): Argument #2 ($backpressure) is unrecognized
+Swow\Log::enableAsync(): Argument #3 ($sampleRate) must be greater than 0 and less than or equal to %d
+Done
@@ -0,0 +1,76 @@
+--TEST--
+swow_pgsql: test pipeline mode
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if_env_not_true('TEST_SWOW_POSTGRESQL');
+skip_if(!Swow\Extension::isBuiltWith('pgsql'), 'pgsql is not built in');
+skip_if(PHP_VERSION_ID < 80100, 'pipeline mode requires PHP 8.1+');
+skip_if(!method_exists(PDO::class, 'pgsqlEnterPipelineMode') && !method_exists('Pdo\Pgsql', 'pgsqlEnterPipelineMode'), 'libpq does not support pipeline mode');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+require __DIR__ . '/PDOUtil.inc';
+
+PDOUtil::init();
+
+$pdo = PDOUtil::create();
+$pdo->setAttribute(PDO::ATTR_ERRMODE, PDO::ERRMODE_EXCEPTION);
+
+// batched inserts cost one round trip
+$insert = $pdo->prepare('INSERT INTO test_swow_pgsql_users (name, age) values (?, ?)');
+Assert::true($pdo->pgsqlEnterPipelineMode());
+for ($i = 0; $i < 100; $i++) {
+    $insert->execute(["user-{$i}", 18 + $i % 10]);
+}
+Assert::true($pdo->pgsqlPipelineSync());
+Assert::same($insert->rowCount(), 1);
+
+// results are collected in order
+$statements = [];
+for ($i = 0; $i < 10; $i++) {
+    $statements[$i] = $pdo->prepare('SELECT name FROM test_swow_pgsql_users WHERE name = ?');
+    $statements[$i]->execute(["user-{$i}"]);
+}
+$count = $pdo->prepare('SELECT COUNT(*) FROM test_swow_pgsql_users');
+$count->execute();
+Assert::true($pdo->pgsqlPipelineSync());
+foreach ($statements as $i => $statement) {
+    Assert::same($statement->fetchColumn(), "user-{$i}");
+}
+Assert::same($count->fetchColumn(), 100);
+
+// an error aborts the following statements until the sync point
+$bad = $pdo->prepare('SELECT * FROM test_swow_pgsql_no_such_table');
+$bad->execute();
+$count->execute();
+try {
+    $pdo->pgsqlPipelineSync();
+    echo "Never here\n";
+} catch (PDOException $exception) {
+    Assert::same($exception->getCode(), '42P01');
+    Assert::contains($exception->getMessage(), 'test_swow_pgsql_no_such_table');
+}
+Assert::same($bad->errorCode(), '42P01');
+Assert::same($count->errorCode(), 'HY000');
+Assert::same($pdo->errorInfo()[0], '42P01');
+Assert::contains($pdo->errorInfo()[2], 'test_swow_pgsql_no_such_table');
+
+// synchronous commands are refused in pipeline mode
+try {
+    $pdo->exec('SELECT 1');
+    echo "Never here\n";
+} catch (PDOException $exception) {
+    Assert::contains($exception->getMessage(), 'pipeline mode');
+}
+
+// pending results are read when exiting
+$count->execute();
+Assert::true($pdo->pgsqlExitPipelineMode());
+Assert::same($count->fetchColumn(), 100);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
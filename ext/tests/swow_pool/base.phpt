@@ -0,0 +1,123 @@
+--TEST--
+swow_pool: base
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Pool;
+use Swow\PoolException;
+use Swow\Sync\WaitReference;
+
+$id = 0;
+$pool = new Pool(static function () use (&$id): stdClass {
+    $item = new stdClass();
+    $item->id = ++$id;
+    return $item;
+}, maxSize: 2, minSize: 1, idleTimeout: 50);
+
+Assert::same($pool->fill(), 1);
+Assert::same($pool->getSize(), 1);
+Assert::same($pool->getIdleCount(), 1);
+
+// the most recently used one is reused first
+$a = $pool->get();
+$b = $pool->get();
+Assert::same([$a->id, $b->id], [1, 2]);
+$pool->put($a)->put($b);
+Assert::same($pool->get(), $b);
+$pool->put($b);
+
+// waiters are served in order
+$a = $pool->get();
+$b = $pool->get();
+$order = [];
+$wr = new WaitReference();
+for ($n = 0; $n < 3; $n++) {
+    Coroutine::run(static function () use ($pool, $n, &$order, $wr): void {
+        $item = $pool->get();
+        $order[] = $n;
+        $pool->put($item);
+    });
+}
+try {
+    $pool->get(1);
+    echo "Never here\n";
+} catch (PoolException $exception) {
+    Assert::same($exception->getCode(), Errno::ETIMEDOUT);
+}
+$pool->put($a);
+WaitReference::wait($wr);
+Assert::same($order, [0, 1, 2]);
+
+// broken ones are released
+$pool->put($b, true);
+Assert::same($pool->getSize(), 1);
+Assert::same($pool->get(), $a);
+$pool->put($a);
+
+// idle ones are evicted but min size is kept
+$c = $pool->get();
+$d = $pool->get();
+$pool->put($c)->put($d);
+Assert::same($pool->getSize(), 2);
+msleep(200);
+Assert::same($pool->getSize(), 1);
+
+$stats = $pool->getStats();
+Assert::same($stats['wait_count'], 4);
+Assert::same($stats['timeout_count'], 1);
+Assert::greaterThan($stats['eviction_count'], 0);
+Assert::greaterThan($stats['max_wait_time'], 0);
+
+// only the ones handed out can be put back, and only once
+$a = $pool->get();
+$pool->put($a);
+foreach ([[$a, false], [$a, true], [new stdClass(), false], [new stdClass(), true]] as [$item, $broken]) {
+    try {
+        $pool->put($item, $broken);
+        echo "Never here\n";
+    } catch (PoolException $exception) {
+        Assert::same($exception->getCode(), Errno::EMISUSE);
+    }
+}
+Assert::same($pool->getSize(), 1);
+Assert::same($pool->getIdleCount(), 1);
+Assert::same($pool->get(), $a);
+$pool->put($a);
+
+// checker
+$pool = new Pool(static fn(): stdClass => new stdClass(), checker: static fn(stdClass $item): bool => !isset($item->closed));
+$a = $pool->get();
+$a->closed = true;
+$pool->put($a);
+Assert::notSame($pool->get(), $a);
+Assert::same($pool->getStats()['check_failure_count'], 1);
+
+// closed
+$pool->close();
+try {
+    $pool->get();
+    echo "Never here\n";
+} catch (PoolException $exception) {
+    Assert::same($exception->getCode(), Errno::ECLOSED);
+}
+
+try {
+    (new Pool(static fn() => 'foo'))->get();
+    echo "Never here\n";
+} catch (PoolException $exception) {
+    echo "PoolException\n";
+}
+
+echo "Done\n";
+
+?>
+--EXPECT--
+PoolException
+Done
@@ -0,0 +1,57 @@
+--TEST--
+swow_pool: sockets are checked by liveness by default
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Pool;
+use Swow\Socket;
+use Swow\SocketException;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$connections = [];
+Coroutine::run(static function () use ($server, &$connections): void {
+    try {
+        while (true) {
+            $connections[] = $server->accept();
+        }
+    } catch (SocketException) {
+        /* server closed */
+    }
+});
+
+$pool = new Pool(static fn(): Socket => (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort()));
+$a = $pool->get();
+$pool->put($a);
+msleep(10);
+
+// alive one is reused
+Assert::same($pool->get(), $a);
+$pool->put($a);
+Assert::same($pool->getStats()['check_failure_count'], 0);
+
+// the idle one is closed by peer, it is replaced by a new one
+Assert::count($connections, 1);
+$connections[0]->close();
+msleep(10);
+$b = $pool->get();
+Assert::notSame($b, $a);
+Assert::true($b->isAvailable());
+Assert::same($pool->getStats()['check_failure_count'], 1);
+Assert::same($pool->getSize(), 1);
+$pool->put($b);
+
+$pool->close();
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
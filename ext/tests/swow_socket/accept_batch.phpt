@@ -0,0 +1,128 @@
+--TEST--
+swow_socket: accept connections in batch
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Channel;
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitGroup;
+use Swow\Sync\WaitReference;
+
+const N = 16;
+
+function connect_n(Socket $server, int $n): array
+{
+    $clients = [];
+    for ($i = 0; $i < $n; $i++) {
+        $clients[] = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+    }
+    return $clients;
+}
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+
+// all pending connections are accepted in one go
+$clients = connect_n($server, N);
+$connections = $server->acceptBatch(N * 2);
+Assert::count($connections, N);
+foreach ($connections as $connection) {
+    Assert::isInstanceOf($connection, Socket::class);
+    Assert::greaterThan($connection->getPeerPort(), 0);
+}
+$ports = array_map(static fn (Socket $client) => $client->getSockPort(), $clients);
+$peerPorts = array_map(static fn (Socket $connection) => $connection->getPeerPort(), $connections);
+sort($ports);
+sort($peerPorts);
+Assert::same($peerPorts, $ports);
+
+// capped by max count
+$clients = connect_n($server, 3);
+Assert::count($server->acceptBatch(2), 2);
+Assert::count($server->acceptBatch(2), 1);
+
+try {
+    $server->acceptBatch(0);
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+
+// dispatch to channel
+$channel = new Channel(N);
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $channel, $wr): void {
+    // it returns when server is closed
+    $server->acceptLoop($channel, 4);
+    $channel->close();
+});
+$clients = connect_n($server, N);
+for ($i = 0; $i < N; $i++) {
+    Assert::isInstanceOf($channel->pop(), Socket::class);
+}
+$server->close();
+WaitReference::wait($wr);
+Assert::false($channel->isAvailable());
+
+// dispatch to handler
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$wg = new WaitGroup();
+$wg->add(N);
+Coroutine::run(static function () use ($server, $wg): void {
+    $server->acceptLoop(static function (Socket $connection) use ($wg): void {
+        $connection->send('x');
+        $connection->close();
+        $wg->done();
+    }, 4);
+});
+$clients = connect_n($server, N);
+foreach ($clients as $client) {
+    Assert::same($client->recvString(), 'x');
+}
+$wg->wait();
+$server->close();
+
+// established connections are not starved by a connection flood
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen(N * 2);
+$establishedClient = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+$established = $server->accept();
+$log = [];
+$wr = new WaitReference();
+Coroutine::run(static function () use ($established, &$log, $wr): void {
+    Assert::same($established->recvString(), 'x');
+    $log[] = 'established';
+});
+$clients = connect_n($server, N);
+$wg = new WaitGroup();
+$wg->add(N);
+Coroutine::run(static function () use ($server, $establishedClient, &$log, $wg): void {
+    $server->acceptLoop(static function (Socket $connection) use ($establishedClient, &$log, $wg): void {
+        $log[] = 'accepted';
+        if (count($log) === 1) {
+            // it becomes readable in the middle of the first batch
+            $establishedClient->send('x');
+        }
+        $wg->done();
+    }, 4);
+});
+$wg->wait();
+WaitReference::wait($wr);
+$server->close();
+$position = array_search('established', $log, true);
+Assert::greaterThan($position, 0);
+// it runs between batches instead of after the whole backlog has been drained
+Assert::lessThan($position, N);
+
+echo "Done\n";
+?>
+--EXPECT--
+Swow\Socket::acceptBatch(): Argument #1 ($maxCount) must be greater than 0
+Done
@@ -0,0 +1,81 @@
+--TEST--
+swow_socket: broadcast
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+Socket::setGlobalTimeout(1000);
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+
+$clients = $connections = [];
+for ($n = 0; $n < 4; $n++) {
+    $clients[$n] = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+    $connections["connection-{$n}"] = $server->accept();
+}
+
+$data = str_repeat('x', 256 * 1024);
+$rounds = 8;
+
+// all of clients receive all of data
+$wr = new WaitReference();
+foreach ($clients as $client) {
+    Coroutine::run(static function () use ($client, $data, $rounds, $wr): void {
+        Assert::same($client->readString(strlen($data) * $rounds), str_repeat($data, $rounds));
+    });
+}
+for ($n = 0; $n < $rounds; $n++) {
+    $buffer = new Buffer(strlen($data));
+    $buffer->append($data);
+    $stats = Socket::broadcast($connections, $n % 2 ? $data : $buffer, failures: $failures);
+    Assert::same($stats['done'] + $stats['queued'], count($connections));
+    Assert::same($stats['skipped'], 0);
+    Assert::same($stats['failed'], 0);
+    Assert::same($failures, []);
+    // data is safe to be modified
+    $buffer->write(0, 'y');
+}
+WaitReference::wait($wr);
+
+// the slow one is skipped
+$slowConnection = $connections['connection-0'];
+$skipped = 0;
+for ($n = 0; $n < 64; $n++) {
+    $stats = Socket::broadcast([$slowConnection], $data, 1024 * 1024, $failures);
+    if ($stats['skipped'] === 1) {
+        Assert::same($failures, [0 => Errno::ENOBUFS]);
+        $skipped++;
+    }
+}
+Assert::greaterThan($skipped, 0);
+
+// failures are indexed by keys of targets
+$connections['connection-1']->close();
+$stats = Socket::broadcast($connections, 'foo', failures: $failures);
+Assert::same($stats['failed'], 1);
+Assert::keyExists($failures, 'connection-1');
+
+try {
+    Socket::broadcast([new stdClass()], 'foo');
+    echo "Never here\n";
+} catch (TypeError $error) {
+    echo "TypeError\n";
+}
+
+echo "Done\n";
+
+?>
+--EXPECT--
+TypeError
+Done
@@ -0,0 +1,102 @@
+--TEST--
+swow_socket: length-prefixed frames
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+$socket = new Socket(Socket::TYPE_TCP);
+Assert::same($socket->getFrameFormat(), ['length_size' => 4, 'little_endian' => false, 'length_offset' => 0, 'max_length' => 0]);
+try {
+    $socket->setFrameFormat(3);
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+
+$wr = new WaitReference();
+$server = new Socket(Socket::TYPE_TCP);
+$server->setFrameFormat(2, true, 1, 64)->bind('127.0.0.1')->listen();
+Coroutine::run(static function () use ($server, $wr): void {
+    $connection = $server->accept();
+    // inherited from server
+    Assert::same($connection->getFrameFormat()['length_offset'], 1);
+    $connection->sendFrame('foo');
+    $connection->writeFrame(['b', ['xar', 1], new Buffer(0)]);
+    $connection->sendFrame('');
+    msleep(10);
+    // header and body are split
+    $connection->send("\x00\x03");
+    msleep(10);
+    $connection->send("\x00ba");
+    msleep(10);
+    $connection->send('z');
+    // too large
+    $connection->send("\x00\xff\x00" . str_repeat('x', 255));
+    $connection->close();
+});
+
+$client = new Socket(Socket::TYPE_TCP);
+$client->setFrameFormat(2, true, 1, 64)->connect($server->getSockAddress(), $server->getSockPort());
+$buffer = new Buffer(0);
+msleep(5);
+// all complete frames are received in one go
+Assert::same($client->recvFrames($buffer), [3, 3, 0]);
+Assert::same($buffer->toString(), 'foobar');
+Assert::same($client->recvFrame($buffer), 3);
+Assert::same($buffer->toString(), 'foobarbaz');
+try {
+    $client->recvFrame($buffer);
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::EMSGSIZE);
+}
+// nothing is consumed
+$client->setFrameFormat(2, true, 1);
+Assert::same($client->recvFrame($buffer), 255);
+Assert::same($buffer->getLength(), 9 + 255);
+try {
+    $client->recvFrame($buffer);
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::ECONNRESET);
+}
+$client->close();
+WaitReference::wait($wr);
+$server->close();
+
+// length can not be represented by the length field
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$a = new Socket(Socket::TYPE_TCP);
+$a->connect($server->getSockAddress(), $server->getSockPort());
+$b = $server->accept();
+try {
+    $a->setFrameFormat(1)->sendFrame(str_repeat('x', 256));
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::EMSGSIZE);
+}
+$a->sendFrame(str_repeat('x', 255));
+$b->setFrameFormat(1);
+Assert::same($b->recvFrame(new Buffer(0)), 255);
+$a->close();
+$b->close();
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Swow\Socket::setFrameFormat(): Argument #1 ($lengthSize) must be 1, 2, 4 or 8
+Done
@@ -0,0 +1,69 @@
+--TEST--
+swow_socket: persistent read interest
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+Assert::false(Socket::getGlobalReadPersistent());
+Socket::setGlobalReadPersistent(true);
+Assert::true(Socket::getGlobalReadPersistent());
+Assert::true((new Socket(Socket::TYPE_TCP))->isReadPersistent());
+Assert::false((new Socket(Socket::TYPE_UDP))->isReadPersistent());
+Socket::setGlobalReadPersistent(false);
+
+try {
+    (new Socket(Socket::TYPE_UDP))->setReadPersistent(true);
+    echo 'Never here' . PHP_EOL;
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::EMISUSE);
+}
+
+$randoms = getRandomBytesArray(TEST_MAX_REQUESTS);
+$wr = new WaitReference();
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+Coroutine::run(static function () use ($server, $randoms, $wr): void {
+    $connection = $server->accept();
+    Assert::false($connection->isReadPersistent());
+    $connection->setReadPersistent(true);
+    Assert::true($connection->isReadPersistent());
+    // ping-pong
+    foreach ($randoms as $random) {
+        Assert::same($connection->readString(strlen($random)), $random);
+        $connection->send($random);
+    }
+    // data and EOF arrive while nobody is reading
+    msleep(100);
+    $connection->checkLiveness();
+    Assert::same($connection->peekString(strlen($randoms[0])), $randoms[0]);
+    Assert::same($connection->readString(strlen(implode($randoms))), implode($randoms));
+    Assert::same($connection->recvString(), '');
+    $connection->close();
+});
+
+$client = new Socket(Socket::TYPE_TCP);
+$client->connect($server->getSockAddress(), $server->getSockPort())->setReadPersistent(true);
+foreach ($randoms as $random) {
+    $client->send($random);
+    Assert::same($client->readString(strlen($random)), $random);
+}
+$client->send(implode($randoms));
+$client->close();
+WaitReference::wait($wr);
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
@@ -0,0 +1,75 @@
+--TEST--
+swow_socket: recv until delimiter
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+$wr = new WaitReference();
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+Coroutine::run(static function () use ($server, $wr): void {
+    $connection = $server->accept();
+    // delimiter is split across writes
+    $connection->send("foo\r");
+    msleep(10);
+    $connection->send("\nbar\r\n\r\nbaz");
+    msleep(10);
+    $connection->send(str_repeat('x', 64) . "\r\n");
+    $connection->close();
+});
+
+$client = new Socket(Socket::TYPE_TCP);
+$client->connect($server->getSockAddress(), $server->getSockPort());
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+Assert::same($client->recvUntil($buffer, "\r\n"), 5);
+Assert::same($buffer->toString(), "foo\r\n");
+// leftovers are kept in socket
+Assert::same($client->recvUntil($buffer, "\r\n"), 5);
+Assert::same($client->recvUntil($buffer, "\r\n"), 2);
+Assert::same($buffer->toString(), "foo\r\nbar\r\n\r\n");
+$buffer->clear();
+// nothing is consumed if the delimiter is not found in max length
+try {
+    $client->recvUntil($buffer, "\r\n", 16);
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::EMSGSIZE);
+}
+Assert::same($buffer->getLength(), 0);
+// buffer is extended on demand
+$small = new Buffer(8);
+Assert::same($client->recvUntil($small, "\r\n", 128), 69);
+Assert::same($small->toString(), 'baz' . str_repeat('x', 64) . "\r\n");
+try {
+    $client->recvUntil($buffer, "\r\n");
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::ECONNRESET);
+}
+try {
+    $client->recvUntil($buffer, '');
+    echo "Never here\n";
+} catch (ValueError $exception) {
+    echo $exception->getMessage() . "\n";
+}
+$client->close();
+WaitReference::wait($wr);
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Swow\Socket::recvUntil(): Argument #2 ($delimiter) can not be empty
+Done
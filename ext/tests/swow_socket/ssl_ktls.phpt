@@ -0,0 +1,59 @@
+--TEST--
+swow_socket: SSL with kTLS
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!getenv('SWOW_HAVE_SSL') && !Swow\Extension::isBuiltWith('ssl'), 'extension must be built with ssl');
+skip_linux_only();
+skip_if(!is_dir('/sys/module/tls'), 'kernel tls module is not loaded');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+$file = tempnam(sys_get_temp_dir(), 'swow_ktls_');
+file_put_contents($file, $fileContent = getRandomBytes(256 * 1024));
+$message = getRandomBytes(64 * 1024);
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $file, $message, $wr): void {
+    $connection = $server->accept();
+    $connection->enableCrypto([
+        'certificate' => __DIR__ . '/../include/ssl/server.crt',
+        'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+        'ktls' => true,
+    ]);
+    Assert::true($connection->isKtlsEnabled());
+    Assert::same($connection->readString(5), 'hello');
+    Assert::same($connection->sendFile($file), filesize($file));
+    $connection->sendString($message);
+    Assert::same($connection->readString(3), 'bye');
+    $connection->close();
+});
+$client = new Socket(Socket::TYPE_TCP);
+$client->connect($server->getSockAddress(), $server->getSockPort());
+$client->enableCrypto([
+    'verify_peer' => false,
+    'verify_peer_name' => false,
+    'ktls' => true,
+]);
+Assert::true($client->isKtlsEnabled());
+$client->sendString('hello');
+Assert::same($client->readString(strlen($fileContent)), $fileContent);
+Assert::same($client->readString(strlen($message)), $message);
+$client->sendString('bye');
+$wr::wait($wr);
+$client->close();
+unlink($file);
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
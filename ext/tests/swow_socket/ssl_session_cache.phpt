@@ -0,0 +1,91 @@
+--TEST--
+swow_socket: SSL session cache
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!getenv('SWOW_HAVE_SSL') && !Swow\Extension::isBuiltWith('ssl'), 'extension must be built with ssl');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+const N = 4;
+
+function handshake(Socket $server, array $serverOptions = [], array $clientOptions = []): void
+{
+    $wr = new WaitReference();
+    Coroutine::run(static function () use ($server, $serverOptions, $wr): void {
+        $connection = $server->accept();
+        $connection->enableCrypto($serverOptions + [
+            'certificate' => __DIR__ . '/../include/ssl/server.crt',
+            'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+        ]);
+        $connection->sendString($connection->readString(4));
+        $connection->close();
+    });
+    $client = new Socket(Socket::TYPE_TCP);
+    $client->connect($server->getSockAddress(), $server->getSockPort());
+    $client->enableCrypto($clientOptions + [
+        'verify_peer' => false,
+        'verify_peer_name' => false,
+    ]);
+    $client->sendString('ping');
+    Assert::same($client->readString(4), 'ping');
+    $client->close();
+    $wr::wait($wr);
+}
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+
+/* tickets */
+for ($n = 0; $n < N; $n++) {
+    handshake($server);
+}
+$stats = Socket::getSslSessionCacheStats();
+Assert::same($stats['server_misses'], 1);
+Assert::same($stats['server_hits'], N - 1);
+Assert::same($stats['client_misses'], 1);
+Assert::same($stats['client_hits'], N - 1);
+
+/* tickets issued by the previous key are still accepted */
+Socket::rotateSslTicketKeys();
+handshake($server);
+Assert::same(Socket::getSslSessionCacheStats()['server_hits'], N);
+
+/* stateful sessions */
+Socket::clearSslSessionCache();
+for ($n = 0; $n < N; $n++) {
+    handshake($server, ['no_ticket' => true]);
+}
+$stats = Socket::getSslSessionCacheStats();
+Assert::same($stats['server_misses'], 2);
+Assert::same($stats['server_hits'], N * 2 - 1);
+Assert::greaterThan($stats['server_count'], 0);
+
+/* client sessions are not shared by different verify options */
+handshake($server, ['no_ticket' => true], ['allow_self_signed' => true]);
+$stats = Socket::getSslSessionCacheStats();
+Assert::same($stats['client_misses'], 3);
+Assert::same($stats['server_misses'], 3);
+handshake($server, ['no_ticket' => true], ['allow_self_signed' => true]);
+Assert::same(Socket::getSslSessionCacheStats()['client_hits'], N * 2);
+
+/* disabled */
+handshake($server, clientOptions: ['no_session_cache' => true]);
+Assert::same(Socket::getSslSessionCacheStats()['client_misses'], 3);
+Socket::setSslSessionCacheOptions(size: 0);
+handshake($server);
+$stats = Socket::getSslSessionCacheStats();
+Assert::same($stats['size'], 0);
+Assert::same($stats['server_count'] + $stats['client_count'], 0);
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
@@ -0,0 +1,71 @@
+--TEST--
+swow_socket: udp batch
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Socket;
+use Swow\Errno;
+use Swow\SocketException;
+
+Socket::setGlobalTimeout(1000);
+
+$server = new Socket(Socket::TYPE_UDP);
+$server->bind('127.0.0.1');
+$client = new Socket(Socket::TYPE_UDP);
+
+$datagrams = [];
+for ($n = 0; $n < 32; $n++) {
+    $datagrams[] = $n % 2 ? "datagram-{$n}" : ["datagram-{$n}", $server->getSockAddress(), $server->getSockPort()];
+}
+$client->sendBatch($datagrams, $server->getSockAddress(), $server->getSockPort());
+
+$buffers = [];
+for ($n = 0; $n < 8; $n++) {
+    $buffers[] = new Buffer(Buffer::COMMON_SIZE);
+}
+$received = 0;
+while ($received < 32) {
+    $count = $server->recvBatch($buffers, $addresses, $ports);
+    Assert::greaterThan($count, 0);
+    Assert::lessThanEq($count, 8);
+    Assert::count($addresses, $count);
+    Assert::count($ports, $count);
+    for ($n = 0; $n < $count; $n++) {
+        Assert::same($buffers[$n]->toString(), 'datagram-' . $received++);
+        Assert::same($addresses[$n], '127.0.0.1');
+        Assert::same($ports[$n], $client->getSockPort());
+    }
+}
+
+// segmented datagram, it is split by ourselves if UDP_SEGMENT is not available,
+// or if the kernel refuses it (e.g. too many segments in one datagram)
+foreach ([[300, 100], [390, 3]] as [$length, $segmentSize]) {
+    $client->sendBatch([str_repeat('x', $length), 'end'], $server->getSockAddress(), $server->getSockPort(), segmentSize: $segmentSize);
+    $received = '';
+    while (!str_ends_with($received, 'end')) {
+        $count = $server->recvBatch($buffers);
+        for ($n = 0; $n < $count; $n++) {
+            $received .= $buffers[$n]->toString();
+        }
+    }
+    Assert::same($received, str_repeat('x', $length) . 'end');
+}
+
+try {
+    $server->recvBatch($buffers, timeout: 10);
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::ETIMEDOUT);
+}
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
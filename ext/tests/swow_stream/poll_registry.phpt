@@ -0,0 +1,92 @@
+--TEST--
+swow_stream: poll registrations are kept across waits
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_linux_only();
+skip_if(getenv('CAT_POLL_REGISTRY') === '0', 'Poll registry is disabled');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+
+$stats = stream_poll_get_stats();
+foreach (['adds', 'mods', 'dels', 'fallbacks', 'count'] as $key) {
+    Assert::keyExists($stats, $key);
+    Assert::greaterThanEq($stats[$key], 0);
+}
+
+/* fds of native socket streams are not managed by Swow */
+[$a, $b] = stream_socket_pair(STREAM_PF_UNIX, STREAM_SOCK_STREAM, STREAM_IPPROTO_IP);
+
+$before = stream_poll_get_stats();
+Coroutine::run(static function () use ($b): void {
+    for ($n = 0; $n < 10; $n++) {
+        usleep(1000);
+        fwrite($b, 'x');
+    }
+});
+for ($n = 0; $n < 10; $n++) {
+    Assert::same(stream_poll_one($a, STREAM_POLLIN, 1000), STREAM_POLLIN);
+    Assert::same(fread($a, 1), 'x');
+}
+$after = stream_poll_get_stats();
+/* it is added once, then only the interest mask is modified */
+Assert::same($after['adds'], $before['adds'] + 1);
+Assert::same($after['mods'], $before['mods'] + 9);
+Assert::same($after['count'], $before['count'] + 1);
+
+/* timed out */
+Assert::same(stream_poll_one($a, STREAM_POLLIN, 10), STREAM_POLLNONE);
+Assert::same(stream_poll_one($a, STREAM_POLLOUT, 10), STREAM_POLLOUT);
+Assert::same(stream_poll_get_stats()['adds'], $after['adds']);
+
+/* hang up */
+fclose($b);
+Assert::same(stream_poll_one($a, STREAM_POLLIN, 1000) & STREAM_POLLHUP, STREAM_POLLHUP);
+fclose($a);
+
+/* the fd number may be reused by a new file */
+[$a, $b] = stream_socket_pair(STREAM_PF_UNIX, STREAM_SOCK_STREAM, STREAM_IPPROTO_IP);
+fwrite($b, 'y');
+Assert::same(stream_poll_one($a, STREAM_POLLIN, 1000), STREAM_POLLIN);
+Assert::same(fread($a, 1), 'y');
+fclose($a);
+fclose($b);
+
+/* regular files can not be registered, it is remembered instead of trying it on every wait */
+$file = fopen(__FILE__, 'r');
+$before = stream_poll_get_stats();
+for ($n = 0; $n < 3; $n++) {
+    Assert::throws(static function () use ($file): void {
+        stream_poll_one($file, STREAM_POLLIN, 10);
+    }, RuntimeException::class);
+}
+$after = stream_poll_get_stats();
+Assert::same($after['adds'], $before['adds']);
+Assert::same($after['fallbacks'], $before['fallbacks'] + 3);
+
+/* so does polling it with other fds */
+[$a, $b] = stream_socket_pair(STREAM_PF_UNIX, STREAM_SOCK_STREAM, STREAM_IPPROTO_IP);
+$before = stream_poll_get_stats();
+for ($n = 0; $n < 3; $n++) {
+    $read = [$file, $a];
+    $write = $except = null;
+    Assert::same(stream_select($read, $write, $except, 0, 10000), 1);
+    Assert::same(count($read), 1);
+    Assert::oneOf($file, $read);
+}
+$after = stream_poll_get_stats();
+/* only the socket is added */
+Assert::same($after['adds'], $before['adds'] + 1);
+Assert::same($after['fallbacks'], $before['fallbacks'] + 3);
+fclose($a);
+fclose($b);
+fclose($file);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,64 @@
+--TEST--
+swow_thread: named queue
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Sync\WaitReference;
+use Swow\Thread\Queue;
+use Swow\ThreadException;
+
+$queue = new Queue('test');
+Assert::same($queue->getName(), 'test');
+Assert::same($queue->count(), 0);
+
+/* same name, same queue */
+(new Queue('test'))->push('foo');
+Assert::same($queue->count(), 1);
+Assert::same($queue->pop(), 'foo');
+
+try {
+    $queue->pop(1);
+    echo "Never here\n";
+} catch (ThreadException $exception) {
+    Assert::same($exception->getCode(), Errno::ETIMEDOUT);
+}
+
+/* waiter is woken up by push */
+$wr = new WaitReference();
+Coroutine::run(static function () use ($queue, $wr): void {
+    echo $queue->pop() . "\n";
+});
+$queue->push('bar');
+/* let the waiter take it before pushing more */
+WaitReference::wait($wr);
+
+/* pending messages can still be popped after close */
+$queue->push('baz')->close();
+Assert::true($queue->isClosed());
+try {
+    $queue->push('qux');
+    echo "Never here\n";
+} catch (ThreadException $exception) {
+    Assert::same($exception->getCode(), Errno::ECLOSED);
+}
+echo $queue->pop() . "\n";
+try {
+    $queue->pop();
+    echo "Never here\n";
+} catch (ThreadException $exception) {
+    Assert::same($exception->getCode(), Errno::ECLOSED);
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+bar
+baz
+Done
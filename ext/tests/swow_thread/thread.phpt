@@ -0,0 +1,65 @@
+--TEST--
+swow_thread: run scripts in threads
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!PHP_ZTS, 'ZTS is required');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Thread;
+use Swow\Thread\Queue;
+
+Assert::same(Thread::getCurrentId(), 0);
+Assert::greaterThanEq(Thread::getCpuCount(), 1);
+
+$jobs = new Queue('jobs');
+$results = new Queue('results');
+
+$threads = [];
+for ($n = 0; $n < 4; $n++) {
+    $threads[] = new Thread(__DIR__ . '/worker.inc', ['jobs', 'results']);
+}
+
+/* event loop of the main thread is not blocked */
+$ticks = 0;
+$done = false;
+Coroutine::run(static function () use (&$ticks, &$done): void {
+    while (!$done) {
+        msleep(1);
+        $ticks++;
+    }
+});
+
+$expected = 0;
+for ($n = 1; $n <= 1000; $n++) {
+    $jobs->push((string) $n);
+    $expected += $n;
+}
+$jobs->close();
+
+$total = 0;
+$ids = [];
+for ($n = 0; $n < 4; $n++) {
+    [$id, $sum] = explode(':', $results->pop());
+    $ids[] = (int) $id;
+    $total += (int) $sum;
+}
+$done = true;
+Assert::same($total, $expected);
+sort($ids);
+Assert::same($ids, array_map(static fn (Thread $thread): int => $thread->getId(), $threads));
+
+foreach ($threads as $thread) {
+    Assert::same($thread->join(), 0);
+    Assert::false($thread->isRunning());
+}
+Assert::greaterThan($ticks, 0);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,23 @@
+--TEST--
+swow_websocket: mask and unmask with the neon kernel
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(Swow\WebSocket\WebSocket::getMaskKernel() !== 'neon', 'neon kernel is not supported');
+?>
+--ENV--
+CAT_WEBSOCKET_MASK_KERNEL=neon
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\WebSocket\WebSocket;
+
+Assert::same(WebSocket::getMaskKernel(), 'neon');
+
+require __DIR__ . '/mask.inc';
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
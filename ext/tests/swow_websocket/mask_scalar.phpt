@@ -0,0 +1,22 @@
+--TEST--
+swow_websocket: mask and unmask with the scalar kernel
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--ENV--
+CAT_WEBSOCKET_MASK_KERNEL=scalar
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\WebSocket\WebSocket;
+
+Assert::same(WebSocket::getMaskKernel(), 'scalar');
+
+require __DIR__ . '/mask.inc';
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
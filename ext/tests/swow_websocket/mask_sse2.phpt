@@ -0,0 +1,23 @@
+--TEST--
+swow_websocket: mask and unmask with the sse2 kernel
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(Swow\WebSocket\WebSocket::getMaskKernel() !== 'sse2', 'sse2 kernel is not supported');
+?>
+--ENV--
+CAT_WEBSOCKET_MASK_KERNEL=sse2
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\WebSocket\WebSocket;
+
+Assert::same(WebSocket::getMaskKernel(), 'sse2');
+
+require __DIR__ . '/mask.inc';
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -39,15 +39,15 @@ use function implode;
 use function in_array;
 use function max;
 use function parse_str;
+use function rawurldecode;
+use function rewind;
 use function sprintf;
 use function strcasecmp;
 use function strtolower;
-use function sys_get_temp_dir;
-use function tempnam;
 use function trim;
+use function unlink;
 
 use const PHP_INT_MAX;
-use const UPLOAD_ERR_CANT_WRITE;
 use const UPLOAD_ERR_OK;
 
 /**
@@ -111,6 +111,36 @@ trait ReceiverTrait
         return $this;
     }
 
+    public function getMultipartSpoolDirectory(): ?string
+    {
+        return $this->httpParser->getMultipartSpoolDirectory();
+    }
+
+    /**
+     * @param string|null $directory Where uploaded files are spooled to, null means the system temporary directory
+     */
+    public function setMultipartSpoolDirectory(?string $directory): static
+    {
+        $this->httpParser->setMultipartSpoolDirectory($directory);
+
+        return $this;
+    }
+
+    public function getMultipartMemoryThreshold(): int
+    {
+        return $this->httpParser->getMultipartMemoryThreshold();
+    }
+
+    /**
+     * @param int $threshold Uploaded files are kept in memory until their size exceeds it
+     */
+    public function setMultipartMemoryThreshold(int $threshold): static
+    {
+        $this->httpParser->setMultipartMemoryThreshold($threshold);
+
+        return $this;
+    }
+
     public function isPreserveBodyData(): bool
     {
         return $this->preserveBodyData;
@@ -176,6 +206,7 @@ trait ReceiverTrait
         $buffer = $thisBuffer;
         $parser = $this->httpParser;
         $parsedOffset = $this->parsedOffset;
+        $headStartOffset = $parsedOffset;
         $isServerRequest = $parser->getType() === HttpParser::TYPE_REQUEST;
         $messageEntity = $isServerRequest ? new ServerRequestEntity() : new ResponseEntity();
         $maxHeaderLength = $this->getMaxHeaderLength();
@@ -187,13 +218,10 @@ trait ReceiverTrait
         /* HTTP parser related values {{{ */
         $event = HttpParser::EVENT_NONE;
         $dataOffset = $dataLength = 0;
-        $data = '';
         /* }}} */
         /* HTTP related values {{{ */
         $uriOrReasonPhrase = '';
         $headerName = '';
-        $formDataName = '';
-        $fileName = '';
         /** @var array<string, array<string>> $headers */
         $headers = [];
         /** @var array<string, string> $headerNames */
@@ -208,13 +236,6 @@ trait ReceiverTrait
         /* }}} */
         /* multipart related values {{{ */
         $isMultipart = false;
-        $multiPartHeadersCompleted = false;
-        $multipartHeaderName = '';
-        $multipartHeaders = [];
-        $tmpName = '';
-        $tmpFile = null;
-        $tmpFileSize = 0;
-        $fileError = UPLOAD_ERR_OK;
         $formData = [];
         $uploadedFiles = [];
         /* }}} */
@@ -245,27 +266,48 @@ trait ReceiverTrait
                 }
                 // TODO: call $parser->finished() if connection error?
                 while (true) {
-                    $previousEvent = $event;
-                    $parsedLength = $parser->execute($buffer, $parsedOffset);
+                    if (!$headersCompleted) {
+                        /* the whole head is parsed natively, header data is fetched by index later */
+                        $parsedLength = $parser->executeHead($buffer, $parsedOffset);
+                    } elseif ($isMultipart) {
+                        /* parts are parsed natively, file parts are spooled to disk directly */
+                        $parsedLength = $parser->executeMultipart($buffer, $parsedOffset);
+                    } else {
+                        $parsedLength = $parser->execute($buffer, $parsedOffset);
+                    }
                     $parsedOffset += $parsedLength;
                     $event = $parser->getEvent();
                     if ($event & HttpParser::EVENT_FLAG_DATA) {
                         $dataOffset = $parser->getDataOffset();
                         $dataLength = $parser->getDataLength();
-                        if (!$headersCompleted || ($isMultipart && !$multiPartHeadersCompleted)) {
-                            $data = $buffer->read($dataOffset, $dataLength);
-                        }
                     }
                     if (!$headersCompleted) {
                         $headerLength += $parsedLength;
                         if ($headerLength > $maxHeaderLength) {
-                            throw new ProtocolException(empty($headerName) ? HttpStatus::REQUEST_URI_TOO_LARGE : HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
+                            throw new ProtocolException($parser->getHeaderIndex() === [] ? HttpStatus::REQUEST_URI_TOO_LARGE : HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
                         }
                     }
                     if ($event === HttpParser::EVENT_NONE) {
                         if ($buffer !== $thisBuffer) {
                             throw new ParserException('Unexpected EVENT_NONE, buffer is dummy one');
                         }
+                        if (!$headersCompleted) {
+                            /* header index refers to the offsets in buffer,
+                             * so head data must stay where it is until the head is completed */
+                            if (!$buffer->isFull()) {
+                                $expectMoreData = true;
+                                break; /* goto recv more data */
+                            }
+                            if ($headStartOffset === 0) {
+                                throw new ParserException('Buffer is full and unable to continue parsing');
+                            }
+                            /* move the incomplete head to the front and parse it again */
+                            $buffer->truncateFrom($headStartOffset);
+                            $parser->reset();
+                            $parsedOffset = $headStartOffset = $headerLength = 0;
+                            $event = HttpParser::EVENT_NONE;
+                            break; /* goto parse again */
+                        }
                         $buffer->truncateFrom($parsedOffset);
                         if ($buffer->isFull()) {
                             throw new ParserException('Buffer is full and unable to continue parsing');
@@ -298,30 +340,16 @@ trait ReceiverTrait
                     }
                     if (!$headersCompleted) {
                         switch ($event) {
-                            case HttpParser::EVENT_HEADER_FIELD:
-                                if ($event !== $previousEvent) {
-                                    $headerName = $data;
-                                } else {
-                                    $headerName .= $data;
-                                }
-                                break;
-                            case HttpParser::EVENT_HEADER_VALUE:
-                                if ($event !== $previousEvent) {
-                                    $headers[$headerName][] = $data;
-                                    $headerNames[strtolower($headerName)] = $headerName;
-                                } else {
-                                    $headers[$headerName][count($headers[$headerName]) - 1] .= $data;
-                                }
-                                break;
-                            case HttpParser::EVENT_URL:
-                            case HttpParser::EVENT_STATUS:
-                                if ($event !== $previousEvent) {
-                                    $uriOrReasonPhrase = $data;
-                                } else {
-                                    $uriOrReasonPhrase .= $data;
-                                }
-                                break;
                             case HttpParser::EVENT_HEADERS_COMPLETE:
+                                [$dataOffset, $dataLength] = $parser->getUriOrReasonPhraseIndex();
+                                $uriOrReasonPhrase = $dataLength > 0 ? $buffer->read($dataOffset, $dataLength) : '';
+                                foreach ($parser->getHeaderIndex() as $lowercaseHeaderName => $spans) {
+                                    $headerName = $buffer->read($spans[0], $spans[1]);
+                                    for ($i = 0, $n = count($spans); $i < $n; $i += 4) {
+                                        $headers[$headerName][] = $spans[$i + 3] > 0 ? $buffer->read($spans[$i + 2], $spans[$i + 3]) : '';
+                                    }
+                                    $headerNames[$lowercaseHeaderName] = $headerName;
+                                }
                                 $headersCompleted = true;
                                 $shouldKeepAlive = $parser->shouldKeepAlive();
                                 if ($parser->isChunked()) {
@@ -359,97 +387,59 @@ trait ReceiverTrait
                                 break;
                         }
                     } elseif ($isMultipart) {
-                        switch ($event) {
-                            case HttpParser::EVENT_MULTIPART_HEADER_FIELD:
-                                if ($event !== $previousEvent) {
-                                    $multipartHeaderName = strtolower($data);
-                                } else {
-                                    $multipartHeaderName .= strtolower($data);
-                                }
-                                break;
-                            case HttpParser::EVENT_MULTIPART_HEADER_VALUE:
-                                if ($event !== $previousEvent) {
-                                    $multipartHeaders[$multipartHeaderName] = $data;
-                                } else {
-                                    $multipartHeaders[$multipartHeaderName] .= $data;
-                                }
-                                break;
-                            case HttpParser::EVENT_MULTIPART_HEADERS_COMPLETE:
-                                $multiPartHeadersCompleted = true;
-                                /* parse Content-Disposition */
-                                $contentDisposition = $multipartHeaders['content-disposition'] ?? '';
-                                $contentDispositionParts = explode(';', $contentDisposition, 2);
-                                $contentDispositionType = $contentDispositionParts[0];
-                                // FIXME: is inline/attachment valid?
-                                if (!in_array($contentDispositionType, ['form-data', 'inline', 'attachment'], true)) {
-                                    throw new ProtocolException(HttpStatus::BAD_REQUEST, "Unsupported Content-Disposition type '{$contentDispositionParts[0]}'");
-                                }
-                                $contentDispositionParts = explode(';', $contentDispositionParts[1] ?? '');
-                                $contentDispositionMap = [];
-                                foreach ($contentDispositionParts as $contentDispositionPart) {
-                                    $contentDispositionKeyValue = explode('=', $contentDispositionPart, 2);
-                                    $contentDispositionMap[trim($contentDispositionKeyValue[0], ' ')] = trim($contentDispositionKeyValue[1] ?? '', ' "');
+                        if ($event === HttpParser::EVENT_MULTIPART_DATA_END) {
+                            $part = $parser->getMultipartPart();
+                            /* parse Content-Disposition */
+                            $contentDisposition = $part['headers']['content-disposition'] ?? '';
+                            $contentDispositionParts = explode(';', $contentDisposition, 2);
+                            $contentDispositionType = $contentDispositionParts[0];
+                            // FIXME: is inline/attachment valid?
+                            if (!in_array($contentDispositionType, ['form-data', 'inline', 'attachment'], true)) {
+                                if ($part['tmp_name'] !== null) {
+                                    unlink($part['tmp_name']);
                                 }
-                                $formDataName = $contentDispositionMap['name'] ?? null;
-                                $fileName = $contentDispositionMap['filename'] ?? null;
-                                if (!$fileName && !$formDataName) {
-                                    throw new ProtocolException(HttpStatus::BAD_REQUEST, 'Missing name or filename in Content-Disposition');
-                                }
-
-                                if ($fileName) {
-                                    // TODO: make dir and prefix configurable
-                                    $tmpName = tempnam(sys_get_temp_dir(), 'swow_uploaded_file_');
-                                    $tmpFile = fopen($tmpName, 'rwb+');
-                                } else {
-                                    // TODO: not hard code here?
-                                    $formDataValue = new Buffer(256);
-                                }
-                                break;
-                            case HttpParser::EVENT_MULTIPART_BODY:
-                                if (isset($formDataValue)) {
-                                    $formDataValue->append($buffer, $dataOffset, $dataLength);
-                                } else {
-                                    if ($fileError !== UPLOAD_ERR_OK) {
-                                        break;
-                                    }
-                                    if ($dataOffset === 0) {
-                                        $nWrite = fwrite($tmpFile, $buffer->toString(), $dataLength);
-                                    } else {
-                                        // TODO: maybe we should have something like fwrite_ex() to gain more performance?
-                                        $nWrite = fwrite($tmpFile, $buffer->read($dataOffset, $dataLength));
-                                    }
-                                    if ($nWrite !== $dataLength) {
-                                        $fileError = UPLOAD_ERR_CANT_WRITE;
-                                    } else {
-                                        $tmpFileSize += $nWrite;
-                                    }
+                                throw new ProtocolException(HttpStatus::BAD_REQUEST, "Unsupported Content-Disposition type '{$contentDispositionParts[0]}'");
+                            }
+                            $contentDispositionParts = explode(';', $contentDispositionParts[1] ?? '');
+                            $contentDispositionMap = [];
+                            foreach ($contentDispositionParts as $contentDispositionPart) {
+                                $contentDispositionKeyValue = explode('=', $contentDispositionPart, 2);
+                                $contentDispositionMap[strtolower(trim($contentDispositionKeyValue[0], ' '))] = trim($contentDispositionKeyValue[1] ?? '', ' "');
+                            }
+                            $formDataName = $contentDispositionMap['name'] ?? null;
+                            $fileName = $contentDispositionMap['filename'] ?? null;
+                            /* filename* (RFC 5987) is preferred, it is charset'language'value-chars */
+                            $extendedFileName = explode("'", $contentDispositionMap['filename*'] ?? '', 3)[2] ?? '';
+                            if ($extendedFileName !== '') {
+                                $fileName = rawurldecode($extendedFileName);
+                            }
+                            if (($fileName === null || $fileName === '') && !$formDataName) {
+                                if ($part['tmp_name'] !== null) {
+                                    unlink($part['tmp_name']);
                                 }
-                                break;
-                            case HttpParser::EVENT_MULTIPART_DATA_END:
-                                if (isset($formDataValue)) {
-                                    $formData[$formDataName] = $formDataValue->toString();
-                                    // reset for the next parts
-                                    $formDataName = '';
-                                    $formDataValue = null;
+                                throw new ProtocolException(HttpStatus::BAD_REQUEST, 'Missing name or filename in Content-Disposition');
+                            }
+                            if ($fileName !== null && $fileName !== '') {
+                                $uploadedFile = new UploadedFileEntity();
+                                $uploadedFile->name = $fileName;
+                                $uploadedFile->type = $part['headers']['content-type'] ?? MimeType::TXT;
+                                if ($part['tmp_name'] !== null) {
+                                    $uploadedFile->tmpName = $part['tmp_name'];
+                                    $uploadedFile->tmpFile = fopen($part['tmp_name'], 'r+b');
                                 } else {
-                                    $uploadedFile = new UploadedFileEntity();
-                                    $uploadedFile->name = $fileName;
-                                    $uploadedFile->type = $multipartHeaders['content-type'] ?? MimeType::TXT;
-                                    $uploadedFile->tmpName = $tmpName;
-                                    $uploadedFile->tmpFile = $tmpFile;
-                                    $uploadedFile->error = $fileError;
-                                    $uploadedFile->size = $tmpFileSize;
-                                    $uploadedFiles[$formDataName] = $uploadedFile;
-                                    // reset for the next parts
-                                    $tmpName = '';
-                                    $tmpFile = null;
-                                    $tmpFileSize = 0;
-                                    $fileError = UPLOAD_ERR_OK;
+                                    /* small file which is kept in memory */
+                                    $uploadedFile->tmpName = '';
+                                    $uploadedFile->tmpFile = fopen('php://temp', 'r+b');
+                                    fwrite($uploadedFile->tmpFile, $part['data']);
+                                    rewind($uploadedFile->tmpFile);
                                 }
-                                // reset for the next parts
-                                $multiPartHeadersCompleted = false;
-                                $multipartHeaderName = '';
-                                $multipartHeaders = [];
+                                $uploadedFile->error = $part['error'];
+                                $uploadedFile->size = $part['error'] === UPLOAD_ERR_OK ? $part['size'] : 0;
+                                $uploadedFiles[$formDataName] = $uploadedFile;
+                            } else {
+                                /* only file parts are spooled by the parser */
+                                $formData[$formDataName] = $part['data'];
+                            }
                         }
                     } else {
                         switch ($event) {
@@ -22,7 +22,9 @@ class BroadcastResult
         protected int $count,
         protected int $failureCount,
         /** @var ?WeakMap<ServerConnection, Exception> $exceptions */
-        protected ?WeakMap $exceptions = null
+        protected ?WeakMap $exceptions = null,
+        protected int $queuedCount = 0,
+        protected int $skippedCount = 0
     ) {
     }
 
@@ -41,6 +43,18 @@ class BroadcastResult
         return $this->failureCount;
     }
 
+    /** @return int count of targets whose data was queued because they could not receive it immediately */
+    public function getQueuedCount(): int
+    {
+        return $this->queuedCount;
+    }
+
+    /** @return int count of targets skipped because their write queues were full (they are counted as failures) */
+    public function getSkippedCount(): int
+    {
+        return $this->skippedCount;
+    }
+
     /** @return ?WeakMap<ServerConnection, Exception> $exceptions */
     public function getExceptions(): ?WeakMap
     {
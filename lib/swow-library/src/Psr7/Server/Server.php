@@ -15,6 +15,7 @@ namespace Swow\Psr7\Server;
 
 use Closure;
 use Exception;
+use Swow\Errno;
 use Swow\Psr7\Config\LimitationTrait;
 use Swow\Psr7\Message\ServerPsr17FactoryTrait;
 use Swow\Psr7\Message\WebSocketFrameInterface;
@@ -22,6 +23,9 @@ use Swow\Socket;
 use Swow\SocketException;
 use WeakMap;
 
+use function count;
+use function sprintf;
+
 class Server extends Socket
 {
     use LimitationTrait;
@@ -92,8 +96,10 @@ class Server extends Socket
     public function broadcastWebSocketFrame(WebSocketFrameInterface $frame, ?iterable $targets = null, ?Closure $filter = null, int $flags = self::BROADCAST_FLAG_NONE): BroadcastResult
     {
         $targets ??= $this->getConnections();
-        $count = $failureCount = 0;
+        $failureCount = 0;
         $exceptions = null;
+        /** @var ServerConnection[] $connections */
+        $connections = [];
         foreach ($targets as $target) {
             if ($target->getProtocolType() !== $target::PROTOCOL_TYPE_WEBSOCKET) {
                 continue;
@@ -101,20 +107,36 @@ class Server extends Socket
             if ($filter && !$filter($target)) {
                 continue;
             }
-            $count++;
-            try {
-                $target->sendWebSocketFrame($frame);
-            } catch (Exception $exception) {
-                if ($flags & static::BROADCAST_FLAG_RECORD_EXCEPTIONS) {
-                    /* record it and ignore */
-                    /** @var ?WeakMap<ServerConnection, Exception> $exceptions */
-                    $exceptions ??= new WeakMap();
-                    $exceptions[$target] = $exception;
+            $connections[] = $target;
+        }
+        $count = count($connections);
+        if ($count === 0) {
+            return new BroadcastResult(0, 0);
+        }
+        /* serialize the frame only once and write it to all connections without waiting */
+        $data = $frame->toString(true) . (string) $frame->getPayloadData();
+        $stats = Socket::broadcast($connections, $data, failures: $failures);
+        foreach ($failures as $index => $error) {
+            $target = $connections[$index];
+            if ($error === Errno::ENOTSUP) {
+                /* e.g. SSL connections, fallback to the normal way */
+                try {
+                    $target->sendWebSocketFrame($frame);
+                    continue;
+                } catch (Exception $exception) {
                 }
-                $failureCount++;
+            } else {
+                $exception = new SocketException(sprintf('Broadcast failed, reason: %s', Errno::getDescriptionOf($error)), $error);
+            }
+            if ($flags & static::BROADCAST_FLAG_RECORD_EXCEPTIONS) {
+                /* record it and ignore */
+                /** @var ?WeakMap<ServerConnection, Exception> $exceptions */
+                $exceptions ??= new WeakMap();
+                $exceptions[$target] = $exception;
             }
+            $failureCount++;
         }
 
-        return new BroadcastResult($count, $failureCount, $exceptions);
+        return new BroadcastResult($count, $failureCount, $exceptions, $stats['queued'], $stats['skipped']);
     }
 }
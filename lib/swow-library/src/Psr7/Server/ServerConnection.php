@@ -189,13 +189,12 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
                     }
                 }
                 $headers += $this->generateResponseHeaders($body, $close);
-                $this->write([
-                    Http::packResponse(
-                        statusCode: $statusCode,
-                        headers: $headers
-                    ),
-                    $body,
-                ]);
+                Http::sendResponse(
+                    socket: $this,
+                    statusCode: $statusCode,
+                    headers: $headers,
+                    body: $body
+                );
                 break;
             case static::PROTOCOL_TYPE_WEBSOCKET:
                 // TODO: impl
@@ -211,13 +210,12 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
                     $message = HttpStatus::getReasonPhraseOf($statusCode);
                 }
                 $message = "<html lang=\"en\"><body><h2>HTTP {$statusCode} {$message}</h2><hr><i>Powered by Swow</i></body></html>";
-                $this->write([
-                    Http::packResponse(
-                        statusCode: $statusCode,
-                        headers: $this->generateResponseHeaders($message, $close)
-                    ),
-                    $message,
-                ]);
+                Http::sendResponse(
+                    socket: $this,
+                    statusCode: $statusCode,
+                    headers: $this->generateResponseHeaders($message, $close),
+                    body: $message
+                );
                 break;
             case static::PROTOCOL_TYPE_WEBSOCKET:
                 // TODO: impl
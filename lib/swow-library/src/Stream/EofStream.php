@@ -16,7 +16,9 @@ namespace Swow\Stream;
 use InvalidArgumentException;
 use Stringable;
 use Swow\Buffer;
+use Swow\Errno;
 use Swow\Socket;
+use Swow\SocketException;
 
 use function is_array;
 use function strlen;
@@ -61,6 +63,33 @@ class EofStream extends Socket
         return $connection;
     }
 
+    /**
+     * Scan the delimiter natively and receive the message into the buffer directly,
+     * nothing is consumed if it failed, so the caller can still fall back to the slow path
+     * @return ?int message length, or null if the message can not be received in this way
+     */
+    protected function recvMessageDirectly(Buffer $buffer, int $offset, ?int $timeout): ?int
+    {
+        $eof = $this->eof;
+        if ($buffer->getSize() - $buffer->getLength() < strlen($eof)) {
+            return null;
+        }
+        try {
+            $length = $this->recvUntil($buffer, $eof, timeout: $timeout) - strlen($eof);
+        } catch (SocketException $exception) {
+            if ($exception->getCode() !== Errno::EMSGSIZE && $exception->getCode() !== Errno::ENOTSUP) {
+                throw $exception;
+            }
+            return null;
+        }
+        $buffer->truncate($offset + $length);
+        if ($length > $this->maxMessageLength) {
+            throw new MessageTooLargeException($length, $this->maxMessageLength);
+        }
+
+        return $length;
+    }
+
     /**
      * @param ?int $offset default value is $buffer->getLength()
      * @return int message length
@@ -70,6 +99,12 @@ class EofStream extends Socket
         $offset ??= $buffer->getLength();
         $internalBuffer = $this->internalBuffer;
         $eof = $this->eof;
+        if ($internalBuffer->isEmpty() && $offset === $buffer->getLength()) {
+            $length = $this->recvMessageDirectly($buffer, $offset, $timeout);
+            if ($length !== null) {
+                return $length;
+            }
+        }
         $eofOffset = 0;
         $maxMessageLength = $this->maxMessageLength;
         $nWrite = 0;
@@ -135,6 +170,12 @@ class EofStream extends Socket
         $offset ??= $buffer->getLength();
         $internalBuffer = $this->internalBuffer;
         $eof = $this->eof;
+        if ($internalBuffer->isEmpty() && $offset === $buffer->getLength()) {
+            $length = $this->recvMessageDirectly($buffer, $offset, $timeout);
+            if ($length !== null) {
+                return $length;
+            }
+        }
         $eofOffset = $offset;
         $maxMessageLength = $this->maxMessageLength;
         while (true) {
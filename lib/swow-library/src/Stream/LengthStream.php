@@ -16,8 +16,10 @@ namespace Swow\Stream;
 use InvalidArgumentException;
 use Stringable;
 use Swow\Buffer;
+use Swow\Errno;
 use Swow\Pack\Format;
 use Swow\Socket;
+use Swow\SocketException;
 
 use function assert;
 use function is_array;
@@ -25,12 +27,17 @@ use function pack;
 use function strlen;
 use function unpack;
 
+use const PHP_INT_MAX;
+
 class LengthStream extends Socket
 {
     protected string $format = Format::UINT32_BE;
 
     protected int $formatSize = 4;
 
+    /** whether the format can be handled by the native frame functions of Socket */
+    protected bool $nativeFrame = true;
+
     protected Buffer $internalBuffer;
 
     use MaxMessageLengthTrait;
@@ -54,10 +61,34 @@ class LengthStream extends Socket
     {
         $this->format = $format;
         $this->formatSize = Format::getSize($format);
+        $this->updateFrameFormat();
 
         return $this;
     }
 
+    public function setMaxMessageLength(int $maxMessageLength): static
+    {
+        $this->maxMessageLength = $maxMessageLength < 0 ? PHP_INT_MAX : $maxMessageLength;
+        $this->updateFrameFormat();
+
+        return $this;
+    }
+
+    protected function updateFrameFormat(): void
+    {
+        /* formats in machine byte order and signed ones are handled by unpack() */
+        $littleEndian = match ($this->format) {
+            Format::UINT8, Format::UINT16_BE, Format::UINT32_BE, Format::UINT64_BE => false,
+            Format::UINT16_LE, Format::UINT32_LE, Format::UINT64_LE => true,
+            default => null,
+        };
+        $this->nativeFrame = $littleEndian !== null;
+        if ($this->nativeFrame) {
+            $maxMessageLength = $this->maxMessageLength === PHP_INT_MAX ? 0 : $this->maxMessageLength;
+            $this->setFrameFormat($this->formatSize, $littleEndian, 0, $maxMessageLength);
+        }
+    }
+
     public function getFormatSize(): int
     {
         return $this->formatSize;
@@ -68,6 +99,7 @@ class LengthStream extends Socket
         $connection = parent::accept($timeout);
         $connection->format = $this->format;
         $connection->formatSize = $this->formatSize;
+        $connection->nativeFrame = $this->nativeFrame;
         $connection->maxMessageLength = $this->maxMessageLength;
         $connection->internalBuffer = new Buffer(Buffer::COMMON_SIZE);
 
@@ -81,6 +113,17 @@ class LengthStream extends Socket
     public function recvMessage(Buffer $buffer, ?int $offset = null, ?int $timeout = null): int
     {
         $offset ??= $buffer->getLength();
+        if ($this->nativeFrame && $offset === $buffer->getLength() && $this->internalBuffer->isEmpty()) {
+            /* nothing is consumed if it failed, so we can still fall back to the slow path
+             * (e.g. to report the message length which exceeds the max length) */
+            try {
+                return $this->recvFrame($buffer, $timeout);
+            } catch (SocketException $exception) {
+                if ($exception->getCode() !== Errno::EMSGSIZE && $exception->getCode() !== Errno::ENOTSUP) {
+                    throw $exception;
+                }
+            }
+        }
         $format = $this->getFormat();
         $formatSize = $this->formatSize;
         $maxMessageLength = $this->maxMessageLength;
@@ -131,12 +174,19 @@ class LengthStream extends Socket
 
     public function sendMessage(string|Stringable $string, int $start = 0, int $length = -1, ?int $timeout = null): static
     {
+        if ($this->nativeFrame) {
+            return $this->sendFrame($string, $start, $length, $timeout);
+        }
+
         return $this->write([pack($this->format, strlen((string) $string)), [$string, $start, $length]], $timeout);
     }
 
     /** @param non-empty-array<string|Stringable|Buffer|array{0: string|Stringable|Buffer, 1?: int, 2?: int}|null> $chunks */
     public function sendMessageChunks(array $chunks, ?int $timeout = null): static
     {
+        if ($this->nativeFrame) {
+            return $this->writeFrame($chunks, $timeout);
+        }
         $length = 0;
         // TODO: make Socket support to calculate the length of chunks...
         foreach ($chunks as $chunk) {
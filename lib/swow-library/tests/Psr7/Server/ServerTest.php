@@ -293,6 +293,54 @@ final class ServerTest extends TestCase
         $wr::wait($wr);
     }
 
+    public function testUploadFileWithExtendedFileName(): void
+    {
+        $server = new Server();
+        $server->bind('127.0.0.1')->listen();
+
+        $boundary = bin2hex(getRandomBytes(12));
+        $body =
+            "--{$boundary}\r\n" .
+            "Content-Disposition: form-data; name=\"foo\"\r\n" .
+            "\r\n" .
+            "bar\r\n" .
+            "--{$boundary}\r\n" .
+            "Content-Disposition: form-data; name=\"file\"; filename=\"euro.txt\"; filename*=UTF-8''%E2%82%AC.txt\r\n" .
+            "\r\n" .
+            "euro\r\n" .
+            "--{$boundary}--\r\n";
+        $request =
+            "POST /upload HTTP/1.1\r\n" .
+            "Host: {$server->getSockAddress()}:{$server->getSockPort()}\r\n" .
+            "Content-Type: multipart/form-data; boundary={$boundary}\r\n" .
+            'Content-Length: ' . strlen($body) . "\r\n" .
+            "\r\n" .
+            $body;
+
+        $wr = new WaitReference();
+        $channel = new Channel();
+        Coroutine::run(static function () use ($server, $channel, $wr): void {
+            $connection = $server->acceptConnection();
+            $request = $connection->recvHttpRequest();
+            $channel->push([$request->getParsedBody(), $request->getUploadedFiles()]);
+            $connection->respond(Status::OK);
+        });
+
+        $client = new Client();
+        $client->connect($server->getSockAddress(), $server->getSockPort());
+        $client->send($request);
+        /** @var array<string, UploadedFileInterface> $uploadedFiles */
+        [$formData, $uploadedFiles] = $channel->pop();
+        $this->assertSame(['foo' => 'bar'], $formData);
+        $this->assertCount(1, $uploadedFiles);
+        $this->assertSame('€.txt', $uploadedFiles['file']->getClientFilename());
+        $this->assertSame('euro', (string) $uploadedFiles['file']->getStream());
+        $response = $client->recvResponseEntity();
+        $this->assertSame(Status::OK, $response->statusCode);
+
+        $wr::wait($wr);
+    }
+
     public function testRequestUriOrHeaderFieldsTooLarge(): void
     {
         $server = new Server();
@@ -15,6 +15,7 @@ namespace Swow\Tests\Stream;
 
 use PHPUnit\Framework\Attributes\CoversClass;
 use PHPUnit\Framework\TestCase;
+use Swow\Buffer;
 use Swow\Coroutine;
 use Swow\Errno;
 use Swow\SocketException;
@@ -78,6 +79,29 @@ final class EofStreamTest extends TestCase
         }
     }
 
+    public function testRecvMessageIntoSmallBuffer(): void
+    {
+        $wr = new WaitReference();
+        $server = new EofStream();
+        $server->bind('127.0.0.1')->listen();
+        Coroutine::run(static function () use ($server, $wr): void {
+            $connection = $server->accept();
+            $connection->sendMessages(['foo', 'bar', 'baz']);
+            $connection->close();
+        });
+        $client = new EofStream();
+        $client->connect($server->getSockAddress(), $server->getSockPort());
+        /* the first message goes into a buffer which has no space for the delimiter */
+        $this->assertSame('foo', $client->recvMessageString());
+        $buffer = new Buffer(1);
+        $this->assertSame(3, $client->recvMessage($buffer));
+        $this->assertSame('bar', $buffer->toString());
+        $this->assertSame('baz', $client->recvMessageString());
+        $client->close();
+        $server->close();
+        WaitReference::wait($wr);
+    }
+
     public function testMaxMessageLength(): void
     {
         foreach (['recvMessageString', 'recvMessageStringFast'] as $recvMethod) {
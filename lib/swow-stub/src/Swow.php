@@ -54,6 +54,26 @@ namespace
      * @throws RuntimeException on runtime error, e.g. poll has been cancelled or poll failed
      */
     function stream_poll_one($stream, int $events, int $timeout = -1): int { }
+
+    /**
+     * get statistics of the poll registrations
+     *
+     * on Linux, fds which are not managed by Swow (e.g. fds of ext-sockets or libpq)
+     * are kept registered across waits, waiting on them again only modifies the registration
+     *
+     * @return array{'adds': int, 'mods': int, 'dels': int, 'fallbacks': int, 'count': int}
+     */
+    function stream_poll_get_stats(): array { }
+
+    /**
+     * get the engine of file operations of plain files
+     *
+     * on Linux, they are done by io_uring if the kernel supports it (it can be disabled by env CAT_FS_IO_URING=0),
+     * otherwise they are done by the thread pool
+     *
+     * @return string 'io_uring' or 'thread_pool'
+     */
+    function stream_get_fs_engine(): string { }
 }
 
 namespace Swow
@@ -663,6 +683,10 @@ namespace Swow
         public const TYPES_DEFAULT = 62;
         public const TYPES_ABNORMAL = 60;
         public const TYPES_UNFILTERABLE = 48;
+        public const BACKPRESSURE_DROP = 0;
+        public const BACKPRESSURE_BLOCK = 1;
+        public const BACKPRESSURE_SAMPLE = 2;
+        public const ASYNC_DEFAULT_BUFFER_SIZE = 1048576;
 
         /**
          * get enabled log types
@@ -677,6 +701,43 @@ namespace Swow
          * @param int $types the log type flag
          */
         public static function setTypes(int $types): void { }
+
+        /**
+         * write a log record, it is filtered by the enabled log types,
+         * and it goes through the ring buffer if async log is enabled
+         *
+         * @param int $type one of Log::TYPE_DEBUG, Log::TYPE_INFO, Log::TYPE_NOTICE or Log::TYPE_WARNING
+         */
+        public static function write(int $type, string $message): void { }
+
+        /**
+         * write log records in a background thread
+         *
+         * Records are put into a ring buffer and written in batches,
+         * records of error types are always written synchronously.
+         *
+         * @param int $bufferSize size of the ring buffer, it will be aligned to power of 2
+         * @param int $backpressure what to do if the ring buffer is full, one of Log::BACKPRESSURE_*
+         * @param int $sampleRate only keep one of every $sampleRate records if the ring buffer is over 3/4 full (Log::BACKPRESSURE_SAMPLE)
+         */
+        public static function enableAsync(int $bufferSize = \Swow\Log::ASYNC_DEFAULT_BUFFER_SIZE, int $backpressure = \Swow\Log::BACKPRESSURE_DROP, int $sampleRate = 10): void { }
+
+        /**
+         * write all pending records and go back to synchronous logging
+         */
+        public static function disableAsync(): void { }
+
+        public static function isAsync(): bool { }
+
+        /**
+         * wait until all pending records have been written
+         */
+        public static function flush(): void { }
+
+        /**
+         * @return array{'records': int, 'bytes': int, 'batches': int, 'dropped': int, 'sampled_out': int, 'blocked': int, 'direct': int, 'write_errors': int, 'buffer_size': int, 'pending_bytes': int}
+         */
+        public static function getAsyncStats(): array { }
     }
 }
 
@@ -947,6 +1008,26 @@ namespace Swow
         /** @return array<int, Coroutine> */
         public static function getAll(): array { }
 
+        /**
+         * stacks of dead coroutines are cached and reused by new coroutines,
+         * cached stacks over the high-water mark are released to the OS lazily,
+         * vm_* are stats of the cached PHP VM stack pages (only pages in the size of coroutine construction
+         * are cached, and they never exceed the high-water mark)
+         * @return array{'hits': int, 'misses': int, 'trims': int, 'count': int, 'bytes': int, 'resident_bytes': int, 'max_count': int, 'high_water_mark': int, 'vm_hits': int, 'vm_misses': int, 'vm_count': int, 'vm_bytes': int}
+         */
+        public static function getStackPoolStats(): array { }
+
+        /** 0 disables the stack pool */
+        public static function setStackPoolMaxCount(int $count): void { }
+
+        /** cached VM stack pages over it are released at once */
+        public static function setStackPoolHighWaterMark(int $size): void { }
+
+        /** bytes of C stack pages touched by the coroutine and its PHP VM stack pages, 0 if it is not available */
+        public function getStackResidentSize(): int { }
+
+        public static function getTotalStackResidentSize(): int { }
+
         /** @return array<string, mixed> debug information for var_dump */
         public function __debugInfo(): array { }
 
@@ -999,6 +1080,34 @@ namespace Swow
          */
         public function pop(int $timeout = -1): mixed { }
 
+        /**
+         * push all elements of the array into channel in order,
+         * waiting consumers are woken up once per batch instead of once per element
+         *
+         * @note the elements pushed before a failure (e.g. timed out) remain in the channel
+         *
+         * @phan-param array<T> $data
+         * @phpstan-param array<T> $data
+         * @psalm-param array<T> $data
+         * @param array<mixed> $data
+         * @param int $timeout in microseconds
+         * @return static
+         */
+        public function pushMany(array $data, int $timeout = -1): static { }
+
+        /**
+         * pop at most $count elements from channel,
+         * it waits until there is at least one element, then takes all available ones (up to $count),
+         * on an unbuffered channel the available ones are those of the producers which are waiting
+         *
+         * @param int $timeout in microseconds
+         * @phan-return list<T>
+         * @phpstan-return list<T>
+         * @psalm-return list<T>
+         * @return array<mixed>
+         */
+        public function popMany(int $count, int $timeout = -1): array { }
+
         public function close(): void { }
 
         public function getCapacity(): int { }
@@ -1090,6 +1199,88 @@ namespace Swow
     class SelectorException extends \Swow\CallException { }
 }
 
+namespace Swow
+{
+    /**
+     * pool reuses objects (e.g. connections) across coroutines,
+     * the most recently used idle one is reused first
+     *
+     * @phan-template T of object
+     * @phpstan-template T of object
+     * @psalm-template T of object
+     */
+    class Pool
+    {
+        public const DEFAULT_MAX_SIZE = 64;
+
+        /**
+         * @param callable $creator creates a new object when there is no idle one and the pool is not full
+         * @param int $minSize idle eviction never shrinks the pool below it
+         * @param int $idleTimeout idle objects are evicted after this (in milliseconds), -1 means never
+         * @param callable|null $checker tells whether an idle object is still usable before it is handed out,
+         *                               liveness of \Swow\Socket objects is checked by default
+         * @phan-param callable(): T $creator
+         * @phpstan-param callable(): T $creator
+         * @psalm-param callable(): T $creator
+         * @phan-param null|callable(T): bool $checker
+         * @phpstan-param null|callable(T): bool $checker
+         * @psalm-param null|callable(T): bool $checker
+         */
+        public function __construct(callable $creator, int $maxSize = \Swow\Pool::DEFAULT_MAX_SIZE, int $minSize = 0, int $idleTimeout = -1, ?callable $checker = null) { }
+
+        /**
+         * get an object from the pool
+         *
+         * @note context switching happens here when the pool is full, waiters are served in FIFO order.
+         *
+         * @param int $timeout in milliseconds
+         * @phan-return T
+         * @phpstan-return T
+         * @psalm-return T
+         */
+        public function get(int $timeout = -1): object { }
+
+        /**
+         * put an object back to the pool, broken ones are released instead of being reused
+         *
+         * @throws PoolException when the object was not handed out by get() or has already been put back (EMISUSE)
+         * @phan-param T $item
+         * @phpstan-param T $item
+         * @psalm-param T $item
+         */
+        public function put(object $item, bool $broken = false): static { }
+
+        /** create objects until there are $minSize ones, it returns the number of created ones */
+        public function fill(): int { }
+
+        /** release idle objects and wake up waiters, objects in use are released when they are put back */
+        public function close(): void { }
+
+        public function getSize(): int { }
+
+        public function getIdleCount(): int { }
+
+        public function getMaxSize(): int { }
+
+        public function getMinSize(): int { }
+
+        public function isAvailable(): bool { }
+
+        public function hasWaiters(): bool { }
+
+        /** @return array<string, int> counters and times (in microseconds) of the pool */
+        public function getStats(): array { }
+
+        /** @return array<string, mixed> debug information for var_dump */
+        public function __debugInfo(): array { }
+    }
+}
+
+namespace Swow
+{
+    class PoolException extends \Swow\Exception { }
+}
+
 namespace Swow
 {
     class SyncException extends \Swow\Exception { }
@@ -1109,6 +1300,21 @@ namespace Swow
 
         public static function alignSize(int $size = 0, int $alignment = 0): int { }
 
+        /**
+         * buffer memory is allocated in power-of-two size classes (256B ~ 1MiB, string header is not counted in),
+         * memory of released buffers is cached per runtime and reused by new buffers,
+         * pages of large cached ones are given back to the OS by trimPool() (advised_bytes),
+         * classes are the counts of cached memory blocks by the size of class
+         * @return array{'hits': int, 'misses': int, 'reallocs': int, 'in_place_reallocs': int, 'advised_bytes': int, 'count': int, 'bytes': int, 'max_bytes': int, 'classes': array<int, int>}
+         */
+        public static function getPoolStats(): array { }
+
+        /** 0 disables the buffer pool, cached memory over it is released, and the rest is trimmed */
+        public static function setPoolMaxBytes(int $bytes): void { }
+
+        /** give pages of large cached memory blocks back to the OS, the blocks are kept in the pool */
+        public static function trimPool(): void { }
+
         public function __construct(int $size) { }
 
         public function alloc(int $size): void { }
@@ -1237,6 +1443,7 @@ namespace Swow
     {
         public const INVALID_FD = -1;
         public const DEFAULT_BACKLOG = 511;
+        public const DEFAULT_BROADCAST_MAX_QUEUE_SIZE = 1048576;
         public const TYPE_FLAG_STREAM = 1;
         public const TYPE_FLAG_DGRAM = 2;
         public const TYPE_FLAG_INET = 16;
@@ -1334,6 +1541,26 @@ namespace Swow
          */
         public function accept(?int $timeout = null): static { }
 
+        /**
+         * Wait for a connection, then take the connections which are already pending in the backlog without waiting
+         *
+         * @param int $maxCount max number of connections to accept
+         * @param int $timeout [optional] = $this->getAcceptTimeout()
+         * @return static[] new connections, there is at least one
+         */
+        public function acceptBatch(int $maxCount = 64, ?int $timeout = null): array { }
+
+        /**
+         * Accept connections until the socket is closed
+         *
+         * Each connection is pushed to the channel, or passed to the callable in a new coroutine.
+         * After $maxCountPerTick connections have been accepted in a row,
+         * it yields once so that the established connections are not starved by a connection flood.
+         *
+         * @param Channel|callable(static): mixed $handler
+         */
+        public function acceptLoop(\Swow\Channel|callable $handler, int $maxCountPerTick = 64): void { }
+
         /**
          * @template T of static
          * @param T $connection
@@ -1467,6 +1694,110 @@ namespace Swow
          */
         public function recvDataFrom(\Swow\Buffer $buffer, int $offset = 0, int $size = -1, &$address = null, &$port = null, ?int $timeout = null): int { }
 
+        /**
+         * receive datagrams into buffers in one go (recvmmsg on Linux),
+         * it waits for the first datagram and then takes the ones already queued,
+         * each received datagram replaces the content of its buffer
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when timed out
+         * @throws SocketException when socket read failed
+         * @param array<Buffer> $buffers buffers to receive datagrams
+         * @param-out array<string> &$addresses peer address of each received datagram
+         * @param-out array<int> &$ports peer port of each received datagram
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         * @param-out array<int> &$segmentSizes GRO segment size of each received datagram, 0 if not segmented (see {@see Socket::setUdpGro()})
+         * @return int number of datagrams received
+         */
+        public function recvBatch(array $buffers, &$addresses = null, &$ports = null, ?int $timeout = null, &$segmentSizes = null): int { }
+
+        /**
+         * receive data into buffer until the delimiter is found,
+         * the frame (including the delimiter) is appended to the buffer,
+         * data after the delimiter is kept in socket for further reading operations,
+         * nothing is consumed if it failed
+         *
+         * Notice: SSL sockets are not supported (failed with ENOTSUP)
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when connection was closed before the delimiter was found
+         * @throws SocketException when the delimiter was not found in `$maxLength` bytes (EMSGSIZE)
+         * @throws SocketException when timed out
+         * @throws SocketException when socket read failed
+         * @param Buffer $buffer buffer to write in, data will be appended to it
+         * @param string $delimiter delimiter to find
+         * @phan-param int<-1, max> $maxLength
+         * @psalm-param int<-1, max> $maxLength
+         * @param int $maxLength -1 meaning the writable space of buffer, otherwise max frame length in bytes (buffer will be extended if needed)
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         * @return int frame length including the delimiter
+         */
+        public function recvUntil(\Swow\Buffer $buffer, string $delimiter, int $maxLength = -1, ?int $timeout = null): int { }
+
+        /**
+         * set the length-prefixed frame format used by {@see Socket::recvFrame()} and {@see Socket::sendFrame()},
+         * a frame is `[$lengthOffset bytes][length field][body]`, leading bytes before the length field
+         * are skipped on receiving and zero-filled on sending,
+         * connections accepted by {@see Socket::accept()} inherit the frame format of the server
+         *
+         * @throws \ValueError when arguments are invalid
+         * @phan-param 1|2|4|8 $lengthSize
+         * @phpstan-param 1|2|4|8 $lengthSize
+         * @psalm-param 1|2|4|8 $lengthSize
+         * @param int $lengthSize size of the length field in bytes
+         * @param bool $littleEndian byte order of the length field
+         * @param int $lengthOffset bytes before the length field
+         * @param int $maxLength max body length of received frames in bytes, 0 meaning not limited
+         */
+        public function setFrameFormat(int $lengthSize = 4, bool $littleEndian = false, int $lengthOffset = 0, int $maxLength = 0): static { }
+
+        /**
+         * @return array{'length_size': int, 'little_endian': bool, 'length_offset': int, 'max_length': int}
+         */
+        public function getFrameFormat(): array { }
+
+        /**
+         * receive a length-prefixed frame (see {@see Socket::setFrameFormat()}),
+         * the body is appended to the buffer (buffer will be extended if needed),
+         * data after the frame is kept in socket for further reading operations,
+         * nothing is consumed if it failed
+         *
+         * Notice: SSL sockets are not supported (failed with ENOTSUP)
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when connection was closed before the frame was completed
+         * @throws SocketException when body length exceeds the max length (EMSGSIZE)
+         * @throws SocketException when timed out
+         * @throws SocketException when socket read failed
+         * @param Buffer $buffer buffer to write in, body will be appended to it
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         * @return int body length
+         */
+        public function recvFrame(\Swow\Buffer $buffer, ?int $timeout = null): int { }
+
+        /**
+         * same as {@see Socket::recvFrame()}, but it also takes the complete frames which have been received after the first one,
+         * bodies are appended to the buffer one by one
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when connection was closed before the frame was completed
+         * @throws SocketException when body length exceeds the max length (EMSGSIZE)
+         * @throws SocketException when timed out
+         * @throws SocketException when socket read failed
+         * @param Buffer $buffer buffer to write in, bodies will be appended to it
+         * @phan-param int<1, max> $maxCount
+         * @phpstan-param int<1, max> $maxCount
+         * @psalm-param int<1, max> $maxCount
+         * @param int $maxCount max number of frames to receive (at most 65536 at once)
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         * @return array<int> body length of each received frame
+         */
+        public function recvFrames(\Swow\Buffer $buffer, int $maxCount = 64, ?int $timeout = null): array { }
+
         /**
          * read at max `$size` bytes data into buffer from socket without removing the read data from socket,
          * only works on some type of socket,
@@ -1719,6 +2050,67 @@ namespace Swow
          */
         public function sendTo(\Stringable|string $data, int $start = 0, int $length = -1, ?string $address = null, ?int $port = null, ?int $timeout = null): static { }
 
+        /**
+         * write data as a length-prefixed frame (see {@see Socket::setFrameFormat()}),
+         * the header is written together with data in one go
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when data length can not be represented by the length field (EMSGSIZE)
+         * @throws SocketException when timed out
+         * @throws SocketException when write failed
+         * @phan-param non-empty-array<string|\Stringable|Buffer|array{0: string|\Stringable|Buffer, 1?: int, 2?: int}|null> $vector
+         * @phpstan-param non-empty-array<string|\Stringable|Buffer|array{0: string|\Stringable|Buffer, 1?: int, 2?: int}|null> $vector
+         * @psalm-param non-empty-array<string|\Stringable|Buffer|array{0: string|\Stringable|Buffer, 1?: int, 2?: int}|null> $vector
+         * @param array<string|\Stringable|Buffer|array|null> $vector see {@see Socket::write()}
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getWriteTimeout()} value
+         */
+        public function writeFrame(array $vector, ?int $timeout = null): static { }
+
+        /**
+         * send data from `$start` of data with `$length` bytes as a length-prefixed frame (see {@see Socket::setFrameFormat()})
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when data length can not be represented by the length field (EMSGSIZE)
+         * @throws SocketException when timed out
+         * @throws SocketException when write failed
+         * @phpstan-param int<0, max> $start
+         * @psalm-param int<0, max> $start
+         * @param int $start where to start reading from $data
+         * @phpstan-param int<-1, max> $length
+         * @psalm-param int<-1, max> $length
+         * @param int $length length of data to be sent, -1 meaning remaining data in $data, otherwise length in bytes.
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getWriteTimeout()} value
+         */
+        public function sendFrame(\Stringable|string $data, int $start = 0, int $length = -1, ?int $timeout = null): static { }
+
+        /**
+         * send datagrams in one go (sendmmsg on Linux)
+         *
+         * @throws SocketException when timed out
+         * @throws SocketException when write failed
+         * @param array<string|\Stringable|Buffer|array{0: string|\Stringable|Buffer, 1?: string|null, 2?: int|null}> $datagrams data or [data, address, port] of each datagram
+         * @param string|null $address default address to send to
+         * @param int|null $port default port to send to
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getWriteTimeout()} value
+         * @phpstan-param int<0, 65535> $segmentSize
+         * @psalm-param int<0, 65535> $segmentSize
+         * @param int $segmentSize if it is not 0, each datagram is split into segments of this size (by kernel GSO if possible)
+         */
+        public function sendBatch(array $datagrams, ?string $address = null, ?int $port = null, ?int $timeout = null, int $segmentSize = 0): static { }
+
+        /**
+         * Write the same data to many stream sockets without waiting,
+         * data which can not be written immediately is queued and written in background,
+         * a target is skipped (failed with ENOBUFS) if its write queue would exceed $maxQueueSize
+         * Notice: SSL sockets are not supported (failed with ENOTSUP)
+         * @param array<self> $targets
+         * @param array<int|string, int> $failures [output] errno of failed targets indexed by keys of $targets
+         * @return array{done: int, queued: int, skipped: int, failed: int}
+         */
+        public static function broadcast(array $targets, \Stringable|string $data, int $maxQueueSize = self::DEFAULT_BROADCAST_MAX_QUEUE_SIZE, mixed &$failures = null): array { }
+
         /**
          * Send a socket handle to peer via pipe socket
          * @param int $timeout [optional] = $this->getWriteTimeout()
@@ -1752,6 +2144,12 @@ namespace Swow
 
         public function isClient(): bool { }
 
+        /**
+         * @return bool Whether TLS records are encrypted by the kernel (kTLS),
+         * it can be enabled by the "ktls" crypto option, and sendFile() will be zero-copy then
+         */
+        public function isKtlsEnabled(): bool { }
+
         /**
          * @return int return Errno constants if the socket is broken, zero otherwise,
          * it's a silent version of {@see Socket::checkLiveness()}
@@ -1772,6 +2170,8 @@ namespace Swow
 
         public function getSendBufferSize(): int { }
 
+        public function isReadPersistent(): bool { }
+
         public function setRecvBufferSize(int $size): static { }
 
         public function setSendBufferSize(int $size): static { }
@@ -1780,6 +2180,18 @@ namespace Swow
 
         public function setTcpKeepAlive(bool $enable, int $delay): static { }
 
+        /**
+         * enable UDP generic receive offload, datagrams received by {@see Socket::recvBatch()}
+         * may be coalesced, use large enough buffers and split them by the segment sizes
+         */
+        public function setUdpGro(bool $enable): static { }
+
+        /**
+         * keep read interest armed between reads, data which arrives in the meantime
+         * is buffered and returned by the next read without any syscall
+         */
+        public function setReadPersistent(bool $enable): static { }
+
         /** @return array<string, mixed> debug information for var_dump */
         public function __debugInfo(): array { }
 
@@ -1812,6 +2224,29 @@ namespace Swow
         public static function setGlobalReadTimeout(int $timeout): void { }
 
         public static function setGlobalWriteTimeout(int $timeout): void { }
+
+        public static function getGlobalReadPersistent(): bool { }
+
+        /** it only affects sockets which are created after that */
+        public static function setGlobalReadPersistent(bool $enable): void { }
+
+        /**
+         * Configure the SSL session cache shared by all sockets of the current thread,
+         * server sessions are keyed by session id, client sessions are keyed by host:port
+         * together with the client certificate and verify options
+         * @param int|null $size max count of sessions per side, 0 means disabled
+         * @param int|null $timeout session lifetime in seconds
+         * @param int|null $ticketKeyLifetime ticket keys are rotated after it in seconds
+         */
+        public static function setSslSessionCacheOptions(?int $size = null, ?int $timeout = null, ?int $ticketKeyLifetime = null): void { }
+
+        /** @return array{'size': int, 'timeout': int, 'ticket_key_lifetime': int, 'server_count': int, 'server_hits': int, 'server_misses': int, 'client_count': int, 'client_hits': int, 'client_misses': int, 'ticket_key_rotations': int} */
+        public static function getSslSessionCacheStats(): array { }
+
+        /** tickets encrypted by the previous key are still accepted and renewed */
+        public static function rotateSslTicketKeys(): void { }
+
+        public static function clearSslSessionCache(): void { }
     }
 }
 
@@ -1820,6 +2255,38 @@ namespace Swow
     class SocketException extends \Swow\CallException { }
 }
 
+namespace Swow
+{
+    /**
+     * results of name resolution are cached per runtime,
+     * concurrent lookups of the same name share one request
+     */
+    class Dns
+    {
+        /** @return array{'hits': int, 'negative_hits': int, 'misses': int, 'coalesced': int, 'evictions': int, 'size': int, 'capacity': int} */
+        public static function getCacheStats(): array { }
+
+        public static function clearCache(): void { }
+
+        public static function getCacheCapacity(): int { }
+
+        /** 0 disables the cache */
+        public static function setCacheCapacity(int $capacity): void { }
+
+        /** @return int milliseconds */
+        public static function getCacheTtl(): int { }
+
+        /** @param int $ttl milliseconds, 0 disables caching of resolved addresses */
+        public static function setCacheTtl(int $ttl): void { }
+
+        /** @return int milliseconds */
+        public static function getCacheNegativeTtl(): int { }
+
+        /** @param int $ttl milliseconds, 0 disables caching of unknown names */
+        public static function setCacheNegativeTtl(int $ttl): void { }
+    }
+}
+
 namespace Swow
 {
     class Signal
@@ -2238,6 +2705,12 @@ namespace Swow\Http
         public static function packRequest(string $method, \Stringable|string $uri, array $headers = [], \Stringable|string $body = '', string $protocolVersion = self::DEFAULT_PROTOCOL_VERSION): string { }
 
         public static function packResponse(int $statusCode, string $reasonPhrase = '', array $headers = [], \Stringable|string $body = '', string $protocolVersion = self::DEFAULT_PROTOCOL_VERSION): string { }
+
+        /**
+         * Send the response without copying the body, body will be sent in chunked encoding if it is an array of chunks
+         * @param array<string|\Stringable|\Swow\Buffer>|string|\Stringable $body
+         */
+        public static function sendResponse(\Swow\Socket $socket, int $statusCode, string $reasonPhrase = '', array $headers = [], \Stringable|string|array $body = '', string $protocolVersion = self::DEFAULT_PROTOCOL_VERSION, ?int $timeout = null): void { }
     }
 }
 
@@ -2355,6 +2828,53 @@ namespace Swow\Http
         /** @return int the length of the data which was parsed, same with $this->getParsedLength() */
         public function execute(\Stringable|string $data, int $start = 0, int $length = -1): int { }
 
+        /**
+         * parse the whole head (first line and headers) at once,
+         * it stops at EVENT_HEADERS_COMPLETE, or at EVENT_NONE if more data is needed
+         *
+         * @note data of the head should not be moved (e.g. truncated) until the head is completed,
+         * since the index refers to offsets in it
+         * @return int the length of the data which was parsed
+         */
+        public function executeHead(\Stringable|string $data, int $start = 0, int $length = -1): int { }
+
+        /**
+         * @return array<string, array<int>> lowercase header name => list of
+         * [name offset, name length, value offset, value length] of each occurrence
+         */
+        public function getHeaderIndex(): array { }
+
+        /** @return array{0: int, 1: int} [offset, length] of request URI or response reason phrase */
+        public function getUriOrReasonPhraseIndex(): array { }
+
+        /**
+         * Parse multipart body natively, part headers are collected and part data is
+         * kept in memory or spooled to a temporary file (for file parts),
+         * it stops at EVENT_MULTIPART_DATA_END (the part can be fetched by getMultipartPart()),
+         * at EVENT_MESSAGE_COMPLETE, or at EVENT_NONE if more data is needed
+         *
+         * @note data can be moved (e.g. truncated) between executions
+         * @return int the length of the data which was parsed
+         */
+        public function executeMultipart(\Stringable|string $data, int $start = 0, int $length = -1): int { }
+
+        /**
+         * @return array{headers: array<string, string>, data: string, tmp_name: string|null, size: int, error: int}
+         * part headers with lowercase names, part data if it was kept in memory,
+         * the temporary file if it was spooled to disk (it is owned by the caller), size and UPLOAD_ERR_* error
+         */
+        public function getMultipartPart(): array { }
+
+        public function getMultipartSpoolDirectory(): ?string { }
+
+        /** @param string|null $directory where file parts are spooled to, null means the system temporary directory */
+        public function setMultipartSpoolDirectory(?string $directory): static { }
+
+        public function getMultipartMemoryThreshold(): int { }
+
+        /** @param int $threshold file parts are kept in memory until their size exceeds it */
+        public function setMultipartMemoryThreshold(int $threshold): static { }
+
         public function getEvent(): int { }
 
         public function getEventName(): string { }
@@ -2431,6 +2951,12 @@ namespace Swow\WebSocket
         public static function mask(\Stringable|string $data, int $start = 0, int $length = -1, string $maskingKey = '', int $index = 0): string { }
 
         public static function unmask(\Swow\Buffer $data, int $start = 0, int $length = -1, string $maskingKey = '', int $index = 0): void { }
+
+        /**
+         * name of the kernel used for masking (e.g. "avx2", "sse2", "neon" or "scalar"),
+         * a supported one can be forced by env CAT_WEBSOCKET_MASK_KERNEL
+         */
+        public static function getMaskKernel(): string { }
     }
 }
 
@@ -2518,6 +3044,69 @@ namespace Swow\WebSocket
     }
 }
 
+namespace Swow
+{
+    /**
+     * runs a PHP script in a new thread (ZTS is required),
+     * every thread has its own event loop and scheduler
+     */
+    class Thread
+    {
+        /** @param array<string> $arguments they are passed to the script as `$argv` */
+        public function __construct(string $filename, array $arguments = []) { }
+
+        public function getId(): int { }
+
+        public function isRunning(): bool { }
+
+        /**
+         * only current coroutine waits for it, returns exit status of the script.
+         * threads which have not been joined will be joined in blocking way when they are released
+         */
+        public function join(int $timeout = -1): int { }
+
+        /** 0 for the main thread */
+        public static function getCurrentId(): int { }
+
+        public static function getCpuCount(): int { }
+
+        /**
+         * create a TCP server socket with SO_REUSEPORT,
+         * call it in every thread with the same address so that connections are distributed by the kernel
+         */
+        public static function listen(string $name, int $port, int $backlog = \Swow\Socket::DEFAULT_BACKLOG): \Swow\Socket { }
+    }
+}
+
+namespace Swow\Thread
+{
+    /**
+     * process-wide message queue, queues with the same name are the same one in all threads
+     */
+    class Queue
+    {
+        public function __construct(string $name) { }
+
+        public function getName(): string { }
+
+        public function push(string $message): static { }
+
+        public function pop(int $timeout = -1): string { }
+
+        /** it is closed for all threads, pop() throws once it has been drained */
+        public function close(): static { }
+
+        public function isClosed(): bool { }
+
+        public function count(): int { }
+    }
+}
+
+namespace Swow
+{
+    class ThreadException extends \Swow\Exception { }
+}
+
 namespace Swow\Debug
 {
     /**
@@ -2532,4 +3121,11 @@ namespace Swow\Debug
 namespace Swow\Debug
 {
     function registerExtendedStatementHandler(callable $handler, bool $force = false): \Swow\Utils\Handler { }
+
+    /**
+     * small objects of the event loop (timers, requests, tasks) are allocated from size-class slabs,
+     * classes are keyed by object size and only the ones that have pages are listed
+     * @return array{'page_count': int, 'page_bytes': int, 'used_bytes': int, 'large_count': int, 'classes': array<int, array{'count': int, 'free_count': int, 'page_count': int}>}
+     */
+    function getSlabStats(): array { }
 }